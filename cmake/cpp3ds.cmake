@@ -216,6 +216,82 @@ macro(compile_resources name directory output)
 endmacro()
 
 
+# Converts images to preprocessed textures (see Texture::loadFromPreprocessedFile)
+# format: etc1, etc1a4 or rgba8
+function(compile_textures output directory format)
+	string(REGEX REPLACE "/+$" "" directory "${directory}") # Remove trailing slash
+	file(MAKE_DIRECTORY ${directory})
+	foreach(texture ${ARGN})
+		get_filename_component(filename ${texture} NAME)
+		get_filename_component(name ${texture} NAME_WE)
+		list(APPEND ${output} "${directory}/${name}.tex")
+		add_custom_command(
+			OUTPUT ${directory}/${name}.tex
+			COMMAND python ${CPP3DS}/scripts/tex_compile.py -f ${format} -o ${directory}/${name}.tex ${texture}
+			DEPENDS ${texture} ${CPP3DS}/scripts/tex_compile.py
+			COMMENT "Compiling texture ${filename} (${format})"
+		)
+	endforeach(texture)
+	set(${output} ${${output}} PARENT_SCOPE)
+endfunction()
+
+
+# Converts images to big textures split into tiles (see BigTexture::openFromFile)
+function(compile_big_textures output directory format)
+	string(REGEX REPLACE "/+$" "" directory "${directory}") # Remove trailing slash
+	file(MAKE_DIRECTORY ${directory})
+	foreach(texture ${ARGN})
+		get_filename_component(filename ${texture} NAME)
+		get_filename_component(name ${texture} NAME_WE)
+		list(APPEND ${output} "${directory}/${name}.btex")
+		add_custom_command(
+			OUTPUT ${directory}/${name}.btex
+			COMMAND python ${CPP3DS}/scripts/tex_compile.py -b -f ${format} -o ${directory}/${name}.btex ${texture}
+			DEPENDS ${texture} ${CPP3DS}/scripts/tex_compile.py
+			COMMENT "Compiling big texture ${filename} (${format})"
+		)
+	endforeach(texture)
+	set(${output} ${${output}} PARENT_SCOPE)
+endfunction()
+
+
+# Encodes WAV files as DSP-ADPCM, which SoundBuffer keeps compressed (see SoundBuffer::loadFromFile)
+function(compile_sounds output directory)
+	string(REGEX REPLACE "/+$" "" directory "${directory}") # Remove trailing slash
+	file(MAKE_DIRECTORY ${directory})
+	foreach(sound ${ARGN})
+		get_filename_component(filename ${sound} NAME)
+		get_filename_component(name ${sound} NAME_WE)
+		list(APPEND ${output} "${directory}/${name}.adpcm")
+		add_custom_command(
+			OUTPUT ${directory}/${name}.adpcm
+			COMMAND python ${CPP3DS}/scripts/adpcm_compile.py -o ${directory}/${name}.adpcm ${sound}
+			DEPENDS ${sound} ${CPP3DS}/scripts/adpcm_compile.py
+			COMMENT "Compiling sound ${filename} (DSP-ADPCM)"
+		)
+	endforeach(sound)
+	set(${output} ${${output}} PARENT_SCOPE)
+endfunction()
+
+
+# Packs a directory of images into a texture atlas (see TextureAtlas::loadFromFile)
+# format: etc1, etc1a4 or rgba8
+function(compile_atlas output atlas format directory)
+	get_filename_component(filename ${atlas} NAME)
+	get_filename_component(atlas_dir ${atlas} PATH)
+	file(MAKE_DIRECTORY ${atlas_dir})
+	file(GLOB_RECURSE images ${directory}/*.png ${directory}/*.jpg ${directory}/*.jpeg ${directory}/*.bmp ${directory}/*.tga ${directory}/*.gif)
+	list(APPEND ${output} ${atlas})
+	add_custom_command(
+		OUTPUT ${atlas}
+		COMMAND python ${CPP3DS}/scripts/atlas_pack.py -f ${format} -o ${atlas} ${directory}
+		DEPENDS ${images} ${CPP3DS}/scripts/atlas_pack.py ${CPP3DS}/scripts/tex_compile.py
+		COMMENT "Packing atlas ${filename} (${format})"
+	)
+	set(${output} ${${output}} PARENT_SCOPE)
+endfunction()
+
+
 function(__add_smdh target APP_TITLE APP_DESCRIPTION APP_AUTHOR APP_ICON)
     if(BANNERTOOL AND NOT FORCE_SMDHTOOL)
         set(__SMDH_COMMAND ${BANNERTOOL} makesmdh -s ${APP_TITLE} -l ${APP_DESCRIPTION}  -p ${APP_AUTHOR} -i ${APP_ICON} -o ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${target})
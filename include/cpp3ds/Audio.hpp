@@ -2,13 +2,19 @@
 #define CPP3DS_AUDIO_HPP
 
 #include <cpp3ds/System.hpp>
+#include <cpp3ds/Audio/AudioBus.hpp>
+#include <cpp3ds/Audio/AudioNodes.hpp>
 //#include <cpp3ds/Audio/Listener.hpp>
 #include <cpp3ds/Audio/Music.hpp>
+#include <cpp3ds/Audio/Resampler.hpp>
 #include <cpp3ds/Audio/Sound.hpp>
 #include <cpp3ds/Audio/SoundBuffer.hpp>
 #include <cpp3ds/Audio/SoundBufferRecorder.hpp>
+#include <cpp3ds/Audio/SoundFileRecorder.hpp>
 #include <cpp3ds/Audio/SoundRecorder.hpp>
+#include <cpp3ds/Audio/SoundRingBuffer.hpp>
 #include <cpp3ds/Audio/SoundStream.hpp>
+#include <cpp3ds/Audio/VoiceManager.hpp>
 
 #endif
 
@@ -0,0 +1,299 @@
+#ifndef CPP3DS_AUDIOBUS_HPP
+#define CPP3DS_AUDIOBUS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <cpp3ds/System/Time.hpp>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+namespace cpp3ds
+{
+class AudioBus;
+
+////////////////////////////////////////////////////////////
+/// \brief Abstract base class of the effects of an audio bus
+///
+////////////////////////////////////////////////////////////
+class AudioNode : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual ~AudioNode();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Let the samples through the node unchanged, or not
+    ///
+    /// This can be called at any time, from any thread. A
+    /// bypassed node costs nothing, and its state is kept for
+    /// when it is enabled again.
+    ///
+    /// \param bypassed True to skip the node
+    ///
+    /// \see isBypassed
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBypassed(bool bypassed);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the node is skipped
+    ///
+    /// \return True if the node is bypassed
+    ///
+    /// \see setBypassed
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isBypassed() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time spent processing samples
+    ///
+    /// \return Processing time since the last call to resetCpuStats()
+    ///
+    /// \see getCpuLoad
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getCpuTime() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the share of a CPU the node takes
+    ///
+    /// This is the time spent processing the samples over their
+    /// duration: 0.01 means that the node takes 1% of the core
+    /// the stream runs on.
+    ///
+    /// \return Processing time over audio time, since the last
+    ///         call to resetCpuStats()
+    ///
+    /// \see getCpuTime
+    ///
+    ////////////////////////////////////////////////////////////
+    float getCpuLoad() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start measuring the CPU time again
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetCpuStats();
+
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// This constructor is only meant to be called by derived classes.
+    ///
+    ////////////////////////////////////////////////////////////
+    AudioNode();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get ready for a new stream
+    ///
+    /// This function must be overridden by derived classes to
+    /// allocate what they need for this format, and forget the
+    /// samples of the previous stream. It is called from the
+    /// streaming thread, before the first block.
+    ///
+    /// \param sampleRate   Sample rate of the blocks
+    /// \param channelCount Number of channels of the blocks (1 or 2)
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onPrepare(unsigned int sampleRate, unsigned int channelCount) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Process a block of samples in place
+    ///
+    /// This function must be overridden by derived classes. It
+    /// is called from the streaming thread, and must neither
+    /// lock nor allocate. Parameters changed by other threads
+    /// are read from atomics once per block.
+    ///
+    /// \param channels     One array of samples per channel, in [-1, 1]
+    /// \param channelCount Number of channels (1 or 2)
+    /// \param frameCount   Number of samples in each channel, at most AudioBus::BlockSize
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount) = 0;
+
+private :
+
+    friend class AudioBus;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Account for the processing of some frames
+    ///
+    ////////////////////////////////////////////////////////////
+    void addCpuTime(Time time, unsigned int frameCount);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::atomic<bool>  m_bypassed;   ///< Is the node skipped?
+    std::atomic<Int64> m_cpuTime;    ///< Processing time, in microseconds
+    std::atomic<Int64> m_audioTime;  ///< Duration of the samples processed, in microseconds
+    unsigned int       m_sampleRate; ///< Sample rate of the current stream
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief Chain of effects processing the samples of a stream
+///        in blocks
+///
+////////////////////////////////////////////////////////////
+class AudioBus : public AudioNode
+{
+public :
+
+    enum
+    {
+        BlockSize = 256 ///< Number of frames processed at once
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// An empty bus lets the samples through unchanged.
+    ///
+    ////////////////////////////////////////////////////////////
+    AudioBus();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Append a node to the end of the chain
+    ///
+    /// The node isn't copied, it must stay alive while it is in
+    /// the bus. Nodes can be buses themselves, to bypass or
+    /// measure a group of effects at once. The chain may only
+    /// be changed while no stream plays through the bus.
+    ///
+    /// \param node Node to append
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(AudioNode& node);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a node from the chain
+    ///
+    /// \param node Node to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(AudioNode& node);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the nodes
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of nodes in the chain
+    ///
+    /// \return Number of nodes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getNodeCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get ready for a new stream
+    ///
+    /// Streams call it when they start playing through the bus.
+    ///
+    /// \param sampleRate   Sample rate of the stream
+    /// \param channelCount Number of channels of the stream (1 or 2)
+    ///
+    ////////////////////////////////////////////////////////////
+    void prepare(unsigned int sampleRate, unsigned int channelCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Run samples through the chain, in place
+    ///
+    /// \param samples     Interleaved samples of the stream
+    /// \param sampleCount Number of samples, a multiple of the channel count
+    ///
+    ////////////////////////////////////////////////////////////
+    void process(Int16* samples, std::size_t sampleCount);
+
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Prepare all the nodes of the chain
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onPrepare(unsigned int sampleRate, unsigned int channelCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Run a block through all the nodes of the chain
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<AudioNode*> m_nodes;        ///< Chain of effects, in processing order
+    std::vector<float>      m_block;        ///< Samples of the current block, one channel after the other
+    unsigned int            m_channelCount; ///< Number of channels of the current stream
+    Clock                   m_clock;        ///< Never restarted, so that rounding errors of consecutive measures cancel out
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_AUDIOBUS_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::AudioBus
+/// \ingroup audio
+///
+/// Effects such as filtering the music under water, an echo
+/// in a cave or a limiter on loud scenes are applied to a
+/// stream by attaching a bus to it (see
+/// cpp3ds::SoundStream::setBus). The bus converts the samples
+/// to floating point, runs them through its nodes BlockSize
+/// frames at a time, one channel after the other, and
+/// converts them back.
+///
+/// Parameters of the nodes can be changed at any time without
+/// a lock: the streaming thread picks them up at the next
+/// block. Each node measures the time it takes, which tells
+/// what an effect costs on the console.
+///
+/// A bus and its nodes hold the state of the stream going
+/// through them, so they must only be used by one stream at
+/// a time.
+///
+/// \code
+/// cpp3ds::BiquadNode underwater(cpp3ds::BiquadNode::LowPass, 600.f);
+/// cpp3ds::CompressorNode limiter(-3.f, 20.f);
+/// underwater.setBypassed(true);
+///
+/// cpp3ds::AudioBus bus;
+/// bus.add(underwater);
+/// bus.add(limiter);
+///
+/// cpp3ds::Music music;
+/// music.openFromFile("theme.ogg");
+/// music.setBus(&bus);
+/// music.play();
+///
+/// // Later, from the game loop
+/// underwater.setBypassed(!playerIsUnderwater);
+/// std::cout << "Limiter: " << limiter.getCpuLoad() * 100 << "% CPU" << std::endl;
+/// \endcode
+///
+/// \see cpp3ds::AudioNode, cpp3ds::BiquadNode, cpp3ds::CompressorNode,
+///      cpp3ds::DelayNode, cpp3ds::GainNode
+///
+////////////////////////////////////////////////////////////
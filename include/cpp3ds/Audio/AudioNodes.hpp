@@ -0,0 +1,432 @@
+#ifndef CPP3DS_AUDIONODES_HPP
+#define CPP3DS_AUDIONODES_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/AudioBus.hpp>
+#include <atomic>
+#include <vector>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Changes the volume of a bus, with optional fades
+///
+////////////////////////////////////////////////////////////
+class GainNode : public AudioNode
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param gain Linear gain, 1 to keep the volume
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit GainNode(float gain = 1.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the gain, at once or progressively
+    ///
+    /// Fading down and back up is how music is ducked under
+    /// dialogs, for instance.
+    ///
+    /// \param gain Linear gain, 1 to keep the volume
+    /// \param fade Time to go from the current gain to the new one
+    ///
+    ////////////////////////////////////////////////////////////
+    void setGain(float gain, Time fade = Time::Zero);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the gain, once the fade is over
+    ///
+    /// \return Linear gain
+    ///
+    ////////////////////////////////////////////////////////////
+    float getGain() const;
+
+protected :
+
+    virtual void onPrepare(unsigned int sampleRate, unsigned int channelCount);
+    virtual void onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::atomic<float>  m_target;      ///< Gain to reach
+    std::atomic<Int64>  m_fade;        ///< Duration of the fade to the target, in microseconds
+    std::atomic<Uint32> m_version;     ///< Incremented by each change of the parameters
+    Uint32              m_seenVersion; ///< Version the fade was computed for
+    unsigned int        m_sampleRate;  ///< Sample rate of the current stream
+    float               m_gain;        ///< Gain of the last frame processed
+    float               m_step;        ///< Change of the gain per frame during a fade
+    unsigned int        m_fadeFrames;  ///< Frames left in the fade
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief Second order filter: low-pass, high-pass, equalizer...
+///
+////////////////////////////////////////////////////////////
+class BiquadNode : public AudioNode
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Shapes of the filter
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Type
+    {
+        LowPass,  ///< Cuts above the frequency
+        HighPass, ///< Cuts below the frequency
+        BandPass, ///< Keeps around the frequency
+        Notch,    ///< Cuts around the frequency
+        Peak,     ///< Boosts or cuts around the frequency by the gain
+        LowShelf, ///< Boosts or cuts below the frequency by the gain
+        HighShelf ///< Boosts or cuts above the frequency by the gain
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param type      Shape of the filter
+    /// \param frequency Cutoff or center frequency, in Hz
+    /// \param q         Quality factor, the higher the narrower (0.707 for no resonance)
+    /// \param gain      Boost or cut of the peak and shelf filters, in dB
+    ///
+    ////////////////////////////////////////////////////////////
+    BiquadNode(Type type = LowPass, float frequency = 1000.f, float q = 0.7071f, float gain = 0.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the shape of the filter
+    ///
+    ////////////////////////////////////////////////////////////
+    void setType(Type type);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the cutoff or center frequency, in Hz
+    ///
+    ////////////////////////////////////////////////////////////
+    void setFrequency(float frequency);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the quality factor
+    ///
+    ////////////////////////////////////////////////////////////
+    void setQ(float q);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the boost or cut of the peak and shelf
+    ///        filters, in dB
+    ///
+    ////////////////////////////////////////////////////////////
+    void setGain(float gain);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the shape of the filter
+    ///
+    ////////////////////////////////////////////////////////////
+    Type getType() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the cutoff or center frequency, in Hz
+    ///
+    ////////////////////////////////////////////////////////////
+    float getFrequency() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the quality factor
+    ///
+    ////////////////////////////////////////////////////////////
+    float getQ() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the boost or cut, in dB
+    ///
+    ////////////////////////////////////////////////////////////
+    float getGain() const;
+
+protected :
+
+    virtual void onPrepare(unsigned int sampleRate, unsigned int channelCount);
+    virtual void onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the coefficients from the parameters
+    ///
+    ////////////////////////////////////////////////////////////
+    void design();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::atomic<int>    m_type;        ///< Shape of the filter
+    std::atomic<float>  m_frequency;   ///< Cutoff or center frequency
+    std::atomic<float>  m_q;           ///< Quality factor
+    std::atomic<float>  m_gain;        ///< Boost or cut, in dB
+    std::atomic<Uint32> m_version;     ///< Incremented by each change of the parameters
+    Uint32              m_seenVersion; ///< Version the coefficients were computed for
+    unsigned int        m_sampleRate;  ///< Sample rate of the current stream
+    float               m_b0;          ///< Weight of the input, normalized by a0 like the others
+    float               m_b1;          ///< Weight of the previous input
+    float               m_b2;          ///< Weight of the input before it
+    float               m_a1;          ///< Weight of the previous output
+    float               m_a2;          ///< Weight of the output before it
+    float               m_z1[2];       ///< First state of each channel (transposed direct form II)
+    float               m_z2[2];       ///< Second state of each channel
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief Echo, with feedback
+///
+////////////////////////////////////////////////////////////
+class DelayNode : public AudioNode
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param maxDelay Longest delay the node will be set to
+    /// \param delay    Time between the sound and its echo
+    /// \param feedback Share of the echo fed back into the delay, in [0, 1[
+    /// \param mix      Share of the echo in the output, in [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    DelayNode(Time maxDelay = seconds(1.f), Time delay = milliseconds(250), float feedback = 0.3f, float mix = 0.3f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the time between the sound and its echo
+    ///
+    /// It is clamped to the maximum delay given to the constructor.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDelay(Time delay);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the share of the echo fed back into the
+    ///        delay, in [0, 1[
+    ///
+    ////////////////////////////////////////////////////////////
+    void setFeedback(float feedback);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the share of the echo in the output, in [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    void setMix(float mix);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time between the sound and its echo
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getDelay() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the share of the echo fed back into the delay
+    ///
+    ////////////////////////////////////////////////////////////
+    float getFeedback() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the share of the echo in the output
+    ///
+    ////////////////////////////////////////////////////////////
+    float getMix() const;
+
+protected :
+
+    virtual void onPrepare(unsigned int sampleRate, unsigned int channelCount);
+    virtual void onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Time                m_maxDelay;   ///< Longest delay, which sizes the lines
+    std::atomic<Int64>  m_delay;      ///< Time between the sound and its echo, in microseconds
+    std::atomic<float>  m_feedback;   ///< Share of the echo fed back
+    std::atomic<float>  m_mix;        ///< Share of the echo in the output
+    unsigned int        m_sampleRate; ///< Sample rate of the current stream
+    std::vector<float>  m_lines[2];   ///< Past samples of each channel, a power of two long
+    std::size_t         m_mask;       ///< Length of the lines minus one
+    std::size_t         m_position;   ///< Index of the next sample written in the lines
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief Reduces the level of loud passages, and limits peaks
+///
+////////////////////////////////////////////////////////////
+class CompressorNode : public AudioNode
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// A high ratio with a short attack makes a limiter.
+    ///
+    /// \param threshold Level from which the sound is compressed, in dB below full scale
+    /// \param ratio     Input level increase giving 1 dB of output increase past the threshold
+    /// \param attack    Time to react to a louder sound
+    /// \param release   Time to recover after a louder sound
+    /// \param makeup    Gain applied after the compression, in dB
+    ///
+    ////////////////////////////////////////////////////////////
+    CompressorNode(float threshold = -12.f, float ratio = 4.f, Time attack = milliseconds(5), Time release = milliseconds(100), float makeup = 0.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the level from which the sound is compressed, in dB
+    ///
+    ////////////////////////////////////////////////////////////
+    void setThreshold(float threshold);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the compression ratio, at least 1
+    ///
+    ////////////////////////////////////////////////////////////
+    void setRatio(float ratio);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the time to react to a louder sound
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAttack(Time attack);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the time to recover after a louder sound
+    ///
+    ////////////////////////////////////////////////////////////
+    void setRelease(Time release);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the gain applied after the compression, in dB
+    ///
+    ////////////////////////////////////////////////////////////
+    void setMakeup(float makeup);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the level from which the sound is compressed, in dB
+    ///
+    ////////////////////////////////////////////////////////////
+    float getThreshold() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the compression ratio
+    ///
+    ////////////////////////////////////////////////////////////
+    float getRatio() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time to react to a louder sound
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getAttack() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time to recover after a louder sound
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getRelease() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the gain applied after the compression, in dB
+    ///
+    ////////////////////////////////////////////////////////////
+    float getMakeup() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get how much the last block was turned down
+    ///
+    /// \return Gain reduction, in dB (0 when below the threshold)
+    ///
+    ////////////////////////////////////////////////////////////
+    float getGainReduction() const;
+
+protected :
+
+    virtual void onPrepare(unsigned int sampleRate, unsigned int channelCount);
+    virtual void onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::atomic<float>  m_threshold;     ///< Level from which the sound is compressed, in dB
+    std::atomic<float>  m_ratio;         ///< Compression ratio
+    std::atomic<Int64>  m_attack;        ///< Time to react, in microseconds
+    std::atomic<Int64>  m_release;       ///< Time to recover, in microseconds
+    std::atomic<float>  m_makeup;        ///< Gain after the compression, in dB
+    std::atomic<float>  m_reduction;     ///< Gain reduction of the last block, in dB
+    std::atomic<Uint32> m_version;       ///< Incremented by each change of the time constants
+    Uint32              m_seenVersion;   ///< Version the time constants were computed for
+    unsigned int        m_sampleRate;    ///< Sample rate of the current stream
+    float               m_attackFactor;  ///< Share of the envelope kept per frame when rising
+    float               m_releaseFactor; ///< Share of the envelope kept per frame when falling
+    float               m_envelope;      ///< Peak level followed across blocks
+    float               m_gain;          ///< Gain applied to the last frame
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_AUDIONODES_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::GainNode
+/// \ingroup audio
+///
+/// \see cpp3ds::AudioBus
+///
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::BiquadNode
+/// \ingroup audio
+///
+/// The coefficients follow Robert Bristow-Johnson's audio EQ
+/// cookbook. They are computed again in the streaming thread
+/// at the block following a change.
+///
+/// \see cpp3ds::AudioBus
+///
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::DelayNode
+/// \ingroup audio
+///
+/// The lines are allocated when a stream starts, for the
+/// maximum delay given to the constructor rounded up to a
+/// power of two: one second of stereo 32728 Hz takes 512 KB.
+///
+/// \see cpp3ds::AudioBus
+///
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::CompressorNode
+/// \ingroup audio
+///
+/// The level is the peak of both channels, so that a stereo
+/// image doesn't move when one side is turned down. The gain
+/// is computed every 16 frames and interpolated in between.
+///
+/// \see cpp3ds::AudioBus
+///
+////////////////////////////////////////////////////////////
@@ -30,8 +30,12 @@
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Audio/SoundStream.hpp>
 #include <cpp3ds/Audio/InputSoundFile.hpp>
+#include <cpp3ds/Audio/SoundRingBuffer.hpp>
 #include <cpp3ds/System/Mutex.hpp>
+#include <cpp3ds/System/Semaphore.hpp>
+#include <cpp3ds/System/Thread.hpp>
 #include <cpp3ds/System/Time.hpp>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -128,6 +132,31 @@ public:
     ////////////////////////////////////////////////////////////
     Time getDuration() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set how much of the music is decoded ahead of playback
+    ///
+    /// The music is decoded on its own thread into a buffer of
+    /// this duration, so that slow file reads and seeks don't
+    /// starve the stream. The new duration is used the next time
+    /// a music is opened. The default is one second.
+    ///
+    /// \param duration Duration of the samples decoded in advance
+    ///
+    /// \see getDecodeAhead
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDecodeAhead(Time duration);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get how much of the music is decoded ahead of playback
+    ///
+    /// \return Duration of the samples decoded in advance
+    ///
+    /// \see setDecodeAhead
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getDecodeAhead() const;
+
 protected:
 
     ////////////////////////////////////////////////////////////
@@ -159,13 +188,49 @@ private:
     ////////////////////////////////////////////////////////////
     void initialize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called as the entry point of the decoder thread
+    ///
+    ////////////////////////////////////////////////////////////
+    void decodeAhead();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the decoder thread and wait for it to finish
+    ///
+    ////////////////////////////////////////////////////////////
+    void stopDecoding();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode up to a chunk of samples into the ring buffer
+    ///
+    /// When the music loops, decoding carries on from the
+    /// beginning of the file once its end is reached.
+    /// The mutex must be locked by the caller, which makes it
+    /// the only producer of the ring.
+    ///
+    /// \return True if samples were decoded or the file started over
+    ///
+    ////////////////////////////////////////////////////////////
+    bool decode();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    InputSoundFile     m_file;     ///< The streamed music file
-    Time               m_duration; ///< Music duration
-    std::vector<Int16> m_samples;  ///< Temporary buffer of samples
-    Mutex              m_mutex;    ///< Mutex protecting the data
+    InputSoundFile           m_file;        ///< The streamed music file
+    Time                     m_duration;    ///< Music duration
+    std::vector<Int16>       m_samples;     ///< Temporary buffer of samples
+    Mutex                    m_mutex;       ///< Mutex protecting the file and the decoding
+    Thread                   m_decoder;     ///< Thread decoding ahead of the stream
+    Semaphore                m_wake;        ///< Posted when the ring has room again, or the decoder must seek or stop
+    Time                     m_decodeAhead; ///< Duration of the samples decoded in advance
+    SoundRingBuffer          m_ring;        ///< Samples decoded in advance, taken by the stream without locking
+    std::vector<Int16>       m_decoded;     ///< Samples being decoded, before they are pushed
+    std::size_t              m_pushed;      ///< Number of samples pushed since the last seek
+    std::size_t              m_popped;      ///< Number of samples streamed since the last seek
+    std::atomic<std::size_t> m_endMark;     ///< Value of m_pushed where the file starts over, or -1
+    Uint64                   m_offset;      ///< Offset in the file of the next sample to stream
+    bool                     m_decoding;    ///< Whether the decoder thread must keep running
+    std::atomic<bool>        m_decodedAll;  ///< Whether the end of the file was decoded, without starting over
 };
 
 } // namespace cpp3ds
@@ -194,6 +259,10 @@ private:
 /// leave the music alone after calling play(), it will manage itself
 /// very well.
 ///
+/// A second thread decodes the file ahead of playback (see
+/// setDecodeAhead), and carries on from its beginning when the
+/// music loops, so that starting over doesn't wait for the file.
+///
 /// Usage example:
 /// \code
 /// // Declare a new music
@@ -82,14 +82,18 @@ public:
     ////////////////////////////////////////////////////////////
     void write(const Int16* samples, Uint64 count);
 
-private:
-
     ////////////////////////////////////////////////////////////
     /// \brief Close the current file
     ///
+    /// The file is finalized (headers, last encoded pages) and
+    /// can be read right after. Closing a file that isn't open
+    /// does nothing.
+    ///
     ////////////////////////////////////////////////////////////
     void close();
 
+private:
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
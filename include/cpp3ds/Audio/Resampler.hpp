@@ -0,0 +1,192 @@
+#ifndef CPP3DS_RESAMPLER_HPP
+#define CPP3DS_RESAMPLER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cstddef>
+#include <vector>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Converts audio samples from one sample rate to another
+///
+////////////////////////////////////////////////////////////
+class Resampler
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Trade-off between speed and fidelity
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Quality
+    {
+        Fast,   ///< 8 taps per output sample, aliasing is audible on bright sounds
+        Medium, ///< 16 taps per output sample
+        Best    ///< 32 taps per output sample, for offline conversions
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The resampler copies its input until setRates() is called.
+    ///
+    ////////////////////////////////////////////////////////////
+    Resampler();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct a resampler between two rates
+    ///
+    /// \param inputRate    Sample rate of the input
+    /// \param outputRate   Sample rate of the output
+    /// \param channelCount Number of interleaved channels
+    /// \param quality      Trade-off between speed and fidelity
+    ///
+    ////////////////////////////////////////////////////////////
+    Resampler(unsigned int inputRate, unsigned int outputRate, unsigned int channelCount, Quality quality = Medium);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the rates of the conversion
+    ///
+    /// This designs the filter, which takes a while for odd
+    /// ratios, and forgets the samples given so far.
+    ///
+    /// \param inputRate    Sample rate of the input
+    /// \param outputRate   Sample rate of the output
+    /// \param channelCount Number of interleaved channels
+    /// \param quality      Trade-off between speed and fidelity
+    ///
+    ////////////////////////////////////////////////////////////
+    void setRates(unsigned int inputRate, unsigned int outputRate, unsigned int channelCount, Quality quality = Medium);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forget the samples given so far
+    ///
+    /// Call it before converting a sound unrelated to the
+    /// previous one, after a seek for instance.
+    ///
+    ////////////////////////////////////////////////////////////
+    void reset();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert the next samples of a sound
+    ///
+    /// The sound can be given in pieces of any size: the
+    /// output is the same as if it was given at once. The
+    /// last few input samples are kept until the next call,
+    /// or until flush().
+    ///
+    /// \param samples     Interleaved input samples
+    /// \param sampleCount Number of input samples, a multiple of the channel count
+    /// \param output      Vector to append the output samples to
+    ///
+    ////////////////////////////////////////////////////////////
+    void process(const Int16* samples, std::size_t sampleCount, std::vector<Int16>& output);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert the samples kept for the next call
+    ///
+    /// Call it at the end of a sound. The output then lasts as
+    /// long as the input, and the resampler is reset.
+    ///
+    /// \param output Vector to append the output samples to
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush(std::vector<Int16>& output);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the sample rate of the input
+    ///
+    /// \return Input sample rate
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getInputRate() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the sample rate of the output
+    ///
+    /// \return Output sample rate
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getOutputRate() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert a whole sound at once
+    ///
+    /// \param samples      Interleaved input samples
+    /// \param sampleCount  Number of input samples
+    /// \param channelCount Number of interleaved channels
+    /// \param inputRate    Sample rate of the input
+    /// \param outputRate   Sample rate of the output
+    /// \param output       Vector to fill with the output samples
+    /// \param quality      Trade-off between speed and fidelity
+    ///
+    ////////////////////////////////////////////////////////////
+    static void resample(const Int16* samples, Uint64 sampleCount, unsigned int channelCount,
+                         unsigned int inputRate, unsigned int outputRate, std::vector<Int16>& output, Quality quality = Medium);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the coefficients of the filter
+    ///
+    ////////////////////////////////////////////////////////////
+    void design();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int                     m_inputRate;    ///< Sample rate of the input
+    unsigned int                     m_outputRate;   ///< Sample rate of the output
+    unsigned int                     m_channelCount; ///< Number of interleaved channels
+    Quality                          m_quality;      ///< Trade-off between speed and fidelity
+    unsigned int                     m_up;           ///< Output rate over their greatest common divisor
+    unsigned int                     m_down;         ///< Input rate over their greatest common divisor
+    unsigned int                     m_phaseCount;   ///< Number of filters, one per fraction of input sample
+    unsigned int                     m_tapCount;     ///< Number of coefficients of each filter, even
+    std::vector<Int16>               m_filters;      ///< Coefficients of the filters, 1.15 fixed point
+    std::vector<std::vector<Int16> > m_history;      ///< Input samples still needed, per channel
+    std::size_t                      m_position;     ///< Index in the history of the first tap of the next output
+    unsigned int                     m_phase;        ///< Fraction of input sample of the next output, in 1 / m_up
+    Uint64                           m_inputFrames;  ///< Number of input frames since the last reset
+    Uint64                           m_outputFrames; ///< Number of output frames since the last reset
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_RESAMPLER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::Resampler
+/// \ingroup audio
+///
+/// Sounds recorded at different rates can be played as they
+/// are, each DSP channel has its own rate, but they can't be
+/// mixed together in software, and streams end up at whatever
+/// rate their files have. A Resampler converts them to a
+/// common rate, either once when loading (see
+/// cpp3ds::SoundBuffer::loadFromSamples) or while streaming (see
+/// cpp3ds::SoundStream::setOutputSampleRate).
+///
+/// It is a polyphase windowed-sinc filter in fixed point: each
+/// output sample is the dot product of a few input samples
+/// with one of a bank of precomputed filters, which the ARM11
+/// computes two taps per instruction. Ratios of small integers
+/// (22050 to 44100, 48000 to 32000...) are converted exactly;
+/// others use the closest of 256 fractional positions.
+///
+/// \code
+/// // Normalize a 22050 Hz stereo sound to 32000 Hz
+/// std::vector<cpp3ds::Int16> output;
+/// cpp3ds::Resampler::resample(samples, sampleCount, 2, 22050, 32000, output);
+/// \endcode
+///
+/// \see cpp3ds::SoundBuffer, cpp3ds::SoundStream
+///
+////////////////////////////////////////////////////////////
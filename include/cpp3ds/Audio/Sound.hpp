@@ -146,7 +146,10 @@ public :
     /// \brief Change the current playing position of the sound
     ///
     /// The playing position can be changed when the sound is
-    /// either paused or playing.
+    /// either paused or playing. A buffer played as DSP-ADPCM
+    /// starts at the frame holding the offset, up to 14 samples
+    /// earlier; the decoder state there is looked up in a table
+    /// built when the buffer is loaded.
     ///
     /// \param timeOffset New playing position, from the beginning of the sound
     ///
@@ -173,6 +176,12 @@ public :
     ////////////////////////////////////////////////////////////
     bool getLoop() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the buffer is played as DSP-ADPCM
+    ///
+    /// setBuffer sets it for buffers kept compressed.
+    ///
+    ////////////////////////////////////////////////////////////
 	bool getStateADPCM() const;
 
 	void setStateADPCM(bool enable);
@@ -224,6 +233,9 @@ private :
     const SoundBuffer* m_buffer; ///< Sound buffer bound to the source
 	bool m_loop;
 	bool m_isADPCM;
+#ifndef EMULATION
+	ndspAdpcmData m_adpcmData; ///< Decoder state at the playing offset
+#endif
 };
 
 } // namespace cpp3ds
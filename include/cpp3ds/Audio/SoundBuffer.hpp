@@ -32,7 +32,9 @@
 #include <cpp3ds/System/LinearAllocator.hpp>
 #endif
 #include <cpp3ds/Audio/AlResource.hpp>
+#include <cpp3ds/Audio/Resampler.hpp>
 #include <cpp3ds/System/Time.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 #include <set>
@@ -76,7 +78,9 @@ public:
     /// \brief Load the sound buffer from a file
     ///
     /// See the documentation of cpp3ds::InputSoundFile for the list
-    /// of supported formats.
+    /// of supported formats. On the 3DS, mono DSP-ADPCM files
+    /// (made by scripts/adpcm_compile.py) stay compressed and are
+    /// decoded by the DSP as they play.
     ///
     /// \param filename Path of the sound file to load
     ///
@@ -136,6 +140,43 @@ public:
     ////////////////////////////////////////////////////////////
     bool loadFromSamples(const Int16* samples, Uint64 sampleCount, unsigned int channelCount, unsigned int sampleRate);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the sound buffer from an array of audio samples,
+    ///        converted to another sample rate
+    ///
+    /// Use it to bring sounds recorded at various rates to the
+    /// one they are mixed at (see cpp3ds::VoiceManager).
+    ///
+    /// \param samples      Pointer to the array of samples in memory
+    /// \param sampleCount  Number of samples in the array
+    /// \param channelCount Number of channels (1 = mono, 2 = stereo, ...)
+    /// \param sampleRate   Sample rate of the array
+    /// \param outputRate   Sample rate of the buffer
+    /// \param quality      Trade-off between speed and fidelity of the conversion
+    ///
+    /// \return True if loading succeeded, false if it failed
+    ///
+    /// \see resample
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromSamples(const Int16* samples, Uint64 sampleCount, unsigned int channelCount, unsigned int sampleRate,
+                         unsigned int outputRate, Resampler::Quality quality = Resampler::Medium);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert the samples of the buffer to another sample rate
+    ///
+    /// Buffers kept compressed as DSP-ADPCM can't be converted.
+    ///
+    /// \param sampleRate New sample rate
+    /// \param quality    Trade-off between speed and fidelity of the conversion
+    ///
+    /// \return True if the conversion succeeded, false if it failed
+    ///
+    /// \see loadFromSamples
+    ///
+    ////////////////////////////////////////////////////////////
+    bool resample(unsigned int sampleRate, Resampler::Quality quality = Resampler::Medium);
+
     ////////////////////////////////////////////////////////////
     /// \brief Save the sound buffer to an audio file
     ///
@@ -158,6 +199,9 @@ public:
     /// (cpp3ds::Int16). The total number of samples in this array
     /// is given by the getSampleCount() function.
     ///
+    /// Buffers kept compressed as DSP-ADPCM have no samples to
+    /// give, this returns NULL for them.
+    ///
     /// \return Read-only pointer to the array of sound samples
     ///
     /// \see getSampleCount
@@ -229,6 +273,41 @@ private:
 
     friend class Sound;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Samples of a sound, never modified once loaded
+    ///
+    /// Copies of a buffer share them, and so do buffers loaded
+    /// from the same file while one of them is alive.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Storage
+    {
+#ifdef EMULATION
+        std::vector<Int16>                         samples;               ///< Samples buffer
+#else
+        std::vector<Int16, LinearAllocator<Int16>> samples;               ///< Samples buffer
+        std::vector<Uint8, LinearAllocator<Uint8>> adpcm;                 ///< DSP-ADPCM frames, instead of the samples of compressed buffers
+        Int16                                      adpcmCoefficients[16]; ///< Predictor coefficients of the frames
+        Uint16                                     adpcmPredictorScale;   ///< Header of the first frame
+        std::vector<Int16>                         adpcmHistory;          ///< Two samples before each frame, to start playing at any of them
+        Uint64                                     adpcmSampleCount;      ///< Number of samples held by the frames
+#endif
+        unsigned int                               channelCount;          ///< Number of channels
+        unsigned int                               sampleRate;            ///< Samples per second
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////
+    typedef std::set<Sound*> SoundList;                ///< Set of unique sound instances
+    typedef std::shared_ptr<const Storage> StoragePtr; ///< Shared samples
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Samples of the files loaded by living buffers
+    ///
+    ////////////////////////////////////////////////////////////
+    struct FileCache;
+
     ////////////////////////////////////////////////////////////
     /// \brief Initialize the internal state after loading a new sound
     ///
@@ -240,15 +319,56 @@ private:
     bool initialize(InputSoundFile& file);
 
     ////////////////////////////////////////////////////////////
-    /// \brief Update the internal buffer with the cached audio samples
+    /// \brief Replace the samples of the buffer
+    ///
+    /// \param storage New samples, left unused if invalid
+    ///
+    /// \return True on success, false if any error happened
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const StoragePtr& storage);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the samples of a file loaded by a living buffer
+    ///
+    /// \param filename Path the file was loaded from
+    ///
+    /// \return Samples of the file, NULL if it isn't loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    static StoragePtr findCachedFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the cache shared by all buffers
+    ///
+    /// \return The cache, created on first use
+    ///
+    ////////////////////////////////////////////////////////////
+    static FileCache& getFileCache();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remember the samples loaded from a file
+    ///
+    /// The cache doesn't keep the samples alive, they are freed
+    /// with the last buffer using them.
+    ///
+    /// \param filename Path the file was loaded from
+    /// \param storage  Samples of the file
     ///
-    /// \param channelCount Number of channels
-    /// \param sampleRate   Sample rate (number of samples per second)
+    ////////////////////////////////////////////////////////////
+    static void cacheFile(const std::string& filename, const StoragePtr& storage);
+
+#ifndef EMULATION
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a DSP-ADPCM file, keeping mono ones compressed
+    ///
+    /// \param stream Stream positioned after the magic number
     ///
     /// \return True on success, false if any error happened
     ///
     ////////////////////////////////////////////////////////////
-    bool update(unsigned int channelCount, unsigned int sampleRate);
+    bool loadAdpcm(InputStream& stream);
+#endif
 
     ////////////////////////////////////////////////////////////
     /// \brief Add a sound to the list of sounds that use this buffer
@@ -266,24 +386,14 @@ private:
     ////////////////////////////////////////////////////////////
     void detachSound(Sound* sound) const;
 
-    ////////////////////////////////////////////////////////////
-    // Types
-    ////////////////////////////////////////////////////////////
-    typedef std::set<Sound*> SoundList; ///< Set of unique sound instances
-
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
     Time               m_duration; ///< Sound duration
     mutable SoundList  m_sounds;   ///< List of sounds that are using this buffer
-
-	unsigned int m_sampleRate;
-	unsigned int m_channelCount;
+    StoragePtr         m_storage;  ///< Samples, NULL until loaded
 	#ifdef EMULATION
 	unsigned int       m_buffer;   ///< OpenAL buffer identifier
-    std::vector<Int16> m_samples;  ///< Samples buffer
-	#else
-	std::vector<Int16, LinearAllocator<Int16>> m_samples;
 	#endif
 };
 
@@ -329,6 +439,11 @@ private:
 /// used by a cpp3ds::Sound (i.e. never write a function that
 /// uses a local cpp3ds::SoundBuffer instance for loading a sound).
 ///
+/// Samples are never modified once loaded, so copies of a sound
+/// buffer share them instead of duplicating them, and buffers
+/// loaded from the same file with loadFromFile() share a single
+/// decoded copy for as long as one of them is alive.
+///
 /// Usage example:
 /// \code
 /// // Declare a new sound buffer
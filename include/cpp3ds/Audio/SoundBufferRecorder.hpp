@@ -110,6 +110,10 @@ private :
 /// and adds a function to retrieve the recorded sound buffer
 /// (getBuffer()).
 ///
+/// The whole capture is kept in memory until it ends: to record
+/// long sessions, stream them to a file with
+/// cpp3ds::SoundFileRecorder instead.
+///
 /// As usual, don't forget to call the isAvailable() function
 /// before using this class (see cpp3ds::SoundRecorder for more details
 /// about this).
@@ -132,6 +136,6 @@ private :
 /// }
 /// \endcode
 ///
-/// \see cpp3ds::SoundRecorder
+/// \see cpp3ds::SoundRecorder, cpp3ds::SoundFileRecorder
 ///
 ////////////////////////////////////////////////////////////
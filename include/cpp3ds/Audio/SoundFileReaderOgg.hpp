@@ -29,6 +29,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Audio/SoundFileReader.hpp>
+#include <vector>
 #ifdef _3DS
 #include <tremor/ivorbisfile.h>
 #else
@@ -89,6 +90,10 @@ public:
     /// If the given offset exceeds to total number of samples,
     /// this function must jump to the end of the file.
     ///
+    /// Short jumps forward are decoded through. Others start from
+    /// the closest page recorded while reading, and only bisect
+    /// the file when no page before the offset is known yet.
+    ///
     /// \param sampleOffset Index of the sample to jump to, relative to the beginning
     ///
     ////////////////////////////////////////////////////////////
@@ -113,11 +118,42 @@ private:
     ////////////////////////////////////////////////////////////
     void close();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Jump to the closest recorded page before a frame
+    ///
+    /// \param frame Index of the frame to jump before
+    ///
+    /// \return True if a page was found and the file jumped to it
+    ///
+    ////////////////////////////////////////////////////////////
+    bool seekToIndex(ogg_int64_t frame);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode and drop frames
+    ///
+    /// \param frameCount Number of frames to skip
+    ///
+    ////////////////////////////////////////////////////////////
+    void skip(ogg_int64_t frameCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Page reached while reading, for the seek index
+    ///
+    ////////////////////////////////////////////////////////////
+    struct SeekPoint
+    {
+        ogg_int64_t frame;  ///< First frame decoded after jumping to the page
+        ogg_int64_t offset; ///< Offset of the page in the file, or -1 if not reached yet
+    };
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    OggVorbis_File m_vorbis;       // ogg/vorbis file handle
-    unsigned int   m_channelCount; // number of channels of the open sound file
+    OggVorbis_File         m_vorbis;       // ogg/vorbis file handle
+    unsigned int           m_channelCount; // number of channels of the open sound file
+    ogg_int64_t            m_frameCount;   // number of frames of the open sound file
+    ogg_int64_t            m_seekInterval; // number of frames between two seek points
+    std::vector<SeekPoint> m_seekPoints;   // one page per interval, filled lazily while reading
 };
 
 } // namespace priv
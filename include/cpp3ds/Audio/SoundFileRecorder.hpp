@@ -0,0 +1,258 @@
+#ifndef CPP3DS_SOUNDFILERECORDER_HPP
+#define CPP3DS_SOUNDFILERECORDER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/OutputSoundFile.hpp>
+#include <cpp3ds/Audio/SoundRecorder.hpp>
+#include <cpp3ds/Audio/SoundWriteQueue.hpp>
+#include <cpp3ds/System/Time.hpp>
+#include <atomic>
+#include <string>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Specialized SoundRecorder which streams the captured
+///        audio data to a sound file
+///
+////////////////////////////////////////////////////////////
+class SoundFileRecorder : public SoundRecorder
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    SoundFileRecorder();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~SoundFileRecorder();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the file to record to
+    ///
+    /// The format of the file is deduced from its extension:
+    /// WAV, or Ogg Vorbis in the emulator, as the console has no
+    /// Vorbis encoder. The file is created, or overwritten, when
+    /// the capture starts.
+    ///
+    /// \param filename Path of the sound file to write
+    ///
+    /// \see getFile
+    ///
+    ////////////////////////////////////////////////////////////
+    void setFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the file to record to
+    ///
+    /// \return Path of the sound file
+    ///
+    /// \see setFile
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::string& getFile() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set how often the microphone is read
+    ///
+    /// The captured samples are taken from the microphone at
+    /// this interval and queued for the encoder. A short
+    /// latency wakes the capture thread more often, but keeps
+    /// it from ever lagging behind the microphone. The default
+    /// is 20 ms. The new latency is used the next time the
+    /// capture starts.
+    ///
+    /// \param latency Time between two reads of the microphone
+    ///
+    /// \see getLatency
+    ///
+    ////////////////////////////////////////////////////////////
+    void setLatency(Time latency);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get how often the microphone is read
+    ///
+    /// \return Time between two reads of the microphone
+    ///
+    /// \see setLatency
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getLatency() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set how much audio may wait for the encoder
+    ///
+    /// The captured samples are queued in a buffer of this
+    /// duration, allocated when the capture starts, while the
+    /// encoder thread writes them to the file. If the file
+    /// can't keep up for longer than that, for example on a
+    /// slow SD card, the samples that don't fit are dropped
+    /// and counted. The default is 2 seconds.
+    ///
+    /// \param duration Duration of the samples that can be queued
+    ///
+    /// \see getBufferDuration, getDroppedSampleCount
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBufferDuration(Time duration);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get how much audio may wait for the encoder
+    ///
+    /// \return Duration of the samples that can be queued
+    ///
+    /// \see setBufferDuration
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getBufferDuration() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of samples written to the file
+    ///
+    /// This can be called from any thread, during the capture
+    /// or after it.
+    ///
+    /// \return Number of samples written since the capture started
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint64 getSampleCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of samples lost because the
+    ///        encoder was too far behind
+    ///
+    /// This can be called from any thread, during the capture
+    /// or after it. Anything but zero means that the buffer
+    /// duration is too short for the file being written.
+    ///
+    /// \return Number of samples dropped since the capture started
+    ///
+    /// \see setBufferDuration
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint64 getDroppedSampleCount() const;
+
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start capturing audio data
+    ///
+    /// \return True to start the capture, or false to abort it
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool onStart();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Process a new chunk of recorded samples
+    ///
+    /// \param samples     Pointer to the new chunk of recorded samples
+    /// \param sampleCount Number of samples pointed by \a samples
+    ///
+    /// \return True to continue the capture, or false to stop it
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool onProcessSamples(const Int16* samples, std::size_t sampleCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop capturing audio data
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onStop();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open the file and start the encoder thread
+    ///
+    /// onStart() calls this with the rate of the capture. The
+    /// queue is sized from \a sampleRate, the latency and the
+    /// buffer duration.
+    ///
+    /// \param sampleRate Sample rate of the samples to write
+    ///
+    /// \return True if the file was opened
+    ///
+    ////////////////////////////////////////////////////////////
+    bool startEncoding(unsigned int sampleRate);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write captured samples to the file
+    ///
+    /// This function is called by the encoder thread, with the
+    /// samples taken out of the queue.
+    ///
+    /// \param samples Pointer to the samples to write
+    /// \param count   Number of samples to write
+    ///
+    ////////////////////////////////////////////////////////////
+    void writeSamples(const Int16* samples, std::size_t count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the encoder thread and close the file
+    ///
+    ////////////////////////////////////////////////////////////
+    void stopEncoding();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::string           m_filename;       ///< Path of the file to record to
+    OutputSoundFile       m_file;           ///< File the samples are streamed to
+    priv::SoundWriteQueue m_queue;          ///< Captured samples waiting for the encoder, and the thread writing them
+    Time                  m_latency;        ///< Time between two reads of the microphone
+    Time                  m_bufferDuration; ///< Duration of the samples that can be queued
+    std::atomic<Uint64>   m_written;        ///< Number of samples written to the file
+    std::atomic<Uint64>   m_dropped;        ///< Number of samples that didn't fit in the queue
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_SOUNDFILERECORDER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::SoundFileRecorder
+/// \ingroup audio
+///
+/// Unlike cpp3ds::SoundBufferRecorder, which keeps the whole
+/// capture in memory, cpp3ds::SoundFileRecorder writes it to
+/// a WAV file (or Ogg Vorbis, in the emulator) while recording,
+/// so a capture can last as long as the SD card has room for it.
+///
+/// Its memory use is bounded: the capture thread copies the
+/// microphone samples into a ring buffer allocated when the
+/// capture starts, and an encoder thread takes them out and
+/// writes them to the file. The capture thread never waits on
+/// the file, so the microphone is read on time even while the
+/// Vorbis encoder or the SD card stalls; if the ring fills up
+/// anyway, the samples that don't fit are counted by
+/// getDroppedSampleCount().
+///
+/// Usage example:
+/// \code
+/// if (cpp3ds::SoundFileRecorder::isAvailable())
+/// {
+///     cpp3ds::SoundFileRecorder recorder;
+///     recorder.setFile("sdmc:/voice.wav");
+///     recorder.setLatency(cpp3ds::milliseconds(10));
+///     recorder.start(cpp3ds::SampleRate_16360);
+///     ...
+///     recorder.stop();
+///
+///     if (recorder.getDroppedSampleCount() > 0)
+///         std::cout << "The card was too slow, try a longer buffer" << std::endl;
+/// }
+/// \endcode
+///
+/// \see cpp3ds::SoundRecorder, cpp3ds::SoundBufferRecorder
+///
+////////////////////////////////////////////////////////////
@@ -29,8 +29,10 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Audio/SoundFileWriter.hpp>
+#include <cpp3ds/Audio/SoundWriteQueue.hpp>
 #include <vorbis/vorbisenc.h>
 #include <fstream>
+#include <vector>
 
 
 namespace cpp3ds
@@ -45,6 +47,11 @@ class SoundFileWriterOgg : public SoundFileWriter
 {
 public:
 
+    enum
+    {
+        BufferSize = 64 * 1024 ///< Bytes written to the file at once, a multiple of the SD card clusters
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Check if this writer can handle a file on disk
     ///
@@ -84,6 +91,11 @@ public:
     ////////////////////////////////////////////////////////////
     /// \brief Write audio samples to the open file
     ///
+    /// The samples are queued for the encoder thread, so this
+    /// returns right away unless a second of samples is still
+    /// waiting to be encoded. Samples must be written in whole
+    /// frames.
+    ///
     /// \param samples Pointer to the sample array to write
     /// \param count   Number of samples to write
     ///
@@ -92,12 +104,43 @@ public:
 
 private:
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Submit samples to the vorbis encoder
+    ///
+    /// This function is called by the encoder thread, with the
+    /// samples taken out of the queue.
+    ///
+    /// \param samples Pointer to the sample array to encode
+    /// \param count   Number of samples, whole frames only
+    ///
+    ////////////////////////////////////////////////////////////
+    void encodeSamples(const Int16* samples, std::size_t count);
+
     ////////////////////////////////////////////////////////////
     /// \brief Flush blocks produced by the ogg stream, if any
     ///
     ////////////////////////////////////////////////////////////
     void flushBlocks();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Append a page of the ogg stream to the output buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    void writePage(const ogg_page& page);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Append bytes to the output buffer, writing it to
+    ///        the file each time it is full
+    ///
+    ////////////////////////////////////////////////////////////
+    void writeBytes(const unsigned char* bytes, std::size_t count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the buffered bytes to the file
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush();
+
     ////////////////////////////////////////////////////////////
     /// \brief Close the file
     ///
@@ -107,11 +150,14 @@ private:
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    unsigned int     m_channelCount; // channel count of the sound being written
-    std::ofstream    m_file;         // output file
-    ogg_stream_state m_ogg;          // ogg stream
-    vorbis_info      m_vorbis;       // vorbis handle
-    vorbis_dsp_state m_state;        // current encoding state
+    unsigned int       m_channelCount; // channel count of the sound being written
+    std::ofstream      m_file;         // output file
+    ogg_stream_state   m_ogg;          // ogg stream
+    vorbis_info        m_vorbis;       // vorbis handle
+    vorbis_dsp_state   m_state;        // current encoding state
+    SoundWriteQueue    m_queue;        // samples written but not encoded yet, and the thread encoding them
+    std::vector<char>  m_buffer;       // encoded bytes waiting to be written, BufferSize of them at most
+    std::size_t        m_bufferCount;  // number of bytes in the buffer
 };
 
 } // namespace priv
@@ -31,6 +31,7 @@
 #include <cpp3ds/Audio/SoundFileWriter.hpp>
 #include <fstream>
 #include <string>
+#include <vector>
 
 
 namespace cpp3ds
@@ -45,6 +46,11 @@ class SoundFileWriterWav : public SoundFileWriter
 {
 public:
 
+    enum
+    {
+        BufferSize = 64 * 1024 ///< Bytes written to the file at once, a multiple of the SD card clusters
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Check if this writer can handle a file on disk
     ///
@@ -103,6 +109,15 @@ private:
     ////////////////////////////////////////////////////////////
     bool writeHeader(unsigned int sampleRate, unsigned int channelCount);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the buffered bytes to the file
+    ///
+    /// Only the last flush of a file is smaller than BufferSize,
+    /// so that every write starts at an aligned offset.
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush();
+
     ////////////////////////////////////////////////////////////
     /// \brief Close the file
     ///
@@ -112,9 +127,11 @@ private:
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    std::ofstream m_file;         ///< File stream to write to
-    Uint64        m_sampleCount;  ///< Total number of samples written to the file
-    unsigned int  m_channelCount; ///< Number of channels of the sound
+    std::ofstream     m_file;         ///< File stream to write to
+    std::vector<char> m_buffer;       ///< Bytes waiting to be written, BufferSize of them at most
+    std::size_t       m_bufferCount;  ///< Number of bytes in the buffer
+    Uint64            m_sampleCount;  ///< Total number of samples written to the file
+    unsigned int      m_channelCount; ///< Number of channels of the sound
 };
 
 } // namespace priv
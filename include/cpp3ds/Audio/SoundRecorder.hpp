@@ -258,6 +258,17 @@ private :
     ////////////////////////////////////////////////////////////
     void processCapturedSamples();
 
+#ifndef EMULATION
+    ////////////////////////////////////////////////////////////
+    /// \brief Forward the samples of the microphone buffer from
+    ///        the current position to \a endOffset
+    ///
+    /// \param endOffset Offset in bytes of the end of the samples
+    ///
+    ////////////////////////////////////////////////////////////
+    void forwardCapturedSamples(u32 endOffset);
+#endif
+
     ////////////////////////////////////////////////////////////
     /// \brief Clean up the recorder's internal resources
     ///
@@ -300,7 +311,8 @@ private :
 /// about capturing sound samples, the task of making something
 /// useful with them is left to the derived class. Note that
 /// cpp3ds provides a built-in specialization for saving the
-/// captured data to a sound buffer (see cpp3ds::SoundBufferRecorder).
+/// captured data to a sound buffer (see cpp3ds::SoundBufferRecorder)
+/// and for streaming it to a file (see cpp3ds::SoundFileRecorder).
 ///
 /// A derived class has only one virtual function to override:
 /// \li onProcessSamples provides the new chunks of audio samples while the capture happens
@@ -378,6 +390,6 @@ private :
 /// }
 /// \endcode
 ///
-/// \see cpp3ds::SoundBufferRecorder
+/// \see cpp3ds::SoundBufferRecorder, cpp3ds::SoundFileRecorder
 ///
 ////////////////////////////////////////////////////////////
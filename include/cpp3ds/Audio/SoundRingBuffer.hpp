@@ -0,0 +1,205 @@
+#ifndef CPP3DS_SOUNDRINGBUFFER_HPP
+#define CPP3DS_SOUNDRINGBUFFER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Lock-free queue of audio samples between a producer
+///        thread and a consumer thread
+///
+////////////////////////////////////////////////////////////
+class SoundRingBuffer : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The ring can't hold any sample until setCapacity() is called.
+    ///
+    ////////////////////////////////////////////////////////////
+    SoundRingBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct a ring holding at least \a capacity samples
+    ///
+    /// \param capacity Minimum number of samples
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit SoundRingBuffer(std::size_t capacity);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the number of samples the ring can hold
+    ///
+    /// The capacity is rounded up to a power of two, and the
+    /// samples in the ring are dropped. Neither thread may use
+    /// the ring meanwhile.
+    ///
+    /// \param capacity Minimum number of samples
+    ///
+    ////////////////////////////////////////////////////////////
+    void setCapacity(std::size_t capacity);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of samples the ring can hold
+    ///
+    /// \return Capacity, in samples
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCapacity() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Append samples to the ring
+    ///
+    /// Only the producer thread may call this function. It
+    /// never blocks: the samples that don't fit are left out.
+    /// Multichannel samples must be pushed in whole frames,
+    /// which keeps the free space a multiple of the frame size
+    /// with mono and stereo.
+    ///
+    /// \param samples Samples to append
+    /// \param count   Number of samples to append
+    ///
+    /// \return Number of samples actually appended
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t push(const Int16* samples, std::size_t count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Take the oldest samples out of the ring
+    ///
+    /// Only the consumer thread may call this function. It
+    /// never blocks, and returns fewer samples than asked for
+    /// when the producer is behind.
+    ///
+    /// \param samples  Array to fill
+    /// \param maxCount Maximum number of samples to take
+    ///
+    /// \return Number of samples actually taken
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t pop(Int16* samples, std::size_t maxCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Drop the oldest samples of the ring
+    ///
+    /// Only the consumer thread may call this function.
+    ///
+    /// \param maxCount Maximum number of samples to drop
+    ///
+    /// \return Number of samples actually dropped
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t skip(std::size_t maxCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Drop all the samples of the ring
+    ///
+    /// Only the consumer thread may call this function. Samples
+    /// pushed meanwhile may be kept.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of samples waiting in the ring
+    ///
+    /// From the consumer thread, this is how many samples can
+    /// be taken at least.
+    ///
+    /// \return Number of samples in the ring
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of samples that can be pushed
+    ///
+    /// From the producer thread, this is how many samples can
+    /// be pushed at least.
+    ///
+    /// \return Free space in the ring, in samples
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getFreeCount() const;
+
+private :
+
+    enum
+    {
+        CacheLineSize = 64 ///< Larger than the cache lines of the 3DS and of most PCs
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Int16>       m_samples;                   ///< Storage of the ring, a power of two long
+    std::size_t              m_mask;                      ///< Size of the storage minus one
+    char                     m_padding0[CacheLineSize];   ///< Keeps the producer's line apart from the storage
+    std::atomic<std::size_t> m_write;                     ///< Number of samples ever pushed, written by the producer
+    std::size_t              m_readCache;                 ///< Last value of m_read seen by the producer
+    char                     m_padding1[CacheLineSize];   ///< Keeps the two threads' indices on separate cache lines
+    std::atomic<std::size_t> m_read;                      ///< Number of samples ever taken, written by the consumer
+    std::size_t              m_writeCache;                ///< Last value of m_write seen by the consumer
+    char                     m_padding2[CacheLineSize];   ///< Keeps the consumer's line apart from what follows
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_SOUNDRINGBUFFER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::SoundRingBuffer
+/// \ingroup audio
+///
+/// A SoundRingBuffer hands samples from one thread to another
+/// without any lock: push() and pop() only copy samples and
+/// update an atomic index, so a decoder, a synthesizer or a
+/// network receiver can feed a cpp3ds::SoundStream without
+/// ever making the stream thread wait. Exactly one thread may
+/// push and exactly one thread may pop at any time.
+///
+/// Both functions copy as many samples as fit in one call, and
+/// each thread keeps to its own cache line, so the ring costs
+/// little more than the copies themselves.
+///
+/// \code
+/// class VoiceChat : public cpp3ds::SoundStream
+/// {
+/// public:
+///     VoiceChat() : m_ring(22050), m_samples(1024) {initialize(1, 22050);}
+///
+///     // Called by the network thread
+///     void receive(const cpp3ds::Int16* samples, std::size_t count) {m_ring.push(samples, count);}
+///
+/// private:
+///     virtual bool onGetData(Chunk& data)
+///     {
+///         // Nothing received yet is fine, the stream asks again later
+///         data.samples     = &m_samples[0];
+///         data.sampleCount = m_ring.pop(&m_samples[0], m_samples.size());
+///         return true;
+///     }
+///
+///     virtual void onSeek(cpp3ds::Time) {}
+///
+///     cpp3ds::SoundRingBuffer     m_ring;
+///     std::vector<cpp3ds::Int16> m_samples;
+/// };
+/// \endcode
+///
+/// \see cpp3ds::SoundStream
+///
+////////////////////////////////////////////////////////////
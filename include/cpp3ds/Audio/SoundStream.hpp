@@ -31,16 +31,20 @@
 #ifndef EMULATION
 #include <cpp3ds/System/LinearAllocator.hpp>
 #endif
+#include <cpp3ds/Audio/Resampler.hpp>
 #include <cpp3ds/Audio/SoundSource.hpp>
 #include <cpp3ds/System/Thread.hpp>
 #include <cpp3ds/System/Time.hpp>
 #include <cpp3ds/System/Mutex.hpp>
+#include <atomic>
 #include <cstdlib>
 #include <vector>
 
 
 namespace cpp3ds
 {
+class AudioBus;
+
 ////////////////////////////////////////////////////////////
 /// \brief Abstract base class for streamed audio sources
 ///
@@ -123,6 +127,59 @@ public:
     ////////////////////////////////////////////////////////////
     unsigned int getSampleRate() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Play the stream at another sample rate
+    ///
+    /// The samples given by the source are converted to this
+    /// rate before being queued, so that streams recorded at
+    /// different rates all reach the DSP at the same one.
+    /// Like initialize(), it may only be called while the
+    /// stream is stopped.
+    ///
+    /// \param sampleRate Output sample rate, 0 to play at the rate of the source
+    /// \param quality    Trade-off between speed and fidelity of the conversion
+    ///
+    /// \see getOutputSampleRate
+    ///
+    ////////////////////////////////////////////////////////////
+    void setOutputSampleRate(unsigned int sampleRate, Resampler::Quality quality = Resampler::Medium);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the sample rate the stream is played at
+    ///
+    /// \return Output sample rate, 0 if the stream is played at the rate of its source
+    ///
+    /// \see setOutputSampleRate
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getOutputSampleRate() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Run the stream through a bus of effects
+    ///
+    /// The samples go through the bus after their conversion to
+    /// the output rate, just before being queued; chunks already
+    /// queued are played without it. The bus isn't copied, it
+    /// must stay alive while it is attached, and it can't be
+    /// attached to another stream at the same time.
+    ///
+    /// \param bus Bus to run the samples through, NULL to detach it
+    ///
+    /// \see getBus
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBus(AudioBus* bus);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the bus the stream runs through
+    ///
+    /// \return Bus of effects, NULL if none is attached
+    ///
+    /// \see setBus
+    ///
+    ////////////////////////////////////////////////////////////
+    AudioBus* getBus() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the current status of the stream (stopped, paused, playing)
     ///
@@ -215,9 +272,10 @@ protected:
     /// streaming loop, in a separate thread.
     /// The source can choose to stop the streaming loop at any time, by
     /// returning false to the caller.
-    /// If you return true (i.e. continue streaming) it is important that
-    /// the returned array of samples is not empty; this would stop the stream
-    /// due to an internal limitation.
+    /// If you return true (i.e. continue streaming) with an empty array
+    /// of samples, the stream asks again on its next update; this is how
+    /// a source fed from another thread, through a cpp3ds::SoundRingBuffer
+    /// for instance, waits for its producer.
     ///
     /// \param data Chunk of data to fill
     ///
@@ -254,7 +312,8 @@ private:
     ///
     /// This function is called as soon as a buffer has been fully
     /// consumed; it fills it again and inserts it back into the
-    /// playing queue.
+    /// playing queue. A buffer the source has no data for yet is
+    /// left out, and filled again on the next update.
     ///
     /// \param bufferNum Number of the buffer to fill (in [0, BufferCount])
     ///
@@ -282,6 +341,14 @@ private:
     ////////////////////////////////////////////////////////////
     void clearQueue();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the sample rate of the queued buffers
+    ///
+    /// \return Output sample rate if one is set, sample rate of the source otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPlaybackRate() const;
+
     enum
     {
         BufferCount = 30 ///< Number of audio buffers used by the streaming loop
@@ -290,21 +357,28 @@ private:
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Thread        m_thread;                  ///< Thread running the background tasks
-    mutable Mutex m_threadMutex;             ///< Thread mutex
-    Status        m_threadStartState;        ///< State the thread starts in (Playing, Paused, Stopped)
-    bool          m_isStreaming;             ///< Streaming state (true = playing, false = stopped)
-    unsigned int  m_channelCount;            ///< Number of channels (1 = mono, 2 = stereo, ...)
-    unsigned int  m_sampleRate;              ///< Frequency (samples / second)
-    Uint32        m_format;                  ///< Format of the internal sound buffers
-    bool          m_loop;                    ///< Loop flag (true to loop, false to play once)
-    Uint64        m_samplesProcessed;        ///< Number of buffers processed since beginning of the stream
-    bool          m_endBuffers[BufferCount]; ///< Each buffer is marked as "end buffer" or not, for proper duration calculation
+    Thread        m_thread;                    ///< Thread running the background tasks
+    mutable Mutex m_threadMutex;               ///< Thread mutex
+    Status        m_threadStartState;          ///< State the thread starts in (Playing, Paused, Stopped)
+    bool          m_isStreaming;               ///< Streaming state (true = playing, false = stopped)
+    unsigned int  m_channelCount;              ///< Number of channels (1 = mono, 2 = stereo, ...)
+    unsigned int  m_sampleRate;                ///< Frequency (samples / second)
+    Uint32        m_format;                    ///< Format of the internal sound buffers
+    bool          m_loop;                      ///< Loop flag (true to loop, false to play once)
+    Uint64        m_samplesProcessed;          ///< Number of buffers processed since beginning of the stream
+    bool          m_endBuffers[BufferCount];   ///< Each buffer is marked as "end buffer" or not, for proper duration calculation
+    bool          m_emptyBuffers[BufferCount]; ///< Buffers left out of the queue while the source had no data, to fill again
+    unsigned int  m_outputSampleRate;          ///< Rate the samples are converted to, 0 to keep the source's
+    Resampler::Quality m_resamplerQuality;     ///< Trade-off between speed and fidelity of the conversion
+    Resampler     m_resampler;                 ///< Converts the source's samples to the output rate
+    std::vector<Int16> m_processed;            ///< Samples of the last chunk, at the output rate and through the bus
+    std::atomic<AudioBus*> m_bus;              ///< Effects the samples go through, NULL for none
+    AudioBus*     m_preparedBus;               ///< Bus prepared for the current format by the streaming thread
 #ifndef EMULATION
 	ndspWaveBuf   m_ndspWaveBuffers[BufferCount];
 	std::vector<Int16, LinearAllocator<Int16>> m_buffers[BufferCount];
 #else
-	unsigned int  m_buffers[BufferCount];    ///< Sound buffers used to store temporary audio data
+	unsigned int  m_buffers[BufferCount];      ///< Sound buffers used to store temporary audio data
 #endif
 };
 
@@ -0,0 +1,140 @@
+#ifndef CPP3DS_SOUNDWRITEQUEUE_HPP
+#define CPP3DS_SOUNDWRITEQUEUE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/Audio/SoundRingBuffer.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <cpp3ds/System/Semaphore.hpp>
+#include <cpp3ds/System/Thread.hpp>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Queue of samples written out by a thread of its own
+///
+////////////////////////////////////////////////////////////
+class SoundWriteQueue : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function writing the samples taken out of the queue
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef std::function<void(const Int16*, std::size_t)> Writer;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    SoundWriteQueue();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// The queued samples are written before the thread ends.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~SoundWriteQueue();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allocate the queue and start the writer thread
+    ///
+    /// The writer is given at most \a chunkSize samples at once,
+    /// from its own thread.
+    ///
+    /// \param writer    Function writing the samples
+    /// \param capacity  Minimum number of samples the queue holds
+    /// \param chunkSize Maximum number of samples written at once
+    ///
+    ////////////////////////////////////////////////////////////
+    void start(const Writer& writer, std::size_t capacity, std::size_t chunkSize);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the queued samples and stop the writer thread
+    ///
+    /// Does nothing if the thread isn't running.
+    ///
+    ////////////////////////////////////////////////////////////
+    void stop();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue samples, leaving out those that don't fit
+    ///
+    /// Only one thread may queue samples. It never waits.
+    ///
+    /// \param samples Samples to queue
+    /// \param count   Number of samples, whole frames only
+    ///
+    /// \return Number of samples actually queued
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t push(const Int16* samples, std::size_t count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue samples, waiting for room if the queue is full
+    ///
+    /// Only one thread may queue samples.
+    ///
+    /// \param samples Samples to queue
+    /// \param count   Number of samples, whole frames only
+    ///
+    ////////////////////////////////////////////////////////////
+    void write(const Int16* samples, std::size_t count);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called as the entry point of the writer thread
+    ///
+    /// This function writes the queued samples, and returns
+    /// once the queue is stopped and empty.
+    ///
+    ////////////////////////////////////////////////////////////
+    void run();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Thread             m_thread;  ///< Thread writing the queued samples
+    Writer             m_writer;  ///< Function writing the samples
+    SoundRingBuffer    m_ring;    ///< Samples queued but not written yet
+    std::vector<Int16> m_samples; ///< Samples being written, after they are taken out
+    Semaphore          m_queued;  ///< Posted when samples are queued, or the queue stops
+    Semaphore          m_taken;   ///< Posted when samples are taken out, making room
+    std::atomic<bool>  m_running; ///< Whether the writer thread must wait for more samples
+};
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_SOUNDWRITEQUEUE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::priv::SoundWriteQueue
+/// \ingroup audio
+///
+/// Hands samples to a thread that writes them out, so that
+/// whoever produces them doesn't wait on a slow encoder or a
+/// slow SD card. Both sides sleep on a semaphore while there is
+/// nothing for them to do: the writer thread until samples are
+/// queued, and write() until some are taken out.
+///
+/// The writer thread runs below the thread that starts it.
+///
+/// \see cpp3ds::SoundRingBuffer
+///
+////////////////////////////////////////////////////////////
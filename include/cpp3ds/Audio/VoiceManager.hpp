@@ -0,0 +1,300 @@
+#ifndef CPP3DS_VOICEMANAGER_HPP
+#define CPP3DS_VOICEMANAGER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/Sound.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <cpp3ds/System/Vector3.hpp>
+#include <vector>
+
+
+namespace cpp3ds
+{
+class AudioBus;
+class SoundBuffer;
+
+////////////////////////////////////////////////////////////
+/// \brief Plays many short sounds at once, on a few hardware
+///        channels and a software mix
+///
+////////////////////////////////////////////////////////////
+class VoiceManager : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// Each mix stream takes a channel for as long as the
+    /// manager exists, and each hardware voice one while it
+    /// plays, out of the 24 the DSP has.
+    ///
+    /// \param hardwareVoices Number of voices played on their own channel
+    /// \param mixedVoices    Number of voices mixed in software
+    /// \param streamCount    Number of streams the mixed voices are spread over
+    /// \param sampleRate     Sample rate of the mix streams
+    ///
+    ////////////////////////////////////////////////////////////
+    VoiceManager(unsigned int hardwareVoices = 8, unsigned int mixedVoices = 128, unsigned int streamCount = 2, unsigned int sampleRate = 22050);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Stops all the voices.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~VoiceManager();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play a sound
+    ///
+    /// Sounds with at least the hardware priority get a channel
+    /// of their own while there is one, others are mixed in
+    /// software. When all the voices are taken, the sound
+    /// replaces one with a lower or equal priority, or isn't
+    /// played. Buffers kept compressed as DSP-ADPCM always ask
+    /// for a channel, they can't be mixed.
+    ///
+    /// The buffer must stay alive while its voices play.
+    ///
+    /// \param buffer   Sound buffer to play
+    /// \param priority Priority of the voice, higher ones are kept over it
+    /// \param volume   Volume, in [0, 100]
+    /// \param loop     Play the sound again at the end?
+    ///
+    /// \return Identifier of the voice, 0 if it wasn't played
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 play(const SoundBuffer& buffer, int priority = 0, float volume = 100.f, bool loop = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play a sound at a position
+    ///
+    /// Positional voices are always mixed in software, where
+    /// they are attenuated by their distance to the listener and
+    /// panned. A sound that doesn't loop isn't played at all
+    /// when it is out of range, nor is a buffer kept compressed
+    /// as DSP-ADPCM.
+    ///
+    /// \param buffer   Sound buffer to play
+    /// \param position Position of the sound
+    /// \param priority Priority of the voice, higher ones are kept over it
+    /// \param volume   Volume, in [0, 100]
+    /// \param loop     Play the sound again at the end?
+    ///
+    /// \return Identifier of the voice, 0 if it wasn't played
+    ///
+    /// \see setListenerPosition, setDistances
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 play(const SoundBuffer& buffer, const Vector3f& position, int priority = 0, float volume = 100.f, bool loop = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop a voice
+    ///
+    /// Nothing happens if it already ended.
+    ///
+    ////////////////////////////////////////////////////////////
+    void stop(Uint32 voice);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop all the voices
+    ///
+    ////////////////////////////////////////////////////////////
+    void stopAll();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a voice is still playing
+    ///
+    /// Voices culled by their distance are still playing.
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isPlaying(Uint32 voice) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the volume of a voice, in [0, 100]
+    ///
+    ////////////////////////////////////////////////////////////
+    void setVolume(Uint32 voice, float volume);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move a positional voice
+    ///
+    /// Voices played on a channel of their own aren't moved.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPosition(Uint32 voice, const Vector3f& position);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move the listener of positional voices
+    ///
+    ////////////////////////////////////////////////////////////
+    void setListenerPosition(const Vector3f& position);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the position of the listener
+    ///
+    ////////////////////////////////////////////////////////////
+    const Vector3f& getListenerPosition() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the distances positional voices fade out between
+    ///
+    /// Voices are at full volume up to \a minDistance from the
+    /// listener, and fade out linearly until \a maxDistance, from
+    /// where they are culled: they keep playing, but cost
+    /// nothing to mix. The defaults are 1 and 1000.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDistances(float minDistance, float maxDistance);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the priority from which voices get a channel
+    ///        of their own
+    ///
+    /// The default is 1, so voices played with the default
+    /// priority 0 are mixed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setHardwarePriority(int priority);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the priority from which voices get a channel
+    ///        of their own
+    ///
+    ////////////////////////////////////////////////////////////
+    int getHardwarePriority() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of voices playing
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getVoiceCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of streams the mixed voices are
+    ///        spread over
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getStreamCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Run a mix stream through a bus of effects
+    ///
+    /// Each stream needs a bus and nodes of its own, set alike
+    /// to treat all the mixed voices the same. Voices played
+    /// on a channel of their own don't go through any bus.
+    ///
+    /// \param stream Index of the stream, in [0, getStreamCount()[
+    /// \param bus    Bus to run the stream through, NULL to detach it
+    ///
+    /// \see cpp3ds::SoundStream::setBus
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBus(unsigned int stream, AudioBus* bus);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Free the hardware voices that ended
+    ///
+    /// Call it once per frame. Mixed voices are freed as soon
+    /// as they end.
+    ///
+    ////////////////////////////////////////////////////////////
+    void update();
+
+private :
+
+    class MixStream;
+
+    struct HardwareVoice
+    {
+        Sound  sound;    ///< Sound playing on the channel
+        Uint32 id;       ///< Identifier of the voice, 0 for a free one
+        int    priority; ///< Priority against stealing
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play a voice on a channel of its own
+    ///
+    /// \return Identifier of the voice, 0 if no channel could be had
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 playHardware(const SoundBuffer& buffer, int priority, float volume, bool loop);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play a voice in the least busy mix stream
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 playMixed(const SoundBuffer& buffer, const Vector3f* position, int priority, float volume, bool loop);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the hardware voice playing a voice
+    ///
+    ////////////////////////////////////////////////////////////
+    HardwareVoice* findHardwareVoice(Uint32 voice);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the stream mixing a voice
+    ///
+    ////////////////////////////////////////////////////////////
+    MixStream* findStream(Uint32 voice) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<HardwareVoice> m_hardwareVoices;   ///< Voices played on a channel of their own
+    std::vector<MixStream*>    m_streams;          ///< Streams the other voices are mixed into
+    int                        m_hardwarePriority; ///< Priority from which voices get a channel
+    Vector3f                   m_listener;         ///< Position of the listener
+    float                      m_minDistance;      ///< Distance up to which voices are at full volume
+    float                      m_maxDistance;      ///< Distance from which voices are culled
+    Uint32                     m_serial;           ///< High bytes of the next hardware voice identifier
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_VOICEMANAGER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::VoiceManager
+/// \ingroup audio
+///
+/// cpp3ds::Sound takes one of the 24 DSP channels for itself
+/// and fails once they are all playing, which is far too few
+/// for a game firing dozens of effects per second. A
+/// VoiceManager plays sound buffers as voices: the important
+/// ones on channels of their own, the rest mixed in software
+/// into a few streams.
+///
+/// Every voice has a priority. When all the voices are taken,
+/// a new one replaces the voice with the lowest priority, the
+/// quietest of those, then the oldest, unless they all matter
+/// more than it does. Positional voices fade out with their
+/// distance to the listener and are culled past the maximum
+/// distance, which makes far away explosions free.
+///
+/// \code
+/// cpp3ds::VoiceManager voices;
+/// voices.setDistances(50.f, 400.f);
+///
+/// // Each frame
+/// voices.setListenerPosition(cpp3ds::Vector3f(player.x, player.y, 0.f));
+/// for (each bullet hitting something)
+///     voices.play(hitBuffer, cpp3ds::Vector3f(bullet.x, bullet.y, 0.f));
+/// if (playerWasHit)
+///     voices.play(hurtBuffer, 10);
+/// voices.update();
+/// \endcode
+///
+/// Mixed voices are resampled to the rate of the streams by
+/// taking the nearest sample, so buffers should be recorded at
+/// that rate, or converted to it when loaded (see
+/// cpp3ds::SoundBuffer::resample).
+///
+/// \see cpp3ds::Sound, cpp3ds::SoundBuffer
+///
+////////////////////////////////////////////////////////////
@@ -44,6 +44,7 @@ private:
 private slots:
 	void on_actionScreenshot_triggered(bool checked = false);
 	void on_actionToggle_3D_triggered(bool checked = false);
+	void on_actionOverdraw_triggered(bool checked = false);
 	void on_actionPlay_Pause_triggered(bool checked = false);
 	void on_actionStop_triggered(bool checked = false);
 	void on_toolBar_orientationChanged(Qt::Orientation orientation);
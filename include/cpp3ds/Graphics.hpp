@@ -2,10 +2,14 @@
 #define CPP3DS_GRAPHICS_HPP
 
 #include <cpp3ds/Window.hpp>
+#include <cpp3ds/Graphics/BigSprite.hpp>
+#include <cpp3ds/Graphics/BigTexture.hpp>
 #include <cpp3ds/Graphics/BlendMode.hpp>
+#include <cpp3ds/Graphics/CachedLayer.hpp>
 #include <cpp3ds/Graphics/Color.hpp>
 #include <cpp3ds/Graphics/Console.hpp>
 #include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/Graphics/FontFamily.hpp>
 #include <cpp3ds/Graphics/Glyph.hpp>
 #include <cpp3ds/Graphics/Image.hpp>
 #include <cpp3ds/Graphics/RenderStates.hpp>
@@ -18,7 +22,10 @@
 #include <cpp3ds/Graphics/ConvexShape.hpp>
 #include <cpp3ds/Graphics/Sprite.hpp>
 #include <cpp3ds/Graphics/Text.hpp>
+#include <cpp3ds/Graphics/TextLayout.hpp>
 #include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/Graphics/TextureAtlas.hpp>
+#include <cpp3ds/Graphics/TextureManager.hpp>
 #include <cpp3ds/Graphics/Transform.hpp>
 #include <cpp3ds/Graphics/Vertex.hpp>
 #include <cpp3ds/Graphics/VertexArray.hpp>
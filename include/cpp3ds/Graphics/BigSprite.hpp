@@ -0,0 +1,142 @@
+#ifndef CPP3DS_BIGSPRITE_HPP
+#define CPP3DS_BIGSPRITE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Drawable.hpp>
+#include <cpp3ds/Graphics/Transformable.hpp>
+#include <cpp3ds/Graphics/VertexArray.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+
+
+namespace cpp3ds
+{
+class BigTexture;
+
+////////////////////////////////////////////////////////////
+/// \brief Drawable representation of a BigTexture, drawing
+///        only the tiles that can be seen
+///
+////////////////////////////////////////////////////////////
+class BigSprite : public Drawable, public Transformable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    BigSprite();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the sprite from a big texture
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit BigSprite(const BigTexture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    BigSprite(const BigSprite& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    ////////////////////////////////////////////////////////////
+    BigSprite& operator =(const BigSprite& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the big texture of the sprite
+    ///
+    /// The texture must stay alive while the sprite uses it.
+    /// It may be reloaded with another size, the sprite
+    /// follows its tiles the next time it is drawn.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(const BigTexture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the global color of the sprite
+    ///
+    ////////////////////////////////////////////////////////////
+    void setColor(const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the big texture of the sprite
+    ///
+    ////////////////////////////////////////////////////////////
+    const BigTexture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the global color of the sprite
+    ///
+    ////////////////////////////////////////////////////////////
+    const Color& getColor() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the local bounding rectangle of the entity
+    ///
+    ////////////////////////////////////////////////////////////
+    FloatRect getLocalBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the global bounding rectangle of the entity
+    ///
+    ////////////////////////////////////////////////////////////
+    FloatRect getGlobalBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of tiles drawn by the last draw
+    ///
+    /// Tiles outside the target's view are skipped, and aren't
+    /// streamed in either.
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getDrawnTileCount() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the visible tiles to a render target
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rebuild one quad per tile
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateVertices() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    const BigTexture*    m_texture;     ///< Big texture of the sprite
+    mutable VertexArray  m_vertices;    ///< Four vertices per tile
+    mutable Vector2u     m_tileCount;   ///< Tile grid of the texture when the vertices were built
+    mutable Vector2u     m_size;        ///< Size of the texture when the vertices were built
+    Color                m_color;       ///< Global color of the sprite
+    mutable unsigned int m_drawnTiles;  ///< Tiles drawn by the last draw call
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_BIGSPRITE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::BigSprite
+/// \ingroup graphics
+///
+/// Like cpp3ds::Sprite but for a cpp3ds::BigTexture. Each tile
+/// is a quad drawn with its own texture; before drawing, the
+/// target's view is mapped into the sprite's local space and
+/// tiles outside it are skipped. Streamed tiles are loaded the
+/// first time they become visible.
+///
+/// \see cpp3ds::BigTexture, cpp3ds::Sprite
+///
+////////////////////////////////////////////////////////////
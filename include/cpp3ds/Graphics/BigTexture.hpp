@@ -0,0 +1,218 @@
+#ifndef CPP3DS_BIGTEXTURE_HPP
+#define CPP3DS_BIGTEXTURE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/System/FileInputStream.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace cpp3ds
+{
+class Image;
+class InputStream;
+
+////////////////////////////////////////////////////////////
+/// \brief Image split into a grid of textures, for images
+///        too large or too wasteful to fit in a single Texture
+///
+////////////////////////////////////////////////////////////
+class BigTexture : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    BigTexture();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Split an image into tiles
+    ///
+    /// Each row and column is cut into power-of-two segments of
+    /// at most Texture::getMaximumSize(), chosen so that little
+    /// padding is needed. All tiles are created immediately.
+    ///
+    /// \param image  Image to split
+    /// \param format Pixel format of the tile textures
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromImage(const Image& image, GPU_TEXCOLOR format = GPU_RGBA8);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load an image file and split it into tiles
+    ///
+    /// \see loadFromImage
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& filename, GPU_TEXCOLOR format = GPU_RGBA8);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open a preprocessed big texture file for streaming
+    ///
+    /// Files are produced by compile_big_textures() (see
+    /// scripts/tex_compile.py). Only the tile table is read here,
+    /// tiles are loaded the first time getTile() asks for them.
+    ///
+    /// \param filename Path of the file
+    ///
+    /// \return True if the file is a valid big texture
+    ///
+    ////////////////////////////////////////////////////////////
+    bool openFromFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open a preprocessed big texture from a stream
+    ///
+    /// The stream must stay alive for as long as tiles can be
+    /// loaded from it.
+    ///
+    /// \see openFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool openFromStream(InputStream& stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the whole image, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of tile columns and rows
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getTileCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the area of the image covered by a tile
+    ///
+    ////////////////////////////////////////////////////////////
+    IntRect getTileRect(unsigned int column, unsigned int row) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture of a tile, streaming it in if needed
+    ///
+    /// The texture's top left corner matches the top left of
+    /// getTileRect(); the rest is padding.
+    ///
+    /// \return Tile texture, or NULL if it couldn't be loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTile(unsigned int column, unsigned int row) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check whether a tile is currently in memory
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isTileLoaded(unsigned int column, unsigned int row) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Free streamed tiles not intersecting \a area
+    ///
+    /// Tiles created by loadFromImage can't be reloaded and are
+    /// always kept.
+    ///
+    /// \param area Area of the image to keep, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void unloadTiles(const FloatRect& area = FloatRect());
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the smooth filter on all tiles
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSmooth(bool smooth);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the smooth filter is enabled or not
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isSmooth() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tile of the grid
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Tile
+    {
+        Tile();
+
+        IntRect                  rect;    ///< Area of the image covered by the tile
+        Vector2u                 size;    ///< Size of the tile texture
+        Uint32                   offset;  ///< Offset of the tile data in the stream
+        Uint32                   length;  ///< Size of the tile data in the stream
+        std::unique_ptr<Texture> texture; ///< Texture, NULL while not loaded
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset to an empty grid
+    ///
+    ////////////////////////////////////////////////////////////
+    void cleanup();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Build the tile grid from column and row sizes
+    ///
+    ////////////////////////////////////////////////////////////
+    void setupGrid(const std::vector<unsigned int>& columns, const std::vector<unsigned int>& rows);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read a tile from the stream into its texture
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadTile(Tile& tile) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Vector2u                  m_size;      ///< Size of the whole image
+    Vector2u                  m_tileCount; ///< Number of columns and rows
+    mutable std::vector<Tile> m_tiles;     ///< Tiles, row by row
+    GPU_TEXCOLOR              m_format;    ///< Format of the tiles
+    InputStream*              m_stream;    ///< Stream tiles are loaded from, if any
+    FileInputStream           m_file;      ///< Owned stream used by openFromFile
+    bool                      m_isSmooth;  ///< Status of the smooth filter
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_BIGTEXTURE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::BigTexture
+/// \ingroup graphics
+///
+/// Textures are limited to Texture::getMaximumSize() and are
+/// padded to a power of two. BigTexture cuts an image into a
+/// grid of textures whose sizes add up to barely more than the
+/// image, so a 1100x600 panorama becomes columns of 1024+64+16
+/// and rows of 512+64+32 instead of not loading at all.
+///
+/// Preprocessed big textures keep their tiles on disk until
+/// they are needed, which lets scenes larger than memory be
+/// displayed a screen at a time. Use it with cpp3ds::BigSprite:
+///
+/// \code
+/// cpp3ds::BigTexture background;
+/// background.openFromFile("map.btex");
+/// cpp3ds::BigSprite sprite(background);
+/// window.draw(sprite); // only visible tiles get loaded
+/// \endcode
+///
+/// \see cpp3ds::BigSprite, cpp3ds::Texture
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,200 @@
+#ifndef CPP3DS_CACHEDLAYER_HPP
+#define CPP3DS_CACHEDLAYER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Drawable.hpp>
+#include <cpp3ds/Graphics/Transformable.hpp>
+#include <cpp3ds/Graphics/RenderTexture.hpp>
+#include <cpp3ds/Graphics/RectangleShape.hpp>
+#include <cpp3ds/Graphics/Sprite.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Group of drawables rendered once into a texture and
+///        drawn as a single sprite until invalidated
+///
+////////////////////////////////////////////////////////////
+class CachedLayer : public Drawable, public Transformable, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    CachedLayer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the layer's render texture
+    ///
+    /// \param width  Width of the layer, in pixels
+    /// \param height Height of the layer, in pixels
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a drawable to the layer
+    ///
+    /// Children are drawn in the order they were added, in the
+    /// layer's local pixel coordinates. They aren't copied and
+    /// must outlive the layer or be removed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Drawable& drawable);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a drawable from the layer
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(const Drawable& drawable);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all drawables from the layer
+    ///
+    ////////////////////////////////////////////////////////////
+    void removeAll();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the color the layer is cleared to before drawing
+    ///
+    /// Transparent by default.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setClearColor(const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark the whole layer for re-rendering
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidate();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark part of the layer for re-rendering
+    ///
+    /// Only this area is cleared and redrawn by the next
+    /// update(), using the scissor. Call it with the old and the
+    /// new bounds of a child that moved.
+    ///
+    /// \param area Area to redraw, in the layer's local coordinates
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidate(const FloatRect& area);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether update() has anything to redraw
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isDirty() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Re-render the invalidated parts of the layer
+    ///
+    /// Call once per frame before drawing the layer; it does
+    /// nothing when the layer is clean.
+    ///
+    /// \return True if anything was re-rendered
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of full re-renders
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getRenderCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of partial (scissored) re-renders
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPartialRenderCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of times the layer was drawn
+    ///
+    /// Compared with the render counts, this tells how well the
+    /// layer is cached.
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getDrawCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the render and draw counters
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetStats();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture holding the rendered layer
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getTexture() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the cached texture to a render target
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    RenderTexture                m_renderTexture;  ///< Texture the children are rendered to
+    Sprite                       m_sprite;         ///< Sprite compositing the texture
+    RectangleShape               m_eraser;         ///< Clears dirty areas
+    std::vector<const Drawable*> m_children;       ///< Drawables of the layer
+    std::vector<UintRect>        m_dirtyAreas;     ///< Areas to redraw, in pixels
+    Color                        m_clearColor;     ///< Background of the layer
+    bool                         m_fullyDirty;     ///< Does the whole layer need redrawing?
+    unsigned int                 m_renderCount;    ///< Full re-renders
+    unsigned int                 m_partialCount;   ///< Partial re-renders
+    mutable unsigned int         m_drawCount;      ///< Composites to a target
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_CACHEDLAYER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::CachedLayer
+/// \ingroup graphics
+///
+/// Menus and HUDs are made of many texts and shapes that rarely
+/// change. Drawing them into a CachedLayer renders them once,
+/// and every frame after that costs a single textured quad until
+/// something is invalidated.
+///
+/// \code
+/// cpp3ds::CachedLayer menu;
+/// menu.create(320, 240);
+/// menu.add(background);
+/// menu.add(title);
+/// menu.add(score);
+///
+/// // When the score changes, redraw only where it is
+/// menu.invalidate(score.getGlobalBounds());
+/// score.setString("1200");
+/// menu.invalidate(score.getGlobalBounds());
+///
+/// // Each frame
+/// menu.update();
+/// window.draw(menu);
+/// \endcode
+///
+/// \see cpp3ds::RenderTexture
+///
+////////////////////////////////////////////////////////////
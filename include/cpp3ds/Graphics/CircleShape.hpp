@@ -29,6 +29,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/Shape.hpp>
+#include <vector>
 
 
 namespace cpp3ds
@@ -73,9 +74,11 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Set the number of points of the circle
     ///
+    /// This disables the adaptive point count.
+    ///
     /// \param count New number of points of the circle
     ///
-    /// \see getPointCount
+    /// \see getPointCount, setAdaptivePointCount
     ///
     ////////////////////////////////////////////////////////////
     void setPointCount(unsigned int count);
@@ -90,6 +93,44 @@ public :
     ////////////////////////////////////////////////////////////
     virtual unsigned int getPointCount() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the adaptive point count
+    ///
+    /// When enabled, the number of points is chosen from the
+    /// size the circle is drawn at, its radius with the scale
+    /// of its transform and of the render states, so that the
+    /// polygon never strays far from the circle. It is disabled
+    /// by default.
+    ///
+    /// \param adaptive True to enable the adaptive point count
+    ///
+    /// \see hasAdaptivePointCount, getAdaptivePointCount
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAdaptivePointCount(bool adaptive);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the point count is adaptive
+    ///
+    /// \see setAdaptivePointCount
+    ///
+    ////////////////////////////////////////////////////////////
+    bool hasAdaptivePointCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of points of an adaptive circle
+    ///
+    /// It keeps the polygon within a quarter of a pixel of the
+    /// circle, between 8 and 120 points, rounded up to a multiple
+    /// of 4 so that a circle growing a little isn't rebuilt.
+    ///
+    /// \param radius Radius of the circle on screen, in pixels
+    ///
+    /// \return Number of points of the circle
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getAdaptivePointCount(float radius);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get a point of the circle
     ///
@@ -105,13 +146,33 @@ public :
     ////////////////////////////////////////////////////////////
     virtual Vector2f getPoint(unsigned int index) const;
 
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the circle to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
 private :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Rebuild the geometry at the current radius
+    ///
+    ////////////////////////////////////////////////////////////
+    void rebuild();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    float        m_radius;     ///< Radius of the circle
-    unsigned int m_pointCount; ///< Number of points composing the circle
+    float                        m_radius;             ///< Radius of the circle
+    unsigned int                 m_pointCount;         ///< Number of points composing the circle
+    float                        m_meshRadius;         ///< Radius the geometry was built at
+    bool                         m_adaptivePointCount; ///< Is the number of points chosen from the size on screen?
+    const std::vector<Vector2f>* m_unitPoints;         ///< Shared points of the circle of radius 1
 };
 
 }
@@ -148,6 +209,14 @@ private :
 /// small numbers you can create any regular polygon shape:
 /// equilateral triangle, square, pentagon, hexagon, ...
 ///
+/// Alternatively, setAdaptivePointCount(true) lets the circle pick
+/// as many points as the size it is drawn at needs.
+///
+/// The points of the circle of radius 1 are computed once for each
+/// number of points and shared by all circles. Changing the radius
+/// doesn't rebuild the geometry, it is scaled when drawn, so a
+/// circle can be animated every frame cheaply.
+///
 /// \see cpp3ds::Shape, cpp3ds::RectangleShape, cpp3ds::ConvexShape
 ///
 ////////////////////////////////////////////////////////////
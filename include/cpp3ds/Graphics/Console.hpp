@@ -8,6 +8,7 @@
 #include <cpp3ds/Graphics/Drawable.hpp>
 #include <cpp3ds/Graphics/Font.hpp>
 #include <cpp3ds/Graphics/Text.hpp>
+#include <cpp3ds/Graphics/VertexArray.hpp>
 #include <cpp3ds/Window/ContextSettings.hpp>
 
 namespace cpp3ds
@@ -71,13 +72,43 @@ private:
 	////////////////////////////////////////////////////////////
 	virtual void draw(RenderTarget& target, RenderStates states) const;
 
+	////////////////////////////////////////////////////////////
+	/// \brief Add a line of text without line feeds
+	///
+	/// Its glyph quads go at the end of the vertex buffer, and
+	/// the oldest line is pushed out once the ring is full.
+	///
+	////////////////////////////////////////////////////////////
+	void appendLine(const String& text, std::size_t begin, std::size_t end);
+
+	////////////////////////////////////////////////////////////
+	/// \brief Drop the vertices of the lines pushed out
+	///
+	////////////////////////////////////////////////////////////
+	void compact();
+
+	////////////////////////////////////////////////////////////
+	/// \brief A line of the ring
+	///
+	////////////////////////////////////////////////////////////
+	struct Line
+	{
+		unsigned int begin; ///< Index of the line's first vertex
+		float        top;   ///< Y position of the line in the vertex buffer
+	};
+
 	////////////////////////////////////////////////////////////
 	// Member data
 	////////////////////////////////////////////////////////////
 	Font  m_font;
 	Color m_color;
-	std::vector<Text> m_lines;
+	std::vector<Line> m_lines;       ///< Ring of the last m_limit lines
+	unsigned int m_firstLine;        ///< Index of the oldest line in m_lines
+	unsigned int m_lineCount;        ///< Number of lines in the ring
+	VertexArray m_vertices;          ///< Glyph quads of all the lines, oldest first
+	float m_bottom;                   ///< Y position of the end of the newest line
 	Text m_memoryText;
+	float m_memoryTextAge;            ///< Time since the memory stats were refreshed
 	unsigned int m_limit;
 	static bool m_enabled;
 	static bool m_enabledBasic;
@@ -34,6 +34,7 @@
 #include <cpp3ds/System/Vector2.hpp>
 #include <cpp3ds/System/String.hpp>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,13 @@ namespace cpp3ds
 {
     class InputStream;
 
+    class FontFamily;
+
+    namespace priv
+    {
+        class GlyphLoader;
+    }
+
 ////////////////////////////////////////////////////////////
 /// \brief Class for loading and manipulating character fonts
 ///
@@ -168,6 +176,9 @@ namespace cpp3ds
         /// Be aware that using a negative value for the outline
         /// thickness will cause distorted rendering.
         ///
+        /// In distance field mode, \a outlineThickness is ignored
+        /// and the glyph's bounds include the field's margin.
+        ///
         /// \param codePoint        Unicode code point of the character to get
         /// \param characterSize    Reference character size
         /// \param bold             Retrieve the bold version or the regular one?
@@ -252,6 +263,116 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         const Texture& getTexture(unsigned int characterSize) const;
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Enable or disable signed distance field glyphs
+        ///
+        /// In distance field mode, each glyph is rasterized once
+        /// at DistanceFieldSize into a field of distances to its
+        /// edges, and cpp3ds::Text draws any character size and
+        /// outline thickness from that single page. This saves a
+        /// page and a rasterization per size, at the cost of
+        /// slightly rounded corners on large text. Outlines are
+        /// limited to DistanceFieldSpread pixels at
+        /// DistanceFieldSize, scaled with the character size.
+        /// Only scalable fonts support it.
+        ///
+        /// Changing the mode drops all the loaded glyphs.
+        ///
+        /// \param enabled True to render glyphs from distance fields
+        ///
+        /// \see isDistanceField
+        ///
+        ////////////////////////////////////////////////////////////
+        void setDistanceField(bool enabled);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether glyphs are distance fields
+        ///
+        /// \return True if distance field mode is enabled
+        ///
+        /// \see setDistanceField
+        ///
+        ////////////////////////////////////////////////////////////
+        bool isDistanceField() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Enable or disable loading glyphs in the background
+        ///
+        /// In asynchronous mode, a glyph that isn't loaded yet is
+        /// rasterized by a worker thread instead of stalling the
+        /// frame that first needs it. Until it is ready, getGlyph
+        /// returns a placeholder with the glyph's advance and an
+        /// empty texture rectangle, so text keeps its layout and
+        /// draws nothing in its place. Finished glyphs are written
+        /// to the texture by commitPendingGlyphs(), after which
+        /// cpp3ds::Text objects using the font update themselves.
+        ///
+        /// The worker opens the font again on its own, so only
+        /// fonts loaded from a file or from memory support it.
+        ///
+        /// \param enabled True to load glyphs asynchronously
+        ///
+        /// \see isAsyncLoading, commitPendingGlyphs
+        ///
+        ////////////////////////////////////////////////////////////
+        void setAsyncLoading(bool enabled);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether glyphs are loaded in the background
+        ///
+        /// \return True if asynchronous loading is enabled
+        ///
+        /// \see setAsyncLoading
+        ///
+        ////////////////////////////////////////////////////////////
+        bool isAsyncLoading() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether some glyphs are still placeholders
+        ///
+        /// \return True if glyphs are waiting to be rasterized or committed
+        ///
+        ////////////////////////////////////////////////////////////
+        bool hasPendingGlyphs() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the number of times pending glyphs were committed
+        ///
+        /// A change of this number tells that placeholders, or
+        /// glyphs missing until a fallback was added, were
+        /// replaced, and that text laid out with them is outdated.
+        ///
+        /// \return Number of commits that replaced placeholders
+        ///
+        ////////////////////////////////////////////////////////////
+        unsigned int getUpdateCount() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Write the glyphs finished in the background to their texture
+        ///
+        /// Commits at most the upload budget's worth of glyphs over
+        /// all the fonts in asynchronous mode, so that a burst of
+        /// new characters is spread over several frames. It is
+        /// called once per frame by cpp3ds::Game.
+        ///
+        /// \see setGlyphUploadBudget
+        ///
+        ////////////////////////////////////////////////////////////
+        static void commitPendingGlyphs();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Set how many glyphs commitPendingGlyphs() writes per call
+        ///
+        /// The default is 8.
+        ///
+        /// \param glyphsPerFrame Maximum number of glyphs committed per frame
+        ///
+        ////////////////////////////////////////////////////////////
+        static void setGlyphUploadBudget(unsigned int glyphsPerFrame);
+
+        static const unsigned int DistanceFieldSize   = 32; ///< Character size distance fields are rasterized at
+        static const unsigned int DistanceFieldSpread = 4;  ///< Distance covered by the field on each side of an edge, in pixels at DistanceFieldSize
+
         ////////////////////////////////////////////////////////////
         /// \brief Overload of assignment operator
         ///
@@ -264,6 +385,9 @@ namespace cpp3ds
 
     private:
 
+        friend class FontFamily;
+        friend class priv::GlyphLoader;
+
         ////////////////////////////////////////////////////////////
         /// \brief Structure defining a row of glyphs
         ///
@@ -296,12 +420,96 @@ namespace cpp3ds
             std::vector<Row> rows;    ///< List containing the position of all the existing rows
         };
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Structure defining a character size of the face
+        ///
+        ////////////////////////////////////////////////////////////
+        struct Size
+        {
+            void* size;               ///< FreeType size object (it is typeless to avoid exposing implementation details)
+            float lineSpacing;        ///< Line spacing, in pixels
+            float underlinePosition;  ///< Underline position, in pixels
+            float underlineThickness; ///< Underline thickness, in pixels
+        };
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Structure defining where a face is loaded from
+        ///
+        ////////////////////////////////////////////////////////////
+        struct Source
+        {
+            Source() : data(NULL), size(0) {}
+
+            std::string filename; ///< File to open the face from, empty when it is in memory
+            const void* data;     ///< Memory to open the face from
+            std::size_t size;     ///< Size of the memory, in bytes
+        };
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Structure defining a fallback face
+        ///
+        ////////////////////////////////////////////////////////////
+        struct Fallback
+        {
+            Source                       source;   ///< Where the face is loaded from
+            void*                        face;     ///< FreeType face, NULL until it is first needed (it is typeless to avoid exposing implementation details)
+            bool                         isBroken; ///< Did opening the face fail?
+            std::map<unsigned int, Size> sizes;    ///< FreeType sizes of the face, by character size
+        };
+
         ////////////////////////////////////////////////////////////
         /// \brief Free all the internal resources
         ///
         ////////////////////////////////////////////////////////////
         void cleanup();
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Add a face to look up the characters missing from this one
+        ///
+        /// The face is only opened once a code point misses in
+        /// the font's face and in the fallbacks added before it.
+        /// The glyphs already loaded for characters no face had
+        /// are forgotten, so they are loaded from the new face.
+        ///
+        /// \param source Where to load the face from
+        ///
+        ////////////////////////////////////////////////////////////
+        void addFallback(const Source& source);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Remove the glyphs of the characters no face has
+        ///
+        /// \param glyphs Table of glyphs to remove them from
+        ///
+        /// \return True if any glyph was removed
+        ///
+        ////////////////////////////////////////////////////////////
+        bool forgetMissingGlyphs(GlyphTable& glyphs) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Find the face that covers a code point
+        ///
+        /// Fallback faces are opened as the search reaches them, and
+        /// the result is cached for each code point.
+        ///
+        /// \param codePoint Unicode code point of the character
+        ///
+        /// \return 0 for the font's own face (also when no face has
+        ///         the character), or 1 + the index of the fallback
+        ///
+        ////////////////////////////////////////////////////////////
+        unsigned int findFace(Uint32 codePoint) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get a face by the index returned by findFace
+        ///
+        /// Opens the fallback face if it isn't yet.
+        ///
+        /// \return The FreeType face, NULL if it failed to open
+        ///
+        ////////////////////////////////////////////////////////////
+        void* getFace(unsigned int index) const;
+
         ////////////////////////////////////////////////////////////
         /// \brief Load a new glyph and store it in the cache
         ///
@@ -315,6 +523,49 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const;
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Write a rasterized glyph to the page of its size
+        ///
+        /// \param glyph         Glyph whose texture rectangle is to be set
+        /// \param characterSize Reference character size
+        /// \param pixels        RGBA pixels of the glyph
+        /// \param size          Size of the glyph's bitmap, in pixels
+        ///
+        ////////////////////////////////////////////////////////////
+        void writeGlyph(Glyph& glyph, unsigned int characterSize, const std::vector<Uint8>& pixels, Vector2u size) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Queue a glyph for the background loader
+        ///
+        /// \param codePoint        Unicode code point of the character to load
+        /// \param characterSize    Reference character size
+        /// \param bold             Retrieve the bold version or the regular one?
+        /// \param outlineThickness Thickness of outline
+        /// \param key              Key of the glyph in its page's table
+        ///
+        /// \return Placeholder glyph to use until the glyph is committed
+        ///
+        ////////////////////////////////////////////////////////////
+        Glyph requestGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness, Uint64 key) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Commit the glyphs finished by the background loader
+        ///
+        /// \param budget Maximum number of glyphs to commit
+        ///
+        /// \return Number of glyphs committed
+        ///
+        ////////////////////////////////////////////////////////////
+        unsigned int commitGlyphs(unsigned int budget) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Stop the background loader and forget its placeholders
+        ///
+        /// Forgotten placeholders are requested again when used.
+        ///
+        ////////////////////////////////////////////////////////////
+        void stopGlyphLoader() const;
+
         ////////////////////////////////////////////////////////////
         /// \brief Find a suitable rectangle within the texture for a glyph
         ///
@@ -330,29 +581,48 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         /// \brief Make sure that the given size is the current one
         ///
+        /// Each character size of each face gets its own FreeType
+        /// size object, created on first use, so switching between
+        /// sizes only activates it instead of scaling the face again.
+        ///
         /// \param characterSize Reference character size
+        /// \param index         Index of the face, 0 for the font's own
         ///
         /// \return True on success, false if any error happened
         ///
         ////////////////////////////////////////////////////////////
-        bool setCurrentSize(unsigned int characterSize) const;
+        bool setCurrentSize(unsigned int characterSize, unsigned int index = 0) const;
 
         ////////////////////////////////////////////////////////////
         // Types
         ////////////////////////////////////////////////////////////
-        typedef std::map<unsigned int, Page> PageTable; ///< Table mapping a character size to its page (texture)
+        typedef std::map<unsigned int, Page>       PageTable;        ///< Table mapping a character size to its page (texture)
+        typedef std::map<unsigned int, GlyphTable> ScaledGlyphTable; ///< Table mapping a character size to its scaled distance field glyphs
+        typedef std::map<unsigned int, Size>       SizeTable;        ///< Table mapping a character size to its FreeType size and metrics
+        typedef std::set<std::pair<unsigned int, Uint64> > PendingSet; ///< Character sizes and keys of the placeholder glyphs
+        typedef std::map<Uint32, unsigned int>     FaceTable;        ///< Table mapping a code point to the index of the face covering it
 
         ////////////////////////////////////////////////////////////
         // Member data
         ////////////////////////////////////////////////////////////
-        void*                      m_library;     ///< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
-        void*                      m_face;        ///< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
-        void*                      m_streamRec;   ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
-        void*                      m_stroker;     ///< Pointer to the stroker (it is typeless to avoid exposing implementation details)
-        int*                       m_refCount;    ///< Reference counter used by implicit sharing
-        Info                       m_info;        ///< Information about the font
-        mutable PageTable          m_pages;       ///< Table containing the glyphs pages by character size
-        mutable std::vector<Uint8> m_pixelBuffer; ///< Pixel buffer holding a glyph's pixels before being written to the texture
+        void*                      m_library;         ///< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
+        void*                      m_face;            ///< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
+        void*                      m_streamRec;       ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
+        void*                      m_stroker;         ///< Pointer to the stroker (it is typeless to avoid exposing implementation details)
+        int*                       m_refCount;        ///< Reference counter used by implicit sharing
+        Info                       m_info;            ///< Information about the font
+        mutable PageTable          m_pages;           ///< Table containing the glyphs pages by character size
+        mutable std::vector<Uint8> m_pixelBuffer;     ///< Pixel buffer holding a glyph's pixels before being written to the texture
+        mutable ScaledGlyphTable   m_scaledGlyphs;    ///< Distance field glyphs scaled to each character size
+        mutable SizeTable          m_sizes;           ///< FreeType sizes and metrics of the character sizes in use
+        bool                       m_isDistanceField; ///< Are glyphs loaded as distance fields?
+        bool                       m_isAsync;         ///< Are glyphs loaded in the background?
+        mutable priv::GlyphLoader* m_glyphLoader;     ///< Background loader, started with the first request
+        mutable PendingSet         m_pendingGlyphs;   ///< Placeholders waiting for the background loader
+        mutable unsigned int       m_updateCount;     ///< Number of commits that replaced placeholders
+        Source                     m_source;          ///< Where the face was loaded from, for the background loader
+        mutable std::vector<Fallback> m_fallbacks;    ///< Faces used for the characters this one lacks, in order
+        mutable FaceTable          m_faceIndices;     ///< Face covering each code point looked up, when there are fallbacks
     };
 
 } // namespace cpp3ds
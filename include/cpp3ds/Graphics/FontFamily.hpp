@@ -0,0 +1,109 @@
+#ifndef CPP3DS_FONTFAMILY_HPP
+#define CPP3DS_FONTFAMILY_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Font.hpp>
+#include <string>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Font falling back to other faces for the characters
+///        its own face doesn't have
+///
+////////////////////////////////////////////////////////////
+class FontFamily : public Font
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a face from a file
+    ///
+    /// The first face added is the family's own: it is loaded
+    /// right away and gives the metrics, like Font::loadFromFile.
+    /// Later faces are fallbacks, looked up in the order they
+    /// were added; they are only opened once a character misses
+    /// in all the faces before them.
+    ///
+    /// Loading the family again with one of the Font::loadFrom
+    /// functions removes its fallbacks.
+    ///
+    /// \param filename Path of the font file to add
+    ///
+    /// \return True if the face was added
+    ///
+    ////////////////////////////////////////////////////////////
+    bool addFromFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a face from a file in memory
+    ///
+    /// The buffer must remain valid as long as the family uses it,
+    /// as with Font::loadFromMemory.
+    ///
+    /// \param data        Pointer to the file data in memory
+    /// \param sizeInBytes Size of the data to load, in bytes
+    ///
+    /// \return True if the face was added
+    ///
+    /// \see addFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool addFromMemory(const void* data, std::size_t sizeInBytes);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of faces in the family
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getFaceCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of faces opened so far
+    ///
+    /// Fallbacks no character has needed yet aren't counted.
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getOpenFaceCount() const;
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_FONTFAMILY_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::FontFamily
+/// \ingroup graphics
+///
+/// A CJK or symbol font is several megabytes, and parsing it
+/// and keeping its tables in memory only pays off once a string
+/// actually uses one of its characters. A FontFamily takes a
+/// main face and an ordered list of fallbacks: each character
+/// is looked up in the main face first, then in the fallbacks,
+/// which are opened on the first miss that reaches them. The
+/// face covering each character is cached.
+///
+/// Glyphs from every face are rasterized into the family's own
+/// glyph pages, so a text mixing scripts is still drawn with a
+/// single texture, and unused fallbacks cost nothing but their
+/// source. Line spacing and underlines come from the main face;
+/// there is no kerning next to characters from a fallback.
+///
+/// A FontFamily is a cpp3ds::Font and is used by cpp3ds::Text
+/// the same way:
+/// \code
+/// cpp3ds::FontFamily family;
+/// family.addFromFile("fonts/opensans.ttf");
+/// family.addFromFile("fonts/notosanscjk.otf");
+/// family.addFromFile("fonts/symbols.ttf");
+///
+/// cpp3ds::Text text(L"Score: 1200 ★ ハイスコア", family);
+/// \endcode
+///
+/// \see cpp3ds::Font, cpp3ds::Text
+///
+////////////////////////////////////////////////////////////
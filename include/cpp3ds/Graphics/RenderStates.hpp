@@ -55,6 +55,8 @@ public :
     /// \li the identity transform
     /// \li a null texture
     /// \li a null shader
+    /// \li the layer 0
+    /// \li no distance field
     ///
     ////////////////////////////////////////////////////////////
     RenderStates();
@@ -119,11 +121,14 @@ public :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    BlendMode      blendMode; ///< Blending mode
-    Transform      transform; ///< Transform
-    const Texture* texture;   ///< Texture
-    const Shader*  shader;    ///< Shader
-    UintRect       scissor;   ///< Scissor
+    BlendMode      blendMode;                  ///< Blending mode
+    Transform      transform;                  ///< Transform
+    const Texture* texture;                    ///< Texture
+    const Shader*  shader;                     ///< Shader
+    UintRect       scissor;                    ///< Scissor
+    int            layer;                      ///< Layer, higher layers in front, used by depth sorting render targets
+    float          distanceFieldThreshold;     ///< Edge of a signed distance field texture in [0, 1], 0 for an ordinary texture
+    float          distanceFieldPixelsPerUnit; ///< Screen pixels over which the distance field goes from 0 to 1
 };
 
 }
@@ -177,6 +182,22 @@ public :
 /// current transform with its own transform. A sprite will
 /// set its texture. Etc.
 ///
+/// The layer only matters between RenderTarget::beginDepthSorting
+/// and RenderTarget::endDepthSorting, where it replaces the draw
+/// order: draws on a higher layer cover the ones on lower layers,
+/// whichever was drawn first.
+/// \code
+/// cpp3ds::RenderStates states(cpp3ds::BlendNone);
+/// states.layer = 2;
+/// window.draw(panel, states);
+/// \endcode
+///
+/// A distance field threshold makes the target turn the alpha
+/// of the texture, a signed distance field such as the glyphs
+/// of a distance field cpp3ds::Font, into coverage around that
+/// threshold. cpp3ds::Text sets it, so it is kept along with
+/// the other states when the draw is depth sorted.
+///
 /// \see cpp3ds::RenderTarget, cpp3ds::Drawable
 ///
 ////////////////////////////////////////////////////////////
@@ -34,6 +34,7 @@
 #include <cpp3ds/Graphics/PrimitiveType.hpp>
 #include <cpp3ds/Graphics/Vertex.hpp>
 #include <cpp3ds/System/NonCopyable.hpp>
+#include <vector>
 #ifndef EMULATION
 #include <citro3d.h>
 #endif
@@ -43,6 +44,11 @@ namespace cpp3ds
 {
 class Drawable;
 
+namespace priv
+{
+    struct DepthDraw;
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief Base class for all render targets (window, texture, ...)
 ///
@@ -256,6 +262,45 @@ public :
     ////////////////////////////////////////////////////////////
     virtual Vector2u getSize() const = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Start recording draws to submit them sorted by layer
+    ///
+    /// Until endDepthSorting is called, draws aren't submitted
+    /// but recorded, with the vertices they point to, which must
+    /// stay alive until then. The layer of their render states
+    /// decides which ones are in front, and within a layer the
+    /// ones drawn last are. Everything a draw needs, including
+    /// the distance field threshold of cpp3ds::Text, must be in
+    /// its render states, as it is applied when submitted.
+    ///
+    /// The depth buffer must have been cleared by clear() since
+    /// the previous depth sorted pass.
+    ///
+    /// \see endDepthSorting, RenderStates::layer
+    ///
+    ////////////////////////////////////////////////////////////
+    void beginDepthSorting();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Submit the draws recorded since beginDepthSorting
+    ///
+    /// Opaque draws, the ones using BlendNone, are submitted
+    /// first, front to back, with depth test and write enabled,
+    /// so that the pixels they hide behind each other are only
+    /// filled once. Translucent draws follow, back to front,
+    /// tested against the opaque ones' depth without writing it.
+    ///
+    /// \see beginDepthSorting
+    ///
+    ////////////////////////////////////////////////////////////
+    void endDepthSorting();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether draws are being recorded for depth sorting
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isDepthSorting() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Save the current OpenGL render states and matrices
     ///
@@ -326,6 +371,26 @@ public :
 
 #ifndef EMULATION
 	C3D_RenderTarget* getCitroTarget();
+#else
+    ////////////////////////////////////////////////////////////
+    /// \brief Show overdraw instead of the drawn colors
+    ///
+    /// Each fragment that passes the depth test adds 1 to the
+    /// red channel of the pixel, and a brighter green and blue,
+    /// untextured and whatever the blend mode, so that the
+    /// screens show how many times each pixel is filled and
+    /// the red channel counts it exactly.
+    ///
+    /// \param visible True to show overdraw
+    ///
+    ////////////////////////////////////////////////////////////
+    static void setOverdrawVisible(bool visible);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether overdraw is shown
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isOverdrawVisible();
 #endif
 
 protected :
@@ -347,6 +412,13 @@ protected :
 
 private:
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Submit a draw to the GPU
+    ///
+    ////////////////////////////////////////////////////////////
+    void submit(const Vertex* vertices, unsigned int vertexCount,
+                PrimitiveType type, const RenderStates& states);
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply the current view
     ///
@@ -377,6 +449,15 @@ private:
     ////////////////////////////////////////////////////////////
     void applyTransform(const Transform& transform);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the depth test
+    ///
+    /// \param test  True to reject the fragments behind the depth buffer
+    /// \param write True to write the depth of the fragments drawn
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyDepthTest(bool test, bool write);
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply a new texture
     ///
@@ -393,6 +474,20 @@ private:
     ////////////////////////////////////////////////////////////
     void applyShader(const Shader* shader);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply a new distance field threshold
+    ///
+    /// Sets up the texture combiners so that the alpha of the
+    /// bound texture, a signed distance field, is turned into
+    /// coverage ramping around \a threshold. A threshold of 0
+    /// restores the combiners of ordinary textures.
+    ///
+    /// \param threshold     Edge of the distance field, or 0
+    /// \param pixelsPerUnit Screen pixels over which the field goes from 0 to 1
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyDistanceField(float threshold, float pixelsPerUnit);
+
     ////////////////////////////////////////////////////////////
     /// \brief Activate the target for rendering
     ///
@@ -430,6 +525,9 @@ private:
     View        m_defaultView; ///< Default view
     View        m_view;        ///< Current view
     StatesCache m_cache;       ///< Render states cache
+    bool        m_depthSorting; ///< Are draws recorded for depth sorting?
+    float       m_depth;        ///< Z coordinate of the draws submitted, 0 outside of depth sorting
+    std::vector<priv::DepthDraw>* m_depthDraws; ///< Draws recorded for depth sorting, created when first needed
 
 protected:
 #ifndef EMULATION
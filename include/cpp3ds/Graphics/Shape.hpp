@@ -32,6 +32,7 @@
 #include <cpp3ds/Graphics/Transformable.hpp>
 #include <cpp3ds/Graphics/VertexArray.hpp>
 #include <cpp3ds/System/Vector2.hpp>
+#include <vector>
 
 
 namespace cpp3ds
@@ -257,7 +258,21 @@ protected :
     ////////////////////////////////////////////////////////////
     void update();
 
-private :
+    ////////////////////////////////////////////////////////////
+    /// \brief Scale the shape's points without recomputing its geometry
+    ///
+    /// The derived class can call this instead of update() when
+    /// all its points were scaled from the origin by the same
+    /// factor since the last update(), like a circle whose radius
+    /// changed. The fill isn't touched, the scale is applied by the
+    /// transform it is drawn with; only the outline is moved, so
+    /// that it keeps its thickness.
+    ///
+    /// \param scale Factor between the current points and those of
+    ///              the last update(), must be positive
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateScale(float scale);
 
     ////////////////////////////////////////////////////////////
     /// \brief Draw the shape to a render target
@@ -268,6 +283,8 @@ private :
     ////////////////////////////////////////////////////////////
     virtual void draw(RenderTarget& target, RenderStates states) const;
 
+private :
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the fill vertices' color
     ///
@@ -283,9 +300,17 @@ private :
     ////////////////////////////////////////////////////////////
     /// \brief Update the outline vertices' position
     ///
+    /// Nothing is built while the outline has no thickness.
+    ///
     ////////////////////////////////////////////////////////////
     void updateOutline();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the extrusion direction of each point
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateOutlineNormals();
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the outline vertices' color
     ///
@@ -297,15 +322,18 @@ private :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    const Texture* m_texture;          ///< Texture of the shape
-    IntRect        m_textureRect;      ///< Rectangle defining the area of the source texture to display
-    Color          m_fillColor;        ///< Fill color
-    Color          m_outlineColor;     ///< Outline color
-    float          m_outlineThickness; ///< Thickness of the shape's outline
-    VertexArray    m_vertices;         ///< Vertex array containing the fill geometry
-    VertexArray    m_outlineVertices;  ///< Vertex array containing the outline geometry
-    FloatRect      m_insideBounds;     ///< Bounding rectangle of the inside (fill)
-    FloatRect      m_bounds;           ///< Bounding rectangle of the whole shape (outline + fill)
+    const Texture*        m_texture;                  ///< Texture of the shape
+    IntRect               m_textureRect;              ///< Rectangle defining the area of the source texture to display
+    Color                 m_fillColor;                ///< Fill color
+    Color                 m_outlineColor;             ///< Outline color
+    float                 m_outlineThickness;         ///< Thickness of the shape's outline
+    VertexArray           m_vertices;                 ///< Vertex array containing the fill geometry
+    VertexArray           m_outlineVertices;          ///< Vertex array containing the outline geometry
+    FloatRect             m_insideBounds;             ///< Bounding rectangle of the inside (fill), before scaling
+    FloatRect             m_bounds;                   ///< Bounding rectangle of the whole shape (outline + fill)
+    float                 m_scale;                    ///< Scale of the points since the last update
+    std::vector<Vector2f> m_outlineNormals;           ///< Extrusion direction of each point
+    bool                  m_outlineNormalsNeedUpdate; ///< Do the extrusion directions need to be computed again?
 };
 
 }
@@ -342,6 +370,13 @@ private :
 /// \li getPointCount must return the number of points of the shape
 /// \li getPoint must return the points of the shape
 ///
+/// The geometry is only rebuilt when the points change. Colors
+/// and the texture rectangle only update the vertices' colors
+/// and texture coordinates, the outline thickness only moves the
+/// outline along directions computed once per geometry, and a
+/// derived class whose points are just scaled can call
+/// updateScale() to have the transform do the work.
+///
 /// \see cpp3ds::RectangleShape, cpp3ds::CircleShape, cpp3ds::ConvexShape, cpp3ds::Transformable
 ///
 ////////////////////////////////////////////////////////////
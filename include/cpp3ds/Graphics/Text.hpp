@@ -31,6 +31,7 @@
 #include <cpp3ds/Graphics/Drawable.hpp>
 #include <cpp3ds/Graphics/Transformable.hpp>
 #include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/Graphics/TextLayout.hpp>
 #include <cpp3ds/Graphics/Rect.hpp>
 #include <cpp3ds/Graphics/VertexArray.hpp>
 #include <cpp3ds/System/String.hpp>
@@ -201,6 +202,40 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         void setOutlineThickness(float thickness);
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Set the width the text's lines are wrapped at
+        ///
+        /// By default, the wrap width is 0 and lines only break at
+        /// line feeds.
+        ///
+        /// \param width New wrap width, in pixels
+        ///
+        /// \see TextLayout::setWrapWidth
+        ///
+        ////////////////////////////////////////////////////////////
+        void setWrapWidth(float width);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Set the maximum number of lines shown
+        ///
+        /// Text past the last line is replaced with an ellipsis.
+        /// By default, the number of lines isn't limited (0).
+        ///
+        /// \param lines New maximum number of lines
+        ///
+        /// \see TextLayout::setMaxLines
+        ///
+        ////////////////////////////////////////////////////////////
+        void setMaxLines(unsigned int lines);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Set the string ending truncated text
+        ///
+        /// \param ellipsis New ellipsis, "..." by default
+        ///
+        ////////////////////////////////////////////////////////////
+        void setEllipsis(const String& ellipsis);
+
         ////////////////////////////////////////////////////////////
         /// \brief Get the text's string
         ///
@@ -284,6 +319,19 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         float getOutlineThickness() const;
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the layout of the text
+        ///
+        /// The layout gives the size, lines and character positions
+        /// of the text from the font's metrics. Unlike getLocalBounds,
+        /// it doesn't build the text's geometry, and the geometry
+        /// reuses it when the text is drawn.
+        ///
+        /// \return Layout of the text, in local coordinates
+        ///
+        ////////////////////////////////////////////////////////////
+        const TextLayout& getLayout() const;
+
         ////////////////////////////////////////////////////////////
         /// \brief Return the position of the \a index-th character
         ///
@@ -364,13 +412,15 @@ namespace cpp3ds
         Color               m_fillColor;          ///< Text fill color
         Color               m_outlineColor;       ///< Text outline color
         float               m_outlineThickness;   ///< Thickness of the text's outline
+        TextLayout          m_layout;             ///< Positions of the characters, computed on demand
         mutable VertexArray m_vertices;           ///< Vertex array containing the fill geometry
         mutable VertexArray m_outlineVertices;    ///< Vertex array containing the outline geometry
         mutable FloatRect   m_bounds;             ///< Bounding rectangle of the text (in local coordinates)
         mutable bool        m_geometryNeedUpdate; ///< Does the geometry need to be recomputed?
         bool                m_useSystemFont;      ///< Flag to use 3DS system font
+        mutable unsigned int m_fontUpdateCount;   ///< Font's update count when the geometry was built
 #ifndef EMULATION
-        mutable std::vector<Uint16> m_systemGlyphTextures;
+        mutable std::vector<std::pair<Uint16, Uint32> > m_systemGlyphSheets; ///< System font sheets, with the number of vertices drawn from each
 #endif
     };
 
@@ -0,0 +1,249 @@
+#ifndef CPP3DS_TEXTLAYOUT_HPP
+#define CPP3DS_TEXTLAYOUT_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/System/String.hpp>
+#include <cpp3ds/System/Vector2.hpp>
+#include <vector>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Positions of the characters of a string, with line
+///        wrapping and truncation, computed from glyph metrics
+///
+////////////////////////////////////////////////////////////
+class TextLayout
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief A laid out character
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Character
+    {
+        Uint32   codePoint; ///< Unicode code point of the character
+        Vector2f position;  ///< Pen position, the top of its line being at y
+        float    advance;   ///< Horizontal space taken, kerning with the next character aside
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief A laid out line
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Line
+    {
+        std::size_t begin; ///< Index of the line's first character in getCharacters()
+        std::size_t end;   ///< Index past the line's last character
+        float       top;   ///< Y position of the top of the line
+        float       width; ///< Width of the line, without the space it was wrapped at
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Lays out nothing until a font is set.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextLayout();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the layout of a string
+    ///
+    ////////////////////////////////////////////////////////////
+    TextLayout(const String& string, const Font& font, unsigned int characterSize = 30);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the string to lay out
+    ///
+    ////////////////////////////////////////////////////////////
+    void setString(const String& string);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the font giving the metrics
+    ///
+    /// The font isn't copied and must outlive the layout.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setFont(const Font& font);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the character size, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void setCharacterSize(unsigned int size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set whether characters are bold
+    ///
+    /// It is the only style changing the advances.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBold(bool bold);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the width lines are wrapped at
+    ///
+    /// Lines are broken at the last space or tab that fits, or
+    /// before the character that overflows when a word is wider
+    /// than the whole line. 0, the default, disables wrapping.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setWrapWidth(float width);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the maximum number of lines
+    ///
+    /// The text past the last line is cut, and the ellipsis is
+    /// added to the last line, which is shortened to keep it
+    /// within the wrap width. 0, the default, allows any number
+    /// of lines.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setMaxLines(unsigned int lines);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the string ending truncated text
+    ///
+    /// "..." by default.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setEllipsis(const String& ellipsis);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the laid out characters
+    ///
+    /// They are the characters of the string up to where it was
+    /// truncated, followed by those of the ellipsis if it was.
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Character>& getCharacters() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the laid out lines
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Line>& getLines() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of characters of the string shown
+    ///
+    /// It is the string's size unless the text is truncated.
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getVisibleCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the text was truncated
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isTruncated() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the width of the widest line and the height
+    ///        of all the lines
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2f getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the position of the \a index-th character
+    ///
+    /// Hidden characters of a truncated text are at the ellipsis,
+    /// and an \a index out of range gives the end of the text.
+    ///
+    /// \param index Index of the character in the string
+    ///
+    /// \return Pen position of the character, in local coordinates
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2f findCharacterPos(std::size_t index) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Lay the text out if it changed
+    ///
+    ////////////////////////////////////////////////////////////
+    void ensureUpdate() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the advance of a character, whitespace included
+    ///
+    ////////////////////////////////////////////////////////////
+    float getAdvance(Uint32 codePoint, float hspace) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Close the current line and start the next one
+    ///
+    /// \param end         Index past the line's last character
+    /// \param width       Width of the line
+    /// \param lineSpacing Distance between two lines
+    ///
+    /// \return False if the line limit was reached
+    ///
+    ////////////////////////////////////////////////////////////
+    bool newLine(std::size_t end, float width, float lineSpacing) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Cut the text at the end of the last line and add
+    ///        the ellipsis
+    ///
+    ////////////////////////////////////////////////////////////
+    void truncate(float hspace) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    String                         m_string;          ///< String to lay out
+    const Font*                    m_font;            ///< Font giving the metrics
+    unsigned int                   m_characterSize;   ///< Base size of characters, in pixels
+    bool                           m_bold;            ///< Are the characters bold?
+    float                          m_wrapWidth;       ///< Width lines are wrapped at, 0 for none
+    unsigned int                   m_maxLines;        ///< Maximum number of lines, 0 for no limit
+    String                         m_ellipsis;        ///< String ending truncated text
+    mutable std::vector<Character> m_characters;      ///< Laid out characters
+    mutable std::vector<Line>      m_lines;           ///< Laid out lines
+    mutable std::size_t            m_visibleCount;    ///< Number of characters of the string shown
+    mutable Vector2f               m_size;            ///< Size of the laid out text
+    mutable bool                   m_needUpdate;      ///< Does the layout need to be computed again?
+    mutable unsigned int           m_fontUpdateCount; ///< Font's update count when the text was laid out
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTLAYOUT_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::TextLayout
+/// \ingroup graphics
+///
+/// Laying out a UI only needs to know how large a text is, where
+/// its lines break and where its characters are, all of which
+/// come from glyph advances and kerning. TextLayout computes just
+/// that, without rasterizing vertices, and keeps the result until
+/// the string, font or one of the settings changes.
+///
+/// cpp3ds::Text lays its string out with a TextLayout too, and
+/// builds its vertices from it when it is drawn, so measuring a
+/// Text with getLayout() doesn't build its geometry either.
+///
+/// \code
+/// cpp3ds::TextLayout layout(description, font, 14);
+/// layout.setWrapWidth(300);
+/// layout.setMaxLines(3);
+///
+/// panel.setSize(cpp3ds::Vector2f(300, layout.getSize().y));
+/// cpp3ds::Vector2f cursor = layout.findCharacterPos(selection);
+/// \endcode
+///
+/// \see cpp3ds::Text, cpp3ds::Font
+///
+////////////////////////////////////////////////////////////
@@ -33,6 +33,26 @@
 #include <cpp3ds/Window/GlResource.hpp>
 #ifndef EMULATION
 #include <citro3d.h>
+#else
+// Mirror of ctrulib's texture color formats, so preprocessed
+// textures can be decoded by the emulator and test builds
+typedef enum
+{
+    GPU_RGBA8    = 0x0,
+    GPU_RGB8     = 0x1,
+    GPU_RGBA5551 = 0x2,
+    GPU_RGB565   = 0x3,
+    GPU_RGBA4    = 0x4,
+    GPU_LA8      = 0x5,
+    GPU_HILO8    = 0x6,
+    GPU_L8       = 0x7,
+    GPU_A8       = 0x8,
+    GPU_LA4      = 0x9,
+    GPU_L4       = 0xA,
+    GPU_A4       = 0xB,
+    GPU_ETC1     = 0xC,
+    GPU_ETC1A4   = 0xD
+} GPU_TEXCOLOR;
 #endif
 
 
@@ -88,15 +108,24 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Create the texture
     ///
+    /// The \a format argument selects how texels are stored in
+    /// VRAM. Lower bit depths such as GPU_RGB565, GPU_RGBA5551,
+    /// GPU_RGBA4, GPU_LA8, GPU_A8 and GPU_A4 save memory; pixels
+    /// given to update() are still RGBA and are converted on upload.
+    /// Alpha-only formats take their color from the vertices.
+    /// Compressed formats can only be loaded with
+    /// loadFromPreprocessedFile.
+    ///
     /// If this function fails, the texture is left unchanged.
     ///
     /// \param width  Width of the texture
     /// \param height Height of the texture
+    /// \param format Pixel format of the texture
     ///
     /// \return True if creation was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool create(unsigned int width, unsigned int height);
+    bool create(unsigned int width, unsigned int height, GPU_TEXCOLOR format = GPU_RGBA8);
 
     ////////////////////////////////////////////////////////////
     /// \brief Load the texture from a file on disk
@@ -216,11 +245,24 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadFromImage(const Image& image, const IntRect& area = IntRect());
 
-#ifndef EMULATION
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from a file produced by tex_compile.py
+    ///
+    /// The file holds a small header followed by texture data
+    /// already tiled in the native 3DS layout, in any GPU_TEXCOLOR
+    /// format including the ETC1/ETC1A4 compressed ones. On the
+    /// 3DS it is uploaded as-is; the emulator decodes it in software.
+    ///
+    /// \param filename Path of the preprocessed texture file
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
     bool loadFromPreprocessedFile(const std::string& filename);
     bool loadFromPreprocessedFile(const std::string& filename, size_t width, size_t height, GPU_TEXCOLOR format);
     bool loadFromPreprocessedMemory(void *data, size_t size, size_t width, size_t height, GPU_TEXCOLOR format, bool copyData = true);
 
+#ifndef EMULATION
     C3D_Tex* getNativeTexture() { return m_texture; }
 #endif
 
@@ -421,6 +463,33 @@ public :
     ////////////////////////////////////////////////////////////
     bool isRepeated() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the pixel format the texture is stored in
+    ///
+    /// \return Format of the texture
+    ///
+    /// \see create
+    ///
+    ////////////////////////////////////////////////////////////
+    GPU_TEXCOLOR getFormat() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate a mipmap using the current texture data
+    ///
+    /// Each level is a 2x2 box downsample of the previous one,
+    /// computed on the CPU and stored in the texture's format,
+    /// down to 8x8. Mipmaps reduce shimmering and texture cache
+    /// misses when the texture is drawn smaller than its size.
+    ///
+    /// The mipmap is invalidated by update(), call this function
+    /// again afterwards to regenerate it. Compressed textures
+    /// aren't supported.
+    ///
+    /// \return True if mipmap generation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool generateMipmap();
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of assignment operator
     ///
@@ -480,6 +549,7 @@ private :
 
     friend class RenderTexture;
     friend class RenderTarget;
+    friend class TextureManager;
 
     ////////////////////////////////////////////////////////////
     /// \brief Get a valid image size according to hardware support
@@ -496,6 +566,22 @@ private :
     ////////////////////////////////////////////////////////////
     static unsigned int getValidSize(unsigned int size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop sampling from the mipmap levels
+    ///
+    /// Called when level 0 changes, as the levels are now stale.
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidateMipmap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Free the pixels, keeping the size and settings
+    ///
+    /// Used by TextureManager to evict textures it can reload.
+    ///
+    ////////////////////////////////////////////////////////////
+    void unload();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
@@ -505,6 +591,9 @@ private :
     bool         m_isRepeated;    ///< Is the texture in repeat mode?
     mutable bool m_pixelsFlipped; ///< To work around the inconsistency in Y orientation
     Uint64       m_cacheId;       ///< Unique number that identifies the texture to the render target's cache
+    GPU_TEXCOLOR m_format;        ///< Pixel format of the texture
+    bool         m_hasMipmap;     ///< Has the mipmap been generated?
+    bool         m_isManaged;     ///< Is the texture registered with TextureManager?
 #ifdef EMULATION
     unsigned int m_texture;       ///< Internal texture identifier
 #else
@@ -0,0 +1,178 @@
+#ifndef CPP3DS_TEXTUREATLAS_HPP
+#define CPP3DS_TEXTUREATLAS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cpp3ds
+{
+class Image;
+class InputStream;
+class Sprite;
+
+////////////////////////////////////////////////////////////
+/// \brief Set of named images packed into a few texture pages
+///
+////////////////////////////////////////////////////////////
+class TextureAtlas : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Named area of a page
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Region
+    {
+        const Texture* texture; ///< Page holding the image
+        IntRect        rect;    ///< Area of the image in the page
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load an atlas produced by compile_atlas()
+    ///
+    /// \see scripts/atlas_pack.py
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load an atlas from a file in memory
+    ///
+    /// \see loadFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromMemory(const void* data, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load an atlas from a stream
+    ///
+    /// \see loadFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromStream(InputStream& stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pack images into an atlas at runtime
+    ///
+    /// Uses the same packing as the host tool, for images that
+    /// aren't known at build time.
+    ///
+    /// \param images  Images to pack, by name
+    /// \param format  Pixel format of the pages
+    /// \param padding Empty pixels kept between images
+    ///
+    /// \return True if all images were packed
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromImages(const std::map<std::string, Image>& images, GPU_TEXCOLOR format = GPU_RGBA8, unsigned int padding = 1);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find an image by name
+    ///
+    /// \return Region of the image, or NULL if there is none
+    ///
+    ////////////////////////////////////////////////////////////
+    const Region* findRegion(const std::string& name) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set a sprite's texture and texture rect to an image
+    ///
+    /// \return False, leaving the sprite untouched, if there is
+    ///         no image by that name
+    ///
+    ////////////////////////////////////////////////////////////
+    bool applyTo(Sprite& sprite, const std::string& name) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of images in the atlas
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getRegionCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of texture pages
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPageCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a texture page
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getPage(unsigned int index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the smooth filter on all pages
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSmooth(bool smooth);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all pages and regions
+    ///
+    ////////////////////////////////////////////////////////////
+    void cleanup();
+
+    typedef std::unordered_map<std::string, Region> RegionTable;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<std::unique_ptr<Texture>> m_pages;   ///< Texture pages
+    RegionTable                           m_regions; ///< Regions by name
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTUREATLAS_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::TextureAtlas
+/// \ingroup graphics
+///
+/// Giving every sprite its own texture wastes the padding up to
+/// the next power of two, and changes texture between every
+/// draw. An atlas packs many images into a few pages, so sprites
+/// sharing a page can go into one VertexArray and be drawn at
+/// once.
+///
+/// Atlases are built on the host from a directory of images:
+/// \code
+/// compile_atlas(ATLASES ${PROJECT_BINARY_DIR}/romfs/sprites.atlas etc1a4 ${PROJECT_SOURCE_DIR}/res/sprites)
+/// \endcode
+///
+/// and looked up by file name, without the extension:
+/// \code
+/// cpp3ds::TextureAtlas atlas;
+/// atlas.loadFromFile("sprites.atlas");
+///
+/// cpp3ds::Sprite player;
+/// atlas.applyTo(player, "player/idle");
+/// \endcode
+///
+/// \see cpp3ds::Texture, cpp3ds::Sprite
+///
+////////////////////////////////////////////////////////////
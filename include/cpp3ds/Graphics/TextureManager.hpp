@@ -0,0 +1,257 @@
+#ifndef CPP3DS_TEXTUREMANAGER_HPP
+#define CPP3DS_TEXTUREMANAGER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <functional>
+#include <map>
+#include <string>
+
+
+namespace cpp3ds
+{
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Keeps registered textures within a memory budget,
+///        evicting the least recently bound ones
+///
+////////////////////////////////////////////////////////////
+class TextureManager : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function (re)loading a texture's pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef std::function<bool(Texture&)> Loader;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Residency counters
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Stats
+    {
+        Uint32       hits;          ///< Binds of textures that were resident
+        Uint32       misses;        ///< Binds that had to reload the texture
+        Uint32       evictions;     ///< Textures freed to stay within the budget
+        std::size_t  residentBytes; ///< Memory used by resident textures
+        unsigned int residentCount; ///< Number of resident textures
+        unsigned int textureCount;  ///< Number of registered textures
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the manager
+    ///
+    ////////////////////////////////////////////////////////////
+    static TextureManager& getInstance();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a texture from a file and manage it
+    ///
+    /// Files ending in ".tex" are loaded with
+    /// Texture::loadFromPreprocessedFile, others with
+    /// Texture::loadFromFile.
+    ///
+    /// \param texture  Texture to manage, must outlive its registration
+    /// \param filename Path of the file to (re)load from
+    /// \param priority Textures with a lower priority are evicted first
+    ///
+    /// \return True if the texture was loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    bool addFromFile(Texture& texture, const std::string& filename, int priority = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a texture from an image file in memory and manage it
+    ///
+    /// The data isn't copied and must stay valid while the
+    /// texture is registered.
+    ///
+    /// \see addFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool addFromMemory(Texture& texture, const void* data, std::size_t size, int priority = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a texture with a callback and manage it
+    ///
+    /// The loader is called now, and again each time the texture
+    /// is bound after being evicted.
+    ///
+    /// \see addFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool add(Texture& texture, const Loader& loader, int priority = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop managing a texture
+    ///
+    /// The texture is left as it is, resident or not. This is
+    /// done automatically when a managed texture is destroyed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the memory managed textures may use, in bytes
+    ///
+    /// Evicts textures right away if needed. There is no limit
+    /// by default.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBudget(std::size_t bytes);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the memory budget, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getBudget() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a managed texture is currently loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isResident(const Texture& texture) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark the end of a frame
+    ///
+    /// Textures bound during the current frame may still be read
+    /// by the GPU and are never evicted, even when this means
+    /// going over budget. Game calls this after each frame; apps
+    /// driving their own loop call it after presenting.
+    ///
+    ////////////////////////////////////////////////////////////
+    void endFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the residency counters
+    ///
+    ////////////////////////////////////////////////////////////
+    Stats getStats() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset hits, misses and evictions to zero
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetStats();
+
+private :
+
+    friend class Texture;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Registered texture
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        Texture*    texture;  ///< Managed texture
+        Loader      loader;   ///< Reloads the texture after eviction
+        int         priority; ///< Lower priorities are evicted first
+        std::size_t bytes;    ///< Memory used when resident
+        Uint64      lastUse;  ///< Value of m_useCounter when last bound
+        bool        resident; ///< Is the texture loaded?
+        bool        mipmap;   ///< Must the mipmap be generated again after a reload?
+    };
+
+    typedef std::map<const Texture*, Entry> EntryMap;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureManager();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureManager();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a bind, reloading the texture if evicted
+    ///
+    /// Called by Texture::bind for managed textures.
+    ///
+    ////////////////////////////////////////////////////////////
+    void use(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a mipmap generated for a texture
+    ///
+    /// Called by Texture::generateMipmap for managed textures,
+    /// so that the mipmap's memory is accounted for, and the
+    /// mipmap generated again whenever the texture is reloaded.
+    ///
+    ////////////////////////////////////////////////////////////
+    void addMipmap(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Run an entry's loader and account for its memory
+    ///
+    ////////////////////////////////////////////////////////////
+    bool load(Entry& entry);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Evict textures until \a bytes more fit in the budget
+    ///
+    /// \param bytes Memory about to be used
+    /// \param keep  Texture that must not be evicted
+    ///
+    ////////////////////////////////////////////////////////////
+    void makeRoom(std::size_t bytes, const Texture* keep);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    EntryMap    m_entries;       ///< Managed textures
+    std::size_t m_budget;        ///< Memory allowed for resident textures
+    std::size_t m_residentBytes; ///< Memory used by resident textures
+    Uint64      m_useCounter;    ///< Incremented on each bind
+    Uint64      m_frameStart;    ///< Value of m_useCounter when the frame began
+    Uint32      m_hits;          ///< Binds of resident textures
+    Uint32      m_misses;        ///< Binds that reloaded a texture
+    Uint32      m_evictions;     ///< Textures evicted
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTUREMANAGER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::TextureManager
+/// \ingroup graphics
+///
+/// VRAM and the linear heap fill up quickly when a game keeps
+/// every texture loaded. Textures registered here remember where
+/// they came from, so when the total goes over the budget the
+/// ones bound least recently are freed, and they are loaded
+/// again the next time they are drawn. An evicted texture keeps
+/// its size and settings, so sprites using it need no changes.
+///
+/// \code
+/// cpp3ds::TextureManager& manager = cpp3ds::TextureManager::getInstance();
+/// manager.setBudget(4 * 1024 * 1024);
+///
+/// cpp3ds::Texture background, hud;
+/// manager.addFromFile(background, "background.tex");
+/// manager.addFromFile(hud, "hud.png", 10); // evicted last
+///
+/// cpp3ds::TextureManager::Stats stats = manager.getStats();
+/// std::cout << stats.misses << " reloads" << std::endl;
+/// \endcode
+///
+/// Reloads happen while drawing, from the thread that draws.
+/// The manager isn't thread safe.
+///
+/// \see cpp3ds::Texture
+///
+////////////////////////////////////////////////////////////
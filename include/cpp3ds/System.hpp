@@ -10,6 +10,7 @@
 #include <cpp3ds/System/InputStream.hpp>
 #include <cpp3ds/System/Lock.hpp>
 #include <cpp3ds/System/Mutex.hpp>
+#include <cpp3ds/System/Semaphore.hpp>
 #include <cpp3ds/System/Sleep.hpp>
 #include <cpp3ds/System/String.hpp>
 #include <cpp3ds/System/Service.hpp>
@@ -0,0 +1,116 @@
+#ifndef CPP3DS_SEMAPHORE_HPP
+#define CPP3DS_SEMAPHORE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/System/NonCopyable.hpp>
+#ifdef EMULATION
+#include <pthread.h>
+#else
+#include <3ds.h>
+#endif
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Counter that threads can wait on until it is
+///        above zero
+///
+////////////////////////////////////////////////////////////
+class Semaphore : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// \param count Initial value of the counter
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit Semaphore(unsigned int count = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Semaphore();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until the counter is above zero, then
+    ///        decrement it
+    ///
+    /// The thread sleeps while it waits, without polling.
+    ///
+    /// \see post
+    ///
+    ////////////////////////////////////////////////////////////
+    void wait();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Increment the counter, waking a waiting thread
+    ///
+    /// \see wait
+    ///
+    ////////////////////////////////////////////////////////////
+    void post();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+#ifdef EMULATION
+    pthread_mutex_t m_mutex;     ///< Protects the counter
+    pthread_cond_t  m_condition; ///< Signalled when the counter is incremented
+    unsigned int    m_count;     ///< Value of the counter
+#else
+    Handle          m_semaphore; ///< Kernel handle of the semaphore
+#endif
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_SEMAPHORE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::Semaphore
+/// \ingroup system
+///
+/// A semaphore lets a thread sleep until another one has work
+/// for it, instead of waking up every few milliseconds to look.
+/// Each call to post() lets exactly one call to wait() through,
+/// whether it was made before or after.
+///
+/// Usage example:
+/// \code
+/// cpp3ds::Mutex mutex;
+/// cpp3ds::Semaphore pending;
+/// std::deque<Job> jobs;
+///
+/// void producer(const Job& job)
+/// {
+///     {
+///         cpp3ds::Lock lock(mutex);
+///         jobs.push_back(job);
+///     }
+///     pending.post();
+/// }
+///
+/// void worker()
+/// {
+///     for (;;)
+///     {
+///         pending.wait(); // sleeps until a job was pushed
+///         cpp3ds::Lock lock(mutex);
+///         ...
+///     }
+/// }
+/// \endcode
+///
+/// \see cpp3ds::Mutex
+///
+////////////////////////////////////////////////////////////
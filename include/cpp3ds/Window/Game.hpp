@@ -37,6 +37,8 @@ private:
 #ifdef EMULATION
 	sf::RenderTexture m_frameTextureTop, m_frameTextureBottom;
 	sf::Sprite m_frameSpriteTop, m_frameSpriteBottom;
+	Uint64 m_overdrawFragments; ///< Fragments counted while showing overdraw, since the last report
+	unsigned int m_overdrawFrames;
 #else
 	Shader m_shader;
 #endif
@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+# Encodes 16-bit WAV files as DSP-ADPCM for SoundBuffer::loadFromFile(), which keeps mono
+# files compressed for the DSP to decode (stereo ones are decoded when loaded).
+# Output is a "DSPA" header (channel count and a reserved u16, sample rate and samples per
+# channel as u32), 40 bytes per channel (16 s16 coefficients, the first frame header as u16,
+# two s16 history samples and padding) and then the 8 byte frames of the channels,
+# interleaved frame by frame. All numbers are little-endian.
+import sys, struct, getopt, wave
+
+FRAME_SAMPLES = 14
+PREDICTORS = 8
+MAX_SCALE = 12
+KMEANS_PASSES = 8
+
+def clamp16(v):
+	return -32768 if v < -32768 else (32767 if v > 32767 else v)
+
+def read_wav(filename):
+	w = wave.open(filename, 'rb')
+	channels, width, rate, count = w.getnchannels(), w.getsampwidth(), w.getframerate(), w.getnframes()
+	data = w.readframes(count)
+	w.close()
+	if channels not in (1, 2):
+		print('%s: only mono and stereo sounds are supported' % filename)
+		sys.exit(1)
+	if width == 2:
+		samples = list(struct.unpack('<%dh' % (count * channels), data))
+	elif width == 1:
+		samples = [(ord(data[i:i + 1]) - 128) << 8 for i in range(count * channels)]
+	else:
+		print('%s: only 8 and 16-bit sounds are supported' % filename)
+		sys.exit(1)
+	return rate, [samples[c::channels] for c in range(channels)]
+
+def block_predictor(samples, start):
+	# Least squares second order predictor of a frame, with its energy as weight
+	r11 = r12 = r22 = r01 = r02 = 0.0
+	for i in range(start, min(start + FRAME_SAMPLES, len(samples))):
+		x = samples[i]
+		h1 = samples[i - 1] if i >= 1 else 0
+		h2 = samples[i - 2] if i >= 2 else 0
+		r11 += h1 * h1
+		r12 += h1 * h2
+		r22 += h2 * h2
+		r01 += x * h1
+		r02 += x * h2
+	det = r11 * r22 - r12 * r12
+	if r11 <= 0 or abs(det) < 1e-9 * r11 * r22:
+		return (r01 / r11 if r11 > 0 else 0.0, 0.0, r11)
+	return ((r01 * r22 - r02 * r12) / det, (r02 * r11 - r01 * r12) / det, r11)
+
+def stable(c1, c2):
+	# Keep the predictor stable and within the 5.11 fixed point range
+	c2 = max(-0.99, min(0.99, c2))
+	c1 = max(-(1 + c2) * 0.99, min((1 + c2) * 0.99, c1))
+	return (c1, c2)
+
+def design_coefficients(samples):
+	# Clusters the predictors of the frames into 8 pairs, weighted by energy
+	blocks = [block_predictor(samples, start) for start in range(0, len(samples), FRAME_SAMPLES)]
+	blocks = [(stable(c1, c2), w) for c1, c2, w in blocks if w > 0]
+	centers = [(0.0, 0.0), (1.0, 0.0), (2.0, -1.0), (1.5, -0.6), (0.5, 0.0), (1.8, -0.85), (1.2, -0.3), (-0.5, 0.0)]
+	for _ in range(KMEANS_PASSES):
+		sums = [[0.0, 0.0, 0.0] for _ in centers]
+		for (c1, c2), w in blocks:
+			k = min(range(PREDICTORS), key=lambda j: (centers[j][0] - c1) ** 2 + (centers[j][1] - c2) ** 2)
+			sums[k][0] += c1 * w
+			sums[k][1] += c2 * w
+			sums[k][2] += w
+		centers = [stable(s[0] / s[2], s[1] / s[2]) if s[2] > 0 else centers[k] for k, s in enumerate(sums)]
+	coefficients = []
+	for c1, c2 in centers:
+		coefficients += [int(round(c1 * 2048)), int(round(c2 * 2048))]
+	return coefficients
+
+def encode_frame(samples, c1, c2, scale, h1, h2):
+	# Encodes a frame the way it will be decoded, returns (error, nibbles, h1, h2)
+	error = 0
+	nibbles = []
+	step = 1 << scale
+	for x in samples:
+		prediction = c1 * h1 + c2 * h2 + 1024
+		n = int(round((x * 2048 - prediction) / float(step * 2048)))
+		n = -8 if n < -8 else (7 if n > 7 else n)
+		y = clamp16(((n * step) << 11) + prediction >> 11)
+		error += (x - y) * (x - y)
+		nibbles.append(n & 0xF)
+		h2, h1 = h1, y
+	return error, nibbles, h1, h2
+
+def encode_channel(samples, coefficients):
+	frames = []
+	h1 = h2 = 0
+	for start in range(0, len(samples), FRAME_SAMPLES):
+		block = samples[start:start + FRAME_SAMPLES]
+		best = None
+		for p in range(PREDICTORS):
+			c1, c2 = coefficients[p * 2], coefficients[p * 2 + 1]
+			# The scale the open loop residual needs, and the one below it
+			residual = 0
+			r1, r2 = h1, h2
+			for x in block:
+				residual = max(residual, abs(x * 2048 - c1 * r1 - c2 * r2) >> 11)
+				r2, r1 = r1, x
+			scale = 0
+			while scale < MAX_SCALE and (7 << scale) < residual:
+				scale += 1
+			for s in (scale - 1, scale):
+				if s < 0:
+					continue
+				result = encode_frame(block, c1, c2, s, h1, h2)
+				if best is None or result[0] < best[0]:
+					best = result + (p, s)
+		_, nibbles, h1, h2, p, s = best
+		nibbles += [0] * (FRAME_SAMPLES - len(nibbles))
+		frame = [(p << 4) | s] + [(nibbles[i] << 4) | nibbles[i + 1] for i in range(0, FRAME_SAMPLES, 2)]
+		frames.append(struct.pack('8B', *frame))
+	return frames
+
+def compile(filename, output):
+	rate, channels = read_wav(filename)
+	count = len(channels[0])
+	coefficients = [design_coefficients(samples) for samples in channels]
+	frames = [encode_channel(samples, coefs) for samples, coefs in zip(channels, coefficients)]
+
+	with open(output, 'wb') as f:
+		f.write(struct.pack('<4s2H2I', b'DSPA', len(channels), 0, rate, count))
+		for c in range(len(channels)):
+			header = struct.unpack('B', frames[c][0][:1])[0] if frames[c] else 0
+			f.write(struct.pack('<16hH2h2x', *(coefficients[c] + [header, 0, 0])))
+		for i in range(len(frames[0])):
+			for c in range(len(channels)):
+				f.write(frames[c][i])
+
+def show_usage_exit():
+	print('adpcm_compile.py -o <output> <wav>')
+	sys.exit(2)
+
+def main(argv):
+	try:
+		opts, args = getopt.getopt(argv, "ho:")
+	except getopt.GetoptError:
+		show_usage_exit()
+	outfile = None
+	for opt, arg in opts:
+		if opt == '-h':
+			show_usage_exit()
+		elif opt in ("-o", "--output"):
+			outfile = arg
+	if not outfile or len(args) != 1:
+		show_usage_exit()
+	compile(args[0], outfile)
+
+if __name__ == "__main__":
+	main(sys.argv[1:])
@@ -0,0 +1,116 @@
+#!/usr/bin/env python
+# Packs images into texture atlas pages for TextureAtlas::loadFromFile().
+# Output is an "ATLS" header (page count, region count as u16, names length as u32),
+# a page table (format, width, height, reserved as u16, then data offset and length
+# as u32), a region table (page, left, top, width, height, name length as u16), the
+# region names and finally each page encoded like tex_compile.py does.
+# Regions are named after their path relative to the input directory, without the
+# extension. Requires Pillow.
+import os, sys, struct, getopt
+from PIL import Image
+from tex_compile import FORMATS, MAX_TEXTURE_SIZE, next_pow2, encode_region
+
+IMAGE_EXTENSIONS = ('.png', '.jpg', '.jpeg', '.bmp', '.tga', '.gif')
+
+def pack(sizes, max_size, padding):
+	# Shelf packing, tallest first. Mirrors priv::packAtlas in AtlasPacker.cpp.
+	order = sorted(range(len(sizes)), key=lambda i: (-sizes[i][1], -sizes[i][0]))
+	placements = [None] * len(sizes)
+	shelves = []      # [page, x, y, height]
+	page_tops = []
+	page_extents = []
+	for i in order:
+		w, h = sizes[i]
+		if w > max_size or h > max_size:
+			return None, None
+		shelf = None
+		for s in shelves:
+			if s[1] + w <= max_size:
+				shelf = s
+				break
+		if shelf is None:
+			page = 0
+			while page < len(page_tops) and page_tops[page] + h > max_size:
+				page += 1
+			if page == len(page_tops):
+				page_tops.append(0)
+				page_extents.append([0, 0])
+			shelf = [page, 0, page_tops[page], h]
+			shelves.append(shelf)
+			page_tops[page] += h + padding
+		page, x, y = shelf[0], shelf[1], shelf[2]
+		placements[i] = (page, x, y)
+		shelf[1] += w + padding
+		extent = page_extents[page]
+		extent[0] = max(extent[0], x + w)
+		extent[1] = max(extent[1], y + h)
+	return placements, [(next_pow2(w), next_pow2(h)) for w, h in page_extents]
+
+def collect(inputs):
+	images = []
+	for path in inputs:
+		if os.path.isdir(path):
+			for root, dirs, files in os.walk(path):
+				dirs.sort()
+				for filename in sorted(files):
+					if os.path.splitext(filename)[1].lower() in IMAGE_EXTENSIONS:
+						full = os.path.join(root, filename)
+						name = os.path.splitext(os.path.relpath(full, path))[0].replace(os.sep, '/')
+						images.append((name, full))
+		else:
+			images.append((os.path.splitext(os.path.basename(path))[0], path))
+	return images
+
+def compile(inputs, output, fmt, padding):
+	entries = collect(inputs)
+	images = [Image.open(filename).convert('RGBA') for name, filename in entries]
+	placements, page_sizes = pack([image.size for image in images], MAX_TEXTURE_SIZE, padding)
+	if placements is None:
+		print('atlas images are limited to %dx%d' % (MAX_TEXTURE_SIZE, MAX_TEXTURE_SIZE))
+		sys.exit(1)
+
+	pages = [Image.new('RGBA', size, (0, 0, 0, 0)) for size in page_sizes]
+	for image, (page, x, y) in zip(images, placements):
+		pages[page].paste(image, (x, y))
+	page_data = [encode_region(page, 0, 0, page.size[0], page.size[1], fmt) for page in pages]
+
+	names = b''.join(name.encode('utf-8') for name, filename in entries)
+	offset = 12 + 16 * len(pages) + 12 * len(entries) + len(names)
+	with open(output, 'wb') as f:
+		f.write(struct.pack('<4s2HI', b'ATLS', len(pages), len(entries), len(names)))
+		for page, data in zip(pages, page_data):
+			f.write(struct.pack('<4H2I', FORMATS[fmt], page.size[0], page.size[1], 0, offset, len(data)))
+			offset += len(data)
+		for (name, filename), image, (page, x, y) in zip(entries, images, placements):
+			f.write(struct.pack('<6H', page, x, y, image.size[0], image.size[1], len(name.encode('utf-8'))))
+		f.write(names)
+		for data in page_data:
+			f.write(data)
+
+def show_usage_exit():
+	print('atlas_pack.py -f <%s> [-p <padding>] -o <output> <directory|image>...' % '|'.join(sorted(FORMATS)))
+	sys.exit(2)
+
+def main(argv):
+	try:
+		opts, args = getopt.getopt(argv, "hf:o:p:")
+	except getopt.GetoptError:
+		show_usage_exit()
+	outfile = None
+	fmt = 'rgba8'
+	padding = 1
+	for opt, arg in opts:
+		if opt == '-h':
+			show_usage_exit()
+		elif opt in ("-f", "--format"):
+			fmt = arg.lower()
+		elif opt in ("-o", "--output"):
+			outfile = arg
+		elif opt in ("-p", "--padding"):
+			padding = int(arg)
+	if not outfile or not args or fmt not in FORMATS:
+		show_usage_exit()
+	compile(args, outfile, fmt, padding)
+
+if __name__ == "__main__":
+	main(sys.argv[1:])
@@ -0,0 +1,256 @@
+#!/usr/bin/env python
+# Converts images into preprocessed 3DS textures for Texture::loadFromPreprocessedFile().
+# Output is a 10 byte header (format, width, height, original width, original height as
+# little-endian u16) followed by the texture data tiled in the layout the GPU expects.
+# With -b, writes a big texture for BigTexture::openFromFile() instead: a "BTEX" header
+# (format, width, height, columns, rows as u16), the column widths and row heights (u16),
+# an offset/length pair (u32) per tile and then the tiles, each encoded as above.
+# Requires Pillow.
+import os, sys, struct, getopt
+from PIL import Image
+
+# Values of ctrulib's GPU_TEXCOLOR enum
+FORMATS = {
+	'rgba8':  0x0,
+	'etc1':   0xC,
+	'etc1a4': 0xD,
+}
+
+MAX_TEXTURE_SIZE = 1024
+MAX_REMAINDER_SEGMENTS = 3
+
+ETC1_MODIFIERS = [
+	[2, 8], [5, 17], [9, 29], [13, 42], [18, 60], [24, 80], [33, 106], [47, 183]
+]
+
+def next_pow2(n):
+	p = 8
+	while p < n:
+		p *= 2
+	return p
+
+def clamp(v):
+	return 0 if v < 0 else (255 if v > 255 else v)
+
+def morton_interleave(x, y):
+	i = (x & 7) | ((y & 7) << 8)
+	i = (i ^ (i << 2)) & 0x1313
+	i = (i ^ (i << 1)) & 0x1515
+	i = (i | (i >> 7)) & 0x3F
+	return i
+
+def expand4(v):
+	return (v << 4) | v
+
+def expand5(v):
+	return (v << 3) | (v >> 2)
+
+def fit_subblock(pixels, base):
+	# Returns (error, table, indices) of the best table for a base color
+	best = None
+	for table in range(8):
+		a, b = ETC1_MODIFIERS[table]
+		candidates = [[clamp(c + m) for c in base] for m in (a, b, -a, -b)]
+		error = 0
+		indices = []
+		for p in pixels:
+			best_idx, best_err = 0, None
+			for idx, c in enumerate(candidates):
+				e = (p[0] - c[0]) ** 2 + (p[1] - c[1]) ** 2 + (p[2] - c[2]) ** 2
+				if best_err is None or e < best_err:
+					best_idx, best_err = idx, e
+			error += best_err
+			indices.append(best_idx)
+			if best is not None and error >= best[0]:
+				break
+		if best is None or error < best[0]:
+			best = (error, table, indices)
+	return best
+
+def average(pixels):
+	n = float(len(pixels))
+	return [sum(p[c] for p in pixels) / n for c in range(3)]
+
+def encode_etc1_block(block):
+	# block[y][x] is an (r, g, b, a) tuple, y going down in texture memory
+	best = None
+	for flip in (0, 1):
+		subs = [[], []]
+		texels = [[], []]
+		for x in range(4):
+			for y in range(4):
+				sub = (y >= 2) if flip else (x >= 2)
+				subs[sub].append(block[y][x])
+				texels[sub].append(x * 4 + y)
+		avgs = [average(s) for s in subs]
+
+		modes = []
+		# Individual mode: two 4-bit base colors
+		q4 = [[int(round(c * 15 / 255.0)) for c in avg] for avg in avgs]
+		modes.append((0, q4, [[expand4(c) for c in q] for q in q4]))
+		# Differential mode: 5-bit base color and a 3-bit signed delta
+		q5 = [[int(round(c * 31 / 255.0)) for c in avg] for avg in avgs]
+		delta = [q5[1][c] - q5[0][c] for c in range(3)]
+		if all(-4 <= d <= 3 for d in delta):
+			modes.append((1, q5, [[expand5(c) for c in q] for q in q5]))
+
+		for diff, quantized, bases in modes:
+			fits = [fit_subblock(subs[i], bases[i]) for i in range(2)]
+			error = fits[0][0] + fits[1][0]
+			if best is None or error < best[0]:
+				best = (error, flip, diff, quantized, fits, texels)
+
+	error, flip, diff, quantized, fits, texels = best
+	value = 0
+	if diff:
+		for c in range(3):
+			shift = 59 - 8 * c
+			value |= quantized[0][c] << shift
+			value |= ((quantized[1][c] - quantized[0][c]) & 0x7) << (shift - 3)
+	else:
+		for c in range(3):
+			value |= quantized[0][c] << (60 - 8 * c)
+			value |= quantized[1][c] << (56 - 8 * c)
+	value |= fits[0][1] << 37
+	value |= fits[1][1] << 34
+	value |= diff << 33
+	value |= flip << 32
+	for sub in range(2):
+		for texel, idx in zip(texels[sub], fits[sub][2]):
+			value |= (idx & 1) << texel
+			value |= (idx >> 1) << (16 + texel)
+	return struct.pack('<Q', value)
+
+def encode_alpha_block(block):
+	value = 0
+	for x in range(4):
+		for y in range(4):
+			value |= (int(round(block[y][x][3] * 15 / 255.0)) & 0xF) << (4 * (x * 4 + y))
+	return struct.pack('<Q', value)
+
+def encode(pixels, width, height, fmt):
+	# pixels[y][x], y=0 being the bottom row as stored by the GPU
+	data = bytearray()
+	for ty in range(0, height, 8):
+		for tx in range(0, width, 8):
+			if fmt == 'rgba8':
+				tile = [None] * 64
+				for y in range(8):
+					for x in range(8):
+						r, g, b, a = pixels[ty + y][tx + x]
+						tile[morton_interleave(x, y)] = struct.pack('BBBB', a, b, g, r)
+				data += b''.join(tile)
+			else:
+				for sub in range(4):
+					bx = tx + (sub & 1) * 4
+					by = ty + (sub >> 1) * 4
+					block = [pixels[by + y][bx:bx + 4] for y in range(4)]
+					if fmt == 'etc1a4':
+						data += encode_alpha_block(block)
+					data += encode_etc1_block(block)
+	return data
+
+def split_size(size, max_size):
+	# Same split as BigTexture: power-of-two segments with little padding
+	segments = []
+	while size >= max_size:
+		segments.append(max_size)
+		size -= max_size
+	if size == 0:
+		return segments
+	full = len(segments)
+	size = (size + 7) & ~7
+	segment = max_size
+	while segment >= 8:
+		if size & segment:
+			segments.append(segment)
+		segment //= 2
+	while len(segments) - full > MAX_REMAINDER_SEGMENTS:
+		merged = segments.pop() + segments.pop()
+		segments.append(next_pow2(merged))
+	total = sum(segments[full:])
+	if len(segments) - full > 1 and total == next_pow2(total) and total <= max_size:
+		segments = segments[:full] + [total]
+	return segments
+
+def encode_region(image, left, top, tex_width, tex_height, fmt):
+	# Pad to the texture size with the region in the top left corner,
+	# then flip so rows are ordered the way the GPU samples them
+	region = image.crop((left, top, min(left + tex_width, image.size[0]), min(top + tex_height, image.size[1])))
+	canvas = Image.new('RGBA', (tex_width, tex_height), (0, 0, 0, 0))
+	canvas.paste(region, (0, 0))
+	canvas = canvas.transpose(Image.FLIP_TOP_BOTTOM)
+	src = list(canvas.getdata())
+	pixels = [src[y * tex_width:(y + 1) * tex_width] for y in range(tex_height)]
+	return encode(pixels, tex_width, tex_height, fmt)
+
+def compile_big(filename, output, fmt):
+	image = Image.open(filename).convert('RGBA')
+	width, height = image.size
+	if width > 0xFFFF or height > 0xFFFF:
+		print('%s: big textures are limited to 65535x65535' % filename)
+		sys.exit(1)
+	columns = split_size(width, MAX_TEXTURE_SIZE)
+	rows = split_size(height, MAX_TEXTURE_SIZE)
+
+	tiles = []
+	top = 0
+	for row in rows:
+		left = 0
+		for column in columns:
+			tiles.append(encode_region(image, left, top, column, row, fmt))
+			left += column
+		top += row
+
+	offset = 14 + 2 * (len(columns) + len(rows)) + 8 * len(tiles)
+	with open(output, 'wb') as f:
+		f.write(struct.pack('<4s5H', b'BTEX', FORMATS[fmt], width, height, len(columns), len(rows)))
+		f.write(struct.pack('<%dH' % (len(columns) + len(rows)), *(columns + rows)))
+		for data in tiles:
+			f.write(struct.pack('<2I', offset, len(data)))
+			offset += len(data)
+		for data in tiles:
+			f.write(data)
+
+def compile(filename, output, fmt):
+	image = Image.open(filename).convert('RGBA')
+	width, height = image.size
+	if width > MAX_TEXTURE_SIZE or height > MAX_TEXTURE_SIZE:
+		print('%s: textures are limited to 1024x1024, use -b for larger images' % filename)
+		sys.exit(1)
+	tex_width, tex_height = next_pow2(width), next_pow2(height)
+
+	with open(output, 'wb') as f:
+		f.write(struct.pack('<5H', FORMATS[fmt], tex_width, tex_height, width, height))
+		f.write(encode_region(image, 0, 0, tex_width, tex_height, fmt))
+
+def show_usage_exit():
+	print('tex_compile.py [-b] -f <%s> -o <output> <image>' % '|'.join(sorted(FORMATS)))
+	sys.exit(2)
+
+def main(argv):
+	try:
+		opts, args = getopt.getopt(argv, "hbf:o:")
+	except getopt.GetoptError:
+		show_usage_exit()
+	outfile = None
+	fmt = 'etc1'
+	big = False
+	for opt, arg in opts:
+		if opt == '-h':
+			show_usage_exit()
+		elif opt in ("-b", "--big"):
+			big = True
+		elif opt in ("-f", "--format"):
+			fmt = arg.lower()
+		elif opt in ("-o", "--output"):
+			outfile = arg
+	if not outfile or len(args) != 1 or fmt not in FORMATS:
+		show_usage_exit()
+	if big:
+		compile_big(args[0], outfile, fmt)
+	else:
+		compile(args[0], outfile, fmt)
+
+if __name__ == "__main__":
+	main(sys.argv[1:])
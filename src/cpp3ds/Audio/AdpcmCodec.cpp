@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "AdpcmCodec.hpp"
+#include <cpp3ds/System/InputStream.hpp>
+#include <cstring>
+
+
+namespace
+{
+    const std::size_t ChannelHeaderSize = 40;
+
+    cpp3ds::Uint16 readUint16(const unsigned char* bytes)
+    {
+        return static_cast<cpp3ds::Uint16>(bytes[0] | (bytes[1] << 8));
+    }
+
+    cpp3ds::Uint32 readUint32(const unsigned char* bytes)
+    {
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<cpp3ds::Uint32>(bytes[3]) << 24);
+    }
+
+    cpp3ds::Int16 clampSample(cpp3ds::Int32 sample)
+    {
+        return static_cast<cpp3ds::Int16>(sample < -32768 ? -32768 : (sample > 32767 ? 32767 : sample));
+    }
+
+    // Decode the first samples of a frame, every stride samples of the output
+    void decodeFrame(const cpp3ds::Uint8* frame, unsigned int count, cpp3ds::priv::AdpcmChannel& channel, cpp3ds::Int16* samples, unsigned int stride)
+    {
+        cpp3ds::Int32 scale = 1 << (frame[0] & 0xF);
+        unsigned int predictor = (frame[0] >> 4) & 0x7;
+        cpp3ds::Int32 coefficient1 = channel.coefficients[predictor * 2];
+        cpp3ds::Int32 coefficient2 = channel.coefficients[predictor * 2 + 1];
+        cpp3ds::Int32 history1 = channel.history1;
+        cpp3ds::Int32 history2 = channel.history2;
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            cpp3ds::Uint8 byte = frame[1 + i / 2];
+            cpp3ds::Int32 nibble = (i & 1) ? (byte & 0xF) : (byte >> 4);
+            if (nibble >= 8)
+                nibble -= 16;
+
+            cpp3ds::Int32 sample = clampSample((((nibble * scale) << 11) + 1024 + coefficient1 * history1 + coefficient2 * history2) >> 11);
+            *samples = static_cast<cpp3ds::Int16>(sample);
+            samples += stride;
+
+            history2 = history1;
+            history1 = sample;
+        }
+
+        channel.history1 = static_cast<cpp3ds::Int16>(history1);
+        channel.history2 = static_cast<cpp3ds::Int16>(history2);
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+bool checkAdpcm(InputStream& stream)
+{
+    char magic[4];
+    if (stream.read(magic, sizeof(magic)) != sizeof(magic))
+        return false;
+
+    return std::memcmp(magic, "DSPA", sizeof(magic)) == 0;
+}
+
+
+////////////////////////////////////////////////////////////
+bool readAdpcmHeader(InputStream& stream, AdpcmHeader& header)
+{
+    if ((stream.seek(0) != 0) || !checkAdpcm(stream))
+        return false;
+
+    unsigned char bytes[12];
+    if (stream.read(bytes, sizeof(bytes)) != sizeof(bytes))
+        return false;
+
+    header.channelCount = readUint16(bytes);
+    header.sampleRate   = readUint32(bytes + 4);
+    header.sampleCount  = readUint32(bytes + 8);
+    if ((header.channelCount < 1) || (header.channelCount > 2) || (header.sampleRate == 0))
+        return false;
+
+    for (unsigned int i = 0; i < header.channelCount; ++i)
+    {
+        unsigned char channelBytes[ChannelHeaderSize];
+        if (stream.read(channelBytes, sizeof(channelBytes)) != sizeof(channelBytes))
+            return false;
+
+        AdpcmChannel& channel = header.channels[i];
+        for (unsigned int j = 0; j < 16; ++j)
+            channel.coefficients[j] = static_cast<Int16>(readUint16(channelBytes + j * 2));
+        channel.predictorScale = readUint16(channelBytes + 32);
+        channel.history1       = static_cast<Int16>(readUint16(channelBytes + 34));
+        channel.history2       = static_cast<Int16>(readUint16(channelBytes + 36));
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t getAdpcmSize(Uint32 sampleCount, unsigned int channelCount)
+{
+    return (sampleCount + AdpcmFrameSamples - 1) / AdpcmFrameSamples * AdpcmFrameSize * channelCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void decodeAdpcm(const Uint8* data, Uint32 sampleCount, unsigned int channelCount, AdpcmChannel* channels, Int16* samples)
+{
+    while (sampleCount > 0)
+    {
+        unsigned int count = (sampleCount < AdpcmFrameSamples) ? sampleCount : static_cast<unsigned int>(AdpcmFrameSamples);
+        for (unsigned int i = 0; i < channelCount; ++i)
+        {
+            decodeFrame(data, count, channels[i], samples + i, channelCount);
+            data += AdpcmFrameSize;
+        }
+
+        samples     += count * channelCount;
+        sampleCount -= count;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void getAdpcmHistory(const Uint8* data, Uint32 sampleCount, AdpcmChannel channel, std::vector<Int16>& history)
+{
+    std::size_t frameCount = getAdpcmSize(sampleCount, 1) / AdpcmFrameSize;
+    history.resize(frameCount * 2);
+
+    Int16 samples[AdpcmFrameSamples];
+    for (std::size_t i = 0; i < frameCount; ++i)
+    {
+        history[i * 2]     = channel.history1;
+        history[i * 2 + 1] = channel.history2;
+        decodeFrame(data + i * AdpcmFrameSize, AdpcmFrameSamples, channel, samples, 1);
+    }
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
@@ -0,0 +1,116 @@
+#ifndef CPP3DS_ADPCMCODEC_HPP
+#define CPP3DS_ADPCMCODEC_HPP
+
+#include <cpp3ds/Config.hpp>
+#include <cstddef>
+#include <vector>
+
+
+namespace cpp3ds
+{
+class InputStream;
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Sizes of DSP-ADPCM frames
+///
+/// Each frame is a header byte, the predictor in the high
+/// nibble and the scale exponent in the low one, followed by
+/// 14 signed 4-bit samples, high nibble first.
+///
+////////////////////////////////////////////////////////////
+enum
+{
+    AdpcmFrameSize    = 8, ///< Bytes of a frame
+    AdpcmFrameSamples = 14 ///< Samples of a frame
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Decoding state of one DSP-ADPCM channel
+///
+////////////////////////////////////////////////////////////
+struct AdpcmChannel
+{
+    Int16  coefficients[16]; ///< Pairs of 5.11 fixed point coefficients, one per predictor
+    Uint16 predictorScale;   ///< Header byte of the first frame
+    Int16  history1;         ///< Last decoded sample
+    Int16  history2;         ///< Sample before the last
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Header of DSP-ADPCM sound files (see scripts/adpcm_compile.py)
+///
+/// The file starts with "DSPA", the channel count (u16), a
+/// reserved u16, the sample rate and the samples per channel
+/// (u32), then the coefficients (16 s16), the predictor and
+/// scale (u16) and the history (2 s16) of each channel,
+/// padded to 40 bytes. The frames of the channels follow,
+/// interleaved frame by frame. All numbers are little endian.
+///
+////////////////////////////////////////////////////////////
+struct AdpcmHeader
+{
+    unsigned int channelCount; ///< 1 or 2
+    unsigned int sampleRate;   ///< Samples per second of each channel
+    Uint32       sampleCount;  ///< Samples of each channel
+    AdpcmChannel channels[2];  ///< Initial state of each channel
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether a stream holds a DSP-ADPCM sound file
+///
+/// The stream is left after the magic number.
+///
+////////////////////////////////////////////////////////////
+bool checkAdpcm(InputStream& stream);
+
+////////////////////////////////////////////////////////////
+/// \brief Read the header of a DSP-ADPCM sound file
+///
+/// The stream is left at the start of the frames.
+///
+/// \return False if the header is invalid
+///
+////////////////////////////////////////////////////////////
+bool readAdpcmHeader(InputStream& stream, AdpcmHeader& header);
+
+////////////////////////////////////////////////////////////
+/// \brief Get the size of the frames holding \a sampleCount
+///        samples of each of \a channelCount channels
+///
+////////////////////////////////////////////////////////////
+std::size_t getAdpcmSize(Uint32 sampleCount, unsigned int channelCount);
+
+////////////////////////////////////////////////////////////
+/// \brief Decode interleaved DSP-ADPCM frames
+///
+/// \param data         Frames, interleaved frame by frame
+/// \param sampleCount  Samples of each channel to decode
+/// \param channelCount Number of channels
+/// \param channels     State of each channel, whose history is updated
+/// \param samples      Interleaved output, \a sampleCount * \a channelCount samples
+///
+////////////////////////////////////////////////////////////
+void decodeAdpcm(const Uint8* data, Uint32 sampleCount, unsigned int channelCount, AdpcmChannel* channels, Int16* samples);
+
+////////////////////////////////////////////////////////////
+/// \brief Find the history each frame of a channel starts with
+///
+/// The frames are decoded once, so that decoding can later
+/// start at any frame without going through the ones before.
+///
+/// \param data        Frames of a single channel
+/// \param sampleCount Samples held by the frames
+/// \param channel     State before the first frame
+/// \param history     Filled with history1 and history2 before each frame
+///
+////////////////////////////////////////////////////////////
+void getAdpcmHistory(const Uint8* data, Uint32 sampleCount, AdpcmChannel channel, std::vector<Int16>& history);
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_ADPCMCODEC_HPP
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/AudioBus.hpp>
+#include <algorithm>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+AudioNode::AudioNode() :
+m_bypassed  (false),
+m_cpuTime   (0),
+m_audioTime (0),
+m_sampleRate(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+AudioNode::~AudioNode()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioNode::setBypassed(bool bypassed)
+{
+    m_bypassed.store(bypassed, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+bool AudioNode::isBypassed() const
+{
+    return m_bypassed.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+Time AudioNode::getCpuTime() const
+{
+    return microseconds(m_cpuTime.load(std::memory_order_relaxed));
+}
+
+
+////////////////////////////////////////////////////////////
+float AudioNode::getCpuLoad() const
+{
+    Int64 audioTime = m_audioTime.load(std::memory_order_relaxed);
+    if (audioTime == 0)
+        return 0.f;
+
+    return static_cast<float>(m_cpuTime.load(std::memory_order_relaxed)) / audioTime;
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioNode::resetCpuStats()
+{
+    m_cpuTime.store(0, std::memory_order_relaxed);
+    m_audioTime.store(0, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioNode::addCpuTime(Time time, unsigned int frameCount)
+{
+    // Only the streaming thread writes, the atomics are for the readers
+    if (m_sampleRate)
+    {
+        m_cpuTime.store(m_cpuTime.load(std::memory_order_relaxed) + time.asMicroseconds(), std::memory_order_relaxed);
+        m_audioTime.store(m_audioTime.load(std::memory_order_relaxed) + static_cast<Int64>(frameCount) * 1000000 / m_sampleRate, std::memory_order_relaxed);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+AudioBus::AudioBus() :
+m_nodes       (),
+m_block       (),
+m_channelCount(0),
+m_clock       ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioBus::add(AudioNode& node)
+{
+    m_nodes.push_back(&node);
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioBus::remove(AudioNode& node)
+{
+    m_nodes.erase(std::remove(m_nodes.begin(), m_nodes.end(), &node), m_nodes.end());
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioBus::clear()
+{
+    m_nodes.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t AudioBus::getNodeCount() const
+{
+    return m_nodes.size();
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioBus::prepare(unsigned int sampleRate, unsigned int channelCount)
+{
+    m_block.assign(BlockSize * std::max(channelCount, 1u), 0.f);
+    onPrepare(sampleRate, channelCount);
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioBus::process(Int16* samples, std::size_t sampleCount)
+{
+    if (isBypassed() || m_nodes.empty() || (m_channelCount == 0) || m_block.empty())
+        return;
+
+    Time begin = m_clock.getElapsedTime();
+    float* channels[2] = {&m_block[0], &m_block[BlockSize * (m_channelCount - 1)]};
+    std::size_t frameCount = sampleCount / m_channelCount;
+
+    for (std::size_t start = 0; start < frameCount; start += BlockSize)
+    {
+        unsigned int count = static_cast<unsigned int>(std::min<std::size_t>(BlockSize, frameCount - start));
+        Int16* block = samples + start * m_channelCount;
+
+        // Split the channels, the nodes filter each of them in a plain loop
+        for (unsigned int c = 0; c < m_channelCount; ++c)
+            for (unsigned int i = 0; i < count; ++i)
+                channels[c][i] = block[i * m_channelCount + c] * (1.f / 32768.f);
+
+        onProcess(channels, m_channelCount, count);
+
+        for (unsigned int c = 0; c < m_channelCount; ++c)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                float sample = channels[c][i] * 32768.f;
+                block[i * m_channelCount + c] = static_cast<Int16>(std::min(std::max(sample, -32768.f), 32767.f));
+            }
+        }
+    }
+
+    addCpuTime(m_clock.getElapsedTime() - begin, static_cast<unsigned int>(frameCount));
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioBus::onPrepare(unsigned int sampleRate, unsigned int channelCount)
+{
+    m_sampleRate   = sampleRate;
+    m_channelCount = std::min(channelCount, 2u);
+
+    for (std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        m_nodes[i]->m_sampleRate = sampleRate;
+        m_nodes[i]->onPrepare(sampleRate, m_channelCount);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void AudioBus::onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount)
+{
+    // Each node is measured from the end of the previous one
+    Time start = m_clock.getElapsedTime();
+    for (std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        AudioNode& node = *m_nodes[i];
+        if (node.isBypassed())
+            continue;
+
+        node.onProcess(channels, channelCount, frameCount);
+
+        Time end = m_clock.getElapsedTime();
+        node.addCpuTime(end - start, frameCount);
+        start = end;
+    }
+}
+
+} // namespace cpp3ds
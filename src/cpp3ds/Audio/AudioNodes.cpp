@@ -0,0 +1,581 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/AudioNodes.hpp>
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+    const float Pi = 3.14159265f;
+
+    // Frames sharing one gain computation in the compressor
+    const unsigned int GainInterval = 16;
+
+    float toDecibels(float level)
+    {
+        return 20.f * std::log10(std::max(level, 1e-6f));
+    }
+
+    float fromDecibels(float decibels)
+    {
+        return std::pow(10.f, decibels / 20.f);
+    }
+
+    // Share of the envelope kept per frame, to move by 1 - 1/e in the given time
+    float smoothingFactor(cpp3ds::Int64 time, unsigned int sampleRate)
+    {
+        float frames = time * 1e-6f * sampleRate;
+        return (frames > 1.f) ? std::exp(-1.f / frames) : 0.f;
+    }
+
+    // Denormals of a decaying state are very slow on the VFP
+    void flushDenormal(float& value)
+    {
+        if (std::fabs(value) < 1e-15f)
+            value = 0.f;
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+GainNode::GainNode(float gain) :
+m_target     (gain),
+m_fade       (0),
+m_version    (0),
+m_seenVersion(0),
+m_sampleRate (0),
+m_gain       (gain),
+m_step       (0.f),
+m_fadeFrames (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void GainNode::setGain(float gain, Time fade)
+{
+    m_target.store(gain, std::memory_order_relaxed);
+    m_fade.store(fade.asMicroseconds(), std::memory_order_relaxed);
+    m_version.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+float GainNode::getGain() const
+{
+    return m_target.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void GainNode::onPrepare(unsigned int sampleRate, unsigned int)
+{
+    m_sampleRate  = sampleRate;
+    m_seenVersion = m_version.load(std::memory_order_acquire);
+    m_gain        = m_target.load(std::memory_order_relaxed);
+    m_fadeFrames  = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void GainNode::onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount)
+{
+    Uint32 version = m_version.load(std::memory_order_acquire);
+    float target = m_target.load(std::memory_order_relaxed);
+    if (version != m_seenVersion)
+    {
+        m_seenVersion = version;
+        m_fadeFrames  = static_cast<unsigned int>(m_fade.load(std::memory_order_relaxed) * m_sampleRate / 1000000);
+        m_step        = m_fadeFrames ? (target - m_gain) / m_fadeFrames : 0.f;
+        if (m_fadeFrames == 0)
+            m_gain = target;
+    }
+
+    // The ramp, then the constant gain
+    unsigned int rampFrames = std::min(frameCount, m_fadeFrames);
+    for (unsigned int c = 0; c < channelCount; ++c)
+    {
+        float* samples = channels[c];
+        for (unsigned int i = 0; i < rampFrames; ++i)
+            samples[i] *= m_gain + m_step * (i + 1);
+
+        float gain = (rampFrames == m_fadeFrames) ? target : m_gain + m_step * rampFrames;
+        if (gain != 1.f)
+            for (unsigned int i = rampFrames; i < frameCount; ++i)
+                samples[i] *= gain;
+    }
+
+    m_fadeFrames -= rampFrames;
+    m_gain = m_fadeFrames ? m_gain + m_step * rampFrames : target;
+}
+
+
+////////////////////////////////////////////////////////////
+BiquadNode::BiquadNode(Type type, float frequency, float q, float gain) :
+m_type       (type),
+m_frequency  (frequency),
+m_q          (q),
+m_gain       (gain),
+m_version    (0),
+m_seenVersion(0),
+m_sampleRate (0),
+m_b0         (1.f),
+m_b1         (0.f),
+m_b2         (0.f),
+m_a1         (0.f),
+m_a2         (0.f)
+{
+    m_z1[0] = m_z1[1] = 0.f;
+    m_z2[0] = m_z2[1] = 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+void BiquadNode::setType(Type type)
+{
+    m_type.store(type, std::memory_order_relaxed);
+    m_version.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+void BiquadNode::setFrequency(float frequency)
+{
+    m_frequency.store(frequency, std::memory_order_relaxed);
+    m_version.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+void BiquadNode::setQ(float q)
+{
+    m_q.store(q, std::memory_order_relaxed);
+    m_version.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+void BiquadNode::setGain(float gain)
+{
+    m_gain.store(gain, std::memory_order_relaxed);
+    m_version.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+BiquadNode::Type BiquadNode::getType() const
+{
+    return static_cast<Type>(m_type.load(std::memory_order_relaxed));
+}
+
+
+////////////////////////////////////////////////////////////
+float BiquadNode::getFrequency() const
+{
+    return m_frequency.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+float BiquadNode::getQ() const
+{
+    return m_q.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+float BiquadNode::getGain() const
+{
+    return m_gain.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void BiquadNode::onPrepare(unsigned int sampleRate, unsigned int)
+{
+    m_sampleRate = sampleRate;
+    m_z1[0] = m_z1[1] = 0.f;
+    m_z2[0] = m_z2[1] = 0.f;
+
+    m_seenVersion = m_version.load(std::memory_order_acquire);
+    design();
+}
+
+
+////////////////////////////////////////////////////////////
+void BiquadNode::onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount)
+{
+    Uint32 version = m_version.load(std::memory_order_acquire);
+    if (version != m_seenVersion)
+    {
+        m_seenVersion = version;
+        design();
+    }
+
+    // Locals let the compiler keep everything in registers
+    const float b0 = m_b0, b1 = m_b1, b2 = m_b2, a1 = m_a1, a2 = m_a2;
+    for (unsigned int c = 0; c < channelCount; ++c)
+    {
+        float* samples = channels[c];
+        float z1 = m_z1[c];
+        float z2 = m_z2[c];
+        for (unsigned int i = 0; i < frameCount; ++i)
+        {
+            float x = samples[i];
+            float y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            samples[i] = y;
+        }
+        flushDenormal(z1);
+        flushDenormal(z2);
+        m_z1[c] = z1;
+        m_z2[c] = z2;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void BiquadNode::design()
+{
+    if (m_sampleRate == 0)
+        return;
+
+    float frequency = std::min(std::max(m_frequency.load(std::memory_order_relaxed), 1.f), m_sampleRate * 0.49f);
+    float q         = std::max(m_q.load(std::memory_order_relaxed), 0.01f);
+    float amplitude = std::pow(10.f, m_gain.load(std::memory_order_relaxed) / 40.f);
+    float omega     = 2.f * Pi * frequency / m_sampleRate;
+    float cosine    = std::cos(omega);
+    float alpha     = std::sin(omega) / (2.f * q);
+
+    float b0, b1, b2, a0, a1, a2;
+    switch (static_cast<Type>(m_type.load(std::memory_order_relaxed)))
+    {
+        default:
+        case LowPass:
+            b0 = (1.f - cosine) / 2.f; b1 = 1.f - cosine; b2 = b0;
+            a0 = 1.f + alpha; a1 = -2.f * cosine; a2 = 1.f - alpha;
+            break;
+
+        case HighPass:
+            b0 = (1.f + cosine) / 2.f; b1 = -(1.f + cosine); b2 = b0;
+            a0 = 1.f + alpha; a1 = -2.f * cosine; a2 = 1.f - alpha;
+            break;
+
+        case BandPass:
+            b0 = alpha; b1 = 0.f; b2 = -alpha;
+            a0 = 1.f + alpha; a1 = -2.f * cosine; a2 = 1.f - alpha;
+            break;
+
+        case Notch:
+            b0 = 1.f; b1 = -2.f * cosine; b2 = 1.f;
+            a0 = 1.f + alpha; a1 = -2.f * cosine; a2 = 1.f - alpha;
+            break;
+
+        case Peak:
+            b0 = 1.f + alpha * amplitude; b1 = -2.f * cosine; b2 = 1.f - alpha * amplitude;
+            a0 = 1.f + alpha / amplitude; a1 = -2.f * cosine; a2 = 1.f - alpha / amplitude;
+            break;
+
+        case LowShelf:
+        {
+            float root = 2.f * std::sqrt(amplitude) * alpha;
+            b0 = amplitude * ((amplitude + 1.f) - (amplitude - 1.f) * cosine + root);
+            b1 = 2.f * amplitude * ((amplitude - 1.f) - (amplitude + 1.f) * cosine);
+            b2 = amplitude * ((amplitude + 1.f) - (amplitude - 1.f) * cosine - root);
+            a0 = (amplitude + 1.f) + (amplitude - 1.f) * cosine + root;
+            a1 = -2.f * ((amplitude - 1.f) + (amplitude + 1.f) * cosine);
+            a2 = (amplitude + 1.f) + (amplitude - 1.f) * cosine - root;
+            break;
+        }
+
+        case HighShelf:
+        {
+            float root = 2.f * std::sqrt(amplitude) * alpha;
+            b0 = amplitude * ((amplitude + 1.f) + (amplitude - 1.f) * cosine + root);
+            b1 = -2.f * amplitude * ((amplitude - 1.f) + (amplitude + 1.f) * cosine);
+            b2 = amplitude * ((amplitude + 1.f) + (amplitude - 1.f) * cosine - root);
+            a0 = (amplitude + 1.f) - (amplitude - 1.f) * cosine + root;
+            a1 = 2.f * ((amplitude - 1.f) - (amplitude + 1.f) * cosine);
+            a2 = (amplitude + 1.f) - (amplitude - 1.f) * cosine - root;
+            break;
+        }
+    }
+
+    m_b0 = b0 / a0;
+    m_b1 = b1 / a0;
+    m_b2 = b2 / a0;
+    m_a1 = a1 / a0;
+    m_a2 = a2 / a0;
+}
+
+
+////////////////////////////////////////////////////////////
+DelayNode::DelayNode(Time maxDelay, Time delay, float feedback, float mix) :
+m_maxDelay  (maxDelay),
+m_delay     (delay.asMicroseconds()),
+m_feedback  (feedback),
+m_mix       (mix),
+m_sampleRate(0),
+m_mask      (0),
+m_position  (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void DelayNode::setDelay(Time delay)
+{
+    m_delay.store(delay.asMicroseconds(), std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void DelayNode::setFeedback(float feedback)
+{
+    m_feedback.store(feedback, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void DelayNode::setMix(float mix)
+{
+    m_mix.store(mix, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+Time DelayNode::getDelay() const
+{
+    return microseconds(m_delay.load(std::memory_order_relaxed));
+}
+
+
+////////////////////////////////////////////////////////////
+float DelayNode::getFeedback() const
+{
+    return m_feedback.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+float DelayNode::getMix() const
+{
+    return m_mix.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void DelayNode::onPrepare(unsigned int sampleRate, unsigned int channelCount)
+{
+    m_sampleRate = sampleRate;
+
+    // Room for the longest delay and a block, wrapped with a mask
+    std::size_t frames = static_cast<std::size_t>(m_maxDelay.asMicroseconds() * sampleRate / 1000000) + AudioBus::BlockSize;
+    std::size_t size = 1;
+    while (size < frames)
+        size *= 2;
+
+    for (unsigned int c = 0; c < 2; ++c)
+        m_lines[c].assign(c < channelCount ? size : 0, 0.f);
+    m_mask     = size - 1;
+    m_position = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void DelayNode::onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount)
+{
+    std::size_t maxFrames = m_mask + 1 - AudioBus::BlockSize;
+    std::size_t delay     = static_cast<std::size_t>(m_delay.load(std::memory_order_relaxed) * m_sampleRate / 1000000);
+    delay = std::min(std::max<std::size_t>(delay, 1), maxFrames);
+
+    float feedback = std::min(std::max(m_feedback.load(std::memory_order_relaxed), 0.f), 0.99f);
+    float mix      = std::min(std::max(m_mix.load(std::memory_order_relaxed), 0.f), 1.f);
+
+    for (unsigned int c = 0; c < channelCount; ++c)
+    {
+        float* samples = channels[c];
+        float* line    = &m_lines[c][0];
+        std::size_t position = m_position;
+        for (unsigned int i = 0; i < frameCount; ++i, ++position)
+        {
+            float delayed = line[(position - delay) & m_mask];
+            line[position & m_mask] = samples[i] + delayed * feedback;
+            samples[i] += (delayed - samples[i]) * mix;
+        }
+    }
+
+    m_position += frameCount;
+}
+
+
+////////////////////////////////////////////////////////////
+CompressorNode::CompressorNode(float threshold, float ratio, Time attack, Time release, float makeup) :
+m_threshold    (threshold),
+m_ratio        (ratio),
+m_attack       (attack.asMicroseconds()),
+m_release      (release.asMicroseconds()),
+m_makeup       (makeup),
+m_reduction    (0.f),
+m_version      (0),
+m_seenVersion  (0),
+m_sampleRate   (0),
+m_attackFactor (0.f),
+m_releaseFactor(0.f),
+m_envelope     (0.f),
+m_gain         (1.f)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void CompressorNode::setThreshold(float threshold)
+{
+    m_threshold.store(threshold, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void CompressorNode::setRatio(float ratio)
+{
+    m_ratio.store(ratio, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void CompressorNode::setAttack(Time attack)
+{
+    m_attack.store(attack.asMicroseconds(), std::memory_order_relaxed);
+    m_version.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+void CompressorNode::setRelease(Time release)
+{
+    m_release.store(release.asMicroseconds(), std::memory_order_relaxed);
+    m_version.fetch_add(1, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+void CompressorNode::setMakeup(float makeup)
+{
+    m_makeup.store(makeup, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+float CompressorNode::getThreshold() const
+{
+    return m_threshold.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+float CompressorNode::getRatio() const
+{
+    return m_ratio.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+Time CompressorNode::getAttack() const
+{
+    return microseconds(m_attack.load(std::memory_order_relaxed));
+}
+
+
+////////////////////////////////////////////////////////////
+Time CompressorNode::getRelease() const
+{
+    return microseconds(m_release.load(std::memory_order_relaxed));
+}
+
+
+////////////////////////////////////////////////////////////
+float CompressorNode::getMakeup() const
+{
+    return m_makeup.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+float CompressorNode::getGainReduction() const
+{
+    return m_reduction.load(std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void CompressorNode::onPrepare(unsigned int sampleRate, unsigned int)
+{
+    m_sampleRate    = sampleRate;
+    m_seenVersion   = m_version.load(std::memory_order_acquire);
+    m_attackFactor  = smoothingFactor(m_attack.load(std::memory_order_relaxed), sampleRate);
+    m_releaseFactor = smoothingFactor(m_release.load(std::memory_order_relaxed), sampleRate);
+    m_envelope      = 0.f;
+    m_gain          = fromDecibels(m_makeup.load(std::memory_order_relaxed));
+    m_reduction.store(0.f, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////
+void CompressorNode::onProcess(float* const* channels, unsigned int channelCount, unsigned int frameCount)
+{
+    Uint32 version = m_version.load(std::memory_order_acquire);
+    if (version != m_seenVersion)
+    {
+        m_seenVersion   = version;
+        m_attackFactor  = smoothingFactor(m_attack.load(std::memory_order_relaxed), m_sampleRate);
+        m_releaseFactor = smoothingFactor(m_release.load(std::memory_order_relaxed), m_sampleRate);
+    }
+
+    float threshold = m_threshold.load(std::memory_order_relaxed);
+    float slope     = 1.f - 1.f / std::max(m_ratio.load(std::memory_order_relaxed), 1.f);
+    float makeup    = m_makeup.load(std::memory_order_relaxed);
+    float reduction = 0.f;
+
+    for (unsigned int start = 0; start < frameCount; start += GainInterval)
+    {
+        unsigned int count = std::min(GainInterval, frameCount - start);
+
+        // Follow the peak of both channels
+        float envelope = m_envelope;
+        for (unsigned int i = start; i < start + count; ++i)
+        {
+            float peak = std::fabs(channels[0][i]);
+            if (channelCount > 1)
+                peak = std::max(peak, std::fabs(channels[1][i]));
+
+            float factor = (peak > envelope) ? m_attackFactor : m_releaseFactor;
+            envelope = peak + (envelope - peak) * factor;
+        }
+        flushDenormal(envelope);
+        m_envelope = envelope;
+
+        // Gain at the end of the interval, reached linearly from the previous one
+        float over = toDecibels(envelope) - threshold;
+        float cut  = (over > 0.f) ? over * slope : 0.f;
+        float gain = fromDecibels(makeup - cut);
+        float step = (gain - m_gain) / count;
+        reduction = std::max(reduction, cut);
+
+        for (unsigned int c = 0; c < channelCount; ++c)
+        {
+            float* samples = channels[c] + start;
+            for (unsigned int i = 0; i < count; ++i)
+                samples[i] *= m_gain + step * (i + 1);
+        }
+        m_gain = gain;
+    }
+
+    m_reduction.store(reduction, std::memory_order_relaxed);
+}
+
+} // namespace cpp3ds
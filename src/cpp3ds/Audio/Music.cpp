@@ -28,17 +28,35 @@
 #include <cpp3ds/Audio/Music.hpp>
 #include <cpp3ds/System/Lock.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <algorithm>
 #include <fstream>
 
 
+namespace
+{
+    const std::size_t NoEndMark = static_cast<std::size_t>(-1);
+}
+
+
 namespace cpp3ds
 {
 ////////////////////////////////////////////////////////////
 Music::Music() :
-m_file    (),
-m_duration()
+m_file       (),
+m_duration   (),
+m_decoder    (&Music::decodeAhead, this),
+m_decodeAhead(seconds(1)),
+m_ring       (),
+m_decoded    (),
+m_pushed     (0),
+m_popped     (0),
+m_endMark    (NoEndMark),
+m_offset     (0),
+m_decoding   (false),
+m_decodedAll (false)
 {
-
+    // Just below the stream thread, which waits on the decoded samples
+    m_decoder.setPriority(0x1B);
 }
 
 
@@ -47,6 +65,7 @@ Music::~Music()
 {
     // We must stop before destroying the file
     stop();
+    stopDecoding();
 }
 
 
@@ -55,6 +74,7 @@ bool Music::openFromFile(const std::string& filename)
 {
     // First stop the music if it was already running
     stop();
+    stopDecoding();
 
     // Open the underlying sound file
     if (!m_file.openFromFile(filename))
@@ -72,6 +92,7 @@ bool Music::openFromMemory(const void* data, std::size_t sizeInBytes)
 {
     // First stop the music if it was already running
     stop();
+    stopDecoding();
 
     // Open the underlying sound file
     if (!m_file.openFromMemory(data, sizeInBytes))
@@ -89,6 +110,7 @@ bool Music::openFromStream(InputStream& stream)
 {
     // First stop the music if it was already running
     stop();
+    stopDecoding();
 
     // Open the underlying sound file
     if (!m_file.openFromStream(stream))
@@ -108,17 +130,61 @@ Time Music::getDuration() const
 }
 
 
+////////////////////////////////////////////////////////////
+void Music::setDecodeAhead(Time duration)
+{
+    m_decodeAhead = duration;
+}
+
+
+////////////////////////////////////////////////////////////
+Time Music::getDecodeAhead() const
+{
+    return m_decodeAhead;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Music::onGetData(SoundStream::Chunk& data)
 {
-    Lock lock(m_mutex);
+    // The decoder is behind (right after a seek), decode the rest here
+    if (m_ring.getCount() < m_samples.size())
+    {
+        Lock lock(m_mutex);
+        while ((m_ring.getCount() < m_samples.size()) && decode())
+        {
+        }
+    }
+
+    // Stream up to the end of the file, if it was decoded. The mark is
+    // read after the count, so that it is seen before the samples past it.
+    std::size_t count   = std::min(m_samples.size(), m_ring.getCount());
+    std::size_t endMark = m_endMark.load();
+    if (endMark != NoEndMark)
+        count = std::min(count, endMark - m_popped);
+
+    count = m_ring.pop(&m_samples[0], count);
+    m_popped += count;
+    m_offset += count;
+
+    // There is room in the ring again
+    if (count > 0)
+        m_wake.post();
 
     // Fill the chunk parameters
     data.samples     = &m_samples[0];
-    data.sampleCount = static_cast<std::size_t>(m_file.read(&m_samples[0], m_samples.size()));
+    data.sampleCount = count;
 
     // Check if we have reached the end of the audio file
-    return data.sampleCount == m_samples.size();
+    if ((endMark != NoEndMark) && (m_popped == endMark))
+    {
+        // The ring already holds the beginning of the file
+        m_endMark = NoEndMark;
+        m_offset  = 0;
+        return false;
+    }
+
+    return !m_decodedAll || (m_ring.getCount() > 0);
 }
 
 
@@ -127,7 +193,23 @@ void Music::onSeek(Time timeOffset)
 {
     Lock lock(m_mutex);
 
-    m_file.seek(timeOffset);
+    Uint64 offset = static_cast<Uint64>(timeOffset.asSeconds() * m_file.getSampleRate()) * m_file.getChannelCount();
+    offset = std::min(offset, m_file.getSampleCount());
+
+    // Starting over a loop, or playing right after opening,
+    // finds the samples already decoded
+    if (offset == m_offset)
+        return;
+
+    // The decoder waits on the mutex, the ring can be emptied
+    m_file.seek(offset);
+    m_ring.clear();
+    m_offset     = offset;
+    m_pushed     = 0;
+    m_popped     = 0;
+    m_endMark    = NoEndMark;
+    m_decodedAll = false;
+    m_wake.post();
 }
 
 
@@ -137,11 +219,93 @@ void Music::initialize()
     // Compute the music duration
     m_duration = m_file.getDuration();
 
-    // Resize the internal buffer so that it can contain 1 second of audio samples
-    m_samples.resize(m_file.getSampleRate() * m_file.getChannelCount() / 16);
+    // Resize the internal buffer so that it can contain 1/16 second of audio samples,
+    // and the ring a few of them. Both hold whole frames, as the readers expect.
+    std::size_t channelCount = m_file.getChannelCount();
+    std::size_t chunkFrames  = std::max<std::size_t>(m_file.getSampleRate() / 16, 1);
+    std::size_t ringFrames   = static_cast<std::size_t>(m_decodeAhead.asSeconds() * m_file.getSampleRate());
+    m_samples.resize(chunkFrames * channelCount);
+    m_decoded.resize(chunkFrames * channelCount);
+    m_ring.setCapacity(std::max(ringFrames, chunkFrames * 2) * channelCount);
+
+    m_pushed     = 0;
+    m_popped     = 0;
+    m_endMark    = NoEndMark;
+    m_offset     = 0;
+    m_decodedAll = false;
 
     // Initialize the stream
     SoundStream::initialize(m_file.getChannelCount(), m_file.getSampleRate());
+
+    // Start decoding ahead
+    m_decoding = true;
+    m_decoder.launch();
+}
+
+
+////////////////////////////////////////////////////////////
+void Music::decodeAhead()
+{
+    for (;;)
+    {
+        {
+            Lock lock(m_mutex);
+
+            if (!m_decoding)
+                return;
+
+            if (decode())
+                continue;
+        }
+
+        // The ring is full or the file is over, wait for the stream to play some
+        m_wake.wait();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Music::stopDecoding()
+{
+    {
+        Lock lock(m_mutex);
+        m_decoding = false;
+    }
+
+    m_wake.post();
+    m_decoder.wait();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Music::decode()
+{
+    // Whole frames only, as the readers expect
+    std::size_t channelCount = m_file.getChannelCount();
+    std::size_t count = std::min(m_decoded.size(), m_ring.getFreeCount() / channelCount * channelCount);
+    if (m_decodedAll || (count == 0))
+        return false;
+
+    std::size_t read = static_cast<std::size_t>(m_file.read(&m_decoded[0], count));
+    m_ring.push(&m_decoded[0], read);
+    m_pushed += read;
+
+    if (read < count)
+    {
+        if (!getLoop())
+        {
+            m_decodedAll = true;
+        }
+        else if (m_endMark == NoEndMark)
+        {
+            // Mark the end before pushing anything past it, and carry on from the beginning
+            m_endMark = m_pushed;
+            m_file.seek(0);
+            return true;
+        }
+    }
+
+    return read > 0;
 }
 
 } // namespace cpp3ds
@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/Resampler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+namespace
+{
+    const unsigned int MaxPhaseCount = 256;
+    const unsigned int MaxTapCount   = 128;
+
+    // Taps, passband edge (over the Nyquist frequency) and Kaiser window shape of each quality
+    const unsigned int tapCounts[] = {8, 16, 32};
+    const double       rolloffs[]  = {0.85, 0.9, 0.95};
+    const double       betas[]     = {5.0, 7.0, 9.0};
+
+    unsigned int greatestCommonDivisor(unsigned int a, unsigned int b)
+    {
+        while (b)
+        {
+            unsigned int r = a % b;
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+
+    // Modified Bessel function of the first kind, for the Kaiser window
+    double besselI0(double x)
+    {
+        double sum  = 1.0;
+        double term = 1.0;
+        for (int k = 1; term > sum * 1e-12; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum  += term;
+        }
+        return sum;
+    }
+
+    double sinc(double x)
+    {
+        if (std::fabs(x) < 1e-9)
+            return 1.0;
+        return std::sin(3.14159265358979323846 * x) / (3.14159265358979323846 * x);
+    }
+
+    // Dot product of samples with a filter, of an even length
+    inline cpp3ds::Int32 convolve(const cpp3ds::Int16* samples, const cpp3ds::Int16* filter, unsigned int count)
+    {
+        cpp3ds::Int32 sum = 0;
+#ifdef _3DS
+        // Two multiply-accumulates per SMLAD on the ARM11
+        for (unsigned int i = 0; i < count; i += 2)
+        {
+            cpp3ds::Uint32 a, b;
+            std::memcpy(&a, samples + i, sizeof(a));
+            std::memcpy(&b, filter + i, sizeof(b));
+            __asm__("smlad %0, %1, %2, %0" : "+r"(sum) : "r"(a), "r"(b));
+        }
+#else
+        // Simple enough for the compiler to vectorize
+        for (unsigned int i = 0; i < count; ++i)
+            sum += samples[i] * filter[i];
+#endif
+        return sum;
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+Resampler::Resampler() :
+m_inputRate   (0),
+m_outputRate  (0),
+m_channelCount(1),
+m_quality     (Medium),
+m_up          (1),
+m_down        (1),
+m_phaseCount  (0),
+m_tapCount    (0),
+m_filters     (),
+m_history     (),
+m_position    (0),
+m_phase       (0),
+m_inputFrames (0),
+m_outputFrames(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Resampler::Resampler(unsigned int inputRate, unsigned int outputRate, unsigned int channelCount, Quality quality) :
+m_inputRate   (0),
+m_outputRate  (0),
+m_channelCount(1),
+m_quality     (Medium),
+m_up          (1),
+m_down        (1),
+m_phaseCount  (0),
+m_tapCount    (0),
+m_filters     (),
+m_history     (),
+m_position    (0),
+m_phase       (0),
+m_inputFrames (0),
+m_outputFrames(0)
+{
+    setRates(inputRate, outputRate, channelCount, quality);
+}
+
+
+////////////////////////////////////////////////////////////
+void Resampler::setRates(unsigned int inputRate, unsigned int outputRate, unsigned int channelCount, Quality quality)
+{
+    m_inputRate    = inputRate;
+    m_outputRate   = outputRate;
+    m_channelCount = std::max(channelCount, 1u);
+    m_quality      = quality;
+
+    // Invalid rates leave the samples as they are
+    if (inputRate && outputRate && (inputRate != outputRate))
+    {
+        unsigned int divisor = greatestCommonDivisor(inputRate, outputRate);
+        m_up   = outputRate / divisor;
+        m_down = inputRate / divisor;
+        design();
+    }
+    else
+    {
+        m_up       = 1;
+        m_down     = 1;
+        m_tapCount = 0;
+        m_filters.clear();
+    }
+
+    reset();
+}
+
+
+////////////////////////////////////////////////////////////
+void Resampler::reset()
+{
+    // Silence before the first sample centers the filters on it
+    m_history.assign(m_channelCount, std::vector<Int16>(m_tapCount > 0 ? m_tapCount / 2 - 1 : 0, 0));
+    m_position     = 0;
+    m_phase        = 0;
+    m_inputFrames  = 0;
+    m_outputFrames = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void Resampler::process(const Int16* samples, std::size_t sampleCount, std::vector<Int16>& output)
+{
+    if (m_up == m_down)
+    {
+        output.insert(output.end(), samples, samples + sampleCount);
+        return;
+    }
+
+    // Split the channels, so that the filters run over contiguous samples
+    std::size_t frameCount = sampleCount / m_channelCount;
+    for (unsigned int c = 0; c < m_channelCount; ++c)
+    {
+        std::vector<Int16>& history = m_history[c];
+        std::size_t size = history.size();
+        history.resize(size + frameCount);
+        for (std::size_t i = 0; i < frameCount; ++i)
+            history[size + i] = samples[i * m_channelCount + c];
+    }
+    m_inputFrames += frameCount;
+
+    std::size_t available = m_history[0].size();
+    if (available > m_position)
+        output.reserve(output.size() + ((available - m_position) * m_up / m_down + 1) * m_channelCount);
+
+    while (m_position + m_tapCount <= available)
+    {
+        unsigned int phase = (m_phaseCount == m_up) ? m_phase : static_cast<unsigned int>((static_cast<Uint64>(m_phase) * m_phaseCount * 2 + m_up) / (m_up * 2));
+        const Int16* filter = &m_filters[phase * m_tapCount];
+
+        for (unsigned int c = 0; c < m_channelCount; ++c)
+        {
+            Int32 sample = (convolve(&m_history[c][m_position], filter, m_tapCount) + (1 << 14)) >> 15;
+            output.push_back(static_cast<Int16>(std::min(std::max(sample, -32768), 32767)));
+        }
+        ++m_outputFrames;
+
+        m_phase    += m_down;
+        m_position += m_phase / m_up;
+        m_phase    %= m_up;
+    }
+
+    // Drop the samples no output needs anymore
+    std::size_t consumed = std::min(m_position, available);
+    for (unsigned int c = 0; c < m_channelCount; ++c)
+        m_history[c].erase(m_history[c].begin(), m_history[c].begin() + consumed);
+    m_position -= consumed;
+}
+
+
+////////////////////////////////////////////////////////////
+void Resampler::flush(std::vector<Int16>& output)
+{
+    if (m_up != m_down)
+    {
+        // Push the last samples through the filters, and stop where the input ends
+        Uint64 frameCount = (m_inputFrames * m_up + m_down - 1) / m_down;
+        std::size_t end = output.size() + static_cast<std::size_t>(frameCount - m_outputFrames) * m_channelCount;
+
+        std::vector<Int16> silence(m_tapCount * m_channelCount, 0);
+        process(&silence[0], silence.size(), output);
+        output.resize(std::min(output.size(), end));
+    }
+
+    reset();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Resampler::getInputRate() const
+{
+    return m_inputRate;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Resampler::getOutputRate() const
+{
+    return m_outputRate;
+}
+
+
+////////////////////////////////////////////////////////////
+void Resampler::resample(const Int16* samples, Uint64 sampleCount, unsigned int channelCount,
+                         unsigned int inputRate, unsigned int outputRate, std::vector<Int16>& output, Quality quality)
+{
+    Resampler resampler(inputRate, outputRate, channelCount, quality);
+
+    output.clear();
+    resampler.process(samples, static_cast<std::size_t>(sampleCount), output);
+    resampler.flush(output);
+}
+
+
+////////////////////////////////////////////////////////////
+void Resampler::design()
+{
+    // Ratios with a large numerator round the position to the closest filter,
+    // the last one being the first filter of the next input sample
+    m_phaseCount = std::min(m_up, MaxPhaseCount);
+    unsigned int filterCount = (m_phaseCount < m_up) ? m_phaseCount + 1 : m_phaseCount;
+
+    // Downsampling cuts at the output's Nyquist frequency, which takes longer filters
+    double ratio = static_cast<double>(m_outputRate) / m_inputRate;
+    unsigned int widening = (ratio < 1.0) ? static_cast<unsigned int>(std::ceil(1.0 / ratio)) : 1;
+    m_tapCount = std::min(tapCounts[m_quality] * widening, MaxTapCount);
+
+    double cutoff = std::min(ratio, 1.0) * rolloffs[m_quality];
+    double beta   = betas[m_quality];
+    double half   = m_tapCount / 2.0;
+
+    m_filters.resize(filterCount * m_tapCount);
+    std::vector<double> taps(m_tapCount);
+    for (unsigned int p = 0; p < filterCount; ++p)
+    {
+        // Filter for an output between two input samples, this far after the first
+        double fraction = static_cast<double>(p) / m_phaseCount;
+        double sum = 0;
+        for (unsigned int k = 0; k < m_tapCount; ++k)
+        {
+            double x = k - (half - 1) - fraction;
+            double n = x / half;
+            double window = (n * n < 1.0) ? besselI0(beta * std::sqrt(1.0 - n * n)) / besselI0(beta) : 0.0;
+            taps[k] = cutoff * sinc(cutoff * x) * window;
+            sum += taps[k];
+        }
+
+        // Unity gain for every filter, the rounding error goes to the largest tap
+        Int16* filter = &m_filters[p * m_tapCount];
+        Int32 total = 0;
+        unsigned int largest = 0;
+        for (unsigned int k = 0; k < m_tapCount; ++k)
+        {
+            filter[k] = static_cast<Int16>(std::floor(taps[k] / sum * 32768.0 + 0.5));
+            total += filter[k];
+            if (filter[k] > filter[largest])
+                largest = k;
+        }
+        filter[largest] = static_cast<Int16>(filter[largest] + (32768 - total));
+    }
+}
+
+} // namespace cpp3ds
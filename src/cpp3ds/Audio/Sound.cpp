@@ -29,7 +29,9 @@
 #include <cpp3ds/Audio/SoundBuffer.hpp>
 #include <3ds.h>
 #include <string.h>
+#include <algorithm>
 #include <cpp3ds/System/Err.hpp>
+#include "AdpcmCodec.hpp"
 
 namespace cpp3ds
 {
@@ -103,14 +105,21 @@ void Sound::play(int channel)
 
 	setPlayingOffset(Time::Zero);
 
-	u32 size = sizeof(Int16) * m_buffer->getSampleCount();
-
 	ndspChnReset(m_channel);
 	ndspChnSetInterp(m_channel, NDSP_INTERP_POLYPHASE);
 	ndspChnSetRate(m_channel, float(m_buffer->getSampleRate()));
-	ndspChnSetFormat(m_channel, (m_buffer->getChannelCount() == 1) ? NDSP_FORMAT_MONO_PCM16 : NDSP_FORMAT_STEREO_PCM16);
 
-	DSP_FlushDataCache((u8*)m_buffer->getSamples(), size);
+	if (m_isADPCM)
+	{
+		ndspChnSetFormat(m_channel, NDSP_FORMAT_MONO_ADPCM);
+		ndspChnSetAdpcmCoefs(m_channel, reinterpret_cast<u16*>(const_cast<Int16*>(m_buffer->m_storage->adpcmCoefficients)));
+		DSP_FlushDataCache(&m_buffer->m_storage->adpcm[0], m_buffer->m_storage->adpcm.size());
+	}
+	else
+	{
+		ndspChnSetFormat(m_channel, (m_buffer->getChannelCount() == 1) ? NDSP_FORMAT_MONO_PCM16 : NDSP_FORMAT_STEREO_PCM16);
+		DSP_FlushDataCache((u8*)m_buffer->getSamples(), sizeof(Int16) * m_buffer->getSampleCount());
+	}
 
 	ndspChnWaveBufAdd(m_channel, &m_ndspWaveBuf);
 }
@@ -146,9 +155,12 @@ void Sound::setBuffer(const SoundBuffer& buffer)
         m_buffer->detachSound(this);
     }
 
+	// Compressed buffers have frames instead of samples
+	m_isADPCM = buffer.m_storage && !buffer.m_storage->adpcm.empty();
+
 	memset(&m_ndspWaveBuf, 0, sizeof(ndspWaveBuf));
-	m_ndspWaveBuf.data_vaddr = buffer.getSamples();
-	m_ndspWaveBuf.nsamples = buffer.getSampleCount() / buffer.getChannelCount();
+	m_ndspWaveBuf.data_vaddr = m_isADPCM ? static_cast<const void*>(&buffer.m_storage->adpcm[0]) : buffer.getSamples();
+	m_ndspWaveBuf.nsamples = buffer.getChannelCount() ? buffer.getSampleCount() / buffer.getChannelCount() : 0;
 	m_ndspWaveBuf.looping = m_loop; // Loop enabled
 	m_ndspWaveBuf.status = NDSP_WBUF_FREE;
 
@@ -186,9 +198,28 @@ void Sound::setPlayingOffset(Time timeOffset)
 	Status status = getStatus();
 	stop();
 	m_playOffset = timeOffset;
-	int offset = m_buffer->getSampleRate() * m_buffer->getChannelCount() * timeOffset.asSeconds();
-	m_ndspWaveBuf.data_vaddr = m_buffer->getSamples() + offset;
-	m_ndspWaveBuf.nsamples = m_buffer->getSampleCount() / m_buffer->getChannelCount() - offset;
+	Uint64 frameCount = m_buffer->getSampleCount() / m_buffer->getChannelCount();
+	Uint64 offset = std::min<Uint64>(m_buffer->getSampleRate() * timeOffset.asSeconds(), frameCount);
+
+	if (m_isADPCM)
+	{
+		// Playback starts on a frame, with the decoder state there
+		Uint64 frame = std::min<Uint64>(offset, frameCount - 1) / priv::AdpcmFrameSamples;
+		offset = frame * priv::AdpcmFrameSamples;
+		m_playOffset = seconds(static_cast<float>(offset) / m_buffer->getSampleRate());
+
+		const Uint8* data = &m_buffer->m_storage->adpcm[0];
+		const std::vector<Int16>& history = m_buffer->m_storage->adpcmHistory;
+		m_adpcmData.index    = frame ? data[frame * priv::AdpcmFrameSize] : m_buffer->m_storage->adpcmPredictorScale;
+		m_adpcmData.history0 = history[frame * 2];
+		m_adpcmData.history1 = history[frame * 2 + 1];
+		m_ndspWaveBuf.data_adpcm = const_cast<u8*>(data) + frame * priv::AdpcmFrameSize;
+		m_ndspWaveBuf.adpcm_data = &m_adpcmData;
+	}
+	else
+		m_ndspWaveBuf.data_vaddr = m_buffer->getSamples() + offset * m_buffer->getChannelCount();
+
+	m_ndspWaveBuf.nsamples = frameCount - offset;
 	if (status == Playing)
 		ndspChnWaveBufAdd(m_channel, &m_ndspWaveBuf);
 }
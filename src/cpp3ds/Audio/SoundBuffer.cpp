@@ -32,7 +32,10 @@
 //#include <cpp3ds/Audio/AudioDevice.hpp>
 //#include <cpp3ds/Audio/ALCheck.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <cpp3ds/System/FileInputStream.hpp>
+#include <cpp3ds/System/MemoryInputStream.hpp>
 #include <cpp3ds/Resources.hpp>
+#include "AdpcmCodec.hpp"
 #include <3ds.h>
 #include <memory>
 #include <string.h>
@@ -49,12 +52,10 @@ m_duration()
 
 ////////////////////////////////////////////////////////////
 SoundBuffer::SoundBuffer(const SoundBuffer& copy) :
-m_samples (copy.m_samples),
 m_duration(copy.m_duration),
-m_sounds  () // don't copy the attached sounds
+m_sounds  (), // don't copy the attached sounds
+m_storage (copy.m_storage) // share the samples
 {
-    // Update the internal buffer with the new samples
-    update(copy.getChannelCount(), copy.getSampleRate());
 }
 
 
@@ -76,17 +77,37 @@ SoundBuffer::~SoundBuffer()
 ////////////////////////////////////////////////////////////
 bool SoundBuffer::loadFromFile(const std::string& filename)
 {
-    InputSoundFile file;
-    if (file.openFromFile(filename))
-        return initialize(file);
+    // Buffers loaded from the same file share their samples
+    if (StoragePtr storage = findCachedFile(filename))
+        return update(storage);
+
+    bool loaded;
+    FileInputStream stream;
+    if (stream.open(filename) && priv::checkAdpcm(stream))
+    {
+        loaded = loadAdpcm(stream);
+    }
     else
-        return false;
+    {
+        InputSoundFile file;
+        loaded = file.openFromFile(filename) && initialize(file);
+    }
+
+    if (loaded)
+        cacheFile(filename, m_storage);
+
+    return loaded;
 }
 
 
 ////////////////////////////////////////////////////////////
 bool SoundBuffer::loadFromMemory(const void* data, std::size_t sizeInBytes)
 {
+    MemoryInputStream stream;
+    stream.open(data, sizeInBytes);
+    if (priv::checkAdpcm(stream))
+        return loadAdpcm(stream);
+
     InputSoundFile file;
     if (file.openFromMemory(data, sizeInBytes))
         return initialize(file);
@@ -98,6 +119,9 @@ bool SoundBuffer::loadFromMemory(const void* data, std::size_t sizeInBytes)
 ////////////////////////////////////////////////////////////
 bool SoundBuffer::loadFromStream(InputStream& stream)
 {
+    if (priv::checkAdpcm(stream))
+        return loadAdpcm(stream);
+
     InputSoundFile file;
     if (file.openFromStream(stream))
         return initialize(file);
@@ -111,12 +135,14 @@ bool SoundBuffer::loadFromSamples(const Int16* samples, Uint64 sampleCount, unsi
 {
 	if (samples && sampleCount && channelCount && sampleRate)
 	{
-        m_samples.resize(sampleCount);
 		// Copy the new audio samples
-		m_samples.assign(samples, samples + sampleCount);
+		std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+		storage->samples.assign(samples, samples + sampleCount);
+		storage->channelCount = channelCount;
+		storage->sampleRate   = sampleRate;
 
 		// Update the internal buffer with the new samples
-		return update(channelCount, sampleRate);
+		return update(storage);
 	}
 	else
 	{
@@ -133,15 +159,52 @@ bool SoundBuffer::loadFromSamples(const Int16* samples, Uint64 sampleCount, unsi
 }
 
 
+////////////////////////////////////////////////////////////
+bool SoundBuffer::loadFromSamples(const Int16* samples, Uint64 sampleCount, unsigned int channelCount, unsigned int sampleRate,
+                                  unsigned int outputRate, Resampler::Quality quality)
+{
+    if (!samples || !sampleCount || !channelCount || !sampleRate || !outputRate || (outputRate == sampleRate))
+        return loadFromSamples(samples, sampleCount, channelCount, outputRate ? outputRate : sampleRate);
+
+    std::vector<Int16> resampled;
+    Resampler::resample(samples, sampleCount, channelCount, sampleRate, outputRate, resampled, quality);
+
+    return loadFromSamples(resampled.empty() ? NULL : &resampled[0], resampled.size(), channelCount, outputRate);
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundBuffer::resample(unsigned int sampleRate, Resampler::Quality quality)
+{
+    if (!getSamples())
+    {
+        err() << "Failed to resample sound buffer (no samples, DSP-ADPCM buffers can't be decoded back)" << std::endl;
+        return false;
+    }
+
+    if (sampleRate == getSampleRate())
+        return true;
+
+    // The samples are converted before the storage holding them is replaced
+    return loadFromSamples(getSamples(), getSampleCount(), getChannelCount(), getSampleRate(), sampleRate, quality);
+}
+
+
 ////////////////////////////////////////////////////////////
 bool SoundBuffer::saveToFile(const std::string& filename) const
 {
+    if (!getSamples())
+    {
+        err() << "Failed to save sound buffer to \"" << filename << "\" (no samples, DSP-ADPCM buffers can't be decoded back)" << std::endl;
+        return false;
+    }
+
     // Create the sound file in write mode
     OutputSoundFile file;
     if (file.openFromFile(filename, getSampleRate(), getChannelCount()))
     {
         // Write the samples to the opened file
-        file.write(&m_samples[0], m_samples.size());
+        file.write(getSamples(), getSampleCount());
 
         return true;
     }
@@ -155,28 +218,31 @@ bool SoundBuffer::saveToFile(const std::string& filename) const
 ////////////////////////////////////////////////////////////
 const Int16* SoundBuffer::getSamples() const
 {
-    return m_samples.empty() ? NULL : &m_samples[0];
+    return (!m_storage || m_storage->samples.empty()) ? NULL : &m_storage->samples[0];
 }
 
 
 ////////////////////////////////////////////////////////////
 Uint64 SoundBuffer::getSampleCount() const
 {
-    return m_samples.size();
+    if (!m_storage)
+        return 0;
+
+    return m_storage->adpcm.empty() ? m_storage->samples.size() : m_storage->adpcmSampleCount;
 }
 
 
 ////////////////////////////////////////////////////////////
 unsigned int SoundBuffer::getSampleRate() const
 {
-	return m_sampleRate;
+	return m_storage ? m_storage->sampleRate : 0;
 }
 
 
 ////////////////////////////////////////////////////////////
 unsigned int SoundBuffer::getChannelCount() const
 {
-    return m_channelCount;
+    return m_storage ? m_storage->channelCount : 0;
 }
 
 
@@ -192,11 +258,9 @@ SoundBuffer& SoundBuffer::operator =(const SoundBuffer& right)
 {
     SoundBuffer temp(right);
 
-    std::swap(m_samples,      temp.m_samples);
-    std::swap(m_duration,     temp.m_duration);
-    std::swap(m_channelCount, temp.m_channelCount);
-    std::swap(m_sampleRate,   temp.m_sampleRate);
-    std::swap(m_sounds,       temp.m_sounds); // swap sounds too, so that they are detached when temp is destroyed
+    std::swap(m_storage,  temp.m_storage);
+    std::swap(m_duration, temp.m_duration);
+    std::swap(m_sounds,   temp.m_sounds); // swap sounds too, so that they are detached when temp is destroyed
 
     return *this;
 }
@@ -206,16 +270,17 @@ SoundBuffer& SoundBuffer::operator =(const SoundBuffer& right)
 bool SoundBuffer::initialize(InputSoundFile& file)
 {
     // Retrieve the sound parameters
-    Uint64       sampleCount  = file.getSampleCount();
-    unsigned int channelCount = file.getChannelCount();
-    unsigned int sampleRate   = file.getSampleRate();
+    Uint64 sampleCount = file.getSampleCount();
+    std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+    storage->channelCount = file.getChannelCount();
+    storage->sampleRate   = file.getSampleRate();
 
 	// Read the samples from the provided file
-	m_samples.resize(static_cast<std::size_t>(sampleCount));
-	if (file.read(&m_samples[0], sampleCount) == sampleCount)
+	storage->samples.resize(static_cast<std::size_t>(sampleCount));
+	if (file.read(&storage->samples[0], sampleCount) == sampleCount)
 	{
 		// Update the internal buffer with the new samples
-		return update(channelCount, sampleRate);
+		return update(storage);
 	}
 	else
 	{
@@ -225,21 +290,18 @@ bool SoundBuffer::initialize(InputSoundFile& file)
 
 
 ////////////////////////////////////////////////////////////
-bool SoundBuffer::update(unsigned int channelCount, unsigned int sampleRate)
+bool SoundBuffer::update(const StoragePtr& storage)
 {
     // Check parameters
-    if (!channelCount || !sampleRate || m_samples.empty())
+    if (!storage->channelCount || !storage->sampleRate || (storage->samples.empty() && storage->adpcm.empty()))
         return false;
 
     // Check if the format is valid
-    if (channelCount > 2){
-        err() << "Failed to load sound buffer (unsupported number of channels: " << channelCount << ")" << std::endl;
+    if (storage->channelCount > 2){
+        err() << "Failed to load sound buffer (unsupported number of channels: " << storage->channelCount << ")" << std::endl;
         return false;
     }
 
-	m_channelCount = channelCount;
-	m_sampleRate = sampleRate;
-
     // First make a copy of the list of sounds so we can reattach later
     SoundList sounds(m_sounds);
 
@@ -247,8 +309,10 @@ bool SoundBuffer::update(unsigned int channelCount, unsigned int sampleRate)
     for (SoundList::const_iterator it = sounds.begin(); it != sounds.end(); ++it)
         (*it)->resetBuffer();
 
+    m_storage = storage;
+
     // Compute the duration
-    m_duration = seconds(static_cast<float>(m_samples.size()) / sampleRate / channelCount);
+    m_duration = seconds(static_cast<float>(getSampleCount()) / storage->sampleRate / storage->channelCount);
 
     // Now reattach the buffer to the sounds that use it
     for (SoundList::const_iterator it = sounds.begin(); it != sounds.end(); ++it)
@@ -258,6 +322,48 @@ bool SoundBuffer::update(unsigned int channelCount, unsigned int sampleRate)
 }
 
 
+////////////////////////////////////////////////////////////
+bool SoundBuffer::loadAdpcm(InputStream& stream)
+{
+    priv::AdpcmHeader header;
+    if (!priv::readAdpcmHeader(stream, header))
+    {
+        err() << "Failed to load sound buffer (invalid DSP-ADPCM header)" << std::endl;
+        return false;
+    }
+
+    // The DSP only plays mono ADPCM, stereo files are decoded now
+    if (header.channelCount != 1)
+    {
+        InputSoundFile file;
+        if (file.openFromStream(stream))
+            return initialize(file);
+        else
+            return false;
+    }
+
+    std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+    storage->adpcm.resize(priv::getAdpcmSize(header.sampleCount, 1));
+    if (storage->adpcm.empty() || (stream.read(&storage->adpcm[0], storage->adpcm.size()) != static_cast<Int64>(storage->adpcm.size())))
+    {
+        err() << "Failed to load sound buffer (truncated DSP-ADPCM data)" << std::endl;
+        return false;
+    }
+
+    // Keep the frames as they are, a quarter of the size of the samples
+    memcpy(storage->adpcmCoefficients, header.channels[0].coefficients, sizeof(storage->adpcmCoefficients));
+    storage->adpcmPredictorScale = header.channels[0].predictorScale;
+    storage->adpcmSampleCount    = header.sampleCount;
+    storage->channelCount        = 1;
+    storage->sampleRate          = header.sampleRate;
+
+    // Decoded once now, so that seeking never decodes the frames before the offset
+    priv::getAdpcmHistory(&storage->adpcm[0], header.sampleCount, header.channels[0], storage->adpcmHistory);
+
+    return update(storage);
+}
+
+
 ////////////////////////////////////////////////////////////
 void SoundBuffer::attachSound(Sound* sound) const
 {
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/SoundBuffer.hpp>
+#include <cpp3ds/System/Lock.hpp>
+#include <cpp3ds/System/Mutex.hpp>
+#include <map>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+// Samples of the files loaded by living buffers, by path. Buffers
+// may be loaded from any thread, so the cache is guarded.
+////////////////////////////////////////////////////////////
+struct SoundBuffer::FileCache
+{
+    Mutex                                                mutex;
+    std::map<std::string, std::weak_ptr<const Storage> > files;
+};
+
+
+////////////////////////////////////////////////////////////
+SoundBuffer::FileCache& SoundBuffer::getFileCache()
+{
+    static FileCache cache;
+    return cache;
+}
+
+
+////////////////////////////////////////////////////////////
+SoundBuffer::StoragePtr SoundBuffer::findCachedFile(const std::string& filename)
+{
+    FileCache& cache = getFileCache();
+    Lock lock(cache.mutex);
+
+    std::map<std::string, std::weak_ptr<const Storage> >::iterator it = cache.files.find(filename);
+    if (it == cache.files.end())
+        return StoragePtr();
+
+    StoragePtr storage = it->second.lock();
+    if (!storage)
+        cache.files.erase(it);
+
+    return storage;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundBuffer::cacheFile(const std::string& filename, const StoragePtr& storage)
+{
+    FileCache& cache = getFileCache();
+    Lock lock(cache.mutex);
+
+    // Forget the files no buffer uses anymore
+    for (std::map<std::string, std::weak_ptr<const Storage> >::iterator it = cache.files.begin(); it != cache.files.end();)
+    {
+        if (it->second.expired())
+            cache.files.erase(it++);
+        else
+            ++it;
+    }
+
+    cache.files[filename] = storage;
+}
+
+} // namespace cpp3ds
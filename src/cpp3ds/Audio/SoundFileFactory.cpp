@@ -32,7 +32,10 @@
 #endif
 #ifdef CPP3DS_ENABLE_OGG
 #include <cpp3ds/Audio/SoundFileReaderOgg.hpp>
-//#include <cpp3ds/Audio/SoundFileWriterOgg.hpp>
+#ifdef EMULATION
+// Tremor only decodes, the encoder is linked in the emulator
+#include <cpp3ds/Audio/SoundFileWriterOgg.hpp>
+#endif
 #endif
 #ifdef CPP3DS_ENABLE_MP3
 #include <cpp3ds/Audio/SoundFileReaderMp3.hpp>
@@ -41,6 +44,7 @@
 #include <cpp3ds/Audio/SoundFileWriterWav.hpp>
 #include <cpp3ds/System/FileInputStream.hpp>
 #include <cpp3ds/System/MemoryInputStream.hpp>
+#include "SoundFileReaderAdpcm.hpp"
 
 
 namespace
@@ -57,13 +61,16 @@ namespace
 #endif
 #ifdef CPP3DS_ENABLE_OGG
             cpp3ds::SoundFileFactory::registerReader<cpp3ds::priv::SoundFileReaderOgg>();
-//            cpp3ds::SoundFileFactory::registerWriter<cpp3ds::priv::SoundFileWriterOgg>();
+#ifdef EMULATION
+            cpp3ds::SoundFileFactory::registerWriter<cpp3ds::priv::SoundFileWriterOgg>();
+#endif
 #endif
 #ifdef CPP3DS_ENABLE_MP3
 			cpp3ds::SoundFileFactory::registerReader<cpp3ds::priv::SoundFileReaderMp3>();
 #endif
             cpp3ds::SoundFileFactory::registerReader<cpp3ds::priv::SoundFileReaderWav>();
             cpp3ds::SoundFileFactory::registerWriter<cpp3ds::priv::SoundFileWriterWav>();
+            cpp3ds::SoundFileFactory::registerReader<cpp3ds::priv::SoundFileReaderAdpcm>();
             registered = true;
         }
     }
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "SoundFileReaderAdpcm.hpp"
+#include <cpp3ds/System/InputStream.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+bool SoundFileReaderAdpcm::check(InputStream& stream)
+{
+    return checkAdpcm(stream);
+}
+
+
+////////////////////////////////////////////////////////////
+SoundFileReaderAdpcm::SoundFileReaderAdpcm() :
+m_stream     (NULL),
+m_dataStart  (0),
+m_position   (0),
+m_frameOffset(0),
+m_frameCount (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundFileReaderAdpcm::open(InputStream& stream, Info& info)
+{
+    m_stream = &stream;
+
+    if (!readAdpcmHeader(stream, m_header))
+    {
+        err() << "Failed to open DSP-ADPCM sound file (invalid header)" << std::endl;
+        return false;
+    }
+
+    m_dataStart = stream.tell();
+    if (stream.getSize() - static_cast<Int64>(m_dataStart) < static_cast<Int64>(getAdpcmSize(m_header.sampleCount, m_header.channelCount)))
+    {
+        err() << "Failed to open DSP-ADPCM sound file (truncated data)" << std::endl;
+        return false;
+    }
+
+    info.sampleCount  = static_cast<Uint64>(m_header.sampleCount) * m_header.channelCount;
+    info.channelCount = m_header.channelCount;
+    info.sampleRate   = m_header.sampleRate;
+
+    seek(0);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileReaderAdpcm::seek(Uint64 sampleOffset)
+{
+    assert(m_stream);
+
+    std::memcpy(m_channels, m_header.channels, sizeof(m_channels));
+    m_position    = 0;
+    m_frameOffset = 0;
+    m_frameCount  = 0;
+    m_stream->seek(m_dataStart);
+
+    Uint32 target = static_cast<Uint32>(std::min<Uint64>(sampleOffset / m_header.channelCount, m_header.sampleCount));
+    while ((m_position < target) && decodeFrame())
+    {
+    }
+
+    // Skip what the last frame holds before the offset
+    if (m_position > target)
+        m_frameOffset = m_frameCount - (m_position - target) * m_header.channelCount;
+    else
+        m_frameOffset = m_frameCount;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 SoundFileReaderAdpcm::read(Int16* samples, Uint64 maxCount)
+{
+    assert(m_stream);
+
+    unsigned int channelCount = m_header.channelCount;
+    Uint64 count = 0;
+
+    while (count < maxCount)
+    {
+        // Samples left from the last frame
+        if (m_frameOffset < m_frameCount)
+        {
+            unsigned int size = static_cast<unsigned int>(std::min<Uint64>(m_frameCount - m_frameOffset, maxCount - count));
+            std::memcpy(samples + count, m_frame + m_frameOffset, size * sizeof(Int16));
+            m_frameOffset += size;
+            count += size;
+            continue;
+        }
+
+        // Whole frames are decoded straight into the output
+        Uint32 frameCount = static_cast<Uint32>(std::min<Uint64>((maxCount - count) / (AdpcmFrameSamples * channelCount),
+                                                                 (m_header.sampleCount - m_position) / AdpcmFrameSamples));
+        if (frameCount > 0)
+        {
+            m_data.resize(frameCount * AdpcmFrameSize * channelCount);
+            if (m_stream->read(&m_data[0], m_data.size()) != static_cast<Int64>(m_data.size()))
+                break;
+
+            decodeAdpcm(&m_data[0], frameCount * AdpcmFrameSamples, channelCount, m_channels, samples + count);
+            m_position += frameCount * AdpcmFrameSamples;
+            count += frameCount * AdpcmFrameSamples * channelCount;
+        }
+        else if (!decodeFrame())
+        {
+            break;
+        }
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundFileReaderAdpcm::decodeFrame()
+{
+    unsigned int channelCount = m_header.channelCount;
+    Uint32 count = std::min<Uint32>(m_header.sampleCount - m_position, AdpcmFrameSamples);
+    if (count == 0)
+        return false;
+
+    Uint8 data[AdpcmFrameSize * 2];
+    if (m_stream->read(data, AdpcmFrameSize * channelCount) != static_cast<Int64>(AdpcmFrameSize * channelCount))
+        return false;
+
+    decodeAdpcm(data, count, channelCount, m_channels, m_frame);
+    m_position   += count;
+    m_frameOffset = 0;
+    m_frameCount  = count * channelCount;
+
+    return true;
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
@@ -0,0 +1,90 @@
+#ifndef CPP3DS_SOUNDFILEREADERADPCM_HPP
+#define CPP3DS_SOUNDFILEREADERADPCM_HPP
+
+#include <cpp3ds/Audio/SoundFileReader.hpp>
+#include "AdpcmCodec.hpp"
+#include <vector>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Decodes the DSP-ADPCM sound files of the resource
+///        build in software
+///
+/// SoundBuffer keeps mono files compressed and lets the DSP
+/// decode them; this reader serves everything else: the
+/// emulator, stereo files and streaming with Music.
+///
+////////////////////////////////////////////////////////////
+class SoundFileReaderAdpcm : public SoundFileReader
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if this reader can handle a file given by an input stream
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool check(InputStream& stream);
+
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    SoundFileReaderAdpcm();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open a sound file for reading
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool open(InputStream& stream, Info& info);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the current read position to the given sample offset
+    ///
+    /// Frames depend on the ones before them, so this decodes
+    /// from the start of the file up to the offset.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void seek(Uint64 sampleOffset);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read audio samples from the open file
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Uint64 read(Int16* samples, Uint64 maxCount);
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode the next frame of each channel
+    ///
+    /// \return False at the end of the file or on error
+    ///
+    ////////////////////////////////////////////////////////////
+    bool decodeFrame();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    InputStream*       m_stream;                        ///< Source stream to read from
+    Uint64             m_dataStart;                     ///< Starting position of the frames in the open file
+    AdpcmHeader        m_header;                        ///< Header of the open file
+    AdpcmChannel       m_channels[2];                   ///< Decoding state of each channel
+    Uint32             m_position;                      ///< Samples of each channel decoded so far
+    Int16              m_frame[AdpcmFrameSamples * 2];  ///< Last decoded frame of each channel, interleaved
+    unsigned int       m_frameOffset;                   ///< Samples of the last frame already read
+    unsigned int       m_frameCount;                    ///< Samples of the last frame
+    std::vector<Uint8> m_data;                          ///< Frames being decoded
+};
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_SOUNDFILEREADERADPCM_HPP
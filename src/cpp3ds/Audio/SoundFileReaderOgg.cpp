@@ -89,7 +89,9 @@ bool SoundFileReaderOgg::check(InputStream& stream)
 ////////////////////////////////////////////////////////////
 SoundFileReaderOgg::SoundFileReaderOgg() :
 m_vorbis      (),
-m_channelCount(0)
+m_channelCount(0),
+m_frameCount  (0),
+m_seekInterval(0)
 {
     m_vorbis.datasource = NULL;
 }
@@ -121,6 +123,13 @@ bool SoundFileReaderOgg::open(InputStream& stream, Info& info)
     // We must keep the channel count for the seek function
     m_channelCount = info.channelCount;
 
+    // The seek index has a page per second, known once read through
+    m_frameCount   = std::max<ogg_int64_t>(ov_pcm_total(&m_vorbis, -1), 0);
+    m_seekInterval = std::max<ogg_int64_t>(vorbisInfo->rate, 1);
+    SeekPoint unknown = {0, -1};
+    m_seekPoints.assign(static_cast<std::size_t>(m_frameCount / m_seekInterval) + 1, unknown);
+    m_seekPoints[0].offset = ov_raw_tell(&m_vorbis);
+
     return true;
 }
 
@@ -130,7 +139,21 @@ void SoundFileReaderOgg::seek(Uint64 sampleOffset)
 {
     assert(m_vorbis.datasource);
 
-    ov_pcm_seek(&m_vorbis, sampleOffset / m_channelCount);
+    ogg_int64_t frame    = std::min<ogg_int64_t>(sampleOffset / m_channelCount, m_frameCount);
+    ogg_int64_t position = ov_pcm_tell(&m_vorbis);
+
+    // Decoding a little is cheaper than seeking around slow storage
+    if ((frame < position) || (frame - position > m_seekInterval))
+    {
+        if (!seekToIndex(frame))
+        {
+            // Nothing read close before the frame yet, bisect the file
+            ov_pcm_seek(&m_vorbis, frame);
+            return;
+        }
+    }
+
+    skip(frame - ov_pcm_tell(&m_vorbis));
 }
 
 
@@ -154,6 +177,15 @@ Uint64 SoundFileReaderOgg::read(Int16* samples, Uint64 maxCount)
             long samplesRead = bytesRead / sizeof(Int16);
             count += samplesRead;
             samples += samplesRead;
+
+            // Remember the first page read in each interval
+            ogg_int64_t frame = ov_pcm_tell(&m_vorbis);
+            std::size_t index = static_cast<std::size_t>(frame / m_seekInterval);
+            if ((index < m_seekPoints.size()) && (m_seekPoints[index].offset < 0))
+            {
+                m_seekPoints[index].frame  = frame;
+                m_seekPoints[index].offset = ov_raw_tell(&m_vorbis);
+            }
         }
         else
         {
@@ -174,6 +206,49 @@ void SoundFileReaderOgg::close()
         ov_clear(&m_vorbis);
         m_vorbis.datasource = NULL;
         m_channelCount = 0;
+        m_seekPoints.clear();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundFileReaderOgg::seekToIndex(ogg_int64_t frame)
+{
+    // Only the interval of the frame and the one before are worth
+    // it, decoding through more would be slower than bisecting
+    std::size_t index = static_cast<std::size_t>(frame / m_seekInterval);
+    for (std::size_t i = 0; (i < 2) && (i <= index); ++i)
+    {
+        SeekPoint& point = m_seekPoints[index - i];
+        if ((point.offset < 0) || (point.frame > frame))
+            continue;
+
+        if (ov_raw_seek(&m_vorbis, point.offset) != 0)
+            return false;
+
+        // The page may start after the frame it was recorded at
+        point.frame = ov_pcm_tell(&m_vorbis);
+        if (point.frame <= frame)
+            return true;
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileReaderOgg::skip(ogg_int64_t frameCount)
+{
+    Int16 buffer[2048];
+    Uint64 bufferSize = (2048 / m_channelCount) * m_channelCount;
+    Uint64 count = (frameCount > 0) ? static_cast<Uint64>(frameCount) * m_channelCount : 0;
+
+    while (count > 0)
+    {
+        Uint64 samplesRead = read(buffer, std::min(count, bufferSize));
+        if (samplesRead == 0)
+            break;
+        count -= samplesRead;
     }
 }
 
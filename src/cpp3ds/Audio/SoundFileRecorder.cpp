@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/SoundFileRecorder.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+#include <functional>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+SoundFileRecorder::SoundFileRecorder() :
+m_filename      (),
+m_file          (),
+m_queue         (),
+m_latency       (milliseconds(20)),
+m_bufferDuration(seconds(2)),
+m_written       (0),
+m_dropped       (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+SoundFileRecorder::~SoundFileRecorder()
+{
+    stopEncoding();
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileRecorder::setFile(const std::string& filename)
+{
+    m_filename = filename;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::string& SoundFileRecorder::getFile() const
+{
+    return m_filename;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileRecorder::setLatency(Time latency)
+{
+    m_latency = latency;
+}
+
+
+////////////////////////////////////////////////////////////
+Time SoundFileRecorder::getLatency() const
+{
+    return m_latency;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileRecorder::setBufferDuration(Time duration)
+{
+    m_bufferDuration = duration;
+}
+
+
+////////////////////////////////////////////////////////////
+Time SoundFileRecorder::getBufferDuration() const
+{
+    return m_bufferDuration;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 SoundFileRecorder::getSampleCount() const
+{
+    return m_written;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 SoundFileRecorder::getDroppedSampleCount() const
+{
+    return m_dropped;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundFileRecorder::onStart()
+{
+    if (m_filename.empty())
+    {
+        err() << "Failed to start recording to a file: no file was set (call SoundFileRecorder::setFile)" << std::endl;
+        return false;
+    }
+
+    setProcessingInterval(m_latency);
+
+    return startEncoding(getSampleRate());
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundFileRecorder::onProcessSamples(const Int16* samples, std::size_t sampleCount)
+{
+    // Never wait for the encoder, count what it had no room for instead
+    std::size_t pushed = m_queue.push(samples, sampleCount);
+    if (pushed < sampleCount)
+        m_dropped += sampleCount - pushed;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileRecorder::onStop()
+{
+    // The capture thread is over, the encoder writes what is left
+    stopEncoding();
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundFileRecorder::startEncoding(unsigned int sampleRate)
+{
+    // The capture is mono
+    if (!m_file.openFromFile(m_filename, sampleRate, 1))
+        return false;
+
+    m_written = 0;
+    m_dropped = 0;
+
+    // Allocate everything now, the capture thread only copies samples.
+    // The queue holds at least a few reads of the microphone, whatever the settings.
+    std::size_t latencySamples = static_cast<std::size_t>(m_latency.asSeconds() * sampleRate) + 1;
+    std::size_t bufferSamples  = static_cast<std::size_t>(m_bufferDuration.asSeconds() * sampleRate);
+    m_queue.start(std::bind(&SoundFileRecorder::writeSamples, this, std::placeholders::_1, std::placeholders::_2),
+                  std::max(bufferSamples, latencySamples * 4), std::max<std::size_t>(sampleRate / 16, latencySamples));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileRecorder::writeSamples(const Int16* samples, std::size_t count)
+{
+    m_file.write(samples, count);
+    m_written += count;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileRecorder::stopEncoding()
+{
+    m_queue.stop();
+    m_file.close();
+}
+
+} // namespace cpp3ds
@@ -31,6 +31,7 @@
 #include <cctype>
 #include <cstdlib>
 #include <cassert>
+#include <functional>
 
 
 namespace cpp3ds
@@ -53,7 +54,10 @@ m_channelCount(0),
 m_file        (),
 m_ogg         (),
 m_vorbis      (),
-m_state       ()
+m_state       (),
+m_queue       (),
+m_buffer      (),
+m_bufferCount (0)
 {
 }
 
@@ -86,7 +90,11 @@ bool SoundFileWriterOgg::open(const std::string& filename, unsigned int sampleRa
     }
     vorbis_analysis_init(&m_state, &m_vorbis);
 
-    // Open the file after the vorbis setup is ok
+    // Open the file after the vorbis setup is ok.
+    // The pages are buffered here, the stream writes them through.
+    m_buffer.resize(BufferSize);
+    m_bufferCount = 0;
+    m_file.rdbuf()->pubsetbuf(NULL, 0);
     m_file.open(filename.c_str(), std::ios::binary);
     if (!m_file)
     {
@@ -118,10 +126,12 @@ bool SoundFileWriterOgg::open(const std::string& filename, unsigned int sampleRa
     // This ensures the actual audio data will start on a new page, as per spec
     ogg_page page;
     while (ogg_stream_flush(&m_ogg, &page) > 0)
-    {
-        m_file.write(reinterpret_cast<const char*>(page.header), page.header_len);
-        m_file.write(reinterpret_cast<const char*>(page.body), page.body_len);
-    }
+        writePage(page);
+
+    // Queue a second of samples, encoded in chunks of 1/16 second
+    std::size_t chunkFrames = std::max(sampleRate / 16, 1u);
+    m_queue.start(std::bind(&SoundFileWriterOgg::encodeSamples, this, std::placeholders::_1, std::placeholders::_2),
+                  std::max(sampleRate, 1u) * channelCount, chunkFrames * channelCount);
 
     return true;
 }
@@ -129,6 +139,14 @@ bool SoundFileWriterOgg::open(const std::string& filename, unsigned int sampleRa
 
 ////////////////////////////////////////////////////////////
 void SoundFileWriterOgg::write(const Int16* samples, Uint64 count)
+{
+    // The queue holds a second of samples, only then does this wait for the encoder
+    m_queue.write(samples, static_cast<std::size_t>(count));
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileWriterOgg::encodeSamples(const Int16* samples, std::size_t count)
 {
     // Prepare a buffer to hold our samples
     int frameCount = static_cast<int>(count / m_channelCount);
@@ -167,13 +185,11 @@ void SoundFileWriterOgg::flushBlocks()
             // Write the packet to the ogg stream
             ogg_stream_packetin(&m_ogg, &packet);
 
-            // If the stream produced new pages, write them to the output file
+            // If the stream filled new pages, write them to the output file.
+            // Flushing each packet to its own page would waste bytes and writes.
             ogg_page page;
-            while (ogg_stream_flush(&m_ogg, &page) > 0)
-            {
-                m_file.write(reinterpret_cast<const char*>(page.header), page.header_len);
-                m_file.write(reinterpret_cast<const char*>(page.body), page.body_len);
-            }
+            while (ogg_stream_pageout(&m_ogg, &page) > 0)
+                writePage(page);
         }
     }
 
@@ -182,16 +198,61 @@ void SoundFileWriterOgg::flushBlocks()
 }
 
 
+////////////////////////////////////////////////////////////
+void SoundFileWriterOgg::writePage(const ogg_page& page)
+{
+    writeBytes(page.header, page.header_len);
+    writeBytes(page.body, page.body_len);
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileWriterOgg::writeBytes(const unsigned char* bytes, std::size_t count)
+{
+    while (count > 0)
+    {
+        std::size_t length = std::min(count, m_buffer.size() - m_bufferCount);
+        std::copy(bytes, bytes + length, &m_buffer[m_bufferCount]);
+        m_bufferCount += length;
+        bytes += length;
+        count -= length;
+
+        if (m_bufferCount == m_buffer.size())
+            flush();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundFileWriterOgg::flush()
+{
+    if (m_bufferCount > 0)
+    {
+        m_file.write(&m_buffer[0], m_bufferCount);
+        m_bufferCount = 0;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void SoundFileWriterOgg::close()
 {
+    // Let the encoder thread finish the queue
+    m_queue.stop();
+
     if (m_file.is_open())
     {
         // Submit an empty packet to mark the end of stream
         vorbis_analysis_wrote(&m_state, 0);
         flushBlocks();
 
+        // Write the last, partial page
+        ogg_page page;
+        while (ogg_stream_flush(&m_ogg, &page) > 0)
+            writePage(page);
+
         // Close the file
+        flush();
         m_file.close();
     }
 
@@ -199,6 +260,7 @@ void SoundFileWriterOgg::close()
     ogg_stream_clear(&m_ogg);
     vorbis_dsp_clear(&m_state);
     vorbis_info_clear(&m_vorbis);
+    std::vector<char>().swap(m_buffer);
 }
 
 } // namespace priv
@@ -34,40 +34,35 @@
 
 namespace
 {
-    // The following functions takes integers in host byte order
-    // and writes them to a stream as little endian
+    // The following functions take integers in host byte order
+    // and write them to a buffer as little endian, moving past them
 
-    void encode(std::ostream& stream, cpp3ds::Int16 value)
+    void encode(char*& out, cpp3ds::Int16 value)
     {
-        unsigned char bytes[] =
-        {
-            static_cast<unsigned char>(value & 0xFF),
-            static_cast<unsigned char>(value >> 8)
-        };
-        stream.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        *out++ = static_cast<char>(value & 0xFF);
+        *out++ = static_cast<char>(value >> 8);
     }
 
-    void encode(std::ostream& stream, cpp3ds::Uint16 value)
+    void encode(char*& out, cpp3ds::Uint16 value)
     {
-        unsigned char bytes[] =
-        {
-            static_cast<unsigned char>(value & 0xFF),
-            static_cast<unsigned char>(value >> 8)
-        };
-        stream.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        *out++ = static_cast<char>(value & 0xFF);
+        *out++ = static_cast<char>(value >> 8);
     }
 
-    void encode(std::ostream& stream, cpp3ds::Uint32 value)
+    void encode(char*& out, cpp3ds::Uint32 value)
     {
-        unsigned char bytes[] =
-        {
-            static_cast<unsigned char>(value & 0x000000FF),
-            static_cast<unsigned char>((value & 0x0000FF00) >> 8),
-            static_cast<unsigned char>((value & 0x00FF0000) >> 16),
-            static_cast<unsigned char>((value & 0xFF000000) >> 24),
-        };
-        stream.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        *out++ = static_cast<char>(value & 0x000000FF);
+        *out++ = static_cast<char>((value & 0x0000FF00) >> 8);
+        *out++ = static_cast<char>((value & 0x00FF0000) >> 16);
+        *out++ = static_cast<char>((value & 0xFF000000) >> 24);
     }
+
+    void encode(char*& out, const char (&id)[4])
+    {
+        out = std::copy(id, id + 4, out);
+    }
+
+    const std::size_t headerSize = 44;
 }
 
 namespace cpp3ds
@@ -87,6 +82,8 @@ bool SoundFileWriterWav::check(const std::string& filename)
 ////////////////////////////////////////////////////////////
 SoundFileWriterWav::SoundFileWriterWav() :
 m_file        (),
+m_buffer      (),
+m_bufferCount (0),
 m_sampleCount (0),
 m_channelCount(0)
 {
@@ -103,6 +100,12 @@ SoundFileWriterWav::~SoundFileWriterWav()
 ////////////////////////////////////////////////////////////
 bool SoundFileWriterWav::open(const std::string& filename, unsigned int sampleRate, unsigned int channelCount)
 {
+    // The samples are buffered here, the stream writes them through
+    m_buffer.resize(BufferSize);
+    m_bufferCount = 0;
+    m_sampleCount = 0;
+    m_file.rdbuf()->pubsetbuf(NULL, 0);
+
     // Open the file
     m_file.open(filename.c_str(), std::ios::binary);
     if (!m_file)
@@ -132,8 +135,21 @@ void SoundFileWriterWav::write(const Int16* samples, Uint64 count)
 
     m_sampleCount += count;
 
-    while (count--)
-        encode(m_file, *samples++);
+    while (count > 0)
+    {
+        // The header leaves an even number of bytes in the buffer
+        std::size_t length = static_cast<std::size_t>(std::min<Uint64>(count, (BufferSize - m_bufferCount) / 2));
+        char* out = &m_buffer[m_bufferCount];
+        for (std::size_t i = 0; i < length; ++i)
+            encode(out, samples[i]);
+
+        m_bufferCount += length * 2;
+        samples += length;
+        count -= length;
+
+        if (m_bufferCount == BufferSize)
+            flush();
+    }
 }
 
 
@@ -142,64 +158,89 @@ bool SoundFileWriterWav::writeHeader(unsigned int sampleRate, unsigned int chann
 {
     assert(m_file.good());
 
+    // The header starts the buffer, so that the following writes stay aligned
+    char* out = &m_buffer[0];
+
     // Write the main chunk ID
-    char mainChunkId[4] = {'R', 'I', 'F', 'F'};
-    m_file.write(mainChunkId, sizeof(mainChunkId));
+    const char mainChunkId[4] = {'R', 'I', 'F', 'F'};
+    encode(out, mainChunkId);
 
     // Write the main chunk header
     Uint32 mainChunkSize = 0; // placeholder, will be written later
-    encode(m_file, mainChunkSize);
-    char mainChunkFormat[4] = {'W', 'A', 'V', 'E'};
-    m_file.write(mainChunkFormat, sizeof(mainChunkFormat));
+    encode(out, mainChunkSize);
+    const char mainChunkFormat[4] = {'W', 'A', 'V', 'E'};
+    encode(out, mainChunkFormat);
 
     // Write the sub-chunk 1 ("format") id and size
-    char fmtChunkId[4] = {'f', 'm', 't', ' '};
-    m_file.write(fmtChunkId, sizeof(fmtChunkId));
+    const char fmtChunkId[4] = {'f', 'm', 't', ' '};
+    encode(out, fmtChunkId);
     Uint32 fmtChunkSize = 16;
-    encode(m_file, fmtChunkSize);
+    encode(out, fmtChunkSize);
 
     // Write the format (PCM)
     Uint16 format = 1;
-    encode(m_file, format);
+    encode(out, format);
 
     // Write the sound attributes
-    encode(m_file, static_cast<Uint16>(channelCount));
-    encode(m_file, static_cast<Uint32>(sampleRate));
+    encode(out, static_cast<Uint16>(channelCount));
+    encode(out, static_cast<Uint32>(sampleRate));
     Uint32 byteRate = sampleRate * channelCount * 2;
-    encode(m_file, byteRate);
+    encode(out, byteRate);
     Uint16 blockAlign = channelCount * 2;
-    encode(m_file, blockAlign);
+    encode(out, blockAlign);
     Uint16 bitsPerSample = 16;
-    encode(m_file, bitsPerSample);
+    encode(out, bitsPerSample);
 
     // Write the sub-chunk 2 ("data") id and size
-    char dataChunkId[4] = {'d', 'a', 't', 'a'};
-    m_file.write(dataChunkId, sizeof(dataChunkId));
+    const char dataChunkId[4] = {'d', 'a', 't', 'a'};
+    encode(out, dataChunkId);
     Uint32 dataChunkSize = 0; // placeholder, will be written later
-    encode(m_file, dataChunkSize);
+    encode(out, dataChunkSize);
+
+    m_bufferCount = out - &m_buffer[0];
+    assert(m_bufferCount == headerSize);
 
     return true;
 }
 
 
+////////////////////////////////////////////////////////////
+void SoundFileWriterWav::flush()
+{
+    if (m_bufferCount > 0)
+    {
+        m_file.write(&m_buffer[0], m_bufferCount);
+        m_bufferCount = 0;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void SoundFileWriterWav::close()
 {
     // If the file is open, finalize the header and close it
     if (m_file.is_open())
     {
-        m_file.flush();
+        flush();
 
         // Update the main chunk size and data sub-chunk size
-        Uint32 dataChunkSize = static_cast<Uint32>(m_sampleCount * m_channelCount * 2);
-        Uint32 mainChunkSize = dataChunkSize + 36;
+        Uint32 dataChunkSize = static_cast<Uint32>(m_sampleCount * 2);
+        Uint32 mainChunkSize = dataChunkSize + headerSize - 8;
+        char sizes[4];
+        char* out = sizes;
+        encode(out, mainChunkSize);
         m_file.seekp(4);
-        encode(m_file, mainChunkSize);
+        m_file.write(sizes, sizeof(sizes));
+        out = sizes;
+        encode(out, dataChunkSize);
         m_file.seekp(40);
-        encode(m_file, dataChunkSize);
+        m_file.write(sizes, sizeof(sizes));
 
         m_file.close();
     }
+
+    // Don't keep the buffer of a closed file
+    std::vector<char>().swap(m_buffer);
 }
 
 } // namespace priv
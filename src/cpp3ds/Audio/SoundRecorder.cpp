@@ -100,7 +100,11 @@ bool SoundRecorder::start(SampleRate sampleRate)
 		// Start the capture
 		m_bufferPos = 0;
 		if (R_FAILED(MICU_StartSampling(MICU_ENCODING_PCM16_SIGNED, static_cast<MICU_SampleRate>(sampleRate), 0, m_bufferSize, true)))
+		{
+			err() << "Failed to start sampling the microphone" << std::endl;
+			onStop();
 			return false;
+		}
 
 //		memset(&m_ndspWaveBuf, 0, sizeof(ndspWaveBuf));
 //		m_ndspWaveBuf.data_vaddr = &m_samples[0];
@@ -239,21 +243,35 @@ void SoundRecorder::processCapturedSamples()
 {
 	u32 lastOffset = micGetLastSampleOffset();
 
+	// The microphone loops over its buffer: when it started over,
+	// forward the end of the buffer before the new beginning
+	if (lastOffset < m_bufferPos)
+	{
+		forwardCapturedSamples(m_bufferSize);
+		m_bufferPos = 0;
+	}
+
 	if (lastOffset > m_bufferPos)
 	{
-		u32 samplesAvailable = lastOffset - m_bufferPos;
+		forwardCapturedSamples(lastOffset);
+		m_bufferPos = lastOffset;
+	}
+}
 
-		// Forward them to the derived class
-		if (!onProcessSamples(reinterpret_cast<Int16*>(&Service::m_micBuffer[m_bufferPos]), samplesAvailable / sizeof(Int16)))
-		{
-			// The user wants to stop the capture
-			m_isCapturing = false;
-		}
 
-		m_bufferPos += samplesAvailable;
+////////////////////////////////////////////////////////////
+void SoundRecorder::forwardCapturedSamples(u32 endOffset)
+{
+	u32 samplesAvailable = (endOffset - m_bufferPos) / sizeof(Int16);
+	if (samplesAvailable == 0)
+		return;
+
+	// Forward them to the derived class
+	if (!onProcessSamples(reinterpret_cast<Int16*>(&Service::m_micBuffer[m_bufferPos]), samplesAvailable))
+	{
+		// The user wants to stop the capture
+		m_isCapturing = false;
 	}
-	else
-		m_bufferPos = 0;
 }
 
 
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/SoundRingBuffer.hpp>
+#include <algorithm>
+#include <cstring>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+SoundRingBuffer::SoundRingBuffer() :
+m_samples   (),
+m_mask      (0),
+m_write     (0),
+m_readCache (0),
+m_read      (0),
+m_writeCache(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+SoundRingBuffer::SoundRingBuffer(std::size_t capacity) :
+m_samples   (),
+m_mask      (0),
+m_write     (0),
+m_readCache (0),
+m_read      (0),
+m_writeCache(0)
+{
+    setCapacity(capacity);
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundRingBuffer::setCapacity(std::size_t capacity)
+{
+    // Indices are wrapped with a mask
+    std::size_t size = 1;
+    while (size < capacity)
+        size *= 2;
+
+    m_samples.assign(capacity > 0 ? size : 0, 0);
+    m_mask = size - 1;
+    m_write.store(0);
+    m_read.store(0);
+    m_readCache  = 0;
+    m_writeCache = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundRingBuffer::getCapacity() const
+{
+    return m_samples.size();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundRingBuffer::push(const Int16* samples, std::size_t count)
+{
+    std::size_t write = m_write.load(std::memory_order_relaxed);
+
+    // Only look at the consumer's line when the space last seen is not enough
+    if (m_samples.size() - (write - m_readCache) < count)
+        m_readCache = m_read.load(std::memory_order_acquire);
+
+    count = std::min(count, m_samples.size() - (write - m_readCache));
+    if (count == 0)
+        return 0;
+
+    std::size_t start = write & m_mask;
+    std::size_t size  = std::min(count, m_samples.size() - start);
+    std::memcpy(&m_samples[start], samples, size * sizeof(Int16));
+    std::memcpy(&m_samples[0], samples + size, (count - size) * sizeof(Int16));
+
+    // Publish the samples
+    m_write.store(write + count, std::memory_order_release);
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundRingBuffer::pop(Int16* samples, std::size_t maxCount)
+{
+    std::size_t read = m_read.load(std::memory_order_relaxed);
+
+    // Only look at the producer's line when the samples last seen are not enough
+    if (m_writeCache - read < maxCount)
+        m_writeCache = m_write.load(std::memory_order_acquire);
+
+    std::size_t count = std::min(maxCount, m_writeCache - read);
+    if (count == 0)
+        return 0;
+
+    std::size_t start = read & m_mask;
+    std::size_t size  = std::min(count, m_samples.size() - start);
+    std::memcpy(samples, &m_samples[start], size * sizeof(Int16));
+    std::memcpy(samples + size, &m_samples[0], (count - size) * sizeof(Int16));
+
+    // Hand the space back to the producer
+    m_read.store(read + count, std::memory_order_release);
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundRingBuffer::skip(std::size_t maxCount)
+{
+    std::size_t read = m_read.load(std::memory_order_relaxed);
+
+    if (m_writeCache - read < maxCount)
+        m_writeCache = m_write.load(std::memory_order_acquire);
+
+    std::size_t count = std::min(maxCount, m_writeCache - read);
+    m_read.store(read + count, std::memory_order_release);
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundRingBuffer::clear()
+{
+    m_writeCache = m_write.load(std::memory_order_acquire);
+    m_read.store(m_writeCache, std::memory_order_release);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundRingBuffer::getCount() const
+{
+    std::size_t read = m_read.load(std::memory_order_acquire);
+    return m_write.load(std::memory_order_acquire) - read;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundRingBuffer::getFreeCount() const
+{
+    std::size_t write = m_write.load(std::memory_order_acquire);
+    return m_samples.size() - (write - m_read.load(std::memory_order_acquire));
+}
+
+} // namespace cpp3ds
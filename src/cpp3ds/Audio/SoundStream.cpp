@@ -26,6 +26,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Audio/SoundStream.hpp>
+#include <cpp3ds/Audio/AudioBus.hpp>
 #include <cpp3ds/System/Sleep.hpp>
 #include <cpp3ds/System/Err.hpp>
 #include <cpp3ds/System/Lock.hpp>
@@ -45,6 +46,12 @@ SoundStream::SoundStream()
 , m_format          (0)
 , m_loop            (false)
 , m_samplesProcessed(0)
+, m_outputSampleRate(0)
+, m_resamplerQuality(Resampler::Medium)
+, m_resampler       ()
+, m_processed       ()
+, m_bus             (NULL)
+, m_preparedBus     (NULL)
 {
 	m_thread.setPriority(0x1A);
 }
@@ -81,6 +88,9 @@ void SoundStream::initialize(unsigned int channelCount, unsigned int sampleRate)
     }
 	else
 		m_format = 1;
+
+    // Design the filters for the new rate now rather than when playing
+    m_resampler.setRates(m_sampleRate, getPlaybackRate(), m_channelCount, m_resamplerQuality);
 }
 
 
@@ -132,7 +142,7 @@ void SoundStream::play()
 
     ndspChnReset(m_channel);
     ndspChnSetInterp(m_channel, NDSP_INTERP_LINEAR);
-    ndspChnSetRate(m_channel, float(m_sampleRate));
+    ndspChnSetRate(m_channel, float(getPlaybackRate()));
     ndspChnSetFormat(m_channel, (m_channelCount == 1) ? NDSP_FORMAT_MONO_PCM16 : NDSP_FORMAT_STEREO_PCM16);
 
 	// Move to the beginning
@@ -197,6 +207,36 @@ unsigned int SoundStream::getSampleRate() const
 }
 
 
+////////////////////////////////////////////////////////////
+void SoundStream::setOutputSampleRate(unsigned int sampleRate, Resampler::Quality quality)
+{
+    m_outputSampleRate = sampleRate;
+    m_resamplerQuality = quality;
+    m_resampler.setRates(m_sampleRate, getPlaybackRate(), m_channelCount, m_resamplerQuality);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SoundStream::getOutputSampleRate() const
+{
+    return m_outputSampleRate;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundStream::setBus(AudioBus* bus)
+{
+    m_bus.store(bus);
+}
+
+
+////////////////////////////////////////////////////////////
+AudioBus* SoundStream::getBus() const
+{
+    return m_bus.load();
+}
+
+
 ////////////////////////////////////////////////////////////
 SoundStream::Status SoundStream::getStatus() const
 {
@@ -228,7 +268,7 @@ void SoundStream::setPlayingOffset(Time timeOffset)
     onSeek(timeOffset);
 
     // Restart streaming
-    m_samplesProcessed = static_cast<Uint64>(timeOffset.asSeconds() * m_sampleRate * m_channelCount);
+    m_samplesProcessed = static_cast<Uint64>(timeOffset.asSeconds() * getPlaybackRate() * m_channelCount);
 
     if (oldStatus == Stopped)
         return;
@@ -252,7 +292,7 @@ Time SoundStream::getPlayingOffset() const
                 samplePos += m_ndspWaveBuf.nsamples * m_channelCount;
         }
 
-        return seconds(static_cast<float>(m_samplesProcessed + samplePos) / m_sampleRate / m_channelCount);
+        return seconds(static_cast<float>(m_samplesProcessed + samplePos) / getPlaybackRate() / m_channelCount);
     }
     else
     {
@@ -291,9 +331,16 @@ void SoundStream::streamData()
         }
     }
 
+    // Forget the samples of the previous position
+    m_resampler.reset();
+    m_preparedBus = NULL;
+
     // Reset the buffers
     for (int i = 0; i < BufferCount; ++i)
-        m_endBuffers[i] = false;
+    {
+        m_endBuffers[i]   = false;
+        m_emptyBuffers[i] = false;
+    }
 
     // Fill the queue to start playing
     requestStop = fillQueue();
@@ -354,6 +401,11 @@ void SoundStream::streamData()
 							requestStop = true;
 					}
 				}
+				else if (m_emptyBuffers[i] && !requestStop) {
+					// The source had no data for it last time, try again
+					if (fillAndPushBuffer(i))
+						requestStop = true;
+				}
 			}
 		}
         // Leave some time for the other threads if the stream is still playing
@@ -401,7 +453,39 @@ bool SoundStream::fillAndPushBuffer(unsigned int bufferNum)
         }
     }
 
-    // Fill the buffer if some data was returned
+    // Convert the samples to the output rate, and the ones still in the filters at the end
+    AudioBus* bus = m_bus.load();
+    if (getPlaybackRate() != m_sampleRate)
+    {
+        m_processed.clear();
+        if (data.samples && data.sampleCount)
+            m_resampler.process(data.samples, data.sampleCount, m_processed);
+        if (requestStop)
+            m_resampler.flush(m_processed);
+
+        data.samples     = m_processed.empty() ? NULL : &m_processed[0];
+        data.sampleCount = m_processed.size();
+    }
+    else if (bus && data.samples && data.sampleCount)
+    {
+        // The source's samples are read-only, the bus works on a copy
+        m_processed.assign(data.samples, data.samples + data.sampleCount);
+        data.samples = &m_processed[0];
+    }
+
+    // Apply the effects
+    if (bus && data.samples && data.sampleCount)
+    {
+        if (bus != m_preparedBus)
+        {
+            bus->prepare(getPlaybackRate(), m_channelCount);
+            m_preparedBus = bus;
+        }
+        bus->process(&m_processed[0], data.sampleCount);
+    }
+
+    // Fill the buffer if some data was returned, else leave it out of the queue for now
+    m_emptyBuffers[bufferNum] = !requestStop && (!data.samples || (data.sampleCount == 0));
     if (data.samples && data.sampleCount)
     {
         auto& buffer = m_buffers[bufferNum];
@@ -454,4 +538,11 @@ void SoundStream::clearQueue()
 	m_ndspWaveBuf.status = NDSP_WBUF_FREE;
 }
 
+
+////////////////////////////////////////////////////////////
+unsigned int SoundStream::getPlaybackRate() const
+{
+    return m_outputSampleRate ? m_outputSampleRate : m_sampleRate;
+}
+
 } // namespace cpp3ds
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/SoundWriteQueue.hpp>
+#include <algorithm>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+SoundWriteQueue::SoundWriteQueue() :
+m_thread (&SoundWriteQueue::run, this),
+m_writer (),
+m_ring   (),
+m_samples(),
+m_queued (),
+m_taken  (),
+m_running(false)
+{
+    // Below the thread queuing the samples, which shouldn't wait on the writer
+    m_thread.setRelativePriority(2);
+}
+
+
+////////////////////////////////////////////////////////////
+SoundWriteQueue::~SoundWriteQueue()
+{
+    stop();
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundWriteQueue::start(const Writer& writer, std::size_t capacity, std::size_t chunkSize)
+{
+    stop();
+
+    // Allocate everything now, queuing only copies samples
+    m_writer = writer;
+    m_ring.setCapacity(capacity);
+    m_samples.resize(std::max<std::size_t>(chunkSize, 1));
+
+    m_running = true;
+    m_thread.launch();
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundWriteQueue::stop()
+{
+    if (!m_running.exchange(false))
+        return;
+
+    // Let the writer thread empty the queue
+    m_queued.post();
+    m_thread.wait();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundWriteQueue::push(const Int16* samples, std::size_t count)
+{
+    std::size_t pushed = m_ring.push(samples, count);
+    if (pushed > 0)
+        m_queued.post();
+
+    return pushed;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundWriteQueue::write(const Int16* samples, std::size_t count)
+{
+    for (;;)
+    {
+        std::size_t pushed = push(samples, count);
+        samples += pushed;
+        count -= pushed;
+        if (count == 0)
+            return;
+
+        // The queue is full, wait for the writer to take some out
+        m_taken.wait();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundWriteQueue::run()
+{
+    for (;;)
+    {
+        // Read the state first, so that no sample queued before stopping is left behind
+        bool running = m_running;
+
+        std::size_t count = m_ring.pop(&m_samples[0], m_samples.size());
+        if (count > 0)
+        {
+            m_taken.post();
+            m_writer(&m_samples[0], count);
+            continue;
+        }
+
+        if (!running)
+            return;
+
+        // Nothing to write, sleep until samples are queued or the queue stops
+        m_queued.wait();
+    }
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
@@ -0,0 +1,401 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Audio/VoiceManager.hpp>
+#include <cpp3ds/Audio/SoundBuffer.hpp>
+#include <cpp3ds/Audio/SoundStream.hpp>
+#include <cpp3ds/System/Lock.hpp>
+#include <cpp3ds/System/Mutex.hpp>
+#include "VoiceMixer.hpp"
+#include <algorithm>
+
+
+namespace
+{
+    // Frames mixed at once; the stream queues 30 chunks, this
+    // keeps the latency of a new voice under 200 ms at 22050 Hz
+    const unsigned int MixFrames = 128;
+
+    // Identifiers of mixed voices end with 0x80 + their stream
+    const cpp3ds::Uint8 StreamTag = 0x80;
+
+    cpp3ds::priv::VoiceSource getSource(const cpp3ds::SoundBuffer& buffer)
+    {
+        cpp3ds::priv::VoiceSource source;
+        source.samples      = buffer.getSamples();
+        source.channelCount = buffer.getChannelCount();
+        source.frameCount   = source.channelCount ? buffer.getSampleCount() / source.channelCount : 0;
+        source.sampleRate   = buffer.getSampleRate();
+        return source;
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+class VoiceManager::MixStream : public SoundStream
+{
+public :
+
+    MixStream(unsigned int maxVoices, unsigned int sampleRate, Uint8 tag) :
+    mixer    (maxVoices, sampleRate, tag),
+    m_samples(MixFrames * 2)
+    {
+        initialize(2, sampleRate);
+    }
+
+    ~MixStream()
+    {
+        stop();
+    }
+
+    priv::VoiceMixer mixer; ///< Voices of the stream
+    Mutex            mutex; ///< Guards the mixer against the streaming thread
+
+protected :
+
+    virtual bool onGetData(Chunk& data)
+    {
+        {
+            Lock lock(mutex);
+            mixer.mix(&m_samples[0], MixFrames);
+        }
+
+        // Silence when no voice plays, the stream never ends
+        data.samples     = &m_samples[0];
+        data.sampleCount = m_samples.size();
+        return true;
+    }
+
+    virtual void onSeek(Time)
+    {
+    }
+
+private :
+
+    std::vector<Int16> m_samples; ///< Last mixed chunk
+};
+
+
+////////////////////////////////////////////////////////////
+VoiceManager::VoiceManager(unsigned int hardwareVoices, unsigned int mixedVoices, unsigned int streamCount, unsigned int sampleRate) :
+m_hardwareVoices  (std::min(hardwareVoices, 24u)),
+m_streams         (),
+m_hardwarePriority(1),
+m_listener        (),
+m_minDistance     (1.f),
+m_maxDistance     (1000.f),
+m_serial          (1)
+{
+    for (std::size_t i = 0; i < m_hardwareVoices.size(); ++i)
+        m_hardwareVoices[i].id = 0;
+
+    // Split the voices evenly between the streams
+    streamCount = std::min(streamCount, 24u);
+    for (unsigned int i = 0; i < streamCount; ++i)
+    {
+        unsigned int voices = mixedVoices / streamCount + (i < mixedVoices % streamCount ? 1 : 0);
+        MixStream* stream = new MixStream(voices, sampleRate, static_cast<Uint8>(StreamTag + i));
+        stream->mixer.setListener(m_listener, m_minDistance, m_maxDistance);
+        stream->play();
+        m_streams.push_back(stream);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+VoiceManager::~VoiceManager()
+{
+    stopAll();
+
+    for (std::size_t i = 0; i < m_streams.size(); ++i)
+        delete m_streams[i];
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 VoiceManager::play(const SoundBuffer& buffer, int priority, float volume, bool loop)
+{
+    // Compressed buffers can only be decoded by the DSP
+    if ((priority >= m_hardwarePriority) || !buffer.getSamples())
+    {
+        if (Uint32 voice = playHardware(buffer, priority, volume, loop))
+            return voice;
+    }
+
+    return playMixed(buffer, NULL, priority, volume, loop);
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 VoiceManager::play(const SoundBuffer& buffer, const Vector3f& position, int priority, float volume, bool loop)
+{
+    return playMixed(buffer, &position, priority, volume, loop);
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::stop(Uint32 voice)
+{
+    if (HardwareVoice* hardwareVoice = findHardwareVoice(voice))
+    {
+        hardwareVoice->sound.stop();
+        hardwareVoice->id = 0;
+    }
+    else if (MixStream* stream = findStream(voice))
+    {
+        Lock lock(stream->mutex);
+        stream->mixer.stop(voice);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::stopAll()
+{
+    for (std::size_t i = 0; i < m_hardwareVoices.size(); ++i)
+    {
+        if (m_hardwareVoices[i].id)
+            m_hardwareVoices[i].sound.stop();
+        m_hardwareVoices[i].id = 0;
+    }
+
+    for (std::size_t i = 0; i < m_streams.size(); ++i)
+    {
+        Lock lock(m_streams[i]->mutex);
+        m_streams[i]->mixer.stopAll();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool VoiceManager::isPlaying(Uint32 voice) const
+{
+    if (HardwareVoice* hardwareVoice = const_cast<VoiceManager*>(this)->findHardwareVoice(voice))
+        return hardwareVoice->sound.getStatus() == Sound::Playing;
+
+    if (MixStream* stream = findStream(voice))
+    {
+        Lock lock(stream->mutex);
+        return stream->mixer.isPlaying(voice);
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::setVolume(Uint32 voice, float volume)
+{
+    if (HardwareVoice* hardwareVoice = findHardwareVoice(voice))
+        hardwareVoice->sound.setVolume(volume);
+    else if (MixStream* stream = findStream(voice))
+    {
+        Lock lock(stream->mutex);
+        stream->mixer.setVolume(voice, volume / 100.f);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::setPosition(Uint32 voice, const Vector3f& position)
+{
+    if (MixStream* stream = findStream(voice))
+    {
+        Lock lock(stream->mutex);
+        stream->mixer.setPosition(voice, position);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::setListenerPosition(const Vector3f& position)
+{
+    m_listener = position;
+    setDistances(m_minDistance, m_maxDistance);
+}
+
+
+////////////////////////////////////////////////////////////
+const Vector3f& VoiceManager::getListenerPosition() const
+{
+    return m_listener;
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::setDistances(float minDistance, float maxDistance)
+{
+    m_minDistance = minDistance;
+    m_maxDistance = std::max(minDistance, maxDistance);
+
+    for (std::size_t i = 0; i < m_streams.size(); ++i)
+    {
+        Lock lock(m_streams[i]->mutex);
+        m_streams[i]->mixer.setListener(m_listener, m_minDistance, m_maxDistance);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::setHardwarePriority(int priority)
+{
+    m_hardwarePriority = priority;
+}
+
+
+////////////////////////////////////////////////////////////
+int VoiceManager::getHardwarePriority() const
+{
+    return m_hardwarePriority;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VoiceManager::getVoiceCount() const
+{
+    unsigned int count = 0;
+    for (std::size_t i = 0; i < m_hardwareVoices.size(); ++i)
+        if (m_hardwareVoices[i].id)
+            ++count;
+
+    for (std::size_t i = 0; i < m_streams.size(); ++i)
+    {
+        Lock lock(m_streams[i]->mutex);
+        count += m_streams[i]->mixer.getVoiceCount();
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VoiceManager::getStreamCount() const
+{
+    return static_cast<unsigned int>(m_streams.size());
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::setBus(unsigned int stream, AudioBus* bus)
+{
+    if (stream < m_streams.size())
+        m_streams[stream]->setBus(bus);
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceManager::update()
+{
+    for (std::size_t i = 0; i < m_hardwareVoices.size(); ++i)
+    {
+        HardwareVoice& hardwareVoice = m_hardwareVoices[i];
+        if (hardwareVoice.id && (hardwareVoice.sound.getStatus() == Sound::Stopped))
+            hardwareVoice.id = 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 VoiceManager::playHardware(const SoundBuffer& buffer, int priority, float volume, bool loop)
+{
+    if (m_hardwareVoices.empty())
+        return 0;
+
+    // A free voice, or the oldest with the lowest priority
+    update();
+    HardwareVoice* hardwareVoice = &m_hardwareVoices[0];
+    for (std::size_t i = 0; (i < m_hardwareVoices.size()) && hardwareVoice->id; ++i)
+    {
+        HardwareVoice& other = m_hardwareVoices[i];
+        if (!other.id || (other.priority < hardwareVoice->priority) ||
+            ((other.priority == hardwareVoice->priority) && (other.id < hardwareVoice->id)))
+            hardwareVoice = &other;
+    }
+
+    // Voices as important as this one keep their channel, it is mixed instead
+    if (hardwareVoice->id)
+    {
+        if (hardwareVoice->priority >= priority)
+            return 0;
+        hardwareVoice->sound.stop();
+    }
+
+    hardwareVoice->id = 0;
+    hardwareVoice->sound.setBuffer(buffer);
+    hardwareVoice->sound.setLoop(loop);
+    hardwareVoice->sound.setVolume(volume);
+    hardwareVoice->sound.play();
+
+    // Other sounds may have taken all the channels
+    if (hardwareVoice->sound.getStatus() != Sound::Playing)
+        return 0;
+
+    Uint8 slot = static_cast<Uint8>(hardwareVoice - &m_hardwareVoices[0]);
+    hardwareVoice->id       = (m_serial << 8) | slot;
+    hardwareVoice->priority = priority;
+
+    m_serial = (m_serial + 1) & 0xFFFFFF;
+    if (m_serial == 0)
+        m_serial = 1;
+
+    return hardwareVoice->id;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 VoiceManager::playMixed(const SoundBuffer& buffer, const Vector3f* position, int priority, float volume, bool loop)
+{
+    if (m_streams.empty() || !buffer.getSamples())
+        return 0;
+
+    // Sounds too far to be heard only matter if they last
+    if (position && !loop && m_streams[0]->mixer.isCulled(*position))
+        return 0;
+
+    // The stream with the fewest voices, which steals one only if all are full
+    MixStream* stream = m_streams[0];
+    unsigned int voiceCount = 0;
+    for (std::size_t i = 0; i < m_streams.size(); ++i)
+    {
+        Lock lock(m_streams[i]->mutex);
+        unsigned int count = m_streams[i]->mixer.getVoiceCount();
+        if ((i == 0) || (count < voiceCount))
+        {
+            stream = m_streams[i];
+            voiceCount = count;
+        }
+    }
+
+    Lock lock(stream->mutex);
+    Uint32 voice = stream->mixer.play(getSource(buffer), priority, volume / 100.f, loop);
+    if (voice && position)
+        stream->mixer.setPosition(voice, *position);
+
+    return voice;
+}
+
+
+////////////////////////////////////////////////////////////
+VoiceManager::HardwareVoice* VoiceManager::findHardwareVoice(Uint32 voice)
+{
+    Uint8 slot = voice & 0xFF;
+    if ((voice == 0) || (slot >= m_hardwareVoices.size()) || (m_hardwareVoices[slot].id != voice))
+        return NULL;
+
+    return &m_hardwareVoices[slot];
+}
+
+
+////////////////////////////////////////////////////////////
+VoiceManager::MixStream* VoiceManager::findStream(Uint32 voice) const
+{
+    Uint8 tag = voice & 0xFF;
+    if ((voice == 0) || (tag < StreamTag) || (tag - StreamTag >= static_cast<int>(m_streams.size())))
+        return NULL;
+
+    return m_streams[tag - StreamTag];
+}
+
+} // namespace cpp3ds
@@ -0,0 +1,339 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "VoiceMixer.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(__ARM_FEATURE_SAT)
+#include <arm_acle.h>
+#endif
+
+
+namespace
+{
+    const cpp3ds::Uint32 OneFrame = 1 << 16;
+    const cpp3ds::Int32  FullGain = 1 << 15;
+
+    cpp3ds::Int32 toGain(float volume)
+    {
+        return static_cast<cpp3ds::Int32>(std::min(std::max(volume, 0.f), 1.f) * FullGain);
+    }
+
+    // Both loops only read the source forward and write the
+    // accumulator, so that the compiler can vectorize them
+    void mixMono(cpp3ds::Int32* accumulator, const cpp3ds::Int16* samples, unsigned int count, cpp3ds::Int32 leftGain, cpp3ds::Int32 rightGain)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            cpp3ds::Int32 sample = samples[i];
+            accumulator[i * 2 + 0] += (sample * leftGain) >> 15;
+            accumulator[i * 2 + 1] += (sample * rightGain) >> 15;
+        }
+    }
+
+    void mixStereo(cpp3ds::Int32* accumulator, const cpp3ds::Int16* samples, unsigned int count, cpp3ds::Int32 leftGain, cpp3ds::Int32 rightGain)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            accumulator[i * 2 + 0] += (samples[i * 2 + 0] * leftGain) >> 15;
+            accumulator[i * 2 + 1] += (samples[i * 2 + 1] * rightGain) >> 15;
+        }
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+bool mixVoice(Int32* accumulator, unsigned int frameCount, const VoiceSource& source, Uint64& position, Uint32 step, bool loop, Int32 leftGain, Int32 rightGain)
+{
+    if (source.frameCount == 0)
+        return false;
+
+    const Uint64 end = source.frameCount << 16;
+    while (frameCount > 0)
+    {
+        if (position >= end)
+        {
+            if (!loop)
+                return false;
+            position %= end;
+        }
+
+        // Output frames until the end of the source
+        Uint64 remaining = (end - position + step - 1) / step;
+        unsigned int count = static_cast<unsigned int>(std::min<Uint64>(frameCount, remaining));
+
+        // Culled voices only move forward
+        if ((leftGain != 0) || (rightGain != 0))
+        {
+            if (step == OneFrame)
+            {
+                const Int16* samples = source.samples + (position >> 16) * source.channelCount;
+                if (source.channelCount == 1)
+                    mixMono(accumulator, samples, count, leftGain, rightGain);
+                else
+                    mixStereo(accumulator, samples, count, leftGain, rightGain);
+            }
+            else
+            {
+                Uint64 frame = position;
+                for (unsigned int i = 0; i < count; ++i, frame += step)
+                {
+                    const Int16* sample = source.samples + (frame >> 16) * source.channelCount;
+                    accumulator[i * 2 + 0] += (sample[0] * leftGain) >> 15;
+                    accumulator[i * 2 + 1] += (sample[source.channelCount - 1] * rightGain) >> 15;
+                }
+            }
+        }
+
+        accumulator += count * 2;
+        frameCount  -= count;
+        position    += static_cast<Uint64>(step) * count;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void saturate(Int16* samples, const Int32* accumulator, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+#if defined(__ARM_FEATURE_SAT)
+        samples[i] = static_cast<Int16>(__ssat(accumulator[i], 16));
+#else
+        samples[i] = static_cast<Int16>(std::min(std::max(accumulator[i], -32768), 32767));
+#endif
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+VoiceMixer::VoiceMixer(unsigned int maxVoices, unsigned int sampleRate, Uint8 tag) :
+m_voices     (maxVoices),
+m_accumulator(),
+m_sampleRate (sampleRate),
+m_tag        (tag),
+m_serial     (1),
+m_listener   (),
+m_minDistance(1.f),
+m_maxDistance(1000.f)
+{
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+        m_voices[i].id = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 VoiceMixer::play(const VoiceSource& source, int priority, float volume, bool loop)
+{
+    if (!source.samples || (source.frameCount == 0) || (source.channelCount == 0) || (source.sampleRate == 0) || m_voices.empty())
+        return 0;
+
+    // A free voice, or the one that matters the least
+    Voice* voice = &m_voices[0];
+    for (std::size_t i = 0; (i < m_voices.size()) && voice->id; ++i)
+    {
+        Voice& other = m_voices[i];
+        if (!other.id)
+            voice = &other;
+        else if (other.priority != voice->priority)
+        {
+            if (other.priority < voice->priority)
+                voice = &other;
+        }
+        else if (other.leftGain + other.rightGain != voice->leftGain + voice->rightGain)
+        {
+            if (other.leftGain + other.rightGain < voice->leftGain + voice->rightGain)
+                voice = &other;
+        }
+        else if (other.id < voice->id)
+            voice = &other;
+    }
+
+    if (voice->id && (voice->priority > priority))
+        return 0;
+
+    voice->id         = (m_serial << 8) | m_tag;
+    voice->source     = source;
+    voice->position   = 0;
+    voice->step       = static_cast<Uint32>((static_cast<Uint64>(source.sampleRate) << 16) / m_sampleRate);
+    voice->priority   = priority;
+    voice->loop       = loop;
+    voice->volume     = volume;
+    voice->positional = false;
+    voice->location   = Vector3f();
+    updateGains(*voice);
+
+    m_serial = (m_serial + 1) & 0xFFFFFF;
+    if (m_serial == 0)
+        m_serial = 1;
+
+    return voice->id;
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceMixer::stop(Uint32 id)
+{
+    if (Voice* voice = findVoice(id))
+        voice->id = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceMixer::stopAll()
+{
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+        m_voices[i].id = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VoiceMixer::isPlaying(Uint32 id) const
+{
+    return const_cast<VoiceMixer*>(this)->findVoice(id) != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceMixer::setVolume(Uint32 id, float volume)
+{
+    if (Voice* voice = findVoice(id))
+    {
+        voice->volume = volume;
+        updateGains(*voice);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceMixer::setPosition(Uint32 id, const Vector3f& position)
+{
+    if (Voice* voice = findVoice(id))
+    {
+        voice->positional = true;
+        voice->location   = position;
+        updateGains(*voice);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceMixer::setListener(const Vector3f& position, float minDistance, float maxDistance)
+{
+    m_listener    = position;
+    m_minDistance = minDistance;
+    m_maxDistance = std::max(maxDistance, minDistance);
+
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+        if (m_voices[i].id && m_voices[i].positional)
+            updateGains(m_voices[i]);
+}
+
+
+////////////////////////////////////////////////////////////
+bool VoiceMixer::isCulled(const Vector3f& position) const
+{
+    Vector3f offset = position - m_listener;
+
+    return offset.x * offset.x + offset.y * offset.y + offset.z * offset.z >= m_maxDistance * m_maxDistance;
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceMixer::mix(Int16* samples, unsigned int frameCount)
+{
+    m_accumulator.assign(frameCount * 2, 0);
+
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+    {
+        Voice& voice = m_voices[i];
+        if (voice.id && !mixVoice(&m_accumulator[0], frameCount, voice.source, voice.position, voice.step, voice.loop, voice.leftGain, voice.rightGain))
+            voice.id = 0;
+    }
+
+    saturate(samples, &m_accumulator[0], m_accumulator.size());
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VoiceMixer::getVoiceCount() const
+{
+    unsigned int count = 0;
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+        if (m_voices[i].id)
+            ++count;
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VoiceMixer::getAudibleVoiceCount() const
+{
+    unsigned int count = 0;
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+        if (m_voices[i].id && (m_voices[i].leftGain || m_voices[i].rightGain))
+            ++count;
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VoiceMixer::getSampleRate() const
+{
+    return m_sampleRate;
+}
+
+
+////////////////////////////////////////////////////////////
+VoiceMixer::Voice* VoiceMixer::findVoice(Uint32 id)
+{
+    if (id == 0)
+        return NULL;
+
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+        if (m_voices[i].id == id)
+            return &m_voices[i];
+
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void VoiceMixer::updateGains(Voice& voice) const
+{
+    float left  = voice.volume;
+    float right = voice.volume;
+
+    if (voice.positional)
+    {
+        Vector3f offset = voice.location - m_listener;
+        float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+
+        // Linear fade between the two distances, then panned by
+        // the direction, full volume on the side it comes from
+        float attenuation = 1.f;
+        if (distance >= m_maxDistance)
+            attenuation = 0.f;
+        else if (distance > m_minDistance)
+            attenuation = (m_maxDistance - distance) / (m_maxDistance - m_minDistance);
+
+        float pan = (distance > 0.f) ? offset.x / distance : 0.f;
+        left  *= attenuation * std::min(1.f, 1.f - pan);
+        right *= attenuation * std::min(1.f, 1.f + pan);
+    }
+
+    voice.leftGain  = toGain(left);
+    voice.rightGain = toGain(right);
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
@@ -0,0 +1,212 @@
+#ifndef CPP3DS_VOICEMIXER_HPP
+#define CPP3DS_VOICEMIXER_HPP
+
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/System/Vector3.hpp>
+#include <vector>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Samples played by a voice
+///
+////////////////////////////////////////////////////////////
+struct VoiceSource
+{
+    const Int16* samples;      ///< Interleaved samples, which must stay alive while the voice plays
+    Uint64       frameCount;   ///< Number of frames (samples per channel)
+    unsigned int channelCount; ///< 1 for mono, 2 for stereo
+    unsigned int sampleRate;   ///< Frames per second
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Add a voice to a stereo accumulator
+///
+/// The voice is read from \a position, a 16.16 fixed point
+/// frame index, at \a step frames per output frame, taking the
+/// nearest frame when it doesn't match the output rate. Gains
+/// are 1.15 fixed point, 32768 being full volume.
+///
+/// \param accumulator Interleaved stereo sums, 2 * \a frameCount of them
+/// \param frameCount  Number of output frames to mix
+/// \param source      Samples of the voice
+/// \param position    Position in the voice, moved past what was mixed
+/// \param step        Source frames per output frame, 16.16 fixed point
+/// \param loop        Go back to the start at the end of the voice?
+/// \param leftGain    Gain of the left output channel
+/// \param rightGain   Gain of the right output channel
+///
+/// \return False if the voice ended before \a frameCount frames
+///
+////////////////////////////////////////////////////////////
+bool mixVoice(Int32* accumulator, unsigned int frameCount, const VoiceSource& source, Uint64& position, Uint32 step, bool loop, Int32 leftGain, Int32 rightGain);
+
+////////////////////////////////////////////////////////////
+/// \brief Clamp accumulated sums to 16-bit samples
+///
+////////////////////////////////////////////////////////////
+void saturate(Int16* samples, const Int32* accumulator, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Software mixer of many voices into one stereo stream
+///
+/// When all the voices are taken, a new one replaces the one
+/// with the lowest priority if it isn't higher than its own,
+/// the quietest of those, then the oldest. Positional voices
+/// are culled past the maximum distance: they keep their
+/// place in time but cost nothing to mix.
+///
+/// It isn't thread safe, the owner locks around it.
+///
+////////////////////////////////////////////////////////////
+class VoiceMixer
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \param maxVoices  Number of voices mixed at most
+    /// \param sampleRate Output frames per second
+    /// \param tag        Low byte of the identifiers of the voices,
+    ///                   telling them apart from other mixers'
+    ///
+    ////////////////////////////////////////////////////////////
+    VoiceMixer(unsigned int maxVoices, unsigned int sampleRate, Uint8 tag = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start a voice
+    ///
+    /// \param source   Samples to play
+    /// \param priority Voices with a higher priority are kept over it
+    /// \param volume   Volume, in [0, 1]
+    /// \param loop     Play the samples again at the end?
+    ///
+    /// \return Identifier of the voice, 0 if it was rejected
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 play(const VoiceSource& source, int priority, float volume, bool loop);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop a voice, nothing happens if it already ended
+    ///
+    ////////////////////////////////////////////////////////////
+    void stop(Uint32 id);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop all the voices
+    ///
+    ////////////////////////////////////////////////////////////
+    void stopAll();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a voice is still playing
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isPlaying(Uint32 id) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the volume of a voice, in [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    void setVolume(Uint32 id, float volume);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Make a voice positional and move it
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPosition(Uint32 id, const Vector3f& position);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the listener and the distances voices fade
+    ///        out between
+    ///
+    /// Positional voices are at full volume up to \a minDistance
+    /// from the listener, and silent and culled from
+    /// \a maxDistance. They are panned by their direction.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setListener(const Vector3f& position, float minDistance, float maxDistance);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a position is too far to be heard
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isCulled(const Vector3f& position) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mix the next frames of all the voices
+    ///
+    /// \param samples    Interleaved stereo output, 2 * \a frameCount samples
+    /// \param frameCount Number of frames to mix
+    ///
+    ////////////////////////////////////////////////////////////
+    void mix(Int16* samples, unsigned int frameCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of voices playing
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getVoiceCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of voices playing and not culled
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getAudibleVoiceCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the output frames per second
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getSampleRate() const;
+
+private :
+
+    struct Voice
+    {
+        Uint32      id;         ///< Identifier, 0 for a free voice
+        VoiceSource source;     ///< Samples played
+        Uint64      position;   ///< Position in the source, 16.16 fixed point frames
+        Uint32      step;       ///< Source frames per output frame, 16.16 fixed point
+        int         priority;   ///< Priority against stealing
+        bool        loop;       ///< Does the voice loop?
+        float       volume;     ///< Volume, in [0, 1]
+        bool        positional; ///< Is the voice attenuated and panned by its position?
+        Vector3f    location;   ///< Position of a positional voice
+        Int32       leftGain;   ///< Gain of the left channel, 1.15 fixed point
+        Int32       rightGain;  ///< Gain of the right channel, 1.15 fixed point
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find a playing voice
+    ///
+    ////////////////////////////////////////////////////////////
+    Voice* findVoice(Uint32 id);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the channel gains of a voice
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateGains(Voice& voice) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Voice>  m_voices;      ///< Voices, playing or free
+    std::vector<Int32>  m_accumulator; ///< Sums of the voices, before clamping
+    unsigned int        m_sampleRate;  ///< Output frames per second
+    Uint8               m_tag;         ///< Low byte of the identifiers
+    Uint32              m_serial;      ///< High bytes of the next identifier, increasing so that older voices have smaller ones
+    Vector3f            m_listener;    ///< Position of the listener
+    float               m_minDistance; ///< Distance up to which voices are at full volume
+    float               m_maxDistance; ///< Distance from which voices are culled
+};
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_VOICEMIXER_HPP
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "AtlasPacker.hpp"
+#include <algorithm>
+
+
+namespace
+{
+    struct Shelf
+    {
+        unsigned int page;
+        unsigned int x;
+        unsigned int y;
+        unsigned int height;
+    };
+
+    unsigned int nextPowerOfTwo(unsigned int size)
+    {
+        unsigned int powerOfTwo = 8;
+        while (powerOfTwo < size)
+            powerOfTwo *= 2;
+        return powerOfTwo;
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+std::vector<Vector2u> packAtlas(const std::vector<Vector2u>& sizes, unsigned int maxSize, unsigned int padding,
+                                std::vector<AtlasPlacement>& placements)
+{
+    placements.assign(sizes.size(), AtlasPlacement());
+
+    // Tallest first so every later rectangle fits the height of earlier shelves
+    std::vector<std::size_t> order(sizes.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&sizes](std::size_t a, std::size_t b) {
+        if (sizes[a].y != sizes[b].y)
+            return sizes[a].y > sizes[b].y;
+        return sizes[a].x > sizes[b].x;
+    });
+
+    std::vector<Shelf> shelves;
+    std::vector<unsigned int> pageTops;   // Where the next shelf of each page starts
+    std::vector<Vector2u> pageExtents;    // Bottom right corner of the used area
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const Vector2u& size = sizes[order[i]];
+        if ((size.x > maxSize) || (size.y > maxSize))
+        {
+            placements.clear();
+            return std::vector<Vector2u>();
+        }
+
+        // First shelf with room left, else a new shelf, else a new page
+        std::size_t s = 0;
+        while ((s < shelves.size()) && (shelves[s].x + size.x > maxSize))
+            ++s;
+
+        if (s == shelves.size())
+        {
+            unsigned int page = 0;
+            while ((page < pageTops.size()) && (pageTops[page] + size.y > maxSize))
+                ++page;
+            if (page == pageTops.size())
+            {
+                pageTops.push_back(0);
+                pageExtents.push_back(Vector2u(0, 0));
+            }
+
+            Shelf created = {page, 0, pageTops[page], size.y};
+            shelves.push_back(created);
+            pageTops[page] += size.y + padding;
+        }
+
+        Shelf& shelf = shelves[s];
+        AtlasPlacement& placement = placements[order[i]];
+        placement.page = shelf.page;
+        placement.rect = IntRect(shelf.x, shelf.y, size.x, size.y);
+        shelf.x += size.x + padding;
+
+        Vector2u& extent = pageExtents[shelf.page];
+        extent.x = std::max(extent.x, placement.rect.left + size.x);
+        extent.y = std::max(extent.y, placement.rect.top + size.y);
+    }
+
+    for (std::size_t i = 0; i < pageExtents.size(); ++i)
+        pageExtents[i] = Vector2u(nextPowerOfTwo(pageExtents[i].x), nextPowerOfTwo(pageExtents[i].y));
+
+    return pageExtents;
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
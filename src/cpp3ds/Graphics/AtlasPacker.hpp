@@ -0,0 +1,46 @@
+#ifndef CPP3DS_ATLASPACKER_HPP
+#define CPP3DS_ATLASPACKER_HPP
+
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/System/Vector2.hpp>
+#include <vector>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Where a packed rectangle ended up
+///
+////////////////////////////////////////////////////////////
+struct AtlasPlacement
+{
+    unsigned int page; ///< Index of the page
+    IntRect      rect; ///< Area in the page, top-down
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Pack rectangles into as few pages as possible
+///
+/// Shelf packing, tallest rectangles first. scripts/atlas_pack.py
+/// implements the same algorithm and must stay in sync.
+///
+/// \param sizes      Sizes of the rectangles
+/// \param maxSize    Maximum width and height of a page
+/// \param padding    Empty pixels kept between rectangles
+/// \param placements Receives one placement per size, in order
+///
+/// \return Size of each page rounded up to a power of two, or
+///         empty if a rectangle is larger than \a maxSize
+///
+////////////////////////////////////////////////////////////
+std::vector<Vector2u> packAtlas(const std::vector<Vector2u>& sizes, unsigned int maxSize, unsigned int padding,
+                                std::vector<AtlasPlacement>& placements);
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_ATLASPACKER_HPP
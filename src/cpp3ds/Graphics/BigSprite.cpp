@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/BigSprite.hpp>
+#include <cpp3ds/Graphics/BigTexture.hpp>
+#include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <algorithm>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+BigSprite::BigSprite() :
+m_texture   (NULL),
+m_vertices  (TrianglesStrip),
+m_tileCount (0, 0),
+m_size      (0, 0),
+m_color     (Color::White),
+m_drawnTiles(0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+BigSprite::BigSprite(const BigTexture& texture) :
+m_texture   (NULL),
+m_vertices  (TrianglesStrip),
+m_tileCount (0, 0),
+m_size      (0, 0),
+m_color     (Color::White),
+m_drawnTiles(0)
+{
+    setTexture(texture);
+}
+
+
+////////////////////////////////////////////////////////////
+BigSprite::BigSprite(const BigSprite& copy) :
+Drawable     (copy),
+Transformable(copy),
+m_texture    (NULL),
+m_vertices   (TrianglesStrip),
+m_tileCount  (0, 0),
+m_size       (0, 0),
+m_color      (copy.m_color),
+m_drawnTiles (0)
+{
+    if (copy.m_texture)
+        setTexture(*copy.m_texture);
+}
+
+
+////////////////////////////////////////////////////////////
+BigSprite& BigSprite::operator =(const BigSprite& right)
+{
+    if (this != &right)
+    {
+        Transformable::operator =(right);
+        m_color = right.m_color;
+        if (right.m_texture)
+            setTexture(*right.m_texture);
+    }
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void BigSprite::setTexture(const BigTexture& texture)
+{
+    m_texture = &texture;
+    updateVertices();
+}
+
+
+////////////////////////////////////////////////////////////
+void BigSprite::setColor(const Color& color)
+{
+    m_color = color;
+
+    for (std::size_t i = 0; i < m_vertices.getVertexCount(); ++i)
+        m_vertices[i].color = color;
+}
+
+
+////////////////////////////////////////////////////////////
+const BigTexture* BigSprite::getTexture() const
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+const Color& BigSprite::getColor() const
+{
+    return m_color;
+}
+
+
+////////////////////////////////////////////////////////////
+FloatRect BigSprite::getLocalBounds() const
+{
+    if (!m_texture)
+        return FloatRect();
+
+    Vector2u size = m_texture->getSize();
+    return FloatRect(0.f, 0.f, static_cast<float>(size.x), static_cast<float>(size.y));
+}
+
+
+////////////////////////////////////////////////////////////
+FloatRect BigSprite::getGlobalBounds() const
+{
+    return getTransform().transformRect(getLocalBounds());
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int BigSprite::getDrawnTileCount() const
+{
+    return m_drawnTiles;
+}
+
+
+////////////////////////////////////////////////////////////
+void BigSprite::draw(RenderTarget& target, RenderStates states) const
+{
+    m_drawnTiles = 0;
+    if (!m_texture)
+        return;
+
+    // The texture may have been reloaded with another tile grid
+    if ((m_texture->getTileCount() != m_tileCount) || (m_texture->getSize() != m_size))
+        updateVertices();
+
+    states.transform *= getTransform();
+
+    // Bring the view's corners (in normalized device coordinates)
+    // into local space, the tiles they cover are the visible ones
+    Transform toLocal = states.transform.getInverse() * target.getView().getInverseTransform();
+    FloatRect visible = toLocal.transformRect(FloatRect(-1.f, -1.f, 2.f, 2.f));
+
+    for (unsigned int row = 0; row < m_tileCount.y; ++row)
+    {
+        for (unsigned int column = 0; column < m_tileCount.x; ++column)
+        {
+            if (!visible.intersects(FloatRect(m_texture->getTileRect(column, row))))
+                continue;
+
+            const Texture* texture = m_texture->getTile(column, row);
+            if (!texture)
+                continue;
+
+            states.texture = texture;
+            target.draw(&m_vertices[(column + row * m_tileCount.x) * 4], 4, TrianglesStrip, states);
+            ++m_drawnTiles;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void BigSprite::updateVertices() const
+{
+    m_tileCount = m_texture->getTileCount();
+    m_size      = m_texture->getSize();
+    m_vertices.resize(m_tileCount.x * m_tileCount.y * 4);
+
+    for (unsigned int row = 0; row < m_tileCount.y; ++row)
+    {
+        for (unsigned int column = 0; column < m_tileCount.x; ++column)
+        {
+            IntRect rect = m_texture->getTileRect(column, row);
+            float left   = static_cast<float>(rect.left);
+            float top    = static_cast<float>(rect.top);
+            float width  = static_cast<float>(rect.width);
+            float height = static_cast<float>(rect.height);
+
+            // Texture coordinates are relative to the tile's own texture
+            Vertex* quad = &m_vertices[(column + row * m_tileCount.x) * 4];
+            quad[0] = Vertex(Vector2f(left, top),                  m_color, Vector2f(0.f, 0.f));
+            quad[1] = Vertex(Vector2f(left, top + height),         m_color, Vector2f(0.f, height));
+            quad[2] = Vertex(Vector2f(left + width, top),          m_color, Vector2f(width, 0.f));
+            quad[3] = Vertex(Vector2f(left + width, top + height), m_color, Vector2f(width, height));
+        }
+    }
+}
+
+} // namespace cpp3ds
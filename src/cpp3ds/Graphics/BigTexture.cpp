@@ -0,0 +1,357 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/BigTexture.hpp>
+#include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/System/InputStream.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+#include "TextureCodec.hpp"
+
+
+namespace
+{
+    // Header of preprocessed big textures (see scripts/tex_compile.py),
+    // followed by column widths, row heights and an offset/length pair per tile
+    struct BigTextureHeader
+    {
+        char           magic[4]; // "BTEX"
+        cpp3ds::Uint16 format;
+        cpp3ds::Uint16 width;
+        cpp3ds::Uint16 height;
+        cpp3ds::Uint16 columns;
+        cpp3ds::Uint16 rows;
+    };
+
+    // More small segments per axis mean more tiles and draw calls
+    // for little padding saved, so past this count they get merged
+    const unsigned int MaxRemainderSegments = 3;
+
+    unsigned int nextPowerOfTwo(unsigned int size)
+    {
+        unsigned int powerOfTwo = 8;
+        while (powerOfTwo < size)
+            powerOfTwo *= 2;
+        return powerOfTwo;
+    }
+
+    // Cuts a length into power-of-two segments covering it with little padding,
+    // largest first. 1100 becomes 1024+64+16 instead of a single 2048.
+    std::vector<unsigned int> splitSize(unsigned int size, unsigned int maxSize)
+    {
+        std::vector<unsigned int> segments;
+        while (size >= maxSize)
+        {
+            segments.push_back(maxSize);
+            size -= maxSize;
+        }
+        if (size == 0)
+            return segments;
+
+        std::size_t full = segments.size();
+
+        // Textures are at least 8 texels wide, so round up to that
+        size = (size + 7) & ~7u;
+        for (unsigned int segment = maxSize; segment >= 8; segment /= 2)
+            if (size & segment)
+                segments.push_back(segment);
+
+        while (segments.size() - full > MaxRemainderSegments)
+        {
+            unsigned int merged = segments.back();
+            segments.pop_back();
+            merged += segments.back();
+            segments.pop_back();
+            segments.push_back(nextPowerOfTwo(merged));
+        }
+
+        // Merging may have added up to a single texture's worth
+        unsigned int total = 0;
+        for (std::size_t i = full; i < segments.size(); ++i)
+            total += segments[i];
+        if ((segments.size() - full > 1) && (total == nextPowerOfTwo(total)) && (total <= maxSize))
+        {
+            segments.resize(full);
+            segments.push_back(total);
+        }
+
+        return segments;
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+BigTexture::Tile::Tile() :
+offset(0),
+length(0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+BigTexture::BigTexture() :
+m_size     (0, 0),
+m_tileCount(0, 0),
+m_format   (GPU_RGBA8),
+m_stream   (NULL),
+m_isSmooth (false)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::loadFromImage(const Image& image, GPU_TEXCOLOR format)
+{
+    cleanup();
+
+    Vector2u size = image.getSize();
+    if ((size.x == 0) || (size.y == 0))
+    {
+        err() << "Failed to load big texture, image is empty" << std::endl;
+        return false;
+    }
+
+    m_size = size;
+    m_format = format;
+    unsigned int maxSize = Texture::getMaximumSize();
+    setupGrid(splitSize(size.x, maxSize), splitSize(size.y, maxSize));
+
+    std::vector<Uint8> pixels;
+    for (std::vector<Tile>::iterator tile = m_tiles.begin(); tile != m_tiles.end(); ++tile)
+    {
+        const IntRect& rect = tile->rect;
+
+        // Copy the tile's area into a contiguous block
+        pixels.resize(rect.width * rect.height * 4);
+        const Uint8* src = image.getPixelsPtr() + (rect.left + rect.top * size.x) * 4;
+        for (int y = 0; y < rect.height; ++y)
+            std::memcpy(&pixels[y * rect.width * 4], src + y * size.x * 4, rect.width * 4);
+
+        tile->texture.reset(new Texture());
+        if (!tile->texture->create(rect.width, rect.height, format))
+        {
+            cleanup();
+            return false;
+        }
+        tile->texture->update(&pixels[0]);
+        tile->texture->setSmooth(m_isSmooth);
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::loadFromFile(const std::string& filename, GPU_TEXCOLOR format)
+{
+    Image image;
+    return image.loadFromFile(filename) && loadFromImage(image, format);
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::openFromFile(const std::string& filename)
+{
+    cleanup();
+
+    if (!m_file.open(filename))
+    {
+        err() << "Failed to open big texture \"" << filename << "\"" << std::endl;
+        return false;
+    }
+
+    return openFromStream(m_file);
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::openFromStream(InputStream& stream)
+{
+    if (&stream != &m_file)
+        cleanup();
+
+    BigTextureHeader header;
+    if ((stream.seek(0) != 0) || (stream.read(&header, sizeof(header)) != sizeof(header)) ||
+        (std::memcmp(header.magic, "BTEX", 4) != 0))
+    {
+        err() << "Failed to open big texture, invalid header" << std::endl;
+        return false;
+    }
+
+    GPU_TEXCOLOR format = static_cast<GPU_TEXCOLOR>(header.format);
+    if (!priv::getTextureFormatBits(format) || !header.columns || !header.rows)
+    {
+        err() << "Failed to open big texture, invalid header" << std::endl;
+        return false;
+    }
+
+    std::vector<Uint16> sizes(header.columns + header.rows);
+    std::vector<Uint32> table(header.columns * header.rows * 2);
+    Int64 sizesLength = sizes.size() * sizeof(Uint16);
+    Int64 tableLength = table.size() * sizeof(Uint32);
+    if ((stream.read(&sizes[0], sizesLength) != sizesLength) || (stream.read(&table[0], tableLength) != tableLength))
+    {
+        err() << "Failed to open big texture, truncated tile table" << std::endl;
+        return false;
+    }
+
+    m_size = Vector2u(header.width, header.height);
+    m_format = format;
+    m_stream = &stream;
+    setupGrid(std::vector<unsigned int>(sizes.begin(), sizes.begin() + header.columns),
+              std::vector<unsigned int>(sizes.begin() + header.columns, sizes.end()));
+
+    for (std::size_t i = 0; i < m_tiles.size(); ++i)
+    {
+        m_tiles[i].offset = table[i * 2];
+        m_tiles[i].length = table[i * 2 + 1];
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u BigTexture::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u BigTexture::getTileCount() const
+{
+    return m_tileCount;
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect BigTexture::getTileRect(unsigned int column, unsigned int row) const
+{
+    if ((column >= m_tileCount.x) || (row >= m_tileCount.y))
+        return IntRect();
+
+    return m_tiles[column + row * m_tileCount.x].rect;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* BigTexture::getTile(unsigned int column, unsigned int row) const
+{
+    if ((column >= m_tileCount.x) || (row >= m_tileCount.y))
+        return NULL;
+
+    Tile& tile = m_tiles[column + row * m_tileCount.x];
+    if (!tile.texture && !loadTile(tile))
+        return NULL;
+
+    return tile.texture.get();
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::isTileLoaded(unsigned int column, unsigned int row) const
+{
+    if ((column >= m_tileCount.x) || (row >= m_tileCount.y))
+        return false;
+
+    return static_cast<bool>(m_tiles[column + row * m_tileCount.x].texture);
+}
+
+
+////////////////////////////////////////////////////////////
+void BigTexture::unloadTiles(const FloatRect& area)
+{
+    // Tiles without a stream to reload from are never freed
+    if (!m_stream)
+        return;
+
+    for (std::vector<Tile>::iterator tile = m_tiles.begin(); tile != m_tiles.end(); ++tile)
+        if ((area.width <= 0) || (area.height <= 0) || !area.intersects(FloatRect(tile->rect)))
+            tile->texture.reset();
+}
+
+
+////////////////////////////////////////////////////////////
+void BigTexture::setSmooth(bool smooth)
+{
+    m_isSmooth = smooth;
+
+    for (std::vector<Tile>::iterator tile = m_tiles.begin(); tile != m_tiles.end(); ++tile)
+        if (tile->texture)
+            tile->texture->setSmooth(smooth);
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::isSmooth() const
+{
+    return m_isSmooth;
+}
+
+
+////////////////////////////////////////////////////////////
+void BigTexture::cleanup()
+{
+    m_tiles.clear();
+    m_size = Vector2u(0, 0);
+    m_tileCount = Vector2u(0, 0);
+    m_stream = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void BigTexture::setupGrid(const std::vector<unsigned int>& columns, const std::vector<unsigned int>& rows)
+{
+    m_tileCount = Vector2u(columns.size(), rows.size());
+    m_tiles.clear();
+    m_tiles.resize(columns.size() * rows.size());
+
+    int top = 0;
+    for (std::size_t y = 0; y < rows.size(); ++y)
+    {
+        int left = 0;
+        for (std::size_t x = 0; x < columns.size(); ++x)
+        {
+            // The last row and column are clipped to the image
+            Tile& tile = m_tiles[x + y * columns.size()];
+            tile.size = Vector2u(columns[x], rows[y]);
+            tile.rect = IntRect(left, top,
+                                std::min<int>(columns[x], m_size.x - left),
+                                std::min<int>(rows[y], m_size.y - top));
+            left += columns[x];
+        }
+        top += rows[y];
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::loadTile(Tile& tile) const
+{
+    if (!m_stream || !tile.length)
+        return false;
+
+    std::vector<Uint8> data(tile.length);
+    if ((m_stream->seek(tile.offset) != tile.offset) || (m_stream->read(&data[0], tile.length) != tile.length))
+    {
+        err() << "Failed to stream big texture tile, read error" << std::endl;
+        return false;
+    }
+
+    std::unique_ptr<Texture> texture(new Texture());
+    if (!texture->loadFromPreprocessedMemory(&data[0], data.size(), tile.size.x, tile.size.y, m_format, true))
+        return false;
+
+    texture->setSmooth(m_isSmooth);
+    tile.texture = std::move(texture);
+
+    return true;
+}
+
+} // namespace cpp3ds
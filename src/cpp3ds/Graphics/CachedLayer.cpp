@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/CachedLayer.hpp>
+#include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+    // Past this many separate areas, one full redraw is cheaper
+    const std::size_t MaxDirtyAreas = 8;
+
+    bool touches(const cpp3ds::UintRect& a, const cpp3ds::UintRect& b)
+    {
+        return (a.left <= b.left + b.width) && (b.left <= a.left + a.width) &&
+               (a.top <= b.top + b.height) && (b.top <= a.top + a.height);
+    }
+
+    cpp3ds::UintRect merge(const cpp3ds::UintRect& a, const cpp3ds::UintRect& b)
+    {
+        std::size_t left   = std::min(a.left, b.left);
+        std::size_t top    = std::min(a.top, b.top);
+        std::size_t right  = std::max(a.left + a.width, b.left + b.width);
+        std::size_t bottom = std::max(a.top + a.height, b.top + b.height);
+        return cpp3ds::UintRect(left, top, right - left, bottom - top);
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+CachedLayer::CachedLayer() :
+m_clearColor  (Color::Transparent),
+m_fullyDirty  (true),
+m_renderCount (0),
+m_partialCount(0),
+m_drawCount   (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool CachedLayer::create(unsigned int width, unsigned int height)
+{
+    if (!m_renderTexture.create(width, height))
+        return false;
+
+    m_sprite.setTexture(m_renderTexture.getTexture(), true);
+    invalidate();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void CachedLayer::add(const Drawable& drawable)
+{
+    m_children.push_back(&drawable);
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////
+void CachedLayer::remove(const Drawable& drawable)
+{
+    std::vector<const Drawable*>::iterator it = std::find(m_children.begin(), m_children.end(), &drawable);
+    if (it != m_children.end())
+    {
+        m_children.erase(it);
+        invalidate();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void CachedLayer::removeAll()
+{
+    m_children.clear();
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////
+void CachedLayer::setClearColor(const Color& color)
+{
+    m_clearColor = color;
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////
+void CachedLayer::invalidate()
+{
+    m_fullyDirty = true;
+    m_dirtyAreas.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void CachedLayer::invalidate(const FloatRect& area)
+{
+    if (m_fullyDirty)
+        return;
+
+    // Round outwards to whole pixels and clip to the layer
+    Vector2u size = m_renderTexture.getSize();
+    float left   = std::max(0.f, std::floor(area.left));
+    float top    = std::max(0.f, std::floor(area.top));
+    float right  = std::min(static_cast<float>(size.x), std::ceil(area.left + area.width));
+    float bottom = std::min(static_cast<float>(size.y), std::ceil(area.top + area.height));
+    if ((right <= left) || (bottom <= top))
+        return;
+
+    UintRect rect(static_cast<std::size_t>(left), static_cast<std::size_t>(top),
+                  static_cast<std::size_t>(right - left), static_cast<std::size_t>(bottom - top));
+
+    // Fold in the areas it touches, so each pixel is redrawn once
+    for (std::size_t i = 0; i < m_dirtyAreas.size();)
+    {
+        if (touches(rect, m_dirtyAreas[i]))
+        {
+            rect = merge(rect, m_dirtyAreas[i]);
+            m_dirtyAreas.erase(m_dirtyAreas.begin() + i);
+            i = 0;
+        }
+        else
+            ++i;
+    }
+    m_dirtyAreas.push_back(rect);
+
+    if ((m_dirtyAreas.size() > MaxDirtyAreas) || ((rect.width == size.x) && (rect.height == size.y)))
+        invalidate();
+}
+
+
+////////////////////////////////////////////////////////////
+bool CachedLayer::isDirty() const
+{
+    return m_fullyDirty || !m_dirtyAreas.empty();
+}
+
+
+////////////////////////////////////////////////////////////
+bool CachedLayer::update()
+{
+    if (!isDirty() || !m_renderTexture.getSize().x)
+        return false;
+
+    if (m_fullyDirty)
+    {
+        m_renderTexture.clear(m_clearColor);
+        for (std::vector<const Drawable*>::const_iterator child = m_children.begin(); child != m_children.end(); ++child)
+            m_renderTexture.draw(**child);
+        ++m_renderCount;
+    }
+    else
+    {
+        m_eraser.setFillColor(m_clearColor);
+        for (std::vector<UintRect>::const_iterator area = m_dirtyAreas.begin(); area != m_dirtyAreas.end(); ++area)
+        {
+            // Overwrite the area with the clear color, then redraw
+            // everything; the scissor discards what falls outside
+            RenderStates states(*area);
+            states.blendMode = BlendNone;
+            m_eraser.setPosition(static_cast<float>(area->left), static_cast<float>(area->top));
+            m_eraser.setSize(Vector2f(static_cast<float>(area->width), static_cast<float>(area->height)));
+            m_renderTexture.draw(m_eraser, states);
+
+            states.blendMode = BlendAlpha;
+            for (std::vector<const Drawable*>::const_iterator child = m_children.begin(); child != m_children.end(); ++child)
+                m_renderTexture.draw(**child, states);
+        }
+        ++m_partialCount;
+    }
+
+    m_renderTexture.display();
+    m_fullyDirty = false;
+    m_dirtyAreas.clear();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int CachedLayer::getRenderCount() const
+{
+    return m_renderCount;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int CachedLayer::getPartialRenderCount() const
+{
+    return m_partialCount;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int CachedLayer::getDrawCount() const
+{
+    return m_drawCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void CachedLayer::resetStats()
+{
+    m_renderCount  = 0;
+    m_partialCount = 0;
+    m_drawCount    = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& CachedLayer::getTexture() const
+{
+    return m_renderTexture.getTexture();
+}
+
+
+////////////////////////////////////////////////////////////
+void CachedLayer::draw(RenderTarget& target, RenderStates states) const
+{
+    states.transform *= getTransform();
+    target.draw(m_sprite, states);
+    ++m_drawCount;
+}
+
+} // namespace cpp3ds
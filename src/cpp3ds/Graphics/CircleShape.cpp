@@ -27,25 +27,63 @@
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Config.hpp>
 #include <cpp3ds/Graphics/CircleShape.hpp>
+#include <algorithm>
 #include <cmath>
+#include <map>
+
+
+namespace
+{
+    const float pi = 3.141592654f;
+
+    // Points of the circle of radius 1 centered on the origin, built once for each point count
+    const std::vector<cpp3ds::Vector2f>& getUnitCircle(unsigned int pointCount)
+    {
+        static std::map<unsigned int, std::vector<cpp3ds::Vector2f> > circles;
+
+        std::vector<cpp3ds::Vector2f>& points = circles[pointCount];
+        if (points.size() != pointCount)
+        {
+            points.resize(pointCount);
+            for (unsigned int i = 0; i < pointCount; ++i)
+            {
+                float angle = i * 2 * pi / pointCount - pi / 2;
+                points[i] = cpp3ds::Vector2f(std::cos(angle), std::sin(angle));
+            }
+        }
+
+        return points;
+    }
+}
 
 
 namespace cpp3ds
 {
 ////////////////////////////////////////////////////////////
 CircleShape::CircleShape(float radius, unsigned int pointCount) :
-m_radius    (radius),
-m_pointCount(pointCount)
+m_radius            (radius),
+m_pointCount        (pointCount),
+m_meshRadius        (radius),
+m_adaptivePointCount(false),
+m_unitPoints        (NULL)
 {
-    update();
+    rebuild();
 }
 
 
 ////////////////////////////////////////////////////////////
 void CircleShape::setRadius(float radius)
 {
+    if (radius == m_radius)
+        return;
+
     m_radius = radius;
-    update();
+
+    // The same circle, only bigger or smaller
+    if ((m_radius > 0) && (m_meshRadius > 0))
+        updateScale(m_radius / m_meshRadius);
+    else
+        rebuild();
 }
 
 
@@ -59,8 +97,12 @@ float CircleShape::getRadius() const
 ////////////////////////////////////////////////////////////
 void CircleShape::setPointCount(unsigned int count)
 {
+    m_adaptivePointCount = false;
+    if (count == m_pointCount)
+        return;
+
     m_pointCount = count;
-    update();
+    rebuild();
 }
 
 ////////////////////////////////////////////////////////////
@@ -70,16 +112,87 @@ unsigned int CircleShape::getPointCount() const
 }
 
 
+////////////////////////////////////////////////////////////
+void CircleShape::setAdaptivePointCount(bool adaptive)
+{
+    m_adaptivePointCount = adaptive;
+
+    // Until it is drawn, assume the circle isn't scaled
+    if (adaptive && (getAdaptivePointCount(m_radius) != m_pointCount))
+    {
+        m_pointCount = getAdaptivePointCount(m_radius);
+        rebuild();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool CircleShape::hasAdaptivePointCount() const
+{
+    return m_adaptivePointCount;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int CircleShape::getAdaptivePointCount(float radius)
+{
+    static const float tolerance = 0.25f;
+    static const unsigned int minCount = 8;
+    static const unsigned int maxCount = 120;
+
+    // A side of n points strays by radius * (1 - cos(pi / n)) from the circle
+    unsigned int count = minCount;
+    if (radius > tolerance)
+        count = static_cast<unsigned int>(std::ceil(pi / std::acos(1.f - tolerance / radius)));
+
+    count = (count + 3) / 4 * 4;
+
+    return std::min(std::max(count, minCount), maxCount);
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2f CircleShape::getPoint(unsigned int index) const
 {
-    static const float pi = 3.141592654f;
+    const Vector2f& point = (*m_unitPoints)[index];
+
+    return Vector2f(m_radius + point.x * m_radius, m_radius + point.y * m_radius);
+}
+
+
+////////////////////////////////////////////////////////////
+void CircleShape::draw(RenderTarget& target, RenderStates states) const
+{
+    if (m_adaptivePointCount)
+    {
+        // Length of a local unit once drawn, the longest if the scale isn't uniform
+        Transform transform = states.transform * getTransform();
+        Vector2f origin = transform.transformPoint(0.f, 0.f);
+        Vector2f x = transform.transformPoint(1.f, 0.f) - origin;
+        Vector2f y = transform.transformPoint(0.f, 1.f) - origin;
+        float scale = std::sqrt(std::max(x.x * x.x + x.y * x.y, y.x * y.x + y.y * y.y));
 
-    float angle = index * 2 * pi / m_pointCount - pi / 2;
-    float x = std::cos(angle) * m_radius;
-    float y = std::sin(angle) * m_radius;
+        // Only the geometry changes, not the circle, so it is
+        // rebuilt in place like lazily computed data
+        unsigned int count = getAdaptivePointCount(m_radius * scale);
+        if (count != m_pointCount)
+        {
+            CircleShape& self = const_cast<CircleShape&>(*this);
+            self.m_pointCount = count;
+            self.rebuild();
+        }
+    }
 
-    return Vector2f(m_radius + x, m_radius + y);
+    Shape::draw(target, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void CircleShape::rebuild()
+{
+    m_unitPoints = &getUnitCircle(m_pointCount);
+    m_meshRadius = m_radius;
+    update();
 }
 
 } // namespace cpp3ds
@@ -7,7 +7,9 @@
 #include <cpp3ds/Graphics/Console.hpp>
 #include <cpp3ds/Window/GlContext.hpp>
 #include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <cpp3ds/Graphics/TextureManager.hpp>
 #include <cpp3ds/Resources.hpp>
+#include <algorithm>
 #include <stdio.h>
 #include <sstream>
 #ifndef EMULATION
@@ -40,6 +42,19 @@ static const devoptab_t dotab_stdout = {
 
 }
 
+namespace
+{
+	const unsigned int CharacterSize = 10;
+	const float ScreenHeight = 240.f;
+
+	// Writes to stdout turned into lines per update, so that a burst
+	// of logging is spread over a few frames instead of stalling one
+	const std::size_t FlushLimit = 32;
+
+	// Seconds between two refreshes of the memory stats
+	const float MemoryRefreshInterval = 0.25f;
+}
+
 namespace cpp3ds
 {
 
@@ -48,7 +63,13 @@ bool Console::m_enabledBasic = false;
 
 ////////////////////////////////////////////////////////////
 Console::Console()
-: m_visible(true)
+: m_firstLine(0)
+, m_lineCount(0)
+, m_vertices(Triangles)
+, m_bottom(0.f)
+, m_memoryTextAge(MemoryRefreshInterval)
+, m_limit(0)
+, m_visible(true)
 {
 }
 
@@ -91,6 +112,7 @@ void Console::enable(Screen screen, Color color)
 
 		console.m_screen = screen;
 		console.m_limit = 1000;
+		console.m_lines.resize(console.m_limit);
 		console.setColor(color);
 	}
 }
@@ -130,38 +152,137 @@ bool Console::isEnabledBasic()
 ////////////////////////////////////////////////////////////
 void Console::update(float delta)
 {
-	for (String& s : g_stdout)
-		write(s);
-	g_stdout.clear();
+	// Writes that would be pushed out of the ring anyway aren't laid out
+	if (g_stdout.size() > m_limit)
+		g_stdout.erase(g_stdout.begin(), g_stdout.end() - m_limit);
 
-	if (m_lines.size() > m_limit)
-		m_lines.erase(m_lines.begin(), m_lines.end() - m_limit);
+	std::size_t count = std::min(g_stdout.size(), FlushLimit);
+	for (std::size_t i = 0; i < count; ++i)
+		write(g_stdout[i]);
+	g_stdout.erase(g_stdout.begin(), g_stdout.begin() + count);
 
+	m_memoryTextAge += delta;
 #ifndef EMULATION
-	std::ostringstream ss;
-	ss << (__linear_heap_size - linearSpaceFree()) / 1024 << "kb / " << __linear_heap_size / 1024 << "kb";
-	m_memoryText.setString(ss.str());
-	m_memoryText.setPosition((m_screen == TopScreen ? 395 : 315) - m_memoryText.getGlobalBounds().width, 5);
+	if (m_memoryTextAge >= MemoryRefreshInterval) {
+		m_memoryTextAge = 0.f;
+
+		std::ostringstream ss;
+		ss << (__linear_heap_size - linearSpaceFree()) / 1024 << "kb / " << __linear_heap_size / 1024 << "kb";
+
+		TextureManager::Stats stats = TextureManager::getInstance().getStats();
+		if (stats.textureCount)
+			ss << "\ntex " << stats.residentBytes / 1024 << "kb " << stats.residentCount << "/" << stats.textureCount
+			   << " miss " << stats.misses << " evict " << stats.evictions;
+		m_memoryText.setString(ss.str());
+		m_memoryText.setPosition((m_screen == TopScreen ? 395 : 315) - m_memoryText.getGlobalBounds().width, 5);
+	}
 #endif
+}
+
+
+////////////////////////////////////////////////////////////
+void Console::write(String text)
+{
+	std::size_t begin = 0;
+	for (std::size_t i = 0; i < text.getSize(); ++i)
+		if (text[i] == '\n') {
+			appendLine(text, begin, i);
+			begin = i + 1;
+		}
+
+	// A trailing line feed doesn't start an empty line
+	if (begin < text.getSize())
+		appendLine(text, begin, text.getSize());
+}
+
+
+////////////////////////////////////////////////////////////
+void Console::appendLine(const String& text, std::size_t begin, std::size_t end)
+{
+	if (m_limit == 0)
+		return;
 
-	int h = 240;
-	int i = m_lines.size();
+	// Push the oldest line out of a full ring, its vertices
+	// are dropped once they make up half of the buffer
+	if (m_lineCount == m_limit) {
+		m_firstLine = (m_firstLine + 1) % m_limit;
+		--m_lineCount;
+		if (m_lines[m_firstLine].begin > m_vertices.getVertexCount() / 2)
+			compact();
+	}
 
-	while (h > 0 && i > 0) {
-		Text& text = m_lines[--i];
-		h -= text.getGlobalBounds().height;
-		text.setPosition(0, h);
+	Line& line = m_lines[(m_firstLine + m_lineCount++) % m_limit];
+	line.begin = m_vertices.getVertexCount();
+	line.top   = m_bottom;
+
+	float hspace = m_font.getGlyph(L' ', CharacterSize, false).advance;
+	float x = 0.f;
+	float y = m_bottom + CharacterSize;
+	for (std::size_t i = begin; i < end; ++i) {
+		Uint32 c = text[i];
+		if (c == ' ') {
+			x += hspace;
+			continue;
+		}
+		if (c == '\t') {
+			x += hspace * 4;
+			continue;
+		}
+		if (c == '\r')
+			continue;
+
+		const Glyph& glyph = m_font.getGlyph(c, CharacterSize, false);
+		if (glyph.textureRect.width > 0 && glyph.textureRect.height > 0) {
+			float left   = x + glyph.bounds.left;
+			float top    = y + glyph.bounds.top;
+			float right  = left + glyph.bounds.width;
+			float bottom = top + glyph.bounds.height;
+
+			float u1 = static_cast<float>(glyph.textureRect.left);
+			float v1 = static_cast<float>(glyph.textureRect.top);
+			float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width);
+			float v2 = static_cast<float>(glyph.textureRect.top  + glyph.textureRect.height);
+
+			m_vertices.append(Vertex(Vector2f(left,  top),    m_color, Vector2f(u1, v1)));
+			m_vertices.append(Vertex(Vector2f(right, top),    m_color, Vector2f(u2, v1)));
+			m_vertices.append(Vertex(Vector2f(left,  bottom), m_color, Vector2f(u1, v2)));
+			m_vertices.append(Vertex(Vector2f(left,  bottom), m_color, Vector2f(u1, v2)));
+			m_vertices.append(Vertex(Vector2f(right, top),    m_color, Vector2f(u2, v1)));
+			m_vertices.append(Vertex(Vector2f(right, bottom), m_color, Vector2f(u2, v2)));
+		}
+		x += glyph.advance;
 	}
+
+	m_bottom += m_font.getLineSpacing(CharacterSize);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Console::write(String text)
+void Console::compact()
 {
-	Text line(text, m_font, 10);
-	line.setFillColor(m_color);
-	line.useSystemFont();
-	m_lines.push_back(line);
+	if (m_lineCount == 0) {
+		m_vertices.clear();
+		m_bottom = 0.f;
+		return;
+	}
+
+	// Move the remaining lines to the front, back at the top
+	const Line& first = m_lines[m_firstLine];
+	unsigned int offset = first.begin;
+	float shift = first.top;
+	unsigned int count = m_vertices.getVertexCount() - offset;
+	for (unsigned int i = 0; i < count; ++i) {
+		m_vertices[i] = m_vertices[offset + i];
+		m_vertices[i].position.y -= shift;
+	}
+	m_vertices.resize(count);
+
+	for (unsigned int i = 0; i < m_lineCount; ++i) {
+		Line& line = m_lines[(m_firstLine + i) % m_limit];
+		line.begin -= offset;
+		line.top -= shift;
+	}
+	m_bottom -= shift;
 }
 
 
@@ -206,14 +327,18 @@ void Console::draw(RenderTarget& target, RenderStates states) const
 	if (!m_visible)
 		return;
 
-	int h = 240;
-	int i = m_lines.size();
-
-	while (h > 0 && i > 0) {
-		const Text& text = m_lines[--i];
-		h -= text.getGlobalBounds().height;
-//		text.setPosition(0, h);
-		target.draw(text);
+	if (m_lineCount > 0) {
+		// Only the lines reaching the screen are drawn, in one call,
+		// moved up so that the newest one ends at the bottom
+		unsigned int rows = static_cast<unsigned int>(ScreenHeight / m_font.getLineSpacing(CharacterSize)) + 1;
+		unsigned int hidden = m_lineCount > rows ? m_lineCount - rows : 0;
+		unsigned int begin = m_lines[(m_firstLine + hidden) % m_limit].begin;
+		unsigned int count = m_vertices.getVertexCount();
+		if (begin < count) {
+			states.texture = &m_font.getTexture(CharacterSize);
+			states.transform.translate(0.f, ScreenHeight - m_bottom);
+			target.draw(&m_vertices[begin], count - begin, Triangles, states);
+		}
 	}
 
 	target.draw(m_memoryText);
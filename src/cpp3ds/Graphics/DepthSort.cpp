@@ -0,0 +1,48 @@
+#include "DepthSort.hpp"
+#include <algorithm>
+
+
+namespace
+{
+    bool isBehind(const cpp3ds::priv::DepthDraw& left, const cpp3ds::priv::DepthDraw& right)
+    {
+        return left.states.layer < right.states.layer;
+    }
+
+    bool isOpaqueDraw(const cpp3ds::priv::DepthDraw& draw)
+    {
+        return cpp3ds::priv::isOpaque(draw.states);
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+bool isOpaque(const RenderStates& states)
+{
+    return states.blendMode == BlendNone;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t sortDepthDraws(std::vector<DepthDraw>& draws)
+{
+    // Back to front, keeping the recording order within a layer
+    std::stable_sort(draws.begin(), draws.end(), isBehind);
+
+    float step = 2.f / (draws.size() + 1);
+    for (std::size_t i = 0; i < draws.size(); ++i)
+        draws[i].depth = 1.f - step * (i + 1);
+
+    std::vector<DepthDraw>::iterator translucent = std::stable_partition(draws.begin(), draws.end(), isOpaqueDraw);
+    std::reverse(draws.begin(), translucent);
+
+    return static_cast<std::size_t>(translucent - draws.begin());
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
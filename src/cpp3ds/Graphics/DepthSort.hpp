@@ -0,0 +1,61 @@
+#ifndef CPP3DS_DEPTHSORT_HPP
+#define CPP3DS_DEPTHSORT_HPP
+
+#include <cpp3ds/Graphics/PrimitiveType.hpp>
+#include <cpp3ds/Graphics/RenderStates.hpp>
+#include <cpp3ds/Graphics/Vertex.hpp>
+#include <vector>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief A draw recorded by a render target while depth
+///        sorting
+///
+////////////////////////////////////////////////////////////
+struct DepthDraw
+{
+    const Vertex* vertices;    ///< Vertices to draw, which must stay alive until the draw is submitted
+    unsigned int  vertexCount; ///< Number of vertices
+    PrimitiveType type;        ///< Type of primitives
+    RenderStates  states;      ///< States of the draw
+    float         depth;       ///< Z coordinate in [-1, 1], smaller in front, given by sortDepthDraws
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether a draw hides what is behind it
+///
+/// Only draws without blending are opaque: the depth test
+/// works per pixel, so a sprite with transparent texels must
+/// be drawn over what is behind it.
+///
+////////////////////////////////////////////////////////////
+bool isOpaque(const RenderStates& states);
+
+////////////////////////////////////////////////////////////
+/// \brief Give draws their depth and put them in submission
+///        order
+///
+/// Draws are ranked by layer, then by the order they were
+/// recorded in, as they would have covered each other without
+/// depth sorting, and each one gets its own depth from its
+/// rank. Opaque draws come first, front to back, so that the
+/// depth test rejects the pixels they hide; translucent ones
+/// follow, back to front.
+///
+/// \param draws Draws in recording order, sorted in place
+///
+/// \return Number of opaque draws at the front of \a draws
+///
+////////////////////////////////////////////////////////////
+std::size_t sortDepthDraws(std::vector<DepthDraw>& draws);
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_DEPTHSORT_HPP
@@ -29,14 +29,24 @@
 #include <cpp3ds/OpenGL.hpp>
 #include <cpp3ds/System/InputStream.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <cpp3ds/System/Lock.hpp>
+#include <cpp3ds/System/Mutex.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <cpp3ds/System/Semaphore.hpp>
+#include <cpp3ds/System/Thread.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
 #include FT_STROKER_H
+#include FT_SIZES_H
+#include FT_ADVANCES_H
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <cpp3ds/System/FileSystem.hpp>
 
 
@@ -59,18 +69,484 @@ unsigned long read(FT_Stream rec, unsigned long offset, unsigned char* buffer, u
 void close(FT_Stream)
 {
 }
+
+// Distance fields are computed from glyphs rasterized this many times larger
+const unsigned int DistanceFieldUpsample = 4;
+
+// Offer the nearest seed of a neighbor to a pixel of the distance transform
+void propagate(std::vector<int>& dx, std::vector<int>& dy, int width, int height, int x, int y, int offsetX, int offsetY)
+{
+    int nx = x + offsetX;
+    int ny = y + offsetY;
+    if ((nx < 0) || (ny < 0) || (nx >= width) || (ny >= height))
+        return;
+
+    std::size_t index    = x + y * width;
+    std::size_t neighbor = nx + ny * width;
+    int cx = dx[neighbor] + offsetX;
+    int cy = dy[neighbor] + offsetY;
+    if (cx * cx + cy * cy < dx[index] * dx[index] + dy[index] * dy[index])
+    {
+        dx[index] = cx;
+        dy[index] = cy;
+    }
+}
+
+// Distance from each pixel to the nearest seed (pixel whose inside flag is
+// equal to insideSeeds), by propagating offsets to the seeds over a forward
+// and a backward raster pass (8SSEDT)
+void distanceTransform(const std::vector<cpp3ds::Uint8>& inside, int width, int height, bool insideSeeds, std::vector<float>& distances)
+{
+    const int far = 1 << 12;
+    std::vector<int> dx(inside.size()), dy(inside.size());
+    for (std::size_t i = 0; i < inside.size(); ++i)
+        dx[i] = dy[i] = ((inside[i] != 0) == insideSeeds) ? 0 : far;
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            propagate(dx, dy, width, height, x, y, -1,  0);
+            propagate(dx, dy, width, height, x, y,  0, -1);
+            propagate(dx, dy, width, height, x, y, -1, -1);
+            propagate(dx, dy, width, height, x, y,  1, -1);
+        }
+        for (int x = width - 1; x >= 0; --x)
+            propagate(dx, dy, width, height, x, y, 1, 0);
+    }
+
+    for (int y = height - 1; y >= 0; --y)
+    {
+        for (int x = width - 1; x >= 0; --x)
+        {
+            propagate(dx, dy, width, height, x, y,  1, 0);
+            propagate(dx, dy, width, height, x, y,  0, 1);
+            propagate(dx, dy, width, height, x, y, -1, 1);
+            propagate(dx, dy, width, height, x, y,  1, 1);
+        }
+        for (int x = 0; x < width; ++x)
+            propagate(dx, dy, width, height, x, y, -1, 0);
+    }
+
+    distances.resize(inside.size());
+    for (std::size_t i = 0; i < inside.size(); ++i)
+        distances[i] = std::sqrt(static_cast<float>(dx[i] * dx[i] + dy[i] * dy[i]));
+}
+
+// Replace the RGBA coverage of a glyph rasterized `upsample` times larger
+// than needed with its signed distance field, with `spread` pixels of margin.
+// Distances from -spread (outside) to +spread (inside) are stored in the alpha
+// channel as 0 to 255, the glyph's edge being at the middle
+void makeDistanceField(std::vector<cpp3ds::Uint8>& pixels, int width, int height, int upsample, int spread, int fieldWidth, int fieldHeight)
+{
+    const int margin     = spread * upsample;
+    const int gridWidth  = fieldWidth * upsample;
+    const int gridHeight = fieldHeight * upsample;
+
+    std::vector<cpp3ds::Uint8> inside(gridWidth * gridHeight, 0);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            inside[(x + margin) + (y + margin) * gridWidth] = pixels[(x + y * width) * 4 + 3] >= 128;
+
+    std::vector<float> toOutside, toInside;
+    distanceTransform(inside, gridWidth, gridHeight, false, toOutside);
+    distanceTransform(inside, gridWidth, gridHeight, true, toInside);
+
+    // Average the four pixels around the middle of each block of the fine grid
+    pixels.assign(fieldWidth * fieldHeight * 4, 255);
+    for (int y = 0; y < fieldHeight; ++y)
+    {
+        for (int x = 0; x < fieldWidth; ++x)
+        {
+            float distance = 0.f;
+            for (int i = 0; i < 4; ++i)
+            {
+                std::size_t index = (x * upsample + (upsample - 1) / 2 + i % 2) + (y * upsample + (upsample - 1) / 2 + i / 2) * gridWidth;
+                distance += inside[index] ? toOutside[index] - 0.5f : 0.5f - toInside[index];
+            }
+            distance /= 4;
+
+            float value = std::min(std::max(0.5f + distance / (2.f * margin), 0.f), 1.f);
+            pixels[(x + y * fieldWidth) * 4 + 3] = static_cast<cpp3ds::Uint8>(value * 255.f + 0.5f);
+        }
+    }
+}
+
+// Rasterize a glyph with a face already set to its character size (times
+// DistanceFieldUpsample for distance fields). Fills the glyph's advance and
+// bounds, and the RGBA pixels and size of its bitmap; the texture rectangle is
+// left to the caller. It only uses the FreeType objects it is given, so the
+// glyph loader's thread can run it on its own face.
+bool rasterizeGlyph(FT_Library library, FT_Face face, FT_Stroker stroker, cpp3ds::Uint32 codePoint, bool bold, float outlineThickness,
+                    bool distanceField, cpp3ds::Glyph& glyph, std::vector<cpp3ds::Uint8>& pixelBuffer, cpp3ds::Vector2u& size)
+{
+    const int upsample = distanceField ? DistanceFieldUpsample : 1;
+    size = cpp3ds::Vector2u(0, 0);
+
+    // Load the glyph corresponding to the code point
+    FT_Int32 flags = FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT;
+    if (outlineThickness != 0)
+        flags |= FT_LOAD_NO_BITMAP;
+    if (FT_Load_Char(face, codePoint, flags) != 0)
+        return false;
+
+    // Retrieve the glyph
+    FT_Glyph glyphDesc;
+    if (FT_Get_Glyph(face->glyph, &glyphDesc) != 0)
+        return false;
+
+    // Apply bold and outline (there is no fallback for outline) if necessary -- first technique using outline (highest quality)
+    FT_Pos weight = (1 << 6) * upsample;
+    bool outline = (glyphDesc->format == FT_GLYPH_FORMAT_OUTLINE);
+    if (outline)
+    {
+        if (bold)
+        {
+            FT_OutlineGlyph outlineGlyph = (FT_OutlineGlyph)glyphDesc;
+            FT_Outline_Embolden(&outlineGlyph->outline, weight);
+        }
+
+        if (outlineThickness != 0)
+        {
+            FT_Stroker_Set(stroker, static_cast<FT_Fixed>(outlineThickness * static_cast<float>(1 << 6)), FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+            FT_Glyph_Stroke(&glyphDesc, stroker, false);
+        }
+    }
+
+    // Convert the glyph to a bitmap (i.e. rasterize it)
+    FT_Glyph_To_Bitmap(&glyphDesc, FT_RENDER_MODE_NORMAL, 0, 1);
+    FT_Bitmap& bitmap = reinterpret_cast<FT_BitmapGlyph>(glyphDesc)->bitmap;
+
+    // Apply bold if necessary -- fallback technique using bitmap (lower quality)
+    if (!outline)
+    {
+        if (bold)
+            FT_Bitmap_Embolden(library, &bitmap, weight, weight);
+
+        if (outlineThickness != 0)
+            cpp3ds::err() << "Failed to outline glyph (no fallback available)" << std::endl;
+    }
+
+    // Compute the glyph's advance offset
+    glyph.advance = static_cast<float>(face->glyph->metrics.horiAdvance) / static_cast<float>(1 << 6);
+    if (bold)
+        glyph.advance += static_cast<float>(weight) / static_cast<float>(1 << 6);
+    glyph.advance /= upsample;
+
+    int width  = bitmap.width;
+    int height = bitmap.rows;
+
+    if ((width > 0) && (height > 0))
+    {
+        // Distance fields are smaller than the rasterization, plus their margin
+        const int spread = cpp3ds::Font::DistanceFieldSpread;
+        size.x = width;
+        size.y = height;
+        if (distanceField)
+        {
+            size.x = (width  + upsample - 1) / upsample + 2 * spread;
+            size.y = (height + upsample - 1) / upsample + 2 * spread;
+        }
+
+        // Compute the glyph's bounding box
+        glyph.bounds.left   =  static_cast<float>(face->glyph->metrics.horiBearingX) / static_cast<float>(1 << 6);
+        glyph.bounds.top    = -static_cast<float>(face->glyph->metrics.horiBearingY) / static_cast<float>(1 << 6);
+        glyph.bounds.width  =  static_cast<float>(face->glyph->metrics.width)        / static_cast<float>(1 << 6) + outlineThickness * 2;
+        glyph.bounds.height =  static_cast<float>(face->glyph->metrics.height)       / static_cast<float>(1 << 6) + outlineThickness * 2;
+
+        // Distance fields cover their margin, from the bitmap's origin
+        if (distanceField)
+        {
+            FT_BitmapGlyph bitmapGlyph = reinterpret_cast<FT_BitmapGlyph>(glyphDesc);
+            glyph.bounds.left   =  static_cast<float>(bitmapGlyph->left) / upsample - spread;
+            glyph.bounds.top    = -static_cast<float>(bitmapGlyph->top)  / upsample - spread;
+            glyph.bounds.width  =  static_cast<float>(size.x);
+            glyph.bounds.height =  static_cast<float>(size.y);
+        }
+
+        // Extract the glyph's pixels from the bitmap
+        pixelBuffer.resize(width * height * 4, 255);
+        const cpp3ds::Uint8* pixels = bitmap.buffer;
+        if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+        {
+            // Pixels are 1 bit monochrome values
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    // The color channels remain white, just fill the alpha channel
+                    std::size_t index = (x + y * width) * 4 + 3;
+                    pixelBuffer[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
+                }
+                pixels += bitmap.pitch;
+            }
+        }
+        else
+        {
+            // Pixels are 8 bits gray levels
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    // The color channels remain white, just fill the alpha channel
+                    std::size_t index = (x + y * width) * 4 + 3;
+                    pixelBuffer[index] = pixels[x];
+                }
+                pixels += bitmap.pitch;
+            }
+        }
+
+        if (distanceField)
+            makeDistanceField(pixelBuffer, width, height, upsample, spread, size.x, size.y);
+    }
+
+    // Delete the FT glyph
+    FT_Done_Glyph(glyphDesc);
+
+    return true;
+}
+
+// Open a face from a file, or from memory when no filename is given,
+// with its Unicode character map selected
+FT_Face openFace(FT_Library library, const std::string& filename, const void* data, std::size_t size)
+{
+    FT_Face face;
+    FT_Error error = filename.empty() ? FT_New_Memory_Face(library, static_cast<const FT_Byte*>(data), static_cast<FT_Long>(size), 0, &face)
+                                      : FT_New_Face(library, filename.c_str(), 0, &face);
+    if (error != 0)
+        return NULL;
+
+    if (FT_Select_Charmap(face, FT_ENCODING_UNICODE) != 0)
+    {
+        FT_Done_Face(face);
+        return NULL;
+    }
+
+    return face;
+}
+
+// Switch a face to its FT_Size for the pixel size, created the first time,
+// the way Font::setCurrentSize does for the font's own face
+bool activateSize(FT_Face face, std::map<FT_UInt, FT_Size>& sizes, FT_UInt pixelSize)
+{
+    std::map<FT_UInt, FT_Size>::const_iterator it = sizes.find(pixelSize);
+    if (it != sizes.end())
+        return (face->size == it->second) || (FT_Activate_Size(it->second) == 0);
+
+    FT_Size size;
+    if (FT_New_Size(face, &size) != 0)
+        return false;
+    FT_Activate_Size(size);
+
+    if (FT_Set_Pixel_Sizes(face, 0, pixelSize) != 0)
+    {
+        FT_Done_Size(size);
+        return false;
+    }
+
+    sizes[pixelSize] = size;
+    return true;
+}
+
+// Fonts with a running glyph loader, committed by Font::commitPendingGlyphs
+std::vector<const cpp3ds::Font*>& getLoadingFonts()
+{
+    static std::vector<const cpp3ds::Font*> fonts;
+    return fonts;
+}
+
+unsigned int glyphUploadBudget = 8;
 }
 
 
 namespace cpp3ds
 {
+////////////////////////////////////////////////////////////
+const unsigned int Font::DistanceFieldSize;
+const unsigned int Font::DistanceFieldSpread;
+
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// Rasterizes glyphs on a worker thread, with its own FreeType
+/// library and faces so that it never contends with the font
+////////////////////////////////////////////////////////////
+class GlyphLoader : NonCopyable
+{
+public:
+
+    struct Request
+    {
+        Uint64       key;
+        unsigned int face;
+        unsigned int characterSize;
+        Uint32       codePoint;
+        bool         bold;
+        float        outlineThickness;
+    };
+
+    struct Result
+    {
+        Request            request;
+        Glyph              glyph;
+        std::vector<Uint8> pixels;
+        Vector2u           size;
+    };
+
+    explicit GlyphLoader(const Font& font) :
+    m_library      (NULL),
+    m_stroker      (NULL),
+    m_distanceField(font.m_isDistanceField),
+    m_thread       (&GlyphLoader::run, this),
+    m_running      (false)
+    {
+        // Fallbacks are opened when a request first needs them
+        m_sources.push_back(font.m_source);
+        for (std::size_t i = 0; i < font.m_fallbacks.size(); ++i)
+            m_sources.push_back(font.m_fallbacks[i].source);
+        m_faces.resize(m_sources.size(), NULL);
+        m_sizes.resize(m_sources.size());
+
+        FT_Library library;
+        if (FT_Init_FreeType(&library) != 0)
+            return;
+        m_library = library;
+
+        if (!getFace(0))
+            return;
+
+        FT_Stroker stroker;
+        if (FT_Stroker_New(library, &stroker) != 0)
+            return;
+        m_stroker = stroker;
+
+        // FreeType needs more stack than the default when stroking
+        m_running = true;
+        m_thread.setStackSize(64 * 1024);
+        m_thread.launch();
+    }
+
+    ~GlyphLoader()
+    {
+        {
+            Lock lock(m_mutex);
+            m_running = false;
+        }
+        m_pending.post();
+        m_thread.wait();
+
+        if (m_stroker)
+            FT_Stroker_Done(m_stroker);
+        for (std::size_t i = 0; i < m_faces.size(); ++i)
+            if (m_faces[i])
+                FT_Done_Face(m_faces[i]);
+        if (m_library)
+            FT_Done_FreeType(m_library);
+    }
+
+    bool isRunning() const
+    {
+        return m_running;
+    }
+
+    void push(const Request& request)
+    {
+        {
+            Lock lock(m_mutex);
+            m_requests.push_back(request);
+        }
+        m_pending.post();
+    }
+
+    bool pop(Result& result)
+    {
+        Lock lock(m_mutex);
+        if (m_results.empty())
+            return false;
+
+        result = std::move(m_results.front());
+        m_results.pop_front();
+        return true;
+    }
+
+private:
+
+    FT_Face getFace(unsigned int index)
+    {
+        if (index >= m_faces.size())
+            return NULL;
+
+        if (!m_faces[index])
+            m_faces[index] = openFace(m_library, m_sources[index].filename, m_sources[index].data, m_sources[index].size);
+
+        return m_faces[index];
+    }
+
+    void run()
+    {
+        std::vector<Uint8> pixels;
+        for (;;)
+        {
+            // Sleep until a request is queued, or the loader stops
+            m_pending.wait();
+
+            Request request;
+            {
+                Lock lock(m_mutex);
+                if (!m_running)
+                    return;
+                if (m_requests.empty())
+                    continue;
+
+                request = m_requests.front();
+                m_requests.pop_front();
+            }
+
+            Result result;
+            result.request = request;
+            FT_Face face = getFace(request.face);
+            FT_UInt pixelSize = request.characterSize * (m_distanceField ? DistanceFieldUpsample : 1);
+            if (face && activateSize(face, m_sizes[request.face], pixelSize))
+            {
+                rasterizeGlyph(m_library, face, m_stroker, request.codePoint, request.bold, request.outlineThickness,
+                               m_distanceField, result.glyph, pixels, result.size);
+                result.pixels.assign(pixels.begin(), pixels.begin() + result.size.x * result.size.y * 4);
+            }
+
+            Lock lock(m_mutex);
+            m_results.push_back(std::move(result));
+        }
+    }
+
+    FT_Library           m_library;
+    std::vector<Font::Source> m_sources;
+    std::vector<FT_Face> m_faces;
+    std::vector<std::map<FT_UInt, FT_Size> > m_sizes;
+    FT_Stroker           m_stroker;
+    bool                m_distanceField;
+    Thread              m_thread;
+    Mutex               m_mutex;
+    Semaphore           m_pending;
+    std::deque<Request> m_requests;
+    std::deque<Result>  m_results;
+    bool                m_running;
+};
+
+} // namespace priv
+
+
 ////////////////////////////////////////////////////////////
 Font::Font() :
         m_library  (NULL),
         m_face     (NULL),
         m_streamRec(NULL),
         m_refCount (NULL),
-        m_info     ()
+        m_info     (),
+        m_isDistanceField(false),
+        m_isAsync        (false),
+        m_glyphLoader    (NULL),
+        m_updateCount    (0)
 {
 }
 
@@ -83,8 +559,27 @@ Font::Font(const Font& copy) :
         m_refCount   (copy.m_refCount),
         m_info       (copy.m_info),
         m_pages      (copy.m_pages),
-        m_pixelBuffer(copy.m_pixelBuffer)
+        m_pixelBuffer(copy.m_pixelBuffer),
+        m_scaledGlyphs(copy.m_scaledGlyphs),
+        m_sizes(copy.m_sizes),
+        m_isDistanceField(copy.m_isDistanceField),
+        m_isAsync        (copy.m_isAsync),
+        m_glyphLoader    (NULL),
+        m_pendingGlyphs  (copy.m_pendingGlyphs),
+        m_updateCount    (0),
+        m_source         (copy.m_source),
+        m_fallbacks      (copy.m_fallbacks),
+        m_faceIndices    (copy.m_faceIndices)
 {
+    // The copy has its own loader, it will request the glyphs still loading again
+    stopGlyphLoader();
+
+    // Fallback faces aren't shared, the copy opens its own when it needs them
+    for (std::size_t i = 0; i < m_fallbacks.size(); ++i)
+    {
+        m_fallbacks[i].face = NULL;
+        m_fallbacks[i].sizes.clear();
+    }
 
     // Note: as FreeType doesn't provide functions for copying/cloning,
     // we must share all the FreeType pointers
@@ -150,6 +645,9 @@ bool Font::loadFromFile(const std::string& filename)
     // Store the font information
     m_info.family = face->family_name ? face->family_name : std::string();
 
+    // Remember the source, the glyph loader opens it again
+    m_source.filename = FileSystem::getFilePath(filename);
+
     return true;
 }
 
@@ -203,6 +701,10 @@ bool Font::loadFromMemory(const void* data, std::size_t sizeInBytes)
     // Store the font information
     m_info.family = face->family_name ? face->family_name : std::string();
 
+    // Remember the source, the glyph loader opens it again
+    m_source.data = data;
+    m_source.size = sizeInBytes;
+
     return true;
 }
 
@@ -292,6 +794,37 @@ const Font::Info& Font::getInfo() const
 ////////////////////////////////////////////////////////////
 const Glyph& Font::getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const
 {
+    if (m_isDistanceField)
+    {
+        // Outlines are drawn from the same field, so only bold matters
+        Uint64 key = (static_cast<Uint64>(bold ? 1 : 0) << 31) | static_cast<Uint64>(codePoint);
+
+        GlyphTable& scaledGlyphs = m_scaledGlyphs[characterSize];
+        GlyphTable::const_iterator it = scaledGlyphs.find(key);
+        if (it != scaledGlyphs.end())
+            return it->second;
+
+        // The field is rasterized once, then its metrics are scaled to each size
+        GlyphTable& fields = m_pages[DistanceFieldSize].glyphs;
+        GlyphTable::const_iterator field = fields.find(key);
+        if (field == fields.end())
+        {
+            Glyph loaded = m_isAsync ? requestGlyph(codePoint, DistanceFieldSize, bold, 0, key)
+                                     : loadGlyph(codePoint, DistanceFieldSize, bold, 0);
+            field = fields.insert(std::make_pair(key, loaded)).first;
+        }
+
+        Glyph glyph = field->second;
+        float scale = static_cast<float>(characterSize) / DistanceFieldSize;
+        glyph.advance       *= scale;
+        glyph.bounds.left   *= scale;
+        glyph.bounds.top    *= scale;
+        glyph.bounds.width  *= scale;
+        glyph.bounds.height *= scale;
+
+        return scaledGlyphs.insert(std::make_pair(key, glyph)).first->second;
+    }
+
     // Get the page corresponding to the character size
     GlyphTable& glyphs = m_pages[characterSize].glyphs;
 
@@ -309,8 +842,9 @@ const Glyph& Font::getGlyph(Uint32 codePoint, unsigned int characterSize, bool b
     }
     else
     {
-        // Not found: we have to load it
-        Glyph glyph = loadGlyph(codePoint, characterSize, bold, outlineThickness);
+        // Not found: we have to load it, or have it loaded in the background
+        Glyph glyph = m_isAsync ? requestGlyph(codePoint, characterSize, bold, outlineThickness, key)
+                                : loadGlyph(codePoint, characterSize, bold, outlineThickness);
         return glyphs.insert(std::make_pair(key, glyph)).first->second;
     }
 }
@@ -323,6 +857,10 @@ float Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize)
     if (first == 0 || second == 0)
         return 0.f;
 
+    // Kerning pairs only exist within the font's own face
+    if ((findFace(first) != 0) || (findFace(second) != 0))
+        return 0.f;
+
     FT_Face face = static_cast<FT_Face>(m_face);
 
     if (face && FT_HAS_KERNING(face) && setCurrentSize(characterSize))
@@ -357,7 +895,7 @@ float Font::getLineSpacing(unsigned int characterSize) const
 
     if (face && setCurrentSize(characterSize))
     {
-        return static_cast<float>(face->size->metrics.height) / static_cast<float>(1 << 6);
+        return m_sizes.find(characterSize)->second.lineSpacing;
     }
     else
     {
@@ -373,11 +911,7 @@ float Font::getUnderlinePosition(unsigned int characterSize) const
 
     if (face && setCurrentSize(characterSize))
     {
-        // Return a fixed position if font is a bitmap font
-        if (!FT_IS_SCALABLE(face))
-            return characterSize / 10.f;
-
-        return -static_cast<float>(FT_MulFix(face->underline_position, face->size->metrics.y_scale)) / static_cast<float>(1 << 6);
+        return m_sizes.find(characterSize)->second.underlinePosition;
     }
     else
     {
@@ -393,11 +927,7 @@ float Font::getUnderlineThickness(unsigned int characterSize) const
 
     if (face && setCurrentSize(characterSize))
     {
-        // Return a fixed thickness if font is a bitmap font
-        if (!FT_IS_SCALABLE(face))
-            return characterSize / 14.f;
-
-        return static_cast<float>(FT_MulFix(face->underline_thickness, face->size->metrics.y_scale)) / static_cast<float>(1 << 6);
+        return m_sizes.find(characterSize)->second.underlineThickness;
     }
     else
     {
@@ -409,15 +939,89 @@ float Font::getUnderlineThickness(unsigned int characterSize) const
 ////////////////////////////////////////////////////////////
 const Texture& Font::getTexture(unsigned int characterSize) const
 {
+    if (m_isDistanceField)
+        return m_pages[DistanceFieldSize].texture;
+
     return m_pages[characterSize].texture;
 }
 
 
+////////////////////////////////////////////////////////////
+void Font::setDistanceField(bool enabled)
+{
+    if (m_isDistanceField == enabled)
+        return;
+
+    stopGlyphLoader();
+    m_isDistanceField = enabled;
+    m_pages.clear();
+    m_scaledGlyphs.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::isDistanceField() const
+{
+    return m_isDistanceField;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::setAsyncLoading(bool enabled)
+{
+    if (!enabled)
+        stopGlyphLoader();
+
+    m_isAsync = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::isAsyncLoading() const
+{
+    return m_isAsync;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::hasPendingGlyphs() const
+{
+    return !m_pendingGlyphs.empty();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Font::getUpdateCount() const
+{
+    return m_updateCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::commitPendingGlyphs()
+{
+    unsigned int budget = glyphUploadBudget;
+    std::vector<const Font*>& fonts = getLoadingFonts();
+    for (std::vector<const Font*>::const_iterator font = fonts.begin(); (font != fonts.end()) && (budget > 0); ++font)
+        budget -= (*font)->commitGlyphs(budget);
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::setGlyphUploadBudget(unsigned int glyphsPerFrame)
+{
+    glyphUploadBudget = glyphsPerFrame;
+}
+
+
 ////////////////////////////////////////////////////////////
 Font& Font::operator =(const Font& right)
 {
     Font temp(right);
 
+    // Loaders run for one font object, the swapped in state has none
+    stopGlyphLoader();
+
     std::swap(m_library,     temp.m_library);
     std::swap(m_face,        temp.m_face);
     std::swap(m_streamRec,   temp.m_streamRec);
@@ -425,6 +1029,14 @@ Font& Font::operator =(const Font& right)
     std::swap(m_info,        temp.m_info);
     std::swap(m_pages,       temp.m_pages);
     std::swap(m_pixelBuffer, temp.m_pixelBuffer);
+    std::swap(m_scaledGlyphs, temp.m_scaledGlyphs);
+    std::swap(m_sizes, temp.m_sizes);
+    std::swap(m_isAsync, temp.m_isAsync);
+    std::swap(m_pendingGlyphs, temp.m_pendingGlyphs);
+    std::swap(m_source, temp.m_source);
+    std::swap(m_fallbacks, temp.m_fallbacks);
+    std::swap(m_faceIndices, temp.m_faceIndices);
+    std::swap(m_isDistanceField, temp.m_isDistanceField);
 
     return *this;
 }
@@ -433,6 +1045,14 @@ Font& Font::operator =(const Font& right)
 ////////////////////////////////////////////////////////////
 void Font::cleanup()
 {
+    // Stop the background loader, it holds its own copy of the face
+    stopGlyphLoader();
+
+    // Fallback faces belong to this instance only, close them while the library is alive
+    for (std::size_t i = 0; i < m_fallbacks.size(); ++i)
+        if (m_fallbacks[i].face)
+            FT_Done_Face(static_cast<FT_Face>(m_fallbacks[i].face));
+
     // Check if we must destroy the FreeType pointers
     if (m_refCount)
     {
@@ -471,154 +1091,323 @@ void Font::cleanup()
     m_refCount  = NULL;
     m_pages.clear();
     m_pixelBuffer.clear();
+    m_scaledGlyphs.clear();
+    m_sizes.clear();
+    m_source = Source();
+    m_fallbacks.clear();
+    m_faceIndices.clear();
 }
 
 
 ////////////////////////////////////////////////////////////
-Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const
+void Font::addFallback(const Source& source)
 {
-    // The glyph to return
-    Glyph glyph;
+    // The loader only knows the faces it was started with
+    stopGlyphLoader();
+
+    Fallback fallback;
+    fallback.source   = source;
+    fallback.face     = NULL;
+    fallback.isBroken = false;
+    m_fallbacks.push_back(fallback);
 
-    // First, transform our ugly void* to a FT_Face
+    // Characters no face had may be in the new one
+    for (FaceTable::iterator it = m_faceIndices.begin(); it != m_faceIndices.end();)
+    {
+        if (it->second == 0)
+            m_faceIndices.erase(it++);
+        else
+            ++it;
+    }
+
+    // Their glyphs were rasterized from the font's face, as the missing glyph
+    // box, so they are forgotten to be loaded again from the new face. The
+    // characters that were in a fallback already keep theirs.
     FT_Face face = static_cast<FT_Face>(m_face);
     if (!face)
-        return glyph;
+        return;
 
-    // Set the character size
-    if (!setCurrentSize(characterSize))
-        return glyph;
+    bool forgotten = false;
+    for (PageTable::iterator page = m_pages.begin(); page != m_pages.end(); ++page)
+        forgotten |= forgetMissingGlyphs(page->second.glyphs);
+    for (ScaledGlyphTable::iterator table = m_scaledGlyphs.begin(); table != m_scaledGlyphs.end(); ++table)
+        forgotten |= forgetMissingGlyphs(table->second);
 
-    // Load the glyph corresponding to the code point
-    FT_Int32 flags = FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT;
-    if (outlineThickness != 0)
-        flags |= FT_LOAD_NO_BITMAP;
-    if (FT_Load_Char(face, codePoint, flags) != 0)
-        return glyph;
+    if (forgotten)
+        ++m_updateCount;
+}
 
-    // Retrieve the glyph
-    FT_Glyph glyphDesc;
-    if (FT_Get_Glyph(face->glyph, &glyphDesc) != 0)
-        return glyph;
 
-    // Apply bold and outline (there is no fallback for outline) if necessary -- first technique using outline (highest quality)
-    FT_Pos weight = 1 << 6;
-    bool outline = (glyphDesc->format == FT_GLYPH_FORMAT_OUTLINE);
-    if (outline)
+////////////////////////////////////////////////////////////
+bool Font::forgetMissingGlyphs(GlyphTable& glyphs) const
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+
+    bool forgotten = false;
+    for (GlyphTable::iterator it = glyphs.begin(); it != glyphs.end();)
     {
-        if (bold)
+        Uint32 codePoint = static_cast<Uint32>(it->first & 0x7FFFFFFF);
+        FaceTable::const_iterator index = m_faceIndices.find(codePoint);
+        if (((index == m_faceIndices.end()) || (index->second == 0)) && (FT_Get_Char_Index(face, codePoint) == 0))
         {
-            FT_OutlineGlyph outlineGlyph = (FT_OutlineGlyph)glyphDesc;
-            FT_Outline_Embolden(&outlineGlyph->outline, weight);
+            glyphs.erase(it++);
+            forgotten = true;
         }
-
-        if (outlineThickness != 0)
+        else
         {
-            FT_Stroker stroker = static_cast<FT_Stroker>(m_stroker);
-
-            FT_Stroker_Set(stroker, static_cast<FT_Fixed>(outlineThickness * static_cast<float>(1 << 6)), FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
-            FT_Glyph_Stroke(&glyphDesc, stroker, false);
+            ++it;
         }
     }
 
-    // Convert the glyph to a bitmap (i.e. rasterize it)
-    FT_Glyph_To_Bitmap(&glyphDesc, FT_RENDER_MODE_NORMAL, 0, 1);
-    FT_Bitmap& bitmap = reinterpret_cast<FT_BitmapGlyph>(glyphDesc)->bitmap;
-
-    // Apply bold if necessary -- fallback technique using bitmap (lower quality)
-    if (!outline)
-    {
-        if (bold)
-            FT_Bitmap_Embolden(static_cast<FT_Library>(m_library), &bitmap, weight, weight);
+    return forgotten;
+}
 
-        if (outlineThickness != 0)
-            err() << "Failed to outline glyph (no fallback available)" << std::endl;
-    }
 
-    // Compute the glyph's advance offset
-    glyph.advance = static_cast<float>(face->glyph->metrics.horiAdvance) / static_cast<float>(1 << 6);
-    if (bold)
-        glyph.advance += static_cast<float>(weight) / static_cast<float>(1 << 6);
+////////////////////////////////////////////////////////////
+unsigned int Font::findFace(Uint32 codePoint) const
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (m_fallbacks.empty() || !face)
+        return 0;
 
-    int width  = bitmap.width;
-    int height = bitmap.rows;
+    FaceTable::const_iterator it = m_faceIndices.find(codePoint);
+    if (it != m_faceIndices.end())
+        return it->second;
 
-    if ((width > 0) && (height > 0))
+    // Try the fallbacks in order, each one is opened the first time it is reached
+    unsigned int index = 0;
+    if (FT_Get_Char_Index(face, codePoint) == 0)
     {
-        // Leave a small padding around characters, so that filtering doesn't
-        // pollute them with pixels from neighbors
-        const unsigned int padding = 1;
+        for (unsigned int i = 1; i <= m_fallbacks.size(); ++i)
+        {
+            FT_Face fallback = static_cast<FT_Face>(getFace(i));
+            if (fallback && (FT_Get_Char_Index(fallback, codePoint) != 0))
+            {
+                index = i;
+                break;
+            }
+        }
+    }
 
-        // Get the glyphs page corresponding to the character size
-        Page& page = m_pages[characterSize];
+    m_faceIndices.insert(std::make_pair(codePoint, index));
+    return index;
+}
 
-        // Find a good position for the new glyph into the texture
-        glyph.textureRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
 
-        // Make sure the texture data is positioned in the center
-        // of the allocated texture rectangle
-        glyph.textureRect.left += padding;
-        glyph.textureRect.top += padding;
-        glyph.textureRect.width -= 2 * padding;
-        glyph.textureRect.height -= 2 * padding;
+////////////////////////////////////////////////////////////
+void* Font::getFace(unsigned int index) const
+{
+    if (index == 0)
+        return m_face;
 
-        // Compute the glyph's bounding box
-        glyph.bounds.left   =  static_cast<float>(face->glyph->metrics.horiBearingX) / static_cast<float>(1 << 6);
-        glyph.bounds.top    = -static_cast<float>(face->glyph->metrics.horiBearingY) / static_cast<float>(1 << 6);
-        glyph.bounds.width  =  static_cast<float>(face->glyph->metrics.width)        / static_cast<float>(1 << 6) + outlineThickness * 2;
-        glyph.bounds.height =  static_cast<float>(face->glyph->metrics.height)       / static_cast<float>(1 << 6) + outlineThickness * 2;
+    if (index > m_fallbacks.size())
+        return NULL;
 
-        // Extract the glyph's pixels from the bitmap
-        m_pixelBuffer.resize(width * height * 4, 255);
-        const Uint8* pixels = bitmap.buffer;
-        if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
-        {
-            // Pixels are 1 bit monochrome values
-            for (int y = 0; y < height; ++y)
-            {
-                for (int x = 0; x < width; ++x)
-                {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
-                    m_pixelBuffer[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
-                }
-                pixels += bitmap.pitch;
-            }
-        }
-        else
+    Fallback& fallback = m_fallbacks[index - 1];
+    if (!fallback.face && !fallback.isBroken)
+    {
+        const Source& source = fallback.source;
+        fallback.face = openFace(static_cast<FT_Library>(m_library), source.filename, source.data, source.size);
+        if (!fallback.face)
         {
-            // Pixels are 8 bits gray levels
-            for (int y = 0; y < height; ++y)
-            {
-                for (int x = 0; x < width; ++x)
-                {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
-                    m_pixelBuffer[index] = pixels[x];
-                }
-                pixels += bitmap.pitch;
-            }
+            if (source.filename.empty())
+                err() << "Failed to load fallback font from memory (failed to create the font face)" << std::endl;
+            else
+                err() << "Failed to load fallback font \"" << source.filename << "\" (failed to create the font face)" << std::endl;
+            fallback.isBroken = true;
         }
-
-        // Write the pixels to the texture
-        unsigned int x = glyph.textureRect.left;
-        unsigned int y = glyph.textureRect.top;
-        unsigned int w = glyph.textureRect.width;
-        unsigned int h = glyph.textureRect.height;
-        page.texture.update(&m_pixelBuffer[0], w, h, x, y);
     }
 
-    // Delete the FT glyph
-    FT_Done_Glyph(glyphDesc);
+    return fallback.face;
+}
+
+
+////////////////////////////////////////////////////////////
+Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const
+{
+    // The glyph to return
+    Glyph glyph;
+
+    // First, transform our ugly void* to a FT_Face, the fallback's if this one lacks the character
+    unsigned int index = findFace(codePoint);
+    FT_Face face = static_cast<FT_Face>(getFace(index));
+    if (!face)
+        return glyph;
+
+    // Set the character size, distance fields are computed from a finer rasterization
+    unsigned int pixelSize = characterSize * (m_isDistanceField ? DistanceFieldUpsample : 1);
+    if (!setCurrentSize(pixelSize, index))
+        return glyph;
+
+    Vector2u size;
+    if (rasterizeGlyph(static_cast<FT_Library>(m_library), face, static_cast<FT_Stroker>(m_stroker),
+                       codePoint, bold, outlineThickness, m_isDistanceField, glyph, m_pixelBuffer, size))
+        writeGlyph(glyph, characterSize, m_pixelBuffer, size);
+
+    // Done :)
+    return glyph;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::writeGlyph(Glyph& glyph, unsigned int characterSize, const std::vector<Uint8>& pixels, Vector2u size) const
+{
+    if ((size.x == 0) || (size.y == 0))
+        return;
+
+    // Leave a small padding around characters, so that filtering doesn't
+    // pollute them with pixels from neighbors
+    const unsigned int padding = 1;
+
+    // Get the glyphs page corresponding to the character size
+    Page& page = m_pages[characterSize];
+
+    // Find a good position for the new glyph into the texture
+    glyph.textureRect = findGlyphRect(page, size.x + 2 * padding, size.y + 2 * padding);
+
+    // Make sure the texture data is positioned in the center
+    // of the allocated texture rectangle
+    glyph.textureRect.left += padding;
+    glyph.textureRect.top += padding;
+    glyph.textureRect.width -= 2 * padding;
+    glyph.textureRect.height -= 2 * padding;
+
+    // Write the pixels to the texture
+    unsigned int x = glyph.textureRect.left;
+    unsigned int y = glyph.textureRect.top;
+    unsigned int w = glyph.textureRect.width;
+    unsigned int h = glyph.textureRect.height;
+    page.texture.update(&pixels[0], w, h, x, y);
 
     // Force an OpenGL flush, so that the font's texture will appear updated
     // in all contexts immediately (solves problems in multi-threaded apps)
 #ifdef EMULATION
     glCheck(glFlush());
 #endif
+}
 
-    // Done :)
-    return glyph;
+
+////////////////////////////////////////////////////////////
+Glyph Font::requestGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness, Uint64 key) const
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face)
+        return Glyph();
+
+    if (!m_glyphLoader)
+    {
+        if (m_source.filename.empty() && !m_source.data)
+        {
+            err() << "Failed to load glyphs in the background (font wasn't loaded from a file or memory)" << std::endl;
+            return loadGlyph(codePoint, characterSize, bold, outlineThickness);
+        }
+
+        m_glyphLoader = new priv::GlyphLoader(*this);
+        if (!m_glyphLoader->isRunning())
+        {
+            err() << "Failed to load glyphs in the background (failed to open the font again)" << std::endl;
+            delete m_glyphLoader;
+            m_glyphLoader = NULL;
+            return loadGlyph(codePoint, characterSize, bold, outlineThickness);
+        }
+        getLoadingFonts().push_back(this);
+    }
+
+    unsigned int index = findFace(codePoint);
+    if (getFace(index))
+        face = static_cast<FT_Face>(getFace(index));
+    else
+        index = 0;
+
+    priv::GlyphLoader::Request request;
+    request.key              = key;
+    request.face             = index;
+    request.characterSize    = characterSize;
+    request.codePoint        = codePoint;
+    request.bold             = bold;
+    request.outlineThickness = outlineThickness;
+    m_glyphLoader->push(request);
+    m_pendingGlyphs.insert(std::make_pair(characterSize, key));
+
+    // The placeholder only takes the glyph's advance, which is read from the
+    // metrics table, and a box above the baseline to give text some bounds
+    Glyph placeholder;
+    if (!setCurrentSize(characterSize, index))
+        return placeholder;
+
+    FT_Fixed advance;
+    if (FT_Get_Advance(face, FT_Get_Char_Index(face, codePoint), FT_LOAD_NO_HINTING, &advance) == 0)
+        placeholder.advance = static_cast<float>(advance) / static_cast<float>(1 << 16) + (bold ? 1.f : 0.f);
+
+    float ascender = static_cast<float>(face->size->metrics.ascender) / static_cast<float>(1 << 6);
+    placeholder.bounds = FloatRect(0, -ascender, placeholder.advance, ascender);
+    if (m_isDistanceField)
+    {
+        float spread = static_cast<float>(DistanceFieldSpread);
+        placeholder.bounds = FloatRect(-spread, -ascender - spread, placeholder.advance + 2 * spread, ascender + 2 * spread);
+    }
+
+    return placeholder;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Font::commitGlyphs(unsigned int budget) const
+{
+    unsigned int count = 0;
+    priv::GlyphLoader::Result result;
+    while ((count < budget) && m_glyphLoader && m_glyphLoader->pop(result))
+    {
+        const priv::GlyphLoader::Request& request = result.request;
+        PendingSet::iterator pending = m_pendingGlyphs.find(std::make_pair(request.characterSize, request.key));
+        if (pending == m_pendingGlyphs.end())
+            continue;
+        m_pendingGlyphs.erase(pending);
+
+        writeGlyph(result.glyph, request.characterSize, result.pixels, result.size);
+        m_pages[request.characterSize].glyphs[request.key] = result.glyph;
+
+        // Scaled copies of the placeholder are scaled again from the field
+        if (m_isDistanceField)
+            for (ScaledGlyphTable::iterator table = m_scaledGlyphs.begin(); table != m_scaledGlyphs.end(); ++table)
+                table->second.erase(request.key);
+
+        ++count;
+    }
+
+    if (count > 0)
+        ++m_updateCount;
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::stopGlyphLoader() const
+{
+    if (m_glyphLoader)
+    {
+        std::vector<const Font*>& fonts = getLoadingFonts();
+        fonts.erase(std::remove(fonts.begin(), fonts.end(), this), fonts.end());
+
+        delete m_glyphLoader;
+        m_glyphLoader = NULL;
+    }
+
+    // Forget the placeholders so that they are loaded again when used
+    for (PendingSet::const_iterator pending = m_pendingGlyphs.begin(); pending != m_pendingGlyphs.end(); ++pending)
+    {
+        PageTable::iterator page = m_pages.find(pending->first);
+        if (page != m_pages.end())
+            page->second.glyphs.erase(pending->second);
+
+        if (m_isDistanceField)
+            for (ScaledGlyphTable::iterator table = m_scaledGlyphs.begin(); table != m_scaledGlyphs.end(); ++table)
+                table->second.erase(pending->second);
+    }
+    if (!m_pendingGlyphs.empty())
+        ++m_updateCount;
+    m_pendingGlyphs.clear();
 }
 
 
@@ -664,7 +1453,8 @@ IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height)
                 Image newImage;
                 newImage.create(textureWidth * 2, textureHeight * 2, Color(255, 255, 255, 0));
                 newImage.copy(page.texture.copyToImage(), 0, 0);
-                page.texture.loadFromImage(newImage);
+                page.texture.create(textureWidth * 2, textureHeight * 2, page.texture.getFormat());
+                page.texture.update(newImage);
             }
             else
             {
@@ -691,18 +1481,39 @@ IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height)
 
 
 ////////////////////////////////////////////////////////////
-bool Font::setCurrentSize(unsigned int characterSize) const
+bool Font::setCurrentSize(unsigned int characterSize, unsigned int index) const
 {
-    // FT_Set_Pixel_Sizes is an expensive function, so we must call it
-    // only when necessary to avoid killing performances
+    // FT_Set_Pixel_Sizes is an expensive function, so each size keeps
+    // its own FT_Size, which is much cheaper to switch to
 
-    FT_Face face = static_cast<FT_Face>(m_face);
-    FT_UShort currentSize = face->size->metrics.x_ppem;
+    FT_Face face = static_cast<FT_Face>(getFace(index));
+    if (!face)
+        return false;
 
-    if (currentSize != characterSize)
+    SizeTable& sizes = (index == 0) ? m_sizes : m_fallbacks[index - 1].sizes;
+    SizeTable::const_iterator it = sizes.find(characterSize);
+    if (it != sizes.end())
     {
-        FT_Error result = FT_Set_Pixel_Sizes(face, 0, characterSize);
+        FT_Size size = static_cast<FT_Size>(it->second.size);
+        if (face->size != size)
+            FT_Activate_Size(size);
 
+        return true;
+    }
+
+    // The face owns its sizes and frees them with itself, which
+    // keeps them valid for the copies sharing it
+    FT_Size size;
+    if (FT_New_Size(face, &size) != 0)
+    {
+        err() << "Failed to create font size " << characterSize << std::endl;
+        return false;
+    }
+    FT_Activate_Size(size);
+
+    FT_Error result = FT_Set_Pixel_Sizes(face, 0, characterSize);
+    if (result != FT_Err_Ok)
+    {
         if (result == FT_Err_Invalid_Pixel_Size)
         {
             // In the case of bitmap fonts, resizing can
@@ -717,12 +1528,27 @@ bool Font::setCurrentSize(unsigned int characterSize) const
             }
         }
 
-        return result == FT_Err_Ok;
+        FT_Done_Size(size);
+        return false;
+    }
+
+    // Cache the metrics of the size along with it
+    Size& entry = sizes[characterSize];
+    entry.size        = size;
+    entry.lineSpacing = static_cast<float>(size->metrics.height) / static_cast<float>(1 << 6);
+    if (FT_IS_SCALABLE(face))
+    {
+        entry.underlinePosition  = -static_cast<float>(FT_MulFix(face->underline_position, size->metrics.y_scale)) / static_cast<float>(1 << 6);
+        entry.underlineThickness =  static_cast<float>(FT_MulFix(face->underline_thickness, size->metrics.y_scale)) / static_cast<float>(1 << 6);
     }
     else
     {
-        return true;
+        // Use a fixed position and thickness if font is a bitmap font
+        entry.underlinePosition  = characterSize / 10.f;
+        entry.underlineThickness = characterSize / 14.f;
     }
+
+    return true;
 }
 
 
@@ -739,8 +1565,9 @@ Font::Page::Page() :
         for (int y = 0; y < 2; ++y)
             image.setPixel(x, y, Color(255, 255, 255, 255));
 
-    // Create the texture
-    texture.loadFromImage(image);
+    // Create the texture, glyphs only need coverage so store alpha alone
+    texture.create(128, 128, GPU_A8);
+    texture.update(image);
     texture.setSmooth(true);
 }
 
@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/FontFamily.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <cpp3ds/System/FileSystem.hpp>
+#include <cstdio>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+bool FontFamily::addFromFile(const std::string& filename)
+{
+    if (!m_face)
+        return loadFromFile(filename);
+
+    // Only make sure the file is there, it is parsed when first needed
+    std::string path = FileSystem::getFilePath(filename);
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        err() << "Failed to add fallback font \"" << filename << "\" (failed to open the file)" << std::endl;
+        return false;
+    }
+    std::fclose(file);
+
+    Source source;
+    source.filename = path;
+    addFallback(source);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool FontFamily::addFromMemory(const void* data, std::size_t sizeInBytes)
+{
+    if (!m_face)
+        return loadFromMemory(data, sizeInBytes);
+
+    if (!data || (sizeInBytes == 0))
+    {
+        err() << "Failed to add fallback font from memory (no data)" << std::endl;
+        return false;
+    }
+
+    Source source;
+    source.data = data;
+    source.size = sizeInBytes;
+    addFallback(source);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int FontFamily::getFaceCount() const
+{
+    return m_face ? static_cast<unsigned int>(m_fallbacks.size() + 1) : 0;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int FontFamily::getOpenFaceCount() const
+{
+    if (!m_face)
+        return 0;
+
+    unsigned int count = 1;
+    for (std::size_t i = 0; i < m_fallbacks.size(); ++i)
+        if (m_fallbacks[i].face)
+            ++count;
+
+    return count;
+}
+
+} // namespace cpp3ds
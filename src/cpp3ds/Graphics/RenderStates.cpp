@@ -41,66 +41,84 @@ const RenderStates RenderStates::Default(BlendMode(
 
 ////////////////////////////////////////////////////////////
 RenderStates::RenderStates() :
-blendMode(BlendAlpha),
-transform(),
-texture  (NULL),
-shader   (NULL),
-scissor  ()
+blendMode                 (BlendAlpha),
+transform                 (),
+texture                   (NULL),
+shader                    (NULL),
+scissor                   (),
+layer                     (0),
+distanceFieldThreshold    (0.f),
+distanceFieldPixelsPerUnit(0.f)
 {
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderStates::RenderStates(const Transform& theTransform) :
-blendMode(BlendAlpha),
-transform(theTransform),
-texture  (NULL),
-shader   (NULL),
-scissor  ()
+blendMode                 (BlendAlpha),
+transform                 (theTransform),
+texture                   (NULL),
+shader                    (NULL),
+scissor                   (),
+layer                     (0),
+distanceFieldThreshold    (0.f),
+distanceFieldPixelsPerUnit(0.f)
 {
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderStates::RenderStates(const BlendMode& theBlendMode) :
-blendMode(theBlendMode),
-transform(),
-texture  (NULL),
-shader   (NULL),
-scissor  ()
+blendMode                 (theBlendMode),
+transform                 (),
+texture                   (NULL),
+shader                    (NULL),
+scissor                   (),
+layer                     (0),
+distanceFieldThreshold    (0.f),
+distanceFieldPixelsPerUnit(0.f)
 {
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderStates::RenderStates(const Texture* theTexture) :
-blendMode(BlendAlpha),
-transform(),
-texture  (theTexture),
-shader   (NULL),
-scissor  ()
+blendMode                 (BlendAlpha),
+transform                 (),
+texture                   (theTexture),
+shader                    (NULL),
+scissor                   (),
+layer                     (0),
+distanceFieldThreshold    (0.f),
+distanceFieldPixelsPerUnit(0.f)
 {
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderStates::RenderStates(const Shader* theShader) :
-blendMode(BlendAlpha),
-transform(),
-texture  (NULL),
-shader   (theShader),
-scissor  ()
+blendMode                 (BlendAlpha),
+transform                 (),
+texture                   (NULL),
+shader                    (theShader),
+scissor                   (),
+layer                     (0),
+distanceFieldThreshold    (0.f),
+distanceFieldPixelsPerUnit(0.f)
 {
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderStates::RenderStates(const UintRect& theScissor) :
-blendMode(BlendAlpha),
-transform(),
-texture  (NULL),
-shader   (NULL),
-scissor  (theScissor)
+blendMode                 (BlendAlpha),
+transform                 (),
+texture                   (NULL),
+shader                    (NULL),
+scissor                   (theScissor),
+layer                     (0),
+distanceFieldThreshold    (0.f),
+distanceFieldPixelsPerUnit(0.f)
 {
 }
 
@@ -108,11 +126,14 @@ scissor  (theScissor)
 ////////////////////////////////////////////////////////////
 RenderStates::RenderStates(const BlendMode& theBlendMode, const Transform& theTransform,
                            const Texture* theTexture, const Shader* theShader, const IntRect& theScissor) :
-blendMode(theBlendMode),
-transform(theTransform),
-texture  (theTexture),
-shader   (theShader),
-scissor  (theScissor)
+blendMode                 (theBlendMode),
+transform                 (theTransform),
+texture                   (theTexture),
+shader                    (theShader),
+scissor                   (theScissor),
+layer                     (0),
+distanceFieldThreshold    (0.f),
+distanceFieldPixelsPerUnit(0.f)
 {
 }
 
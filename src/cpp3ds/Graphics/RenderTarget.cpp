@@ -33,7 +33,9 @@
 #include <cpp3ds/OpenGL.hpp>
 #include <cpp3ds/System/Err.hpp>
 #include <c3d/renderbuffer.h>
+#include <algorithm>
 #include "CitroHelpers.hpp"
+#include "DepthSort.hpp"
 
 namespace
 {
@@ -75,9 +77,12 @@ namespace cpp3ds
 {
 ////////////////////////////////////////////////////////////
 RenderTarget::RenderTarget() :
-m_defaultView(),
-m_view       (),
-m_cache      ()
+m_defaultView (),
+m_view        (),
+m_cache       (),
+m_depthSorting(false),
+m_depth       (0.f),
+m_depthDraws  (NULL)
 {
 	m_cache.vertexCache = new Vertex[StatesCache::VertexCacheSize];
 	m_cache.glStatesSet = false;
@@ -88,6 +93,7 @@ m_cache      ()
 RenderTarget::~RenderTarget()
 {
 	delete[] m_cache.vertexCache;
+	delete m_depthDraws;
 }
 
 
@@ -199,6 +205,71 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
     if (!vertices || (vertexCount == 0))
         return;
 
+    if (m_depthSorting)
+    {
+        priv::DepthDraw draw = {vertices, vertexCount, type, states, 0.f};
+        m_depthDraws->push_back(draw);
+        return;
+    }
+
+    submit(vertices, vertexCount, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::beginDepthSorting()
+{
+    if (!m_depthDraws)
+        m_depthDraws = new std::vector<priv::DepthDraw>;
+
+    m_depthSorting = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::endDepthSorting()
+{
+    if (!m_depthSorting)
+        return;
+
+    m_depthSorting = false;
+    std::size_t opaqueCount = priv::sortDepthDraws(*m_depthDraws);
+
+    if (!m_depthDraws->empty() && activate(true))
+    {
+        if (!m_cache.glStatesSet)
+            resetGLStates();
+
+        applyDepthTest(true, true);
+        for (std::size_t i = 0; i < m_depthDraws->size(); ++i)
+        {
+            // Translucent draws must not hide what is drawn behind them after
+            if (i == opaqueCount)
+                applyDepthTest(true, false);
+
+            const priv::DepthDraw& draw = (*m_depthDraws)[i];
+            m_depth = draw.depth;
+            submit(draw.vertices, draw.vertexCount, draw.type, draw.states);
+        }
+        m_depth = 0.f;
+        applyDepthTest(false, true);
+    }
+
+    m_depthDraws->clear();
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isDepthSorting() const
+{
+    return m_depthSorting;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::submit(const Vertex* vertices, unsigned int vertexCount,
+                          PrimitiveType type, const RenderStates& states)
+{
 	// Vertices allocated in the stack (common) can't be converted to physical address
 	if (osConvertVirtToPhys(vertices) == 0)
 	{
@@ -256,6 +327,10 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         if (states.shader)
             applyShader(states.shader);
 
+        // Turn a distance field texture into coverage
+        if (states.distanceFieldThreshold > 0.f)
+            applyDistanceField(states.distanceFieldThreshold, states.distanceFieldPixelsPerUnit);
+
         // If we pre-transform the vertices, we must use our internal vertex cache
         if (useVertexCache)
         {
@@ -287,6 +362,10 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         if (states.shader)
             applyShader(NULL);
 
+        // Restore the combiners of ordinary textures
+        if (states.distanceFieldThreshold > 0.f)
+            applyDistanceField(0.f, 0.f);
+
         // Update the cache
         m_cache.useVertexCache = useVertexCache;
     }
@@ -413,7 +492,19 @@ void RenderTarget::applyScissor(const UintRect& rect)
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyTransform(const Transform& transform)
 {
-    memcpy(MtxStack_Cur(CitroGetModelviewMatrix())->m, transform.getMatrix(), sizeof(C3D_Mtx));
+    C3D_Mtx* modelview = MtxStack_Cur(CitroGetModelviewMatrix());
+    memcpy(modelview->m, transform.getMatrix(), sizeof(C3D_Mtx));
+
+    // The shader's z is the w column of the third row, vertices having no z
+    modelview->r[2].w = m_depth;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::applyDepthTest(bool test, bool write)
+{
+    // Depth is cleared to 0 and nearer fragments have a greater depth
+    C3D_DepthTest(test, GPU_GREATER, write ? GPU_WRITE_ALL : GPU_WRITE_COLOR);
 }
 
 
@@ -432,6 +523,50 @@ void RenderTarget::applyShader(const Shader* shader)
     Shader::bind(shader);
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderTarget::applyDistanceField(float threshold, float pixelsPerUnit)
+{
+    if (threshold <= 0.f)
+    {
+        // Back to the texture stage alone
+        for (int i = 1; i <= 3; ++i)
+            C3D_TexEnvInit(C3D_GetTexEnv(i));
+        return;
+    }
+
+    // The PICA200 has no fragment shaders, so the ramp is built from the
+    // combiner stages following the texture's: (field - offset) * sharpness,
+    // the sharpness being a power of two split over two stages that scale by
+    // 4 at most, then modulated by the vertex alpha
+    int shift = 0;
+    while ((shift < 4) && ((2 << shift) <= pixelsPerUnit))
+        ++shift;
+    float offset = std::max(threshold - 0.5f / static_cast<float>(1 << shift), 0.f);
+
+    C3D_TexEnv* env = C3D_GetTexEnv(1);
+    C3D_TexEnvSrc(env, C3D_RGB, GPU_PREVIOUS, 0, 0);
+    C3D_TexEnvSrc(env, C3D_Alpha, GPU_TEXTURE0, GPU_CONSTANT, 0);
+    C3D_TexEnvOp(env, C3D_Both, 0, 0, 0);
+    C3D_TexEnvFunc(env, C3D_RGB, GPU_REPLACE);
+    C3D_TexEnvFunc(env, C3D_Alpha, GPU_SUBTRACT);
+    C3D_TexEnvColor(env, static_cast<u32>(offset * 255.f + 0.5f) << 24);
+    C3D_TexEnvScale(env, C3D_Alpha, static_cast<GPU_TEVSCALE>(std::min(shift, 2)));
+
+    env = C3D_GetTexEnv(2);
+    C3D_TexEnvSrc(env, C3D_Both, GPU_PREVIOUS, 0, 0);
+    C3D_TexEnvOp(env, C3D_Both, 0, 0, 0);
+    C3D_TexEnvFunc(env, C3D_Both, GPU_REPLACE);
+    C3D_TexEnvScale(env, C3D_Alpha, static_cast<GPU_TEVSCALE>(shift - std::min(shift, 2)));
+
+    env = C3D_GetTexEnv(3);
+    C3D_TexEnvSrc(env, C3D_RGB, GPU_PREVIOUS, 0, 0);
+    C3D_TexEnvSrc(env, C3D_Alpha, GPU_PREVIOUS, GPU_PRIMARY_COLOR, 0);
+    C3D_TexEnvOp(env, C3D_Both, 0, 0, 0);
+    C3D_TexEnvFunc(env, C3D_RGB, GPU_REPLACE);
+    C3D_TexEnvFunc(env, C3D_Alpha, GPU_MODULATE);
+}
+
 } // namespace cpp3ds
 
 
@@ -34,16 +34,24 @@ namespace cpp3ds
 {
 ////////////////////////////////////////////////////////////
 RenderTexture::RenderTexture():
-m_width  (0),
-m_height (0)
+m_width      (0),
+m_height     (0),
+m_context    (NULL),
+m_depthBuffer(0)
 {
-
+#ifndef EMULATION
+    m_target = NULL;
+#endif
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderTexture::~RenderTexture()
 {
+#ifndef EMULATION
+    if (m_target)
+        C3D_RenderTargetDelete(m_target);
+#endif
 	delete m_context;
 }
 
@@ -66,8 +74,24 @@ bool RenderTexture::create(unsigned int width, unsigned int height, bool depthBu
     m_height = height;
 
     // Create the in-memory OpenGL context
+    delete m_context;
     m_context = new Context(ContextSettings(TopScreen, depthBuffer ? 32 : 0), width, height);
 
+#ifndef EMULATION
+    // Render straight into the texture's memory, with a depth buffer
+    // of our own when requested (RenderTarget::beginDepthSorting needs one)
+    if (m_target)
+        C3D_RenderTargetDelete(m_target);
+    m_target = C3D_RenderTargetCreateFromTex(m_texture.m_texture, GPU_TEXFACE_2D, 0, depthBuffer ? GPU_RB_DEPTH24_STENCIL8 : -1);
+    if (!m_target)
+    {
+        err() << "Impossible to create render texture (failed to create the render target)" << std::endl;
+        return false;
+    }
+    C3D_RenderTargetSetClear(m_target, C3D_CLEAR_ALL, 0, 0);
+#endif
+    m_depthBuffer = depthBuffer ? 1 : 0;
+
     // We can now initialize the render target part
     RenderTarget::initialize();
 
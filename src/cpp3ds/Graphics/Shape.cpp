@@ -49,6 +49,12 @@ namespace
     {
         return p1.x * p2.x + p1.y * p2.y;
     }
+
+    // Scale a rectangle from the origin
+    cpp3ds::FloatRect scaleRect(const cpp3ds::FloatRect& rect, float scale)
+    {
+        return cpp3ds::FloatRect(rect.left * scale, rect.top * scale, rect.width * scale, rect.height * scale);
+    }
 }
 
 
@@ -130,8 +136,12 @@ const Color& Shape::getOutlineColor() const
 ////////////////////////////////////////////////////////////
 void Shape::setOutlineThickness(float thickness)
 {
+    if (thickness == m_outlineThickness)
+        return;
+
+    // The fill doesn't depend on the outline
     m_outlineThickness = thickness;
-    update(); // recompute everything because the whole shape must be offset
+    updateOutline();
 }
 
 
@@ -166,7 +176,10 @@ m_outlineThickness(0),
 m_vertices        (TrianglesFan),
 m_outlineVertices (TrianglesStrip),
 m_insideBounds    (),
-m_bounds          ()
+m_bounds          (),
+m_scale           (1.f),
+m_outlineNormals  (),
+m_outlineNormalsNeedUpdate(true)
 {
 }
 
@@ -176,6 +189,8 @@ void Shape::update()
 {
     // Get the total number of points of the shape
     unsigned int count = getPointCount();
+    m_scale = 1.f;
+    m_outlineNormalsNeedUpdate = true;
     if (count < 3)
     {
         m_vertices.resize(0);
@@ -209,10 +224,20 @@ void Shape::update()
 }
 
 
+////////////////////////////////////////////////////////////
+void Shape::updateScale(float scale)
+{
+    m_scale = scale;
+    updateOutline();
+}
+
+
 ////////////////////////////////////////////////////////////
 void Shape::draw(RenderTarget& target, RenderStates states) const
 {
     states.transform *= getTransform();
+    if (m_scale != 1.f)
+        states.transform.scale(m_scale, m_scale);
 
     // Render the inside
     states.texture = m_texture;
@@ -251,9 +276,53 @@ void Shape::updateTexCoords()
 ////////////////////////////////////////////////////////////
 void Shape::updateOutline()
 {
-    unsigned int count = m_vertices.getVertexCount() - 2;
+    unsigned int vertexCount = m_vertices.getVertexCount();
+    if (vertexCount < 3)
+        return;
+
+    // Without thickness the outline isn't drawn, and the fill is the whole shape
+    if (m_outlineThickness == 0)
+    {
+        m_outlineVertices.resize(0);
+        m_bounds = scaleRect(m_insideBounds, m_scale);
+        return;
+    }
+
+    if (m_outlineNormalsNeedUpdate)
+        updateOutlineNormals();
+
+    unsigned int count = vertexCount - 2;
+    bool resized = (m_outlineVertices.getVertexCount() != (count + 1) * 2);
     m_outlineVertices.resize((count + 1) * 2);
 
+    // The vertices are scaled when drawn, but the thickness must not be
+    float thickness = m_outlineThickness / m_scale;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        Vector2f point = m_vertices[i + 1].position;
+        m_outlineVertices[i * 2 + 0].position = point;
+        m_outlineVertices[i * 2 + 1].position = point + m_outlineNormals[i] * thickness;
+    }
+
+    // Duplicate the first point at the end, to close the outline
+    m_outlineVertices[count * 2 + 0].position = m_outlineVertices[0].position;
+    m_outlineVertices[count * 2 + 1].position = m_outlineVertices[1].position;
+
+    // Update outline colors, which resizing doesn't keep
+    if (resized)
+        updateOutlineColors();
+
+    // Update the shape's bounds
+    m_bounds = scaleRect(m_outlineVertices.getBounds(), m_scale);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shape::updateOutlineNormals()
+{
+    unsigned int count = m_vertices.getVertexCount() - 2;
+    m_outlineNormals.resize(count);
+
     for (unsigned int i = 0; i < count; ++i)
     {
         unsigned int index = i + 1;
@@ -276,22 +345,10 @@ void Shape::updateOutline()
 
         // Combine them to get the extrusion direction
         float factor = 1.f + (n1.x * n2.x + n1.y * n2.y);
-        Vector2f normal = (n1 + n2) / factor;
-
-        // Update the outline points
-        m_outlineVertices[i * 2 + 0].position = p1;
-        m_outlineVertices[i * 2 + 1].position = p1 + normal * m_outlineThickness;
+        m_outlineNormals[i] = (n1 + n2) / factor;
     }
 
-    // Duplicate the first point at the end, to close the outline
-    m_outlineVertices[count * 2 + 0].position = m_outlineVertices[0].position;
-    m_outlineVertices[count * 2 + 1].position = m_outlineVertices[1].position;
-
-    // Update outline colors
-    updateOutlineColors();
-
-    // Update the shape's bounds
-    m_bounds = m_outlineVertices.getBounds();
+    m_outlineNormalsNeedUpdate = false;
 }
 
 
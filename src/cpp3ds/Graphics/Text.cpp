@@ -29,11 +29,13 @@
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/RenderTarget.hpp>
 #include <cpp3ds/Resources.hpp>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #ifndef EMULATION
 #include "CitroHelpers.hpp"
 #include <citro3d.h>
+#include <unordered_map>
 #endif
 
 
@@ -56,6 +58,10 @@ void addLine(cpp3ds::VertexArray& vertices, float lineLength, float lineTop, con
 // Add a glyph quad to the vertex array
 void addGlyphQuad(cpp3ds::VertexArray& vertices, cpp3ds::Vector2f position, const cpp3ds::Color& color, const cpp3ds::Glyph& glyph, float italic, float outlineThickness = 0)
 {
+    // Glyphs without pixels, like the placeholders of glyphs still loading, draw nothing
+    if ((glyph.textureRect.width == 0) || (glyph.textureRect.height == 0))
+        return;
+
     float left   = glyph.bounds.left;
     float top    = glyph.bounds.top;
     float right  = glyph.bounds.left + glyph.bounds.width;
@@ -73,6 +79,61 @@ void addGlyphQuad(cpp3ds::VertexArray& vertices, cpp3ds::Vector2f position, cons
     vertices.append(cpp3ds::Vertex(cpp3ds::Vector2f(position.x + right - italic * top    - outlineThickness, position.y + top    - outlineThickness), color, cpp3ds::Vector2f(u2, v1)));
     vertices.append(cpp3ds::Vertex(cpp3ds::Vector2f(position.x + right - italic * bottom - outlineThickness, position.y + bottom - outlineThickness), color, cpp3ds::Vector2f(u2, v2)));
 }
+
+#ifndef EMULATION
+// Position of a system font glyph in its sheet, and its metrics at scale 1
+struct SystemGlyph
+{
+    int   sheet;
+    float left, top, right, bottom;
+    float u1, v1, u2, v2;
+    float advance;
+};
+
+// Looking a glyph up in the system font's tables is slow, and the
+// metrics scale linearly, so they are computed once per code point
+const SystemGlyph& getSystemGlyph(cpp3ds::Uint32 codePoint)
+{
+    static std::unordered_map<cpp3ds::Uint32, SystemGlyph> glyphs;
+
+    std::unordered_map<cpp3ds::Uint32, SystemGlyph>::const_iterator it = glyphs.find(codePoint);
+    if (it != glyphs.end())
+        return it->second;
+
+    fontGlyphPos_s data;
+    fontCalcGlyphPos(&data, fontGlyphIndexFromCodePoint(codePoint), GLYPH_POS_CALC_VTXCOORD, 1.f, 1.f);
+
+    // Texture coordinates in pixels of the sheet, as the target binds textures
+    const TGLP_s* info = fontGetGlyphInfo();
+
+    SystemGlyph glyph;
+    glyph.sheet   = data.sheetIndex;
+    glyph.left    = data.vtxcoord.left;
+    glyph.top     = data.vtxcoord.top;
+    glyph.right   = data.vtxcoord.right;
+    glyph.bottom  = data.vtxcoord.bottom;
+    glyph.u1      = data.texcoord.left * info->sheetWidth;
+    glyph.v1      = data.texcoord.top * info->sheetHeight;
+    glyph.u2      = data.texcoord.right * info->sheetWidth;
+    glyph.v2      = data.texcoord.bottom * info->sheetHeight;
+    glyph.advance = data.xAdvance;
+
+    return glyphs.insert(std::make_pair(codePoint, glyph)).first->second;
+}
+
+// A system font glyph placed in a text, sorted by sheet before making vertices
+struct SystemQuad
+{
+    const SystemGlyph* glyph;
+    float              x;
+    float              y;
+
+    bool operator <(const SystemQuad& right) const
+    {
+        return glyph->sheet < right.glyph->sheet;
+    }
+};
+#endif
 }
 
 
@@ -88,6 +149,17 @@ namespace priv
 	// Default font for Text objects for user convenience
 	Font system_font;
 	static bool system_font_loaded;
+
+	// Load system's opensans.tff the first time a text uses it
+	void ensureSystemFontLoaded()
+	{
+		if (!system_font_loaded)
+		{
+			system_font_loaded = true;
+			priv::ResourceInfo font = priv::core_resources["opensans.ttf"];
+			system_font.loadFromMemory(font.data, font.size);
+		}
+	}
 }
 
 ////////////////////////////////////////////////////////////
@@ -99,11 +171,13 @@ Text::Text() :
         m_fillColor         (255, 255, 255),
         m_outlineColor      (0, 0, 0),
         m_outlineThickness  (0),
+        m_layout            (String(), priv::system_font),
         m_vertices          (Triangles),
         m_outlineVertices   (Triangles),
         m_bounds            (),
         m_geometryNeedUpdate(false),
-        m_useSystemFont     (false)
+        m_useSystemFont     (false),
+        m_fontUpdateCount   (0)
 {
 
 }
@@ -118,11 +192,13 @@ Text::Text(const String& string, const Font& font, unsigned int characterSize) :
         m_fillColor         (255, 255, 255),
         m_outlineColor      (0, 0, 0),
         m_outlineThickness  (0),
+        m_layout            (string, font, characterSize),
         m_vertices          (Triangles),
         m_outlineVertices   (Triangles),
         m_bounds            (),
         m_geometryNeedUpdate(true),
-        m_useSystemFont     (false)
+        m_useSystemFont     (false),
+        m_fontUpdateCount   (0)
 {
 
 }
@@ -134,6 +210,7 @@ void Text::setString(const String& string)
     if (m_string != string)
     {
         m_string = string;
+        m_layout.setString(string);
         m_geometryNeedUpdate = true;
     }
 }
@@ -145,6 +222,7 @@ void Text::setFont(const Font& font)
     if (m_font != &font)
     {
         m_font = &font;
+        m_layout.setFont(font);
         m_geometryNeedUpdate = true;
         m_useSystemFont = false;
     }
@@ -167,6 +245,7 @@ void Text::setCharacterSize(unsigned int size)
     if (m_characterSize != size)
     {
         m_characterSize = size;
+        m_layout.setCharacterSize(size);
         m_geometryNeedUpdate = true;
     }
 }
@@ -178,6 +257,7 @@ void Text::setStyle(Uint32 style)
     if (m_style != style)
     {
         m_style = style;
+        m_layout.setBold((style & Bold) != 0);
         m_geometryNeedUpdate = true;
     }
 }
@@ -230,6 +310,30 @@ void Text::setOutlineThickness(float thickness)
 }
 
 
+////////////////////////////////////////////////////////////
+void Text::setWrapWidth(float width)
+{
+    m_layout.setWrapWidth(width);
+    m_geometryNeedUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::setMaxLines(unsigned int lines)
+{
+    m_layout.setMaxLines(lines);
+    m_geometryNeedUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::setEllipsis(const String& ellipsis)
+{
+    m_layout.setEllipsis(ellipsis);
+    m_geometryNeedUpdate = true;
+}
+
+
 ////////////////////////////////////////////////////////////
 const String& Text::getString() const
 {
@@ -279,6 +383,16 @@ float Text::getOutlineThickness() const
 }
 
 
+////////////////////////////////////////////////////////////
+const TextLayout& Text::getLayout() const
+{
+    if (m_font == &priv::system_font)
+        priv::ensureSystemFontLoaded();
+
+    return m_layout;
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2f Text::findCharacterPosSystemFont(std::size_t index) const
 {
@@ -296,37 +410,8 @@ Vector2f Text::findCharacterPos(std::size_t index) const
     if (!m_font)
         return Vector2f();
 
-    // Adjust the index if it's out of range
-    if (index > m_string.getSize())
-        index = m_string.getSize();
-
-    // Precompute the variables needed by the algorithm
-    bool  bold   = (m_style & Bold) != 0;
-    float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
-    float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-
-    // Compute the position
-    Vector2f position;
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < index; ++i)
-    {
-        Uint32 curChar = m_string[i];
-
-        // Apply the kerning offset
-        position.x += static_cast<float>(m_font->getKerning(prevChar, curChar, m_characterSize));
-        prevChar = curChar;
-
-        // Handle special characters
-        switch (curChar)
-        {
-            case ' ':  position.x += hspace;                 continue;
-            case '\t': position.x += hspace * 4;             continue;
-            case '\n': position.y += vspace; position.x = 0; continue;
-        }
-
-        // For regular characters, add the advance offset of the glyph
-        position.x += static_cast<float>(m_font->getGlyph(curChar, m_characterSize, bold).advance);
-    }
+    // Get the position from the layout, which is only computed again if the text changed
+    Vector2f position = getLayout().findCharacterPos(index);
 
     // Transform the position to global coordinates
     position = getTransform().transformPoint(position);
@@ -355,45 +440,23 @@ FloatRect Text::getGlobalBounds() const
 void Text::drawSystemFont(RenderTarget& target, RenderStates states) const
 {
     ensureGeometryUpdate();
+    if (m_vertices.getVertexCount() == 0)
+        return;
     states.transform *= getTransform();
-#ifdef _3DS
-    if (target.m_cache.viewChanged)
-        target.applyCurrentView();
-    if (states.blendMode != target.m_cache.lastBlendMode)
-        target.applyBlendMode(states.blendMode);
-    if (states.shader)
-        target.applyShader(states.shader);
-    if (states.scissor != target.m_cache.lastScissor)
-        target.applyScissor(states.scissor);
-
-    target.applyTransform(states.transform);
-    Mtx_Identity(MtxStack_Cur(CitroGetTextureMatrix()));
-    CitroUpdateMatrixStacks();
-
-    C3D_BufInfo* bufInfo = C3D_GetBufInfo();
-    BufInfo_Init(bufInfo);
-    BufInfo_Add(bufInfo, &m_vertices[0], sizeof(Vertex), 3, 0x210);
-
-    C3D_TexEnv* env = C3D_GetTexEnv(0);
-    C3D_TexEnvSrc(env, C3D_RGB, GPU_PRIMARY_COLOR, 0, 0);
-    C3D_TexEnvSrc(env, C3D_Alpha, GPU_TEXTURE0, GPU_PRIMARY_COLOR, 0);
-    C3D_TexEnvOp(env, C3D_Both, 0, 0, 0);
-    C3D_TexEnvFunc(env, C3D_RGB, GPU_REPLACE);
-    C3D_TexEnvFunc(env, C3D_Alpha, GPU_MODULATE);
-
-    int vertexIndex = 0;
-    int lastTextureIndex = -1;
-    for (Uint16 textureIndex : m_systemGlyphTextures)
+#ifndef EMULATION
+    // One draw per sheet, the glyphs were grouped by sheet. They go through
+    // the target like any other vertices, so that depth sorting keeps them.
+    std::size_t vertexIndex = 0;
+    for (std::size_t i = 0; i < m_systemGlyphSheets.size(); ++i)
     {
-        if (lastTextureIndex != textureIndex) {
-            lastTextureIndex = textureIndex;
-            C3D_TexBind(0, system_font_textures[textureIndex].getNativeTexture());
-        }
-        C3D_DrawArrays(GPU_TRIANGLE_STRIP, vertexIndex, 4);
-        vertexIndex += 4;
+        states.texture = &system_font_textures[m_systemGlyphSheets[i].first];
+        target.draw(&m_vertices[vertexIndex], m_systemGlyphSheets[i].second, Triangles, states);
+        vertexIndex += m_systemGlyphSheets[i].second;
     }
+#else
+    // The emulator has no system font, so there are no vertices to draw
+    (void)target;
 #endif
-    target.applyTexture(NULL);
 }
 
 
@@ -414,11 +477,29 @@ void Text::draw(RenderTarget& target, RenderStates states) const
         states.transform *= getTransform();
         states.texture = &m_font->getTexture(m_characterSize);
 
-        // Only draw the outline if there is something to draw
-        if (m_outlineThickness != 0)
-            target.draw(m_outlineVertices, states);
+        if (m_font->isDistanceField())
+        {
+            // Outlines are the same quads as the fill, cut at a lower threshold.
+            // The threshold travels in the states, so that it is kept when the
+            // draw is deferred by depth sorting; 0 would mean no distance field.
+            states.distanceFieldPixelsPerUnit = 2.f * Font::DistanceFieldSpread * m_characterSize / Font::DistanceFieldSize;
+            if (m_outlineThickness != 0)
+            {
+                states.distanceFieldThreshold = std::max(0.5f - m_outlineThickness / states.distanceFieldPixelsPerUnit, 1.f / 255.f);
+                target.draw(m_outlineVertices, states);
+            }
+
+            states.distanceFieldThreshold = 0.5f;
+            target.draw(m_vertices, states);
+        }
+        else
+        {
+            // Only draw the outline if there is something to draw
+            if (m_outlineThickness != 0)
+                target.draw(m_outlineVertices, states);
 
-        target.draw(m_vertices, states);
+            target.draw(m_vertices, states);
+        }
     }
 }
 
@@ -427,58 +508,64 @@ void Text::draw(RenderTarget& target, RenderStates states) const
 void Text::ensureGeometryUpdateSystemFont() const
 {
 #ifndef EMULATION
-    m_systemGlyphTextures.clear();
+    m_systemGlyphSheets.clear();
 
     float maxX = 0.f;
     float x = 0.f;
     float y = 0.f;
     float scaleX = static_cast<float>(m_characterSize) / 25.f;
     float scaleY = scaleX;
-    bool baseline = false;
-
-    ssize_t  units;
-    uint32_t code;
+    float lineFeed = scaleY * fontGetInfo()->lineFeed;
 
-    auto str = m_string.toUtf8();
-    const uint8_t* p = str.c_str();
-    float firstX = x;
-    int lastSheet = -1;
-    int vertexIndex = 0;
-    do
+    // Place the glyphs, reading the UTF-32 string directly
+    std::vector<SystemQuad> quads;
+    quads.reserve(m_string.getSize());
+    for (std::size_t i = 0; i < m_string.getSize(); ++i)
     {
-        if (!*p) break;
-        units = decode_utf8(&code, p);
-        if (units == -1)
-            break;
-        p += units;
+        Uint32 code = m_string[i];
         if (code == '\n')
         {
-            x = firstX;
-            y += scaleY*fontGetInfo()->lineFeed;
+            x = 0.f;
+            y += lineFeed;
         }
         else if (code > 0)
         {
-            int glyphIdx = fontGlyphIndexFromCodePoint(code);
-            fontGlyphPos_s data;
-            fontCalcGlyphPos(&data, glyphIdx, GLYPH_POS_CALC_VTXCOORD, scaleX, scaleY);
-
-            m_systemGlyphTextures.push_back(data.sheetIndex);
-
-            m_vertices.append(Vertex(Vector2f(x+data.vtxcoord.left,  y+data.vtxcoord.bottom), m_fillColor, Vector2f(data.texcoord.left,  data.texcoord.bottom)));
-            m_vertices.append(Vertex(Vector2f(x+data.vtxcoord.right, y+data.vtxcoord.bottom), m_fillColor, Vector2f(data.texcoord.right, data.texcoord.bottom)));
-            m_vertices.append(Vertex(Vector2f(x+data.vtxcoord.left,  y+data.vtxcoord.top), m_fillColor, Vector2f(data.texcoord.left,  data.texcoord.top)));
-            m_vertices.append(Vertex(Vector2f(x+data.vtxcoord.right, y+data.vtxcoord.top), m_fillColor, Vector2f(data.texcoord.right, data.texcoord.top)));
+            const SystemGlyph& glyph = getSystemGlyph(code);
+            SystemQuad quad = {&glyph, x, y};
+            quads.push_back(quad);
 
-            x += data.xAdvance;
+            x += glyph.advance * scaleX;
             if (x > maxX)
                 maxX = x;
         }
-    } while (code > 0);
+    }
+
+    // Group the glyphs by sheet, so that each sheet is bound and drawn once
+    std::stable_sort(quads.begin(), quads.end());
+    for (std::vector<SystemQuad>::const_iterator quad = quads.begin(); quad != quads.end(); ++quad)
+    {
+        const SystemGlyph& glyph = *quad->glyph;
+        float left   = quad->x + glyph.left   * scaleX;
+        float right  = quad->x + glyph.right  * scaleX;
+        float top    = quad->y + glyph.top    * scaleY;
+        float bottom = quad->y + glyph.bottom * scaleY;
+
+        m_vertices.append(Vertex(Vector2f(left,  bottom), m_fillColor, Vector2f(glyph.u1, glyph.v2)));
+        m_vertices.append(Vertex(Vector2f(right, bottom), m_fillColor, Vector2f(glyph.u2, glyph.v2)));
+        m_vertices.append(Vertex(Vector2f(left,  top),    m_fillColor, Vector2f(glyph.u1, glyph.v1)));
+        m_vertices.append(Vertex(Vector2f(left,  top),    m_fillColor, Vector2f(glyph.u1, glyph.v1)));
+        m_vertices.append(Vertex(Vector2f(right, bottom), m_fillColor, Vector2f(glyph.u2, glyph.v2)));
+        m_vertices.append(Vertex(Vector2f(right, top),    m_fillColor, Vector2f(glyph.u2, glyph.v1)));
+
+        if (m_systemGlyphSheets.empty() || (m_systemGlyphSheets.back().first != glyph.sheet))
+            m_systemGlyphSheets.push_back(std::make_pair(static_cast<Uint16>(glyph.sheet), 0u));
+        m_systemGlyphSheets.back().second += 6;
+    }
 
     m_bounds.left = 0;
     m_bounds.top = 0;
     m_bounds.width = maxX;
-    m_bounds.height = y + scaleY * fontGetInfo()->lineFeed;
+    m_bounds.height = y + lineFeed;
 #endif
 }
 
@@ -487,12 +574,13 @@ void Text::ensureGeometryUpdateSystemFont() const
 void Text::ensureGeometryUpdate() const
 {
 	// Load system's opensans.tff if user attempts drawing without font
-	if (!m_useSystemFont && m_font == &priv::system_font && !priv::system_font_loaded)
-	{
-		priv::system_font_loaded = true;
-		priv::ResourceInfo font = priv::core_resources["opensans.ttf"];
-		priv::system_font.loadFromMemory(font.data, font.size);
-	}
+	if (!m_useSystemFont && m_font == &priv::system_font)
+		priv::ensureSystemFontLoaded();
+
+    // Rebuild once the font has replaced glyphs, the placeholders of the ones it
+    // was still loading or the missing ones a fallback has
+    if (m_font && (m_font->getUpdateCount() != m_fontUpdateCount))
+        m_geometryNeedUpdate = true;
 
     // Do nothing, if geometry has not changed
     if (!m_geometryNeedUpdate)
@@ -531,84 +619,62 @@ void Text::ensureGeometryUpdate() const
     float strikeThroughOffset = xBounds.top + xBounds.height / 2.f;
 
     // Precompute the variables needed by the algorithm
-    float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
     float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-    float x      = 0.f;
-    float y      = static_cast<float>(m_characterSize);
+
+    // Distance field glyphs come with a margin that doesn't count in the bounds
+    bool  distanceField = m_font->isDistanceField();
+    float fieldMargin   = distanceField ? static_cast<float>(Font::DistanceFieldSpread * m_characterSize) / Font::DistanceFieldSize : 0.f;
+
+    // The layout places the characters, a line's baseline is a character size below its top
+    const std::vector<TextLayout::Character>& characters = m_layout.getCharacters();
+    const std::vector<TextLayout::Line>&      lines      = m_layout.getLines();
+    float baseline = static_cast<float>(m_characterSize);
 
     // Create one quad for each character
     float minX = static_cast<float>(m_characterSize);
     float minY = static_cast<float>(m_characterSize);
     float maxX = 0.f;
     float maxY = 0.f;
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < m_string.getSize(); ++i)
+    for (std::size_t i = 0; i < characters.size(); ++i)
     {
-        Uint32 curChar = m_string[i];
-
-        // Apply the kerning offset
-        x += m_font->getKerning(prevChar, curChar, m_characterSize);
-        prevChar = curChar;
-
-        // If we're using the underlined style and there's a new line, draw a line
-        if (underlined && (curChar == L'\n'))
-        {
-            addLine(m_vertices, x, y, m_fillColor, underlineOffset, underlineThickness);
-
-            if (m_outlineThickness != 0)
-                addLine(m_outlineVertices, x, y, m_outlineColor, underlineOffset, underlineThickness, m_outlineThickness);
-        }
-
-        // If we're using the strike through style and there's a new line, draw a line across all characters
-        if (strikeThrough && (curChar == L'\n'))
-        {
-            addLine(m_vertices, x, y, m_fillColor, strikeThroughOffset, underlineThickness);
-
-            if (m_outlineThickness != 0)
-                addLine(m_outlineVertices, x, y, m_outlineColor, strikeThroughOffset, underlineThickness, m_outlineThickness);
-        }
+        Uint32 curChar = characters[i].codePoint;
+        float  x       = characters[i].position.x;
+        float  y       = characters[i].position.y + baseline;
 
         // Handle special characters
         if ((curChar == ' ') || (curChar == '\t') || (curChar == '\n'))
         {
-            // Update the current bounds (min coordinates)
+            // Update the current bounds, a line feed reaches to the next line
             minX = std::min(minX, x);
             minY = std::min(minY, y);
-
-            switch (curChar)
-            {
-                case ' ':  x += hspace;        break;
-                case '\t': x += hspace * 4;    break;
-                case '\n': y += vspace; x = 0; break;
-            }
-
-            // Update the current bounds (max coordinates)
-            maxX = std::max(maxX, x);
-            maxY = std::max(maxY, y);
+            maxX = std::max(maxX, (curChar == '\n') ? 0.f : x + characters[i].advance);
+            maxY = std::max(maxY, (curChar == '\n') ? y + vspace : y);
 
             // Next glyph, no need to create a quad for whitespace
             continue;
         }
 
-
         // Apply the outline
         if (m_outlineThickness != 0)
         {
             const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, bold, m_outlineThickness);
 
-            float left   = glyph.bounds.left;
-            float top    = glyph.bounds.top;
-            float right  = glyph.bounds.left + glyph.bounds.width;
-            float bottom = glyph.bounds.top  + glyph.bounds.height;
+            // A distance field glyph is the filled one, its outline lies within the margin
+            float offset = distanceField ? 0.f : m_outlineThickness;
+            float inset  = distanceField ? fieldMargin - m_outlineThickness : 0.f;
+            float left   = glyph.bounds.left + inset;
+            float top    = glyph.bounds.top  + inset;
+            float right  = glyph.bounds.left + glyph.bounds.width  - inset;
+            float bottom = glyph.bounds.top  + glyph.bounds.height - inset;
 
             // Add the outline glyph to the vertices
-            addGlyphQuad(m_outlineVertices, Vector2f(x, y), m_outlineColor, glyph, italic, m_outlineThickness);
+            addGlyphQuad(m_outlineVertices, Vector2f(x, y), m_outlineColor, glyph, italic, offset);
 
             // Update the current bounds with the outlined glyph bounds
-            minX = std::min(minX, x + left   - italic * bottom - m_outlineThickness);
-            maxX = std::max(maxX, x + right  - italic * top    - m_outlineThickness);
-            minY = std::min(minY, y + top    - m_outlineThickness);
-            maxY = std::max(maxY, y + bottom - m_outlineThickness);
+            minX = std::min(minX, x + left   - italic * bottom - offset);
+            maxX = std::max(maxX, x + right  - italic * top    - offset);
+            minY = std::min(minY, y + top    - offset);
+            maxY = std::max(maxY, y + bottom - offset);
         }
 
         // Extract the current glyph's description
@@ -620,39 +686,46 @@ void Text::ensureGeometryUpdate() const
         // Update the current bounds with the non outlined glyph bounds
         if (m_outlineThickness == 0)
         {
-            float left   = glyph.bounds.left;
-            float top    = glyph.bounds.top;
-            float right  = glyph.bounds.left + glyph.bounds.width;
-            float bottom = glyph.bounds.top  + glyph.bounds.height;
+            float left   = glyph.bounds.left + fieldMargin;
+            float top    = glyph.bounds.top  + fieldMargin;
+            float right  = glyph.bounds.left + glyph.bounds.width  - fieldMargin;
+            float bottom = glyph.bounds.top  + glyph.bounds.height - fieldMargin;
 
             minX = std::min(minX, x + left  - italic * bottom);
             maxX = std::max(maxX, x + right - italic * top);
             minY = std::min(minY, y + top);
             maxY = std::max(maxY, y + bottom);
         }
-
-        // Advance to the next character
-        x += glyph.advance;
     }
 
-    // If we're using the underlined style, add the last line
-    if (underlined && (x > 0))
+    // Underline and strike through each line, across all its characters
+    for (std::size_t i = 0; (underlined || strikeThrough) && (i < lines.size()); ++i)
     {
-        addLine(m_vertices, x, y, m_fillColor, underlineOffset, underlineThickness);
+        float width = lines[i].width;
+        float y     = lines[i].top + baseline;
+        if (width <= 0)
+            continue;
 
-        if (m_outlineThickness != 0)
-            addLine(m_outlineVertices, x, y, m_outlineColor, underlineOffset, underlineThickness, m_outlineThickness);
-    }
+        if (underlined)
+        {
+            addLine(m_vertices, width, y, m_fillColor, underlineOffset, underlineThickness);
 
-    // If we're using the strike through style, add the last line across all characters
-    if (strikeThrough && (x > 0))
-    {
-        addLine(m_vertices, x, y, m_fillColor, strikeThroughOffset, underlineThickness);
+            if (m_outlineThickness != 0)
+                addLine(m_outlineVertices, width, y, m_outlineColor, underlineOffset, underlineThickness, m_outlineThickness);
+        }
 
-        if (m_outlineThickness != 0)
-            addLine(m_outlineVertices, x, y, m_outlineColor, strikeThroughOffset, underlineThickness, m_outlineThickness);
+        if (strikeThrough)
+        {
+            addLine(m_vertices, width, y, m_fillColor, strikeThroughOffset, underlineThickness);
+
+            if (m_outlineThickness != 0)
+                addLine(m_outlineVertices, width, y, m_outlineColor, strikeThroughOffset, underlineThickness, m_outlineThickness);
+        }
     }
 
+    // Glyphs loading in the background are placeholders for now
+    m_fontUpdateCount = m_font->getUpdateCount();
+
     // Update the bounding rectangle
     m_bounds.left = minX;
     m_bounds.top = minY;
@@ -0,0 +1,402 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextLayout.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    const std::size_t NoBreak = static_cast<std::size_t>(-1);
+
+    bool isWhitespace(cpp3ds::Uint32 codePoint)
+    {
+        return (codePoint == L' ') || (codePoint == L'\t') || (codePoint == L'\n');
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+TextLayout::TextLayout() :
+m_font            (NULL),
+m_characterSize   (30),
+m_bold            (false),
+m_wrapWidth       (0.f),
+m_maxLines        (0),
+m_ellipsis        ("..."),
+m_visibleCount    (0),
+m_needUpdate      (true),
+m_fontUpdateCount (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+TextLayout::TextLayout(const String& string, const Font& font, unsigned int characterSize) :
+m_string          (string),
+m_font            (&font),
+m_characterSize   (characterSize),
+m_bold            (false),
+m_wrapWidth       (0.f),
+m_maxLines        (0),
+m_ellipsis        ("..."),
+m_visibleCount    (0),
+m_needUpdate      (true),
+m_fontUpdateCount (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::setString(const String& string)
+{
+    if (m_string != string)
+    {
+        m_string = string;
+        m_needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::setFont(const Font& font)
+{
+    if (m_font != &font)
+    {
+        m_font = &font;
+        m_needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::setCharacterSize(unsigned int size)
+{
+    if (m_characterSize != size)
+    {
+        m_characterSize = size;
+        m_needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::setBold(bool bold)
+{
+    if (m_bold != bold)
+    {
+        m_bold = bold;
+        m_needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::setWrapWidth(float width)
+{
+    if (m_wrapWidth != width)
+    {
+        m_wrapWidth = width;
+        m_needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::setMaxLines(unsigned int lines)
+{
+    if (m_maxLines != lines)
+    {
+        m_maxLines = lines;
+        m_needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::setEllipsis(const String& ellipsis)
+{
+    if (m_ellipsis != ellipsis)
+    {
+        m_ellipsis = ellipsis;
+        m_needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<TextLayout::Character>& TextLayout::getCharacters() const
+{
+    ensureUpdate();
+
+    return m_characters;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<TextLayout::Line>& TextLayout::getLines() const
+{
+    ensureUpdate();
+
+    return m_lines;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextLayout::getVisibleCount() const
+{
+    ensureUpdate();
+
+    return m_visibleCount;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextLayout::isTruncated() const
+{
+    ensureUpdate();
+
+    return m_visibleCount < m_string.getSize();
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2f TextLayout::getSize() const
+{
+    ensureUpdate();
+
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2f TextLayout::findCharacterPos(std::size_t index) const
+{
+    ensureUpdate();
+
+    // Shown characters, then the ellipsis standing for the hidden ones
+    if (index < m_visibleCount)
+        return m_characters[index].position;
+    if (m_visibleCount < m_characters.size())
+        return m_characters[m_visibleCount].position;
+
+    if (m_characters.empty())
+        return Vector2f();
+
+    // The end of the text, which is on a new line after a line feed
+    const Character& last = m_characters.back();
+    if (last.codePoint == L'\n')
+        return Vector2f(0.f, m_lines.back().top);
+
+    return Vector2f(last.position.x + last.advance, last.position.y);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::ensureUpdate() const
+{
+    // Advances of glyphs loading in the background may change a little, and
+    // those of missing glyphs a lot once a fallback has them
+    if (m_font && (m_font->getUpdateCount() != m_fontUpdateCount))
+        m_needUpdate = true;
+
+    if (!m_needUpdate)
+        return;
+
+    m_needUpdate = false;
+    m_characters.clear();
+    m_lines.clear();
+    m_visibleCount = 0;
+    m_size = Vector2f();
+
+    if (!m_font || m_string.isEmpty())
+        return;
+
+    float hspace = m_font->getGlyph(L' ', m_characterSize, m_bold).advance;
+    float vspace = m_font->getLineSpacing(m_characterSize);
+
+    Line first = {0, 0, 0.f, 0.f};
+    m_lines.push_back(first);
+    m_characters.reserve(m_string.getSize());
+
+    // Each character of the string gets one entry, so an index in the
+    // string is also its index in m_characters until the ellipsis
+    float       x           = 0.f;
+    std::size_t breakIndex  = NoBreak;
+    Uint32      prevChar    = 0;
+    bool        isClosed    = false;
+    for (std::size_t i = 0; i < m_string.getSize(); ++i)
+    {
+        Uint32 curChar = m_string[i];
+        float  y       = m_lines.back().top;
+
+        if (curChar == L'\n')
+        {
+            Character character = {curChar, Vector2f(x, y), 0.f};
+            m_characters.push_back(character);
+
+            if (!newLine(m_characters.size(), x, vspace))
+            {
+                // Only cut if there is text left for the lines that don't fit
+                if (i + 1 < m_string.getSize())
+                {
+                    m_characters.pop_back();
+                    truncate(hspace);
+                }
+                else
+                    m_visibleCount = m_characters.size();
+
+                isClosed = true;
+                break;
+            }
+
+            x          = 0.f;
+            breakIndex = NoBreak;
+            prevChar   = 0;
+            continue;
+        }
+
+        float kerning = m_font->getKerning(prevChar, curChar, m_characterSize);
+        float advance = getAdvance(curChar, hspace);
+        bool  space   = (curChar == L' ') || (curChar == L'\t');
+
+        // Wrap when a visible character overflows a line that has something on it
+        if ((m_wrapWidth > 0.f) && !space && (x + kerning + advance > m_wrapWidth) && (m_characters.size() > m_lines.back().begin))
+        {
+            // At the last space if there is one, the word after it moves
+            // to the next line; otherwise the word itself is cut
+            bool        atSpace = (breakIndex != NoBreak);
+            std::size_t end     = atSpace ? breakIndex + 1 : m_characters.size();
+            float       width   = atSpace ? m_characters[breakIndex].position.x : x;
+            if (atSpace)
+                m_characters[breakIndex].advance = 0.f;
+
+            m_characters.resize(end);
+            if (!newLine(end, width, vspace))
+            {
+                truncate(hspace);
+                isClosed = true;
+                break;
+            }
+
+            x          = 0.f;
+            breakIndex = NoBreak;
+            prevChar   = 0;
+
+            // Lay out the moved word again from the start of the new line
+            if (atSpace)
+            {
+                i = end - 1;
+                continue;
+            }
+
+            kerning = 0.f;
+            y       = m_lines.back().top;
+        }
+
+        x += kerning;
+        Character character = {curChar, Vector2f(x, y), advance};
+        m_characters.push_back(character);
+        x += advance;
+
+        if (space)
+            breakIndex = m_characters.size() - 1;
+        prevChar = curChar;
+    }
+
+    if (!isClosed)
+    {
+        m_lines.back().end   = m_characters.size();
+        m_lines.back().width = x;
+        m_visibleCount       = m_characters.size();
+    }
+
+    for (std::vector<Line>::const_iterator line = m_lines.begin(); line != m_lines.end(); ++line)
+        m_size.x = std::max(m_size.x, line->width);
+    m_size.y = vspace * m_lines.size();
+
+    m_fontUpdateCount = m_font->getUpdateCount();
+}
+
+
+////////////////////////////////////////////////////////////
+float TextLayout::getAdvance(Uint32 codePoint, float hspace) const
+{
+    switch (codePoint)
+    {
+        case L' ':  return hspace;
+        case L'\t': return hspace * 4;
+        case L'\n': return 0.f;
+    }
+
+    return m_font->getGlyph(codePoint, m_characterSize, m_bold).advance;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextLayout::newLine(std::size_t end, float width, float lineSpacing) const
+{
+    Line& line = m_lines.back();
+    line.end   = end;
+    line.width = width;
+
+    if ((m_maxLines > 0) && (m_lines.size() >= m_maxLines))
+        return false;
+
+    Line next = {end, end, line.top + lineSpacing, 0.f};
+    m_lines.push_back(next);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::truncate(float hspace) const
+{
+    Line& line = m_lines.back();
+
+    float ellipsisWidth = 0.f;
+    Uint32 prevChar = 0;
+    for (std::size_t i = 0; i < m_ellipsis.getSize(); ++i)
+    {
+        ellipsisWidth += m_font->getKerning(prevChar, m_ellipsis[i], m_characterSize) + getAdvance(m_ellipsis[i], hspace);
+        prevChar = m_ellipsis[i];
+    }
+
+    // Take characters back until the ellipsis fits, and the spaces before it
+    while (m_characters.size() > line.begin)
+    {
+        const Character& last = m_characters.back();
+        if (!isWhitespace(last.codePoint) && ((m_wrapWidth <= 0.f) || (last.position.x + last.advance + ellipsisWidth <= m_wrapWidth)))
+            break;
+
+        m_characters.pop_back();
+    }
+    m_visibleCount = m_characters.size();
+
+    float x = 0.f;
+    prevChar = 0;
+    if (m_characters.size() > line.begin)
+    {
+        x        = m_characters.back().position.x + m_characters.back().advance;
+        prevChar = m_characters.back().codePoint;
+    }
+
+    for (std::size_t i = 0; i < m_ellipsis.getSize(); ++i)
+    {
+        x += m_font->getKerning(prevChar, m_ellipsis[i], m_characterSize);
+        Character character = {m_ellipsis[i], Vector2f(x, line.top), getAdvance(m_ellipsis[i], hspace)};
+        m_characters.push_back(character);
+        x += character.advance;
+        prevChar = m_ellipsis[i];
+    }
+
+    line.end   = m_characters.size();
+    line.width = x;
+}
+
+} // namespace cpp3ds
@@ -27,6 +27,7 @@
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/Graphics/TextureManager.hpp>
 #include <cpp3ds/OpenGL/GLExtensions.hpp>
 #include <cpp3ds/Window/Window.hpp>
 #include <cpp3ds/System/Mutex.hpp>
@@ -40,6 +41,7 @@
 #include <cpp3ds/System/FileInputStream.hpp>
 #include <cpp3ds/System/FileSystem.hpp>
 #include "CitroHelpers.hpp"
+#include "TextureCodec.hpp"
 
 // Note: vertical flip flag set so 0,0 is top left of texture
 #define TEXTURE_TRANSFER_FLAGS \
@@ -47,17 +49,6 @@
 	GX_TRANSFER_IN_FORMAT(GX_TRANSFER_FMT_RGBA8) | GX_TRANSFER_OUT_FORMAT(GX_TRANSFER_FMT_RGBA8) | \
 	GX_TRANSFER_SCALING(GX_TRANSFER_SCALE_NO))
 
-#ifdef _3DS
-typedef struct
-{
-	u16 format;         //< Format matching ctrulib enum GPU_TEXCOLOR
-	u16 width;          //< Width (original width to next power of 2)
-	u16 height;         //< Height (original height to next power of 2)
-	u16 widthOriginal;  //< Width of original input
-	u16 heightOriginal; //< Height of original input
-} Header;
-#endif
-
 namespace
 {
 	cpp3ds::Mutex mutex;
@@ -124,34 +115,6 @@ namespace
             }
         }
     }
-
-    inline size_t fmtSize(GPU_TEXCOLOR fmt)
-    {
-        switch (fmt)
-        {
-            case GPU_RGBA8:
-                return 32;
-            case GPU_RGB8:
-                return 24;
-            case GPU_RGBA5551:
-            case GPU_RGB565:
-            case GPU_RGBA4:
-            case GPU_LA8:
-            case GPU_HILO8:
-                return 16;
-            case GPU_L8:
-            case GPU_A8:
-            case GPU_LA4:
-            case GPU_ETC1A4:
-                return 8;
-            case GPU_L4:
-            case GPU_A4:
-            case GPU_ETC1:
-                return 4;
-            default:
-                return 0;
-        }
-    }
 }
 
 
@@ -166,6 +129,9 @@ m_isSmooth     (false),
 m_isRepeated   (false),
 m_pixelsFlipped(false),
 m_ownsData     (true),
+m_format       (GPU_RGBA8),
+m_hasMipmap    (false),
+m_isManaged    (false),
 m_cacheId      (getUniqueId())
 {
 
@@ -181,16 +147,29 @@ m_isSmooth     (copy.m_isSmooth),
 m_isRepeated   (copy.m_isRepeated),
 m_pixelsFlipped(false),
 m_ownsData     (true),
+m_format       (GPU_RGBA8),
+m_hasMipmap    (false),
+m_isManaged    (false),
 m_cacheId      (getUniqueId())
 {
     if (copy.m_texture)
-        loadFromImage(copy.copyToImage());
+    {
+        // Compressed textures can't be re-encoded, they become RGBA8 copies
+        GPU_TEXCOLOR format = copy.m_format;
+        if (format == GPU_ETC1 || format == GPU_ETC1A4)
+            format = GPU_RGBA8;
+        if (create(copy.m_size.x, copy.m_size.y, format))
+            update(copy.copyToImage());
+    }
 }
 
 
 ////////////////////////////////////////////////////////////
 Texture::~Texture()
 {
+    if (m_isManaged)
+        TextureManager::getInstance().remove(*this);
+
     if (m_texture)
     {
         if (m_ownsData)
@@ -201,7 +180,7 @@ Texture::~Texture()
 
 
 ////////////////////////////////////////////////////////////
-bool Texture::create(unsigned int width, unsigned int height)
+bool Texture::create(unsigned int width, unsigned int height, GPU_TEXCOLOR format)
 {
     // Check if texture parameters are valid before creating it
     if ((width == 0) || (height == 0))
@@ -209,6 +188,11 @@ bool Texture::create(unsigned int width, unsigned int height)
         err() << "Failed to create texture, invalid size (" << width << "x" << height << ")" << std::endl;
         return false;
     }
+    if (!priv::getTextureFormatBits(format) || (format == GPU_ETC1) || (format == GPU_ETC1A4))
+    {
+        err() << "Failed to create texture, unsupported format (" << format << ")" << std::endl;
+        return false;
+    }
 
     // Compute the internal texture dimensions depending on NPOT textures support
     Vector2u actualSize(getValidSize(width), getValidSize(height));
@@ -231,6 +215,8 @@ bool Texture::create(unsigned int width, unsigned int height)
     m_size.y        = height;
     m_actualSize    = actualSize;
     m_pixelsFlipped = false;
+    m_format        = format;
+    m_hasMipmap     = false;
 
 	ensureGlContext();
 
@@ -242,7 +228,7 @@ bool Texture::create(unsigned int width, unsigned int height)
 
     if (!m_texture)
         return false;
-    if (!C3D_TexInit(m_texture, m_actualSize.x, m_actualSize.y, GPU_RGBA8))
+    if (!C3D_TexInit(m_texture, m_actualSize.x, m_actualSize.y, format))
         return false;
 
     C3D_TexSetWrap(m_texture,
@@ -344,17 +330,17 @@ bool Texture::loadFromPreprocessedFile(const std::string& filename)
     if (filename.empty())
         return false;
 
-    Header header;
+    priv::TextureHeader header;
     FileInputStream file;
     if (!file.open(filename))
         return false;
 
-    file.read(&header, sizeof(Header));
-    size_t size = file.getSize() - sizeof(Header);
+    file.read(&header, sizeof(header));
+    size_t size = file.getSize() - sizeof(header);
 
     // Verify header
     GPU_TEXCOLOR format = static_cast<GPU_TEXCOLOR>(header.format);
-    if (size != header.width * header.height * fmtSize(format) / 8)
+    if (size != header.width * header.height * priv::getTextureFormatBits(format) / 8)
     {
         err() << "Improper file header: " << filename << std::endl;
         return false;
@@ -404,6 +390,8 @@ bool Texture::loadFromPreprocessedMemory(void *data, size_t size, size_t width,
     m_size.y        = height;
     m_actualSize    = m_size;
     m_pixelsFlipped = false;
+    m_format        = format;
+    m_hasMipmap     = false;
 
     ensureGlContext();
 
@@ -461,10 +449,13 @@ Image Texture::copyToImage() const
     // Create an array of pixels
     std::vector<Uint8> pixels(m_size.x * m_size.y * 4);
 
-    u32 *data = (u32*)linearAlloc(m_texture->size);
+    u32 *data = (u32*)linearAlloc(m_texture->width * m_texture->height * 4);
 
+    if (m_texture->fmt == GPU_RGBA8)
         imageUntile32((u8*)data, (u8*)m_texture->data, 0, 0, m_texture->width, m_texture->height, m_texture->width, m_texture->height);
-        GSPGPU_FlushDataCache(data, m_texture->size);
+    else
+        priv::decodeTexture((Uint8*)m_texture->data, (Uint8*)data, m_texture->width, m_texture->height, m_texture->fmt);
+    GSPGPU_FlushDataCache(data, m_texture->width * m_texture->height * 4);
 
     if ((m_size == m_actualSize) && !m_pixelsFlipped)
 	{
@@ -526,11 +517,17 @@ void Texture::update(const Uint8* pixels, unsigned int width, unsigned int heigh
 
     if (pixels && m_texture)
     {
-            u8* dest = (u8*)m_texture->data;
+        u8* dest = (u8*)m_texture->data;
 
+        // Convert while tiling when the texture isn't RGBA8
+        if (m_format == GPU_RGBA8)
             imageTile32(dest, pixels, x, y, width, height, m_texture->width, m_texture->height);
+        else
+            priv::encodeTexture(pixels, width, height, x, y, dest, m_texture->width, m_texture->height, m_format);
+
+        C3D_TexFlush(m_texture);
 
-            C3D_TexFlush(m_texture);
+        invalidateMipmap();
 
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
@@ -570,6 +567,8 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
     {
         err() << "Function not yet implemented" << std::endl;
 
+        invalidateMipmap();
+
         m_pixelsFlipped = true;
         m_cacheId = getUniqueId();
     }
@@ -588,6 +587,8 @@ void Texture::setSmooth(bool smooth)
             C3D_TexSetFilter(m_texture,
                              m_isSmooth ? GPU_LINEAR : GPU_NEAREST,
                              m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
+            if (m_hasMipmap)
+                C3D_TexSetFilterMipmap(m_texture, m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
         }
     }
 }
@@ -624,18 +625,114 @@ bool Texture::isRepeated() const
 }
 
 
+////////////////////////////////////////////////////////////
+GPU_TEXCOLOR Texture::getFormat() const
+{
+    return m_format;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmap()
+{
+    if (!m_texture)
+        return false;
+
+    if ((m_format == GPU_ETC1) || (m_format == GPU_ETC1A4))
+    {
+        err() << "Failed to generate mipmap, compressed textures aren't supported" << std::endl;
+        return false;
+    }
+
+    unsigned int width = m_texture->width;
+    unsigned int height = m_texture->height;
+    int levels = C3D_TexCalcMaxLevel(width, height);
+    if (levels == 0)
+        return true;
+
+    // Read back level 0 as RGBA pixels to filter from
+    std::vector<Uint8> pixels(width * height * 4);
+    if (m_format == GPU_RGBA8)
+        imageUntile32(&pixels[0], (u8*)m_texture->data, 0, 0, width, height, width, height);
+    else
+        priv::decodeTexture((Uint8*)m_texture->data, &pixels[0], width, height, m_format);
+
+    // Reallocate with room for the whole chain, level 0 keeps its layout
+    C3D_Tex* texture = new C3D_Tex();
+    if (!C3D_TexInitMipmap(texture, width, height, m_format))
+    {
+        delete texture;
+        err() << "Failed to generate mipmap, out of memory" << std::endl;
+        return false;
+    }
+    std::memcpy(texture->data, m_texture->data, width * height * priv::getTextureFormatBits(m_format) / 8);
+
+    if (m_ownsData)
+        C3D_TexDelete(m_texture);
+    delete m_texture;
+    m_texture  = texture;
+    m_ownsData = true;
+
+    std::vector<Uint8> next((width / 2) * (height / 2) * 4);
+    for (int level = 1; level <= levels; ++level)
+    {
+        priv::downsampleBox(&pixels[0], width, height, &next[0]);
+        width /= 2;
+        height /= 2;
+
+        u8* dest = (u8*)C3D_TexGetImagePtr(m_texture, m_texture->data, level, NULL);
+        priv::encodeTexture(&next[0], width, height, 0, 0, dest, width, height, m_format);
+        pixels.swap(next);
+    }
+
+    C3D_TexFlush(m_texture);
+
+    C3D_TexSetWrap(m_texture,
+                   m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE,
+                   m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE);
+    C3D_TexSetFilter(m_texture,
+                     m_isSmooth ? GPU_LINEAR : GPU_NEAREST,
+                     m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
+    C3D_TexSetFilterMipmap(m_texture, m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
+
+    m_hasMipmap = true;
+    m_cacheId = getUniqueId();
+
+    // Managed textures get their mipmap back when reloaded
+    if (m_isManaged)
+        TextureManager::getInstance().addMipmap(*this);
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::bind(const Texture* texture, CoordinateType coordinateType)
 {
+    // Evicted textures are reloaded here
+    if (texture && texture->m_isManaged)
+        TextureManager::getInstance().use(*texture);
+
     if (texture && texture->m_texture)
     {
         // Bind the texture
         C3D_TexBind(0, texture->m_texture);
 
         C3D_TexEnv* env = C3D_GetTexEnv(0);
-        C3D_TexEnvSrc(env, C3D_Both, GPU_TEXTURE0, GPU_PRIMARY_COLOR, 0);
         C3D_TexEnvOp(env, C3D_Both, 0, 0, 0);
-        C3D_TexEnvFunc(env, C3D_Both, GPU_MODULATE);
+        if (texture->m_format == GPU_A8 || texture->m_format == GPU_A4)
+        {
+            // Alpha-only textures sample as black, so take color from the vertices
+            C3D_TexEnvSrc(env, C3D_RGB, GPU_PRIMARY_COLOR, 0, 0);
+            C3D_TexEnvFunc(env, C3D_RGB, GPU_REPLACE);
+            C3D_TexEnvSrc(env, C3D_Alpha, GPU_TEXTURE0, GPU_PRIMARY_COLOR, 0);
+            C3D_TexEnvFunc(env, C3D_Alpha, GPU_MODULATE);
+        }
+        else
+        {
+            C3D_TexEnvSrc(env, C3D_Both, GPU_TEXTURE0, GPU_PRIMARY_COLOR, 0);
+            C3D_TexEnvFunc(env, C3D_Both, GPU_MODULATE);
+        }
 
         // Check if we need to define a special texture matrix
         if ((coordinateType == Pixels) || texture->m_pixelsFlipped)
@@ -698,12 +795,43 @@ Texture& Texture::operator =(const Texture& right)
     std::swap(m_isSmooth,      temp.m_isSmooth);
     std::swap(m_isRepeated,    temp.m_isRepeated);
     std::swap(m_pixelsFlipped, temp.m_pixelsFlipped);
+    std::swap(m_format,        temp.m_format);
+    std::swap(m_hasMipmap,     temp.m_hasMipmap);
     m_cacheId = getUniqueId();
 
     return *this;
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::invalidateMipmap()
+{
+    if (!m_hasMipmap)
+        return;
+
+    // Levels stay allocated but only level 0 is sampled
+    m_texture->maxLevel = 0;
+    m_hasMipmap = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::unload()
+{
+    if (m_texture)
+    {
+        if (m_ownsData)
+            C3D_TexDelete(m_texture);
+        delete m_texture;
+        m_texture = nullptr;
+    }
+
+    m_ownsData  = true;
+    m_hasMipmap = false;
+    m_cacheId   = getUniqueId();
+}
+
+
 ////////////////////////////////////////////////////////////
 unsigned int Texture::getValidSize(unsigned int size)
 {
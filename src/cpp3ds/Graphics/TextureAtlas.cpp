@@ -0,0 +1,267 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextureAtlas.hpp>
+#include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/Graphics/Sprite.hpp>
+#include <cpp3ds/System/FileInputStream.hpp>
+#include <cpp3ds/System/MemoryInputStream.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+#include "AtlasPacker.hpp"
+
+
+namespace
+{
+    // Layout of atlas files (see scripts/atlas_pack.py): the header, a page
+    // table, a region table, the region names one after the other, then the
+    // pages' texture data in the native layout
+    struct AtlasHeader
+    {
+        char           magic[4]; // "ATLS"
+        cpp3ds::Uint16 pageCount;
+        cpp3ds::Uint16 regionCount;
+        cpp3ds::Uint32 namesLength;
+    };
+
+    struct AtlasPage
+    {
+        cpp3ds::Uint16 format;
+        cpp3ds::Uint16 width;
+        cpp3ds::Uint16 height;
+        cpp3ds::Uint16 reserved;
+        cpp3ds::Uint32 offset;
+        cpp3ds::Uint32 length;
+    };
+
+    struct AtlasRegion
+    {
+        cpp3ds::Uint16 page;
+        cpp3ds::Uint16 left;
+        cpp3ds::Uint16 top;
+        cpp3ds::Uint16 width;
+        cpp3ds::Uint16 height;
+        cpp3ds::Uint16 nameLength;
+    };
+
+    const unsigned int MaxPageSize = 1024;
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas()
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::loadFromFile(const std::string& filename)
+{
+    FileInputStream stream;
+    if (!stream.open(filename))
+    {
+        err() << "Failed to load texture atlas \"" << filename << "\"" << std::endl;
+        return false;
+    }
+
+    return loadFromStream(stream);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::loadFromMemory(const void* data, std::size_t size)
+{
+    MemoryInputStream stream;
+    stream.open(data, size);
+
+    return loadFromStream(stream);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::loadFromStream(InputStream& stream)
+{
+    cleanup();
+
+    AtlasHeader header;
+    if ((stream.seek(0) != 0) || (stream.read(&header, sizeof(header)) != sizeof(header)) ||
+        (std::memcmp(header.magic, "ATLS", 4) != 0))
+    {
+        err() << "Failed to load texture atlas, invalid header" << std::endl;
+        return false;
+    }
+
+    std::vector<AtlasPage> pages(header.pageCount);
+    std::vector<AtlasRegion> regions(header.regionCount);
+    std::vector<char> names(header.namesLength);
+    Int64 pagesLength   = pages.size() * sizeof(AtlasPage);
+    Int64 regionsLength = regions.size() * sizeof(AtlasRegion);
+    if ((pagesLength && (stream.read(&pages[0], pagesLength) != pagesLength)) ||
+        (regionsLength && (stream.read(&regions[0], regionsLength) != regionsLength)) ||
+        (!names.empty() && (stream.read(&names[0], names.size()) != static_cast<Int64>(names.size()))))
+    {
+        err() << "Failed to load texture atlas, truncated tables" << std::endl;
+        return false;
+    }
+
+    std::vector<Uint8> data;
+    for (std::vector<AtlasPage>::const_iterator page = pages.begin(); page != pages.end(); ++page)
+    {
+        data.resize(page->length);
+        if (!page->length || (stream.seek(page->offset) != page->offset) ||
+            (stream.read(&data[0], page->length) != page->length))
+        {
+            err() << "Failed to load texture atlas, truncated page data" << std::endl;
+            cleanup();
+            return false;
+        }
+
+        std::unique_ptr<Texture> texture(new Texture());
+        if (!texture->loadFromPreprocessedMemory(&data[0], data.size(), page->width, page->height,
+                                                 static_cast<GPU_TEXCOLOR>(page->format), true))
+        {
+            cleanup();
+            return false;
+        }
+        m_pages.push_back(std::move(texture));
+    }
+
+    m_regions.reserve(regions.size());
+    std::size_t nameOffset = 0;
+    for (std::vector<AtlasRegion>::const_iterator region = regions.begin(); region != regions.end(); ++region)
+    {
+        if ((region->page >= m_pages.size()) || (nameOffset + region->nameLength > names.size()))
+        {
+            err() << "Failed to load texture atlas, invalid region table" << std::endl;
+            cleanup();
+            return false;
+        }
+
+        Region& entry = m_regions[std::string(&names[nameOffset], region->nameLength)];
+        entry.texture = m_pages[region->page].get();
+        entry.rect    = IntRect(region->left, region->top, region->width, region->height);
+        nameOffset += region->nameLength;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::loadFromImages(const std::map<std::string, Image>& images, GPU_TEXCOLOR format, unsigned int padding)
+{
+    cleanup();
+
+    std::vector<Vector2u> sizes;
+    sizes.reserve(images.size());
+    for (std::map<std::string, Image>::const_iterator it = images.begin(); it != images.end(); ++it)
+        sizes.push_back(it->second.getSize());
+
+    unsigned int maxSize = std::min(Texture::getMaximumSize(), MaxPageSize);
+    std::vector<priv::AtlasPlacement> placements;
+    std::vector<Vector2u> pageSizes = priv::packAtlas(sizes, maxSize, padding, placements);
+    if (pageSizes.empty() && !images.empty())
+    {
+        err() << "Failed to pack texture atlas, an image is larger than " << maxSize << "x" << maxSize << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0; i < pageSizes.size(); ++i)
+    {
+        std::unique_ptr<Texture> texture(new Texture());
+        if (!texture->create(pageSizes[i].x, pageSizes[i].y, format))
+        {
+            cleanup();
+            return false;
+        }
+
+        // Clear the padding, new textures hold whatever was in memory
+        std::vector<Uint8> clear(pageSizes[i].x * pageSizes[i].y * 4, 0);
+        texture->update(&clear[0]);
+        m_pages.push_back(std::move(texture));
+    }
+
+    m_regions.reserve(images.size());
+    std::size_t i = 0;
+    for (std::map<std::string, Image>::const_iterator it = images.begin(); it != images.end(); ++it, ++i)
+    {
+        const priv::AtlasPlacement& placement = placements[i];
+        Texture& page = *m_pages[placement.page];
+        if (placement.rect.width && placement.rect.height)
+            page.update(it->second, placement.rect.left, placement.rect.top);
+
+        Region& entry = m_regions[it->first];
+        entry.texture = &page;
+        entry.rect    = placement.rect;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+const TextureAtlas::Region* TextureAtlas::findRegion(const std::string& name) const
+{
+    RegionTable::const_iterator it = m_regions.find(name);
+    if (it == m_regions.end())
+        return NULL;
+
+    return &it->second;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::applyTo(Sprite& sprite, const std::string& name) const
+{
+    const Region* region = findRegion(name);
+    if (!region)
+        return false;
+
+    sprite.setTexture(*region->texture);
+    sprite.setTextureRect(region->rect);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::getRegionCount() const
+{
+    return m_regions.size();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::getPageCount() const
+{
+    return m_pages.size();
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& TextureAtlas::getPage(unsigned int index) const
+{
+    return *m_pages[index];
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::setSmooth(bool smooth)
+{
+    for (std::vector<std::unique_ptr<Texture>>::iterator page = m_pages.begin(); page != m_pages.end(); ++page)
+        (*page)->setSmooth(smooth);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::cleanup()
+{
+    m_regions.clear();
+    m_pages.clear();
+}
+
+} // namespace cpp3ds
@@ -0,0 +1,402 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "TextureCodec.hpp"
+#include <algorithm>
+
+
+namespace
+{
+    using cpp3ds::Uint8;
+    using cpp3ds::Uint32;
+    using cpp3ds::Uint64;
+
+    // Same interleave as the one used to tile textures (see Texture.cpp)
+    inline Uint32 mortonInterleave(Uint32 x, Uint32 y)
+    {
+        Uint32 i = (x & 7) | ((y & 7) << 8);
+        i = (i ^ (i << 2)) & 0x1313;
+        i = (i ^ (i << 1)) & 0x1515;
+        i = (i | (i >> 7)) & 0x3F;
+        return i;
+    }
+
+    // Texel index of (x, y) within a tiled texture
+    inline Uint32 getTiledIndex(Uint32 x, Uint32 y, Uint32 width)
+    {
+        return mortonInterleave(x, y) + (x & ~7) * 8 + (y & ~7) * width;
+    }
+
+    inline Uint8 expand4(Uint32 v) { return static_cast<Uint8>((v << 4) | v); }
+    inline Uint8 expand5(Uint32 v) { return static_cast<Uint8>((v << 3) | (v >> 2)); }
+    inline Uint8 expand6(Uint32 v) { return static_cast<Uint8>((v << 2) | (v >> 4)); }
+
+    inline Uint8 clampColor(int v)
+    {
+        return static_cast<Uint8>(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+
+    inline Uint64 readUint64(const Uint8* data)
+    {
+        Uint64 v = 0;
+        for (int i = 7; i >= 0; --i)
+            v = (v << 8) | data[i];
+        return v;
+    }
+
+    inline void setPixel(Uint8* pixel, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+    {
+        pixel[0] = r;
+        pixel[1] = g;
+        pixel[2] = b;
+        pixel[3] = a;
+    }
+
+    void decodeTexel(const Uint8* source, Uint32 index, GPU_TEXCOLOR format, Uint8* pixel)
+    {
+        const Uint8* p;
+        Uint32 v;
+        switch (format)
+        {
+            case GPU_RGBA8:
+                p = source + index * 4;
+                setPixel(pixel, p[3], p[2], p[1], p[0]);
+                break;
+            case GPU_RGB8:
+                p = source + index * 3;
+                setPixel(pixel, p[2], p[1], p[0], 255);
+                break;
+            case GPU_RGBA5551:
+                p = source + index * 2;
+                v = p[0] | (p[1] << 8);
+                setPixel(pixel, expand5((v >> 11) & 0x1F), expand5((v >> 6) & 0x1F), expand5((v >> 1) & 0x1F), (v & 1) ? 255 : 0);
+                break;
+            case GPU_RGB565:
+                p = source + index * 2;
+                v = p[0] | (p[1] << 8);
+                setPixel(pixel, expand5((v >> 11) & 0x1F), expand6((v >> 5) & 0x3F), expand5(v & 0x1F), 255);
+                break;
+            case GPU_RGBA4:
+                p = source + index * 2;
+                v = p[0] | (p[1] << 8);
+                setPixel(pixel, expand4((v >> 12) & 0xF), expand4((v >> 8) & 0xF), expand4((v >> 4) & 0xF), expand4(v & 0xF));
+                break;
+            case GPU_LA8:
+                p = source + index * 2;
+                setPixel(pixel, p[1], p[1], p[1], p[0]);
+                break;
+            case GPU_HILO8:
+                p = source + index * 2;
+                setPixel(pixel, p[1], p[0], 0, 255);
+                break;
+            case GPU_L8:
+                v = source[index];
+                setPixel(pixel, v, v, v, 255);
+                break;
+            case GPU_A8:
+                setPixel(pixel, 255, 255, 255, source[index]);
+                break;
+            case GPU_LA4:
+                v = source[index];
+                setPixel(pixel, expand4(v >> 4), expand4(v >> 4), expand4(v >> 4), expand4(v & 0xF));
+                break;
+            case GPU_L4:
+                v = (source[index / 2] >> ((index & 1) * 4)) & 0xF;
+                setPixel(pixel, expand4(v), expand4(v), expand4(v), 255);
+                break;
+            case GPU_A4:
+                v = (source[index / 2] >> ((index & 1) * 4)) & 0xF;
+                setPixel(pixel, 255, 255, 255, expand4(v));
+                break;
+            default:
+                setPixel(pixel, 0, 0, 0, 0);
+                break;
+        }
+    }
+
+    inline Uint8 getLuma(const Uint8* pixel)
+    {
+        return static_cast<Uint8>((pixel[0] * 77 + pixel[1] * 150 + pixel[2] * 29) >> 8);
+    }
+
+    inline void writeUint16(Uint8* data, Uint32 v)
+    {
+        data[0] = v & 0xFF;
+        data[1] = (v >> 8) & 0xFF;
+    }
+
+    inline void writeNibble(Uint8* data, Uint32 index, Uint32 v)
+    {
+        Uint8& byte = data[index / 2];
+        if (index & 1)
+            byte = (byte & 0x0F) | ((v & 0xF) << 4);
+        else
+            byte = (byte & 0xF0) | (v & 0xF);
+    }
+
+    void encodeTexel(Uint8* dest, Uint32 index, GPU_TEXCOLOR format, const Uint8* pixel)
+    {
+        Uint8* p;
+        switch (format)
+        {
+            case GPU_RGBA8:
+                p = dest + index * 4;
+                p[0] = pixel[3];
+                p[1] = pixel[2];
+                p[2] = pixel[1];
+                p[3] = pixel[0];
+                break;
+            case GPU_RGB8:
+                p = dest + index * 3;
+                p[0] = pixel[2];
+                p[1] = pixel[1];
+                p[2] = pixel[0];
+                break;
+            case GPU_RGBA5551:
+                writeUint16(dest + index * 2, ((pixel[0] >> 3) << 11) | ((pixel[1] >> 3) << 6) | ((pixel[2] >> 3) << 1) | (pixel[3] >> 7));
+                break;
+            case GPU_RGB565:
+                writeUint16(dest + index * 2, ((pixel[0] >> 3) << 11) | ((pixel[1] >> 2) << 5) | (pixel[2] >> 3));
+                break;
+            case GPU_RGBA4:
+                writeUint16(dest + index * 2, ((pixel[0] >> 4) << 12) | ((pixel[1] >> 4) << 8) | ((pixel[2] >> 4) << 4) | (pixel[3] >> 4));
+                break;
+            case GPU_LA8:
+                p = dest + index * 2;
+                p[0] = pixel[3];
+                p[1] = getLuma(pixel);
+                break;
+            case GPU_HILO8:
+                p = dest + index * 2;
+                p[0] = pixel[1];
+                p[1] = pixel[0];
+                break;
+            case GPU_L8:
+                dest[index] = getLuma(pixel);
+                break;
+            case GPU_A8:
+                dest[index] = pixel[3];
+                break;
+            case GPU_LA4:
+                dest[index] = (getLuma(pixel) & 0xF0) | (pixel[3] >> 4);
+                break;
+            case GPU_L4:
+                writeNibble(dest, index, getLuma(pixel) >> 4);
+                break;
+            case GPU_A4:
+                writeNibble(dest, index, pixel[3] >> 4);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Per-channel floor((a + b) / 2) of packed RGBA pixels
+    inline Uint32 averageFloor(Uint32 a, Uint32 b)
+    {
+#ifdef _3DS
+        Uint32 result;
+        __asm__("uhadd8 %0, %1, %2" : "=r"(result) : "r"(a), "r"(b));
+        return result;
+#else
+        return (a & b) + (((a ^ b) & 0xFEFEFEFE) >> 1);
+#endif
+    }
+
+    // Per-channel ceil((a + b) / 2) of packed RGBA pixels
+    inline Uint32 averageCeil(Uint32 a, Uint32 b)
+    {
+        return (a | b) - (((a ^ b) & 0xFEFEFEFE) >> 1);
+    }
+
+    // Decodes a 4x4 ETC1 block into 16 RGBA pixels (row-major).
+    // Blocks are stored little-endian, alpha nibbles are column-major.
+    void decodeEtc1Block(Uint64 block, Uint64 alpha, bool hasAlpha, Uint8* pixels)
+    {
+        static const int modifiers[8][2] = {
+            {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+        };
+
+        bool flip = (block >> 32) & 1;
+        bool differential = (block >> 33) & 1;
+        int tables[2] = {static_cast<int>((block >> 37) & 7), static_cast<int>((block >> 34) & 7)};
+        int base[2][3];
+
+        for (int c = 0; c < 3; ++c)
+        {
+            if (differential)
+            {
+                int shift = 59 - 8 * c;
+                int value = (block >> shift) & 0x1F;
+                int delta = (block >> (shift - 3)) & 0x7;
+                if (delta >= 4)
+                    delta -= 8;
+                base[0][c] = expand5(value);
+                base[1][c] = expand5((value + delta) & 0x1F);
+            }
+            else
+            {
+                base[0][c] = expand4((block >> (60 - 8 * c)) & 0xF);
+                base[1][c] = expand4((block >> (56 - 8 * c)) & 0xF);
+            }
+        }
+
+        for (int y = 0; y < 4; ++y)
+            for (int x = 0; x < 4; ++x)
+            {
+                int texel = x * 4 + y;
+                int sub = flip ? (y >= 2) : (x >= 2);
+                int modifier = modifiers[tables[sub]][(block >> texel) & 1];
+                if ((block >> (16 + texel)) & 1)
+                    modifier = -modifier;
+
+                Uint8 a = hasAlpha ? expand4((alpha >> (4 * texel)) & 0xF) : 255;
+                setPixel(pixels + (y * 4 + x) * 4,
+                         clampColor(base[sub][0] + modifier),
+                         clampColor(base[sub][1] + modifier),
+                         clampColor(base[sub][2] + modifier),
+                         a);
+            }
+    }
+
+    void decodeEtc1(const Uint8* source, Uint8* dest, unsigned int width, unsigned int height, bool hasAlpha)
+    {
+        Uint8 pixels[16 * 4];
+
+        // 8x8 tiles hold four 4x4 blocks in Z order
+        for (unsigned int ty = 0; ty < height; ty += 8)
+            for (unsigned int tx = 0; tx < width; tx += 8)
+                for (unsigned int sub = 0; sub < 4; ++sub)
+                {
+                    unsigned int bx = tx + (sub & 1) * 4;
+                    unsigned int by = ty + (sub >> 1) * 4;
+
+                    Uint64 alpha = 0;
+                    if (hasAlpha)
+                    {
+                        alpha = readUint64(source);
+                        source += 8;
+                    }
+                    decodeEtc1Block(readUint64(source), alpha, hasAlpha, pixels);
+                    source += 8;
+
+                    for (unsigned int y = 0; y < 4; ++y)
+                    {
+                        Uint8* row = dest + ((height - 1 - (by + y)) * width + bx) * 4;
+                        for (unsigned int i = 0; i < 16; ++i)
+                            row[i] = pixels[y * 16 + i];
+                    }
+                }
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+std::size_t getTextureFormatBits(GPU_TEXCOLOR format)
+{
+    switch (format)
+    {
+        case GPU_RGBA8:
+            return 32;
+        case GPU_RGB8:
+            return 24;
+        case GPU_RGBA5551:
+        case GPU_RGB565:
+        case GPU_RGBA4:
+        case GPU_LA8:
+        case GPU_HILO8:
+            return 16;
+        case GPU_L8:
+        case GPU_A8:
+        case GPU_LA4:
+        case GPU_ETC1A4:
+            return 8;
+        case GPU_L4:
+        case GPU_A4:
+        case GPU_ETC1:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool decodeTexture(const Uint8* source, Uint8* dest, unsigned int width, unsigned int height, GPU_TEXCOLOR format)
+{
+    if (!source || !dest || (width % 8) || (height % 8) || !getTextureFormatBits(format))
+        return false;
+
+    if (format == GPU_ETC1 || format == GPU_ETC1A4)
+    {
+        decodeEtc1(source, dest, width, height, format == GPU_ETC1A4);
+        return true;
+    }
+
+    // Texture rows are stored bottom-up, so flip while decoding
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        Uint8* row = dest + (height - 1 - y) * width * 4;
+        for (unsigned int x = 0; x < width; ++x)
+            decodeTexel(source, getTiledIndex(x, y, width), format, row + x * 4);
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool encodeTexture(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y,
+                   Uint8* dest, unsigned int destWidth, unsigned int destHeight, GPU_TEXCOLOR format)
+{
+    if (!pixels || !dest || (destWidth % 8) || (destHeight % 8) || !getTextureFormatBits(format))
+        return false;
+    if (format == GPU_ETC1 || format == GPU_ETC1A4)
+        return false;
+    if ((x + width > destWidth) || (y + height > destHeight))
+        return false;
+
+    for (unsigned int j = 0; j < height; ++j)
+    {
+        // Texture rows are stored bottom-up
+        unsigned int row = destHeight - 1 - (y + j);
+        for (unsigned int i = 0; i < width; ++i)
+            encodeTexel(dest, getTiledIndex(x + i, row, destWidth), format, pixels + (i + j * width) * 4);
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void downsampleBox(const Uint8* source, unsigned int width, unsigned int height, Uint8* dest)
+{
+    const Uint32* src = reinterpret_cast<const Uint32*>(source);
+    Uint32* dst = reinterpret_cast<Uint32*>(dest);
+    unsigned int destWidth = width > 1 ? width / 2 : 1;
+    unsigned int destHeight = height > 1 ? height / 2 : 1;
+
+    for (unsigned int y = 0; y < destHeight; ++y)
+    {
+        const Uint32* row0 = src + (y * 2) * width;
+        const Uint32* row1 = src + std::min(y * 2 + 1, height - 1) * width;
+
+        for (unsigned int x = 0; x < destWidth; ++x)
+        {
+            unsigned int x0 = x * 2;
+            unsigned int x1 = std::min(x0 + 1, width - 1);
+
+            // Rounding down then up keeps the result unbiased
+            dst[x] = averageCeil(averageFloor(row0[x0], row0[x1]), averageFloor(row1[x0], row1[x1]));
+        }
+        dst += destWidth;
+    }
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
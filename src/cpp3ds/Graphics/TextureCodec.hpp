@@ -0,0 +1,95 @@
+#ifndef CPP3DS_TEXTURECODEC_HPP
+#define CPP3DS_TEXTURECODEC_HPP
+
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cstddef>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Header of preprocessed texture files (see scripts/tex_compile.py)
+///
+////////////////////////////////////////////////////////////
+struct TextureHeader
+{
+    Uint16 format;         ///< Format matching ctrulib enum GPU_TEXCOLOR
+    Uint16 width;          ///< Width (original width to next power of 2)
+    Uint16 height;         ///< Height (original height to next power of 2)
+    Uint16 widthOriginal;  ///< Width of original input
+    Uint16 heightOriginal; ///< Height of original input
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Get the number of bits used by one texel of \a format
+///
+/// \return Bits per texel, or 0 if the format is unknown
+///
+////////////////////////////////////////////////////////////
+std::size_t getTextureFormatBits(GPU_TEXCOLOR format);
+
+////////////////////////////////////////////////////////////
+/// \brief Decode texture data in the native 3DS layout
+///
+/// \a source is tiled (8x8 morton tiles, bottom row first) as the
+/// GPU expects it. \a dest receives width * height top-down RGBA
+/// pixels. Alpha-only formats decode to white so that vertex colors
+/// modulate them the same way they do on hardware.
+///
+/// \param source Tiled texture data
+/// \param dest   Destination RGBA pixels
+/// \param width  Width of the texture (multiple of 8)
+/// \param height Height of the texture (multiple of 8)
+/// \param format Format of \a source
+///
+/// \return False if the format or size isn't supported
+///
+////////////////////////////////////////////////////////////
+bool decodeTexture(const Uint8* source, Uint8* dest, unsigned int width, unsigned int height, GPU_TEXCOLOR format);
+
+////////////////////////////////////////////////////////////
+/// \brief Convert RGBA pixels to \a format and tile them into texture data
+///
+/// This is the reverse of decodeTexture, for a sub-rectangle of
+/// the texture. Luminance formats use the luma of the pixels.
+/// Compressed formats aren't supported.
+///
+/// \param pixels     Top-down RGBA pixels to convert
+/// \param width      Width of the pixel rectangle
+/// \param height     Height of the pixel rectangle
+/// \param x          X offset in the texture (from the left)
+/// \param y          Y offset in the texture (from the top)
+/// \param dest       Tiled texture data to write to
+/// \param destWidth  Width of the texture (multiple of 8)
+/// \param destHeight Height of the texture (multiple of 8)
+/// \param format     Format of \a dest
+///
+/// \return False if the format or size isn't supported
+///
+////////////////////////////////////////////////////////////
+bool encodeTexture(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y,
+                   Uint8* dest, unsigned int destWidth, unsigned int destHeight, GPU_TEXCOLOR format);
+
+////////////////////////////////////////////////////////////
+/// \brief Halve RGBA pixels with a 2x2 box filter
+///
+/// Used to build mipmap levels. Averaging works on whole
+/// pixels at once (four channels packed in 32 bits).
+///
+/// \param source Top-down RGBA pixels (width * height)
+/// \param width  Width of \a source
+/// \param height Height of \a source
+/// \param dest   Receives max(1, width / 2) * max(1, height / 2) pixels
+///
+////////////////////////////////////////////////////////////
+void downsampleBox(const Uint8* source, unsigned int width, unsigned int height, Uint8* dest);
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTURECODEC_HPP
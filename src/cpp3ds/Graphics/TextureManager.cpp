@@ -0,0 +1,273 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextureManager.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <limits>
+#include "TextureCodec.hpp"
+
+
+namespace
+{
+    // Memory held by a texture's native storage
+    std::size_t getTextureBytes(const cpp3ds::Vector2u& size, GPU_TEXCOLOR format, bool mipmap)
+    {
+        std::size_t bytes = size.x * size.y * cpp3ds::priv::getTextureFormatBits(format) / 8;
+
+        // The chain below level 0 adds up to a third more
+        if (mipmap)
+            bytes += bytes / 3;
+
+        return bytes;
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+TextureManager& TextureManager::getInstance()
+{
+    static TextureManager manager;
+    return manager;
+}
+
+
+////////////////////////////////////////////////////////////
+TextureManager::TextureManager() :
+m_budget       (std::numeric_limits<std::size_t>::max()),
+m_residentBytes(0),
+m_useCounter   (0),
+m_frameStart   (0),
+m_hits         (0),
+m_misses       (0),
+m_evictions    (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+TextureManager::~TextureManager()
+{
+    // Static textures may be destroyed after the manager
+    for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        it->second.texture->m_isManaged = false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureManager::addFromFile(Texture& texture, const std::string& filename, int priority)
+{
+    bool preprocessed = (filename.size() > 4) && (filename.compare(filename.size() - 4, 4, ".tex") == 0);
+
+    if (preprocessed)
+        return add(texture, [filename](Texture& t) { return t.loadFromPreprocessedFile(filename); }, priority);
+    else
+        return add(texture, [filename](Texture& t) { return t.loadFromFile(filename); }, priority);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureManager::addFromMemory(Texture& texture, const void* data, std::size_t size, int priority)
+{
+    return add(texture, [data, size](Texture& t) { return t.loadFromMemory(data, size); }, priority);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureManager::add(Texture& texture, const Loader& loader, int priority)
+{
+    remove(texture);
+
+    Entry entry;
+    entry.texture  = &texture;
+    entry.loader   = loader;
+    entry.priority = priority;
+    entry.bytes    = 0;
+    entry.lastUse  = 0;
+    entry.resident = false;
+    entry.mipmap   = false;
+
+    Entry& added = m_entries.insert(std::make_pair(&texture, entry)).first->second;
+    texture.m_isManaged = true;
+
+    if (!load(added))
+    {
+        remove(texture);
+        return false;
+    }
+
+    makeRoom(0, &texture);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureManager::remove(Texture& texture)
+{
+    EntryMap::iterator it = m_entries.find(&texture);
+    if (it == m_entries.end())
+        return;
+
+    if (it->second.resident)
+        m_residentBytes -= it->second.bytes;
+
+    m_entries.erase(it);
+    texture.m_isManaged = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureManager::setBudget(std::size_t bytes)
+{
+    m_budget = bytes;
+    makeRoom(0, NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureManager::getBudget() const
+{
+    return m_budget;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureManager::isResident(const Texture& texture) const
+{
+    EntryMap::const_iterator it = m_entries.find(&texture);
+    return (it != m_entries.end()) && it->second.resident;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureManager::endFrame()
+{
+    m_frameStart = m_useCounter;
+
+    // Textures kept over budget by the last frame can go now
+    makeRoom(0, NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+TextureManager::Stats TextureManager::getStats() const
+{
+    Stats stats;
+    stats.hits          = m_hits;
+    stats.misses        = m_misses;
+    stats.evictions     = m_evictions;
+    stats.residentBytes = m_residentBytes;
+    stats.residentCount = 0;
+    stats.textureCount  = m_entries.size();
+
+    for (EntryMap::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        if (it->second.resident)
+            ++stats.residentCount;
+
+    return stats;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureManager::resetStats()
+{
+    m_hits      = 0;
+    m_misses    = 0;
+    m_evictions = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureManager::use(const Texture& texture)
+{
+    EntryMap::iterator it = m_entries.find(&texture);
+    if (it == m_entries.end())
+        return;
+
+    Entry& entry = it->second;
+    entry.lastUse = ++m_useCounter;
+
+    if (entry.resident)
+    {
+        ++m_hits;
+        return;
+    }
+
+    ++m_misses;
+    makeRoom(entry.bytes, &texture);
+    load(entry);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureManager::addMipmap(const Texture& texture)
+{
+    EntryMap::iterator it = m_entries.find(&texture);
+    if (it == m_entries.end())
+        return;
+
+    Entry& entry = it->second;
+    entry.mipmap = true;
+
+    // Called while reloading, load() accounts for the memory
+    if (!entry.resident)
+        return;
+
+    m_residentBytes -= entry.bytes;
+    entry.bytes = getTextureBytes(texture.m_actualSize, texture.m_format, texture.m_hasMipmap);
+    m_residentBytes += entry.bytes;
+
+    makeRoom(0, &texture);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureManager::load(Entry& entry)
+{
+    if (!entry.loader(*entry.texture))
+        return false;
+
+    // The loader only brings back level 0
+    Texture& texture = *entry.texture;
+    if (entry.mipmap)
+        texture.generateMipmap();
+    entry.bytes = getTextureBytes(texture.m_actualSize, texture.m_format, texture.m_hasMipmap);
+    entry.resident = true;
+    m_residentBytes += entry.bytes;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureManager::makeRoom(std::size_t bytes, const Texture* keep)
+{
+    while (m_residentBytes + bytes > m_budget)
+    {
+        // Least recently bound texture of the lowest priority,
+        // skipping those the current frame still needs
+        Entry* victim = NULL;
+        for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            Entry& entry = it->second;
+            if (!entry.resident || (entry.texture == keep) || (entry.lastUse > m_frameStart))
+                continue;
+
+            if (!victim || (entry.priority < victim->priority) ||
+                ((entry.priority == victim->priority) && (entry.lastUse < victim->lastUse)))
+                victim = &entry;
+        }
+
+        if (!victim)
+            return;
+
+        victim->texture->unload();
+        victim->resident = false;
+        m_residentBytes -= victim->bytes;
+        ++m_evictions;
+    }
+}
+
+} // namespace cpp3ds
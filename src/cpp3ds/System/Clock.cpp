@@ -37,7 +37,8 @@ namespace priv {
 
 	static Time getCurrentTime()
 	{
-		return seconds(static_cast<float>(svcGetSystemTick())/TICKS_PER_SEC);
+		// In integer microseconds, a float loses them after a few minutes of uptime
+		return microseconds(static_cast<Int64>(svcGetSystemTick() * 1000 / (TICKS_PER_SEC / 1000)));
 	}
 }
 
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/System/Semaphore.hpp>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+Semaphore::Semaphore(unsigned int count)
+{
+    svcCreateSemaphore(&m_semaphore, static_cast<s32>(count), 0x7FFFFFFF);
+}
+
+
+////////////////////////////////////////////////////////////
+Semaphore::~Semaphore()
+{
+    svcCloseHandle(m_semaphore);
+}
+
+
+////////////////////////////////////////////////////////////
+void Semaphore::wait()
+{
+    svcWaitSynchronization(m_semaphore, U64_MAX);
+}
+
+
+////////////////////////////////////////////////////////////
+void Semaphore::post()
+{
+    s32 count;
+    svcReleaseSemaphore(&count, m_semaphore, 1);
+}
+
+} // namespace cpp3ds
@@ -72,6 +72,9 @@ void Game::render()
 {
 	Console& console = Console::getInstance();
 
+	// Glyphs loaded in the background are written before anything is drawn
+	Font::commitPendingGlyphs();
+
 	if (!console.isEnabledBasic() || console.getScreen() != TopScreen) {
 		C3D_RenderTarget* target = windowTop.getCitroTarget();
 		C3D_RenderBufBind(&target->renderBuf);
@@ -101,6 +104,8 @@ void Game::render()
 	gfxSwapBuffersGpu();
 	gspWaitForVBlank();
 
+	TextureManager::getInstance().endFrame();
+
 	// This currently is only use to properly use frameTimeLimit
 	windowTop.display();
 }
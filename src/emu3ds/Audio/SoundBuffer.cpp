@@ -50,15 +50,15 @@ m_duration()
 ////////////////////////////////////////////////////////////
 SoundBuffer::SoundBuffer(const SoundBuffer& copy) :
 m_buffer  (0),
-m_samples (copy.m_samples),
 m_duration(copy.m_duration),
 m_sounds  () // don't copy the attached sounds
 {
     // Create the buffer
     alCheck(alGenBuffers(1, &m_buffer));
 
-    // Update the internal buffer with the new samples
-    update(copy.getChannelCount(), copy.getSampleRate());
+    // Update the internal buffer with the shared samples
+    if (copy.m_storage)
+        update(copy.m_storage);
 }
 
 
@@ -84,11 +84,20 @@ SoundBuffer::~SoundBuffer()
 ////////////////////////////////////////////////////////////
 bool SoundBuffer::loadFromFile(const std::string& filename)
 {
+    // Buffers loaded from the same file share their samples
+    if (StoragePtr storage = findCachedFile(filename))
+        return update(storage);
+
     InputSoundFile file;
-    if (file.openFromFile(filename))
-        return initialize(file);
+    if (file.openFromFile(filename) && initialize(file))
+    {
+        cacheFile(filename, m_storage);
+        return true;
+    }
     else
+    {
         return false;
+    }
 }
 
 
@@ -120,10 +129,13 @@ bool SoundBuffer::loadFromSamples(const Int16* samples, Uint64 sampleCount, unsi
     if (samples && sampleCount && channelCount && sampleRate)
     {
         // Copy the new audio samples
-        m_samples.assign(samples, samples + sampleCount);
+        std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+        storage->samples.assign(samples, samples + sampleCount);
+        storage->channelCount = channelCount;
+        storage->sampleRate   = sampleRate;
 
         // Update the internal buffer with the new samples
-        return update(channelCount, sampleRate);
+        return update(storage);
     }
     else
     {
@@ -140,6 +152,37 @@ bool SoundBuffer::loadFromSamples(const Int16* samples, Uint64 sampleCount, unsi
 }
 
 
+////////////////////////////////////////////////////////////
+bool SoundBuffer::loadFromSamples(const Int16* samples, Uint64 sampleCount, unsigned int channelCount, unsigned int sampleRate,
+                                  unsigned int outputRate, Resampler::Quality quality)
+{
+    if (!samples || !sampleCount || !channelCount || !sampleRate || !outputRate || (outputRate == sampleRate))
+        return loadFromSamples(samples, sampleCount, channelCount, outputRate ? outputRate : sampleRate);
+
+    std::vector<Int16> resampled;
+    Resampler::resample(samples, sampleCount, channelCount, sampleRate, outputRate, resampled, quality);
+
+    return loadFromSamples(resampled.empty() ? NULL : &resampled[0], resampled.size(), channelCount, outputRate);
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundBuffer::resample(unsigned int sampleRate, Resampler::Quality quality)
+{
+    if (!getSamples())
+    {
+        err() << "Failed to resample sound buffer (no samples, DSP-ADPCM buffers can't be decoded back)" << std::endl;
+        return false;
+    }
+
+    if (sampleRate == getSampleRate())
+        return true;
+
+    // The samples are converted before the storage holding them is replaced
+    return loadFromSamples(getSamples(), getSampleCount(), getChannelCount(), getSampleRate(), sampleRate, quality);
+}
+
+
 ////////////////////////////////////////////////////////////
 bool SoundBuffer::saveToFile(const std::string& filename) const
 {
@@ -148,7 +191,7 @@ bool SoundBuffer::saveToFile(const std::string& filename) const
     if (file.openFromFile(filename, getSampleRate(), getChannelCount()))
     {
         // Write the samples to the opened file
-        file.write(&m_samples[0], m_samples.size());
+        file.write(getSamples(), getSampleCount());
 
         return true;
     }
@@ -162,14 +205,14 @@ bool SoundBuffer::saveToFile(const std::string& filename) const
 ////////////////////////////////////////////////////////////
 const Int16* SoundBuffer::getSamples() const
 {
-    return m_samples.empty() ? NULL : &m_samples[0];
+    return (!m_storage || m_storage->samples.empty()) ? NULL : &m_storage->samples[0];
 }
 
 
 ////////////////////////////////////////////////////////////
 Uint64 SoundBuffer::getSampleCount() const
 {
-    return m_samples.size();
+    return m_storage ? m_storage->samples.size() : 0;
 }
 
 
@@ -205,7 +248,7 @@ SoundBuffer& SoundBuffer::operator =(const SoundBuffer& right)
 {
     SoundBuffer temp(right);
 
-    std::swap(m_samples,  temp.m_samples);
+    std::swap(m_storage,  temp.m_storage);
     std::swap(m_buffer,   temp.m_buffer);
     std::swap(m_duration, temp.m_duration);
     std::swap(m_sounds,   temp.m_sounds); // swap sounds too, so that they are detached when temp is destroyed
@@ -218,16 +261,17 @@ SoundBuffer& SoundBuffer::operator =(const SoundBuffer& right)
 bool SoundBuffer::initialize(InputSoundFile& file)
 {
     // Retrieve the sound parameters
-    Uint64       sampleCount  = file.getSampleCount();
-    unsigned int channelCount = file.getChannelCount();
-    unsigned int sampleRate   = file.getSampleRate();
-	std::cout <<"sampleCount:"<<sampleCount<<" chanCount:"<<channelCount<<" rate:"<<sampleRate<<std::endl;
+    Uint64 sampleCount = file.getSampleCount();
+    std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+    storage->channelCount = file.getChannelCount();
+    storage->sampleRate   = file.getSampleRate();
+	std::cout <<"sampleCount:"<<sampleCount<<" chanCount:"<<storage->channelCount<<" rate:"<<storage->sampleRate<<std::endl;
     // Read the samples from the provided file
-    m_samples.resize(static_cast<std::size_t>(sampleCount));
-    if (file.read(&m_samples[0], sampleCount) == sampleCount)
+    storage->samples.resize(static_cast<std::size_t>(sampleCount));
+    if (file.read(&storage->samples[0], sampleCount) == sampleCount)
     {
         // Update the internal buffer with the new samples
-        return update(channelCount, sampleRate);
+        return update(storage);
     }
     else
     {
@@ -237,10 +281,12 @@ bool SoundBuffer::initialize(InputSoundFile& file)
 
 
 ////////////////////////////////////////////////////////////
-bool SoundBuffer::update(unsigned int channelCount, unsigned int sampleRate)
+bool SoundBuffer::update(const StoragePtr& storage)
 {
     // Check parameters
-    if (!channelCount || !sampleRate || m_samples.empty())
+    unsigned int channelCount = storage->channelCount;
+    unsigned int sampleRate   = storage->sampleRate;
+    if (!channelCount || !sampleRate || storage->samples.empty())
         return false;
 
     // Find the good format according to the number of channels
@@ -261,11 +307,12 @@ bool SoundBuffer::update(unsigned int channelCount, unsigned int sampleRate)
         (*it)->resetBuffer();
 
     // Fill the buffer
-    ALsizei size = static_cast<ALsizei>(m_samples.size()) * sizeof(Int16);
-    alCheck(alBufferData(m_buffer, format, &m_samples[0], size, sampleRate));
+    m_storage = storage;
+    ALsizei size = static_cast<ALsizei>(storage->samples.size()) * sizeof(Int16);
+    alCheck(alBufferData(m_buffer, format, &storage->samples[0], size, sampleRate));
 
     // Compute the duration
-    m_duration = seconds(static_cast<float>(m_samples.size()) / sampleRate / channelCount);
+    m_duration = seconds(static_cast<float>(storage->samples.size()) / sampleRate / channelCount);
 
     // Now reattach the buffer to the sounds that use it
     for (SoundList::const_iterator it = sounds.begin(); it != sounds.end(); ++it)
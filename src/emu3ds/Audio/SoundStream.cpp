@@ -26,6 +26,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Audio/SoundStream.hpp>
+#include <cpp3ds/Audio/AudioBus.hpp>
 #include "AudioDevice.hpp"
 #include "ALCheck.hpp"
 #include <cpp3ds/System/Sleep.hpp>
@@ -49,7 +50,13 @@ m_channelCount    (0),
 m_sampleRate      (0),
 m_format          (0),
 m_loop            (false),
-m_samplesProcessed(0)
+m_samplesProcessed(0),
+m_outputSampleRate(0),
+m_resamplerQuality(Resampler::Medium),
+m_resampler       (),
+m_processed       (),
+m_bus             (NULL),
+m_preparedBus     (NULL)
 {
 
 }
@@ -87,6 +94,9 @@ void SoundStream::initialize(unsigned int channelCount, unsigned int sampleRate)
         m_sampleRate   = 0;
         err() << "Unsupported number of channels (" << m_channelCount << ")" << std::endl;
     }
+
+    // Design the filters for the new rate now rather than when playing
+    m_resampler.setRates(m_sampleRate, getPlaybackRate(), m_channelCount, m_resamplerQuality);
 }
 
 
@@ -187,6 +197,36 @@ unsigned int SoundStream::getSampleRate() const
 }
 
 
+////////////////////////////////////////////////////////////
+void SoundStream::setOutputSampleRate(unsigned int sampleRate, Resampler::Quality quality)
+{
+    m_outputSampleRate = sampleRate;
+    m_resamplerQuality = quality;
+    m_resampler.setRates(m_sampleRate, getPlaybackRate(), m_channelCount, m_resamplerQuality);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SoundStream::getOutputSampleRate() const
+{
+    return m_outputSampleRate;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundStream::setBus(AudioBus* bus)
+{
+    m_bus.store(bus);
+}
+
+
+////////////////////////////////////////////////////////////
+AudioBus* SoundStream::getBus() const
+{
+    return m_bus.load();
+}
+
+
 ////////////////////////////////////////////////////////////
 SoundStream::Status SoundStream::getStatus() const
 {
@@ -218,7 +258,7 @@ void SoundStream::setPlayingOffset(Time timeOffset)
     onSeek(timeOffset);
 
     // Restart streaming
-    m_samplesProcessed = static_cast<Uint64>(timeOffset.asSeconds() * m_sampleRate * m_channelCount);
+    m_samplesProcessed = static_cast<Uint64>(timeOffset.asSeconds() * getPlaybackRate() * m_channelCount);
 
     if (oldStatus == Stopped)
         return;
@@ -237,7 +277,7 @@ Time SoundStream::getPlayingOffset() const
         ALfloat secs = 0.f;
         alCheck(alGetSourcef(m_source, AL_SEC_OFFSET, &secs));
 
-        return seconds(secs + static_cast<float>(m_samplesProcessed) / m_sampleRate / m_channelCount);
+        return seconds(secs + static_cast<float>(m_samplesProcessed) / getPlaybackRate() / m_channelCount);
     }
     else
     {
@@ -276,10 +316,17 @@ void SoundStream::streamData()
         }
     }
 
+    // Forget the samples of the previous position
+    m_resampler.reset();
+    m_preparedBus = NULL;
+
     // Create the buffers
     alCheck(alGenBuffers(BufferCount, m_buffers));
     for (int i = 0; i < BufferCount; ++i)
-        m_endBuffers[i] = false;
+    {
+        m_endBuffers[i]   = false;
+        m_emptyBuffers[i] = false;
+    }
 
     // Fill the queue
     requestStop = fillQueue();
@@ -377,6 +424,13 @@ void SoundStream::streamData()
             }
         }
 
+        // Try again the buffers the source had no data for
+        for (int i = 0; (i < BufferCount) && !requestStop; ++i)
+        {
+            if (m_emptyBuffers[i] && fillAndPushBuffer(i))
+                requestStop = true;
+        }
+
         // Leave some time for the other threads if the stream is still playing
         if (SoundSource::getStatus() != Stopped)
             sleep(milliseconds(10));
@@ -425,14 +479,46 @@ bool SoundStream::fillAndPushBuffer(unsigned int bufferNum)
         }
     }
 
-    // Fill the buffer if some data was returned
+    // Convert the samples to the output rate, and the ones still in the filters at the end
+    AudioBus* bus = m_bus.load();
+    if (getPlaybackRate() != m_sampleRate)
+    {
+        m_processed.clear();
+        if (data.samples && data.sampleCount)
+            m_resampler.process(data.samples, data.sampleCount, m_processed);
+        if (requestStop)
+            m_resampler.flush(m_processed);
+
+        data.samples     = m_processed.empty() ? NULL : &m_processed[0];
+        data.sampleCount = m_processed.size();
+    }
+    else if (bus && data.samples && data.sampleCount)
+    {
+        // The source's samples are read-only, the bus works on a copy
+        m_processed.assign(data.samples, data.samples + data.sampleCount);
+        data.samples = &m_processed[0];
+    }
+
+    // Apply the effects
+    if (bus && data.samples && data.sampleCount)
+    {
+        if (bus != m_preparedBus)
+        {
+            bus->prepare(getPlaybackRate(), m_channelCount);
+            m_preparedBus = bus;
+        }
+        bus->process(&m_processed[0], data.sampleCount);
+    }
+
+    // Fill the buffer if some data was returned, else leave it out of the queue for now
+    m_emptyBuffers[bufferNum] = !requestStop && (!data.samples || (data.sampleCount == 0));
     if (data.samples && data.sampleCount)
     {
         unsigned int buffer = m_buffers[bufferNum];
 
         // Fill the buffer
         ALsizei size = static_cast<ALsizei>(data.sampleCount) * sizeof(Int16);
-        alCheck(alBufferData(buffer, m_format, data.samples, size, m_sampleRate));
+        alCheck(alBufferData(buffer, m_format, data.samples, size, getPlaybackRate()));
 
         // Push it into the sound queue
         alCheck(alSourceQueueBuffers(m_source, 1, &buffer));
@@ -470,4 +556,11 @@ void SoundStream::clearQueue()
         alCheck(alSourceUnqueueBuffers(m_source, 1, &buffer));
 }
 
+
+////////////////////////////////////////////////////////////
+unsigned int SoundStream::getPlaybackRate() const
+{
+    return m_outputSampleRate ? m_outputSampleRate : m_sampleRate;
+}
+
 } // namespace cpp3ds
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <SFML/Graphics.hpp>
 #include <cpp3ds/Emulator/Emulator.hpp>
+#include <cpp3ds/Graphics/RenderTarget.hpp>
 
 namespace cpp3ds {
 
@@ -185,6 +186,10 @@ namespace cpp3ds {
 		this->adjustSize();
 	}
 
+	void Emulator::on_actionOverdraw_triggered(bool checked) {
+		RenderTarget::setOverdrawVisible(checked);
+	}
+
 	void Emulator::on_actionPlay_Pause_triggered(bool checked) {
 		actionStop->setEnabled(true);
 		if (checked){
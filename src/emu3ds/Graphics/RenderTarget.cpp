@@ -32,6 +32,8 @@
 #include <cpp3ds/Graphics/VertexArray.hpp>
 #include <cpp3ds/OpenGL.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <cstring>
+#include "../../cpp3ds/Graphics/DepthSort.hpp"
 
 
 namespace
@@ -66,6 +68,11 @@ namespace
             case cpp3ds::BlendMode::Subtract:        return GL_FUNC_SUBTRACT;
         }
     }
+
+
+    // Show overdraw instead of colors, see RenderTarget::setOverdrawVisible
+    bool overdrawVisible = false;
+    const cpp3ds::Color overdrawColor(1, 24, 12);
 }
 
 
@@ -73,9 +80,12 @@ namespace cpp3ds
 {
 ////////////////////////////////////////////////////////////
 RenderTarget::RenderTarget() :
-m_defaultView(),
-m_view       (),
-m_cache      ()
+m_defaultView (),
+m_view        (),
+m_cache       (),
+m_depthSorting(false),
+m_depth       (0.f),
+m_depthDraws  (NULL)
 {
 	m_cache.vertexCache = new Vertex[StatesCache::VertexCacheSize];
 	m_cache.glStatesSet = false;
@@ -86,6 +96,7 @@ m_cache      ()
 RenderTarget::~RenderTarget()
 {
 	delete[] m_cache.vertexCache;
+	delete m_depthDraws;
 }
 
 
@@ -103,7 +114,13 @@ void RenderTarget::clear(const Color& color)
             // Use glClearColorIiEXT to avoid unnecessary float conversion
             glCheck(glClearColorIiEXT(color.r, color.g, color.b, color.a));
         #endif
-        glCheck(glClear(GL_COLOR_BUFFER_BIT));
+        // Overdraw is counted from black
+        if (overdrawVisible)
+        {
+            glCheck(glClearColor(0.f, 0.f, 0.f, 1.f));
+        }
+
+        glCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
     }
 }
 
@@ -203,6 +220,80 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
     if (!vertices || (vertexCount == 0))
         return;
 
+    if (m_depthSorting)
+    {
+        priv::DepthDraw draw = {vertices, vertexCount, type, states, 0.f};
+        m_depthDraws->push_back(draw);
+        return;
+    }
+
+    submit(vertices, vertexCount, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::beginDepthSorting()
+{
+    if (!m_depthDraws)
+        m_depthDraws = new std::vector<priv::DepthDraw>;
+
+    m_depthSorting = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::endDepthSorting()
+{
+    if (!m_depthSorting)
+        return;
+
+    m_depthSorting = false;
+    std::size_t opaqueCount = priv::sortDepthDraws(*m_depthDraws);
+
+    if (!m_depthDraws->empty() && activate(true))
+    {
+        if (!m_cache.glStatesSet)
+            resetGLStates();
+
+        applyDepthTest(true, true);
+        for (std::size_t i = 0; i < m_depthDraws->size(); ++i)
+        {
+            // Translucent draws must not hide what is drawn behind them after
+            if (i == opaqueCount)
+                applyDepthTest(true, false);
+
+            const priv::DepthDraw& draw = (*m_depthDraws)[i];
+            m_depth = draw.depth;
+            submit(draw.vertices, draw.vertexCount, draw.type, draw.states);
+        }
+        m_depth = 0.f;
+        applyDepthTest(false, true);
+    }
+
+    m_depthDraws->clear();
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isDepthSorting() const
+{
+    return m_depthSorting;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::submit(const Vertex* vertices, unsigned int vertexCount,
+                          PrimitiveType type, const RenderStates& drawStates)
+{
+    // Every fragment adds the same untextured color when showing overdraw
+    RenderStates states(drawStates);
+    if (overdrawVisible)
+    {
+        states.blendMode = BlendAdd;
+        states.texture   = NULL;
+        states.shader    = NULL;
+    }
+
 	// Vertices allocated in the stack (common) can't be converted to physical address
 	#ifndef EMULATION
 	if (osConvertVirtToPhys(vertices) == 0)
@@ -221,7 +312,8 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
             resetGLStates();
 
         // Check if the vertex count is low enough so that we can pre-transform them
-        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
+        // Pre-transformed vertices would lose the depth of the transform
+        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize) && (m_depth == 0.f);
         if (useVertexCache)
         {
             // Pre-transform the vertices and store them into the vertex cache
@@ -263,6 +355,10 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         if (states.shader)
             applyShader(states.shader);
 
+        // Turn a distance field texture into coverage
+        if (states.distanceFieldThreshold > 0.f)
+            applyDistanceField(states.distanceFieldThreshold, states.distanceFieldPixelsPerUnit);
+
         // If we pre-transform the vertices, we must use our internal vertex cache
         if (useVertexCache)
         {
@@ -287,12 +383,26 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         GLenum mode = modes[type];
 
         // Draw the primitives
-        glCheck(glDrawArrays(mode, 0, vertexCount));
+        if (overdrawVisible)
+        {
+            glCheck(glDisableClientState(GL_COLOR_ARRAY));
+            glCheck(glColor4ub(overdrawColor.r, overdrawColor.g, overdrawColor.b, 255));
+            glCheck(glDrawArrays(mode, 0, vertexCount));
+            glCheck(glEnableClientState(GL_COLOR_ARRAY));
+        }
+        else
+        {
+            glCheck(glDrawArrays(mode, 0, vertexCount));
+        }
 
         // Unbind the shader, if any
         if (states.shader)
             applyShader(NULL);
 
+        // Restore the combiners of ordinary textures
+        if (states.distanceFieldThreshold > 0.f)
+            applyDistanceField(0.f, 0.f);
+
         // Update the cache
         m_cache.useVertexCache = useVertexCache;
     }
@@ -460,7 +570,47 @@ void RenderTarget::applyTransform(const Transform& transform)
 {
     // No need to call glMatrixMode(GL_MODELVIEW), it is always the
     // current mode (for optimization purpose, since it's the most used)
-    glCheck(glLoadMatrixf(transform.getMatrix()));
+    if (m_depth == 0.f)
+    {
+        glCheck(glLoadMatrixf(transform.getMatrix()));
+    }
+    else
+    {
+        float matrix[16];
+        std::memcpy(matrix, transform.getMatrix(), sizeof(matrix));
+        matrix[14] = m_depth;
+        glCheck(glLoadMatrixf(matrix));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::applyDepthTest(bool test, bool write)
+{
+    if (test)
+    {
+        glCheck(glEnable(GL_DEPTH_TEST));
+        glCheck(glDepthFunc(GL_LESS));
+    }
+    else
+    {
+        glCheck(glDisable(GL_DEPTH_TEST));
+    }
+    glCheck(glDepthMask(write ? GL_TRUE : GL_FALSE));
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setOverdrawVisible(bool visible)
+{
+    overdrawVisible = visible;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isOverdrawVisible()
+{
+    return overdrawVisible;
 }
 
 
@@ -479,6 +629,56 @@ void RenderTarget::applyShader(const Shader* shader)
     Shader::bind(shader);
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderTarget::applyDistanceField(float threshold, float pixelsPerUnit)
+{
+    if (threshold <= 0.f)
+    {
+        if (GLEXT_multitexture)
+        {
+            glCheck(GLEXT_glActiveTexture(GLEXT_GL_TEXTURE0 + 1));
+            glCheck(glDisable(GL_TEXTURE_2D));
+            glCheck(GLEXT_glActiveTexture(GLEXT_GL_TEXTURE0));
+        }
+        glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE));
+        glCheck(glTexEnvf(GL_TEXTURE_ENV, GL_ALPHA_SCALE, 1.f));
+        return;
+    }
+
+    // First unit: (field - threshold) * sharpness + 0.5 with ADD_SIGNED, which
+    // has no room left for the vertex alpha. GL only scales by 1, 2 or 4.
+    float sharpness = (pixelsPerUnit >= 4.f) ? 4.f : (pixelsPerUnit >= 2.f) ? 2.f : 1.f;
+    GLfloat constant[4] = {0.f, 0.f, 0.f, 0.5f - threshold + 0.5f / sharpness};
+    glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE));
+    glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE));
+    glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PRIMARY_COLOR));
+    glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_ADD_SIGNED));
+    glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE));
+    glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_CONSTANT));
+    glCheck(glTexEnvf(GL_TEXTURE_ENV, GL_ALPHA_SCALE, sharpness));
+    glCheck(glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, constant));
+
+    // Second unit: the coverage modulated by the vertex alpha, like the last
+    // combiner stage on the console. A unit only combines with a texture
+    // bound, so it gets the same one, whose texels it doesn't use.
+    if (GLEXT_multitexture)
+    {
+        GLint texture = 0;
+        glCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture));
+        glCheck(GLEXT_glActiveTexture(GLEXT_GL_TEXTURE0 + 1));
+        glCheck(glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture)));
+        glCheck(glEnable(GL_TEXTURE_2D));
+        glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE));
+        glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE));
+        glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PREVIOUS));
+        glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE));
+        glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_PREVIOUS));
+        glCheck(glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR));
+        glCheck(GLEXT_glActiveTexture(GLEXT_GL_TEXTURE0));
+    }
+}
+
 } // namespace cpp3ds
 
 
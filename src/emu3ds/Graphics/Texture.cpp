@@ -28,14 +28,19 @@
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/Image.hpp>
 #include <cpp3ds/Graphics/TextureSaver.hpp>
+#include <cpp3ds/Graphics/TextureManager.hpp>
 #include <cpp3ds/OpenGL/GLExtensions.hpp>
 #include <cpp3ds/Window/Window.hpp>
 #include <cpp3ds/System/Mutex.hpp>
 #include <cpp3ds/System/Lock.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <cpp3ds/System/FileInputStream.hpp>
 #include <cpp3ds/OpenGL.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <vector>
+#include "../../cpp3ds/Graphics/TextureCodec.hpp"
 #ifndef EMULATION
 #include <3ds.h>
 #endif
@@ -68,6 +73,27 @@ namespace
 
 		return static_cast<unsigned int>(size);
 	}
+
+	// Closest GL internal format for each 3DS texture format, so
+	// that the emulator loses the same precision the hardware does
+	GLint getInternalFormat(GPU_TEXCOLOR format)
+	{
+		switch (format)
+		{
+			case GPU_RGB8:     return GL_RGB8;
+			case GPU_RGBA5551: return GL_RGB5_A1;
+			case GPU_RGB565:   return GL_RGB5;
+			case GPU_RGBA4:    return GL_RGBA4;
+			case GPU_LA8:      return GL_LUMINANCE8_ALPHA8;
+			case GPU_HILO8:    return GL_RGB8;
+			case GPU_L8:       return GL_LUMINANCE8;
+			case GPU_A8:       return GL_ALPHA8;
+			case GPU_LA4:      return GL_LUMINANCE4_ALPHA4;
+			case GPU_L4:       return GL_LUMINANCE4;
+			case GPU_A4:       return GL_ALPHA4;
+			default:           return GL_RGBA;
+		}
+	}
 }
 
 
@@ -81,7 +107,10 @@ m_texture      (0),
 m_isSmooth     (false),
 m_isRepeated   (false),
 m_pixelsFlipped(false),
-m_cacheId      (getUniqueId())
+m_cacheId      (getUniqueId()),
+m_format       (GPU_RGBA8),
+m_hasMipmap    (false),
+m_isManaged    (false)
 {
 
 }
@@ -95,29 +124,29 @@ m_texture      (0),
 m_isSmooth     (copy.m_isSmooth),
 m_isRepeated   (copy.m_isRepeated),
 m_pixelsFlipped(false),
-m_cacheId      (getUniqueId())
+m_cacheId      (getUniqueId()),
+m_format       (GPU_RGBA8),
+m_hasMipmap    (false),
+m_isManaged    (false)
 {
-    if (copy.m_texture)
-        loadFromImage(copy.copyToImage());
+    if (copy.m_texture && create(copy.m_size.x, copy.m_size.y, copy.m_format))
+        update(copy.copyToImage());
 }
 
 
 ////////////////////////////////////////////////////////////
 Texture::~Texture()
 {
-    // Destroy the OpenGL texture
-    if (m_texture)
-    {
-		ensureGlContext();
+    if (m_isManaged)
+        TextureManager::getInstance().remove(*this);
 
-        GLuint texture = static_cast<GLuint>(m_texture);
-        glCheck(glDeleteTextures(1, &texture));
-    }
+    // Destroy the OpenGL texture
+    unload();
 }
 
 
 ////////////////////////////////////////////////////////////
-bool Texture::create(unsigned int width, unsigned int height)
+bool Texture::create(unsigned int width, unsigned int height, GPU_TEXCOLOR format)
 {
     // Check if texture parameters are valid before creating it
     if ((width == 0) || (height == 0))
@@ -125,6 +154,11 @@ bool Texture::create(unsigned int width, unsigned int height)
         err() << "Failed to create texture, invalid size (" << width << "x" << height << ")" << std::endl;
         return false;
     }
+    if (!priv::getTextureFormatBits(format) || (format == GPU_ETC1) || (format == GPU_ETC1A4))
+    {
+        err() << "Failed to create texture, unsupported format (" << format << ")" << std::endl;
+        return false;
+    }
 
     // Compute the internal texture dimensions depending on NPOT textures support
     Vector2u actualSize(getValidSize(width), getValidSize(height));
@@ -145,6 +179,8 @@ bool Texture::create(unsigned int width, unsigned int height)
     m_size.y        = height;
     m_actualSize    = actualSize;
     m_pixelsFlipped = false;
+    m_format        = format;
+    m_hasMipmap     = false;
 
 	ensureGlContext();
 
@@ -161,7 +197,7 @@ bool Texture::create(unsigned int width, unsigned int height)
 
     // Initialize the texture
 	glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-	glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_actualSize.x, m_actualSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+	glCheck(glTexImage2D(GL_TEXTURE_2D, 0, getInternalFormat(m_format), m_actualSize.x, m_actualSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
 	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
 	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
 	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
@@ -261,6 +297,92 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::loadFromPreprocessedFile(const std::string& filename)
+{
+    if (filename.empty())
+        return false;
+
+    priv::TextureHeader header;
+    FileInputStream file;
+    if (!file.open(filename))
+        return false;
+
+    file.read(&header, sizeof(header));
+    size_t size = file.getSize() - sizeof(header);
+
+    // Verify header
+    GPU_TEXCOLOR format = static_cast<GPU_TEXCOLOR>(header.format);
+    if (size != header.width * header.height * priv::getTextureFormatBits(format) / 8)
+    {
+        err() << "Improper file header: " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<Uint8> data(size);
+    file.read(&data[0], size);
+
+    bool ret = loadFromPreprocessedMemory(&data[0], size, header.width, header.height, format, true);
+    m_size.x = header.widthOriginal;
+    m_size.y = header.heightOriginal;
+
+    return ret;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromPreprocessedFile(const std::string& filename, size_t width, size_t height, GPU_TEXCOLOR format)
+{
+    if (filename.empty())
+        return false;
+
+    FileInputStream file;
+    if (!file.open(filename))
+        return false;
+
+    size_t size = file.getSize();
+    std::vector<Uint8> data(size);
+    file.read(&data[0], size);
+
+    return loadFromPreprocessedMemory(&data[0], size, width, height, format, true);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromPreprocessedMemory(void *data, size_t size, size_t width, size_t height, GPU_TEXCOLOR format, bool copyData)
+{
+    if (!data)
+        return false;
+
+    // No native texture formats here, so the data is always decoded
+    // to RGBA and copyData has no effect
+    if (size < width * height * priv::getTextureFormatBits(format) / 8)
+    {
+        err() << "Failed to load preprocessed texture, not enough data" << std::endl;
+        return false;
+    }
+
+    std::vector<Uint8> pixels(width * height * 4);
+    if (!priv::decodeTexture(static_cast<const Uint8*>(data), &pixels[0], width, height, format))
+    {
+        err() << "Failed to decode preprocessed texture (format " << format << ", "
+              << width << "x" << height << ")" << std::endl;
+        return false;
+    }
+
+    if (!create(width, height))
+        return false;
+
+    update(&pixels[0]);
+
+    // Force an OpenGL flush, so that the texture will appear updated
+    // in all contexts immediately (solves problems in multi-threaded apps)
+    glCheck(glFlush());
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2u Texture::getSize() const
 {
@@ -336,6 +458,11 @@ Image Texture::copyToImage() const
 		}
 	}
 #endif
+    // GL reads alpha-only textures back as black, match decodeTexture instead
+    if (m_format == GPU_A8 || m_format == GPU_A4)
+        for (std::size_t i = 0; i < pixels.size(); i += 4)
+            pixels[i] = pixels[i + 1] = pixels[i + 2] = 255;
+
     // Create the image
     Image image;
     image.create(m_size.x, m_size.y, &pixels[0]);
@@ -368,6 +495,7 @@ void Texture::update(const Uint8* pixels, unsigned int width, unsigned int heigh
         // Copy pixels from the given array to the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
         glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+        invalidateMipmap();
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
     }
@@ -410,6 +538,7 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
         // Copy pixels from the back-buffer to the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
         glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, window.getSize().x, window.getSize().y));
+        invalidateMipmap();
         m_pixelsFlipped = true;
         m_cacheId = getUniqueId();
     }
@@ -432,7 +561,15 @@ void Texture::setSmooth(bool smooth)
 
             glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
             glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
-            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+
+            if (m_hasMipmap)
+            {
+                glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST));
+            }
+            else
+            {
+                glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+            }
         }
     }
 }
@@ -474,11 +611,72 @@ bool Texture::isRepeated() const
 }
 
 
+////////////////////////////////////////////////////////////
+GPU_TEXCOLOR Texture::getFormat() const
+{
+    return m_format;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmap()
+{
+    if (!m_texture)
+        return false;
+
+    // Same levels as citro3d allocates on hardware: down to 8x8
+    unsigned int width = m_actualSize.x;
+    unsigned int height = m_actualSize.y;
+    if (std::min(width, height) <= 8)
+        return true;
+
+    ensureGlContext();
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    std::vector<Uint8> pixels(width * height * 4);
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+
+    // Filter on the CPU like the 3DS does rather than with glGenerateMipmap,
+    // so both produce the same levels
+    std::vector<Uint8> next((width / 2) * (height / 2) * 4);
+    int level = 0;
+    while (std::min(width, height) > 8)
+    {
+        priv::downsampleBox(&pixels[0], width, height, &next[0]);
+        width /= 2;
+        height /= 2;
+        ++level;
+
+        glCheck(glTexImage2D(GL_TEXTURE_2D, level, getInternalFormat(m_format), width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &next[0]));
+        pixels.swap(next);
+    }
+
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST));
+
+    m_hasMipmap = true;
+    m_cacheId = getUniqueId();
+
+    // Managed textures get their mipmap back when reloaded
+    if (m_isManaged)
+        TextureManager::getInstance().addMipmap(*this);
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::bind(const Texture* texture, CoordinateType coordinateType)
 {
 	ensureGlContext();
 
+    // Evicted textures are reloaded here
+    if (texture && texture->m_isManaged)
+        TextureManager::getInstance().use(*texture);
+
     if (texture && texture->m_texture)
     {
         // Bind the texture
@@ -553,12 +751,49 @@ Texture& Texture::operator =(const Texture& right)
     std::swap(m_isSmooth,      temp.m_isSmooth);
     std::swap(m_isRepeated,    temp.m_isRepeated);
     std::swap(m_pixelsFlipped, temp.m_pixelsFlipped);
+    std::swap(m_format,        temp.m_format);
+    std::swap(m_hasMipmap,     temp.m_hasMipmap);
     m_cacheId = getUniqueId();
 
     return *this;
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::invalidateMipmap()
+{
+    if (!m_hasMipmap)
+        return;
+
+    ensureGlContext();
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+
+    m_hasMipmap = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::unload()
+{
+    if (m_texture)
+    {
+        ensureGlContext();
+
+        GLuint texture = static_cast<GLuint>(m_texture);
+        glCheck(glDeleteTextures(1, &texture));
+        m_texture = 0;
+    }
+
+    m_hasMipmap = false;
+    m_cacheId   = getUniqueId();
+}
+
+
 ////////////////////////////////////////////////////////////
 unsigned int Texture::getValidSize(unsigned int size)
 {
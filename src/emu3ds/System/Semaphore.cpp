@@ -0,0 +1,46 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/System/Semaphore.hpp>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+Semaphore::Semaphore(unsigned int count) :
+m_count(count)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_condition, NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+Semaphore::~Semaphore()
+{
+    pthread_cond_destroy(&m_condition);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+
+////////////////////////////////////////////////////////////
+void Semaphore::wait()
+{
+    pthread_mutex_lock(&m_mutex);
+    while (m_count == 0)
+        pthread_cond_wait(&m_condition, &m_mutex);
+    --m_count;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+
+////////////////////////////////////////////////////////////
+void Semaphore::post()
+{
+    pthread_mutex_lock(&m_mutex);
+    ++m_count;
+    pthread_mutex_unlock(&m_mutex);
+    pthread_cond_signal(&m_condition);
+}
+
+} // namespace cpp3ds
@@ -4,21 +4,49 @@
 #include <cpp3ds/Window/EventManager.hpp>
 #include <cpp3ds/System/Clock.hpp>
 #include <cpp3ds/Window/Keyboard.hpp>
+#include <cpp3ds/Graphics/Font.hpp>
 #include <cpp3ds/Graphics/Sprite.hpp>
+#include <cpp3ds/Graphics/TextureManager.hpp>
 #include "../Audio/AudioDevice.hpp"
+#include <iostream>
+#include <vector>
+
+namespace {
+
+	// Frames between two reports of the overdraw
+	const unsigned int OverdrawReportInterval = 60;
+
+	// Fragments drawn in the active target, each one having added 1 to
+	// the red channel while showing overdraw
+	cpp3ds::Uint64 countFragments(unsigned int width, unsigned int height)
+	{
+		std::vector<cpp3ds::Uint8> pixels(width * height);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, &pixels[0]);
+
+		cpp3ds::Uint64 count = 0;
+		for (std::size_t i = 0; i < pixels.size(); ++i)
+			count += pixels[i];
+		return count;
+	}
+
+}
 
 namespace cpp3ds {
 
 Game::Game(size_t gpuCommandBufSize)
 : m_triggerExit(false)
+, m_overdrawFragments(0)
+, m_overdrawFrames(0)
 {
 	priv::ensureExtensionsInit();
 
 	windowTop.create(ContextSettings(TopScreen));
 	windowBottom.create(ContextSettings(BottomScreen));
 
-	m_frameTextureTop.create(400, 240);
-	m_frameTextureBottom.create(320, 240);
+	// With a depth buffer for RenderTarget::beginDepthSorting
+	m_frameTextureTop.create(400, 240, true);
+	m_frameTextureBottom.create(320, 240, true);
 
 	m_frameSpriteTop.setPosition(0, 0);
 	m_frameSpriteBottom.setPosition(40, 240);
@@ -39,12 +67,17 @@ void Game::exit()
 
 void Game::render()
 {
+	// Glyphs loaded in the background are written before anything is drawn
+	Font::commitPendingGlyphs();
+
 #ifndef TEST
 	_emulator->screen->clear();
 
 	// Top Screen
 	m_frameTextureTop.setActive(true);
 	renderTopScreen(windowTop);
+	if (RenderTarget::isOverdrawVisible())
+		m_overdrawFragments += countFragments(400, 240);
 	m_frameTextureTop.display();
 	m_frameSpriteTop.setTexture(m_frameTextureTop.getTexture());
 	_emulator->screen->draw(m_frameSpriteTop);
@@ -52,10 +85,22 @@ void Game::render()
 	// Bottom Screen
 	m_frameTextureBottom.setActive(true);
 	renderBottomScreen(windowBottom);
+	if (RenderTarget::isOverdrawVisible())
+		m_overdrawFragments += countFragments(320, 240);
 	m_frameTextureBottom.display();
 	m_frameSpriteBottom.setTexture(m_frameTextureBottom.getTexture());
 	_emulator->screen->draw(m_frameSpriteBottom);
+
+	if (RenderTarget::isOverdrawVisible() && ++m_overdrawFrames == OverdrawReportInterval) {
+		float fragments = static_cast<float>(m_overdrawFragments) / m_overdrawFrames;
+		std::cout << "Overdraw: " << static_cast<Uint64>(fragments) << " fragments per frame, "
+		          << fragments / (400 * 240 + 320 * 240) << " per pixel" << std::endl;
+		m_overdrawFragments = 0;
+		m_overdrawFrames = 0;
+	}
 #endif
+
+	TextureManager::getInstance().endFrame();
 }
 
 
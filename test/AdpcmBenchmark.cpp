@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Audio/InputSoundFile.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include "../src/cpp3ds/Audio/AdpcmCodec.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace {
+
+	void writeUint16(std::vector<Uint8>& file, Uint16 value) {
+		file.push_back(value & 0xFF);
+		file.push_back(value >> 8);
+	}
+
+	void writeUint32(std::vector<Uint8>& file, Uint32 value) {
+		writeUint16(file, value & 0xFFFF);
+		writeUint16(file, value >> 16);
+	}
+
+	// Frames with random samples, scales and predictors, around a smooth predictor
+	std::vector<Uint8> makeFile(unsigned int channelCount, Uint32 sampleCount, priv::AdpcmChannel* channels) {
+		std::srand(42);
+		std::vector<Uint8> file(4);
+		std::memcpy(&file[0], "DSPA", 4);
+		writeUint16(file, channelCount);
+		writeUint16(file, 0);
+		writeUint32(file, 22050);
+		writeUint32(file, sampleCount);
+
+		for (unsigned int i = 0; i < channelCount; ++i) {
+			priv::AdpcmChannel& channel = channels[i];
+			for (int j = 0; j < 8; ++j) {
+				channel.coefficients[j * 2] = static_cast<Int16>(2048 + j * 200);
+				channel.coefficients[j * 2 + 1] = static_cast<Int16>(-j * 180);
+			}
+			channel.predictorScale = 0;
+			channel.history1 = 100;
+			channel.history2 = -100;
+			for (int j = 0; j < 16; ++j)
+				writeUint16(file, channel.coefficients[j]);
+			writeUint16(file, channel.predictorScale);
+			writeUint16(file, channel.history1);
+			writeUint16(file, channel.history2);
+			writeUint16(file, 0);
+		}
+
+		std::size_t frameCount = priv::getAdpcmSize(sampleCount, channelCount) / priv::AdpcmFrameSize;
+		for (std::size_t i = 0; i < frameCount; ++i) {
+			file.push_back(static_cast<Uint8>(((std::rand() % 8) << 4) | (std::rand() % 10)));
+			for (int j = 1; j < priv::AdpcmFrameSize; ++j)
+				file.push_back(static_cast<Uint8>(std::rand()));
+		}
+		return file;
+	}
+
+}
+
+TEST(Adpcm, DecodesFrame){
+	// Predictor 1 adds the last sample, scale 2^1 doubles the nibbles
+	priv::AdpcmChannel channel = {};
+	channel.coefficients[2] = 2048;
+	const Uint8 frame[priv::AdpcmFrameSize] = {0x11, 0x12, 0x34, 0x56, 0x7F, 0xED, 0xCB, 0xA9};
+	const int nibbles[priv::AdpcmFrameSamples] = {1, 2, 3, 4, 5, 6, 7, -1, -2, -3, -4, -5, -6, -7};
+
+	Int16 samples[priv::AdpcmFrameSamples];
+	priv::decodeAdpcm(frame, priv::AdpcmFrameSamples, 1, &channel, samples);
+
+	int expected = 0;
+	for (int i = 0; i < priv::AdpcmFrameSamples; ++i) {
+		expected += nibbles[i] * 2;
+		EXPECT_EQ(expected, samples[i]);
+	}
+	EXPECT_EQ(samples[13], channel.history1);
+	EXPECT_EQ(samples[12], channel.history2);
+}
+
+TEST(Adpcm, ReadsAndSeeks){
+	for (unsigned int channelCount = 1; channelCount <= 2; ++channelCount) {
+		const Uint32 sampleCount = 1000;
+		priv::AdpcmChannel channels[2];
+		std::vector<Uint8> file = makeFile(channelCount, sampleCount, channels);
+
+		std::vector<Int16> expected(sampleCount * channelCount);
+		priv::decodeAdpcm(&file[file.size() - priv::getAdpcmSize(sampleCount, channelCount)], sampleCount, channelCount, channels, &expected[0]);
+
+		InputSoundFile sound;
+		ASSERT_TRUE(sound.openFromMemory(&file[0], file.size()));
+		EXPECT_EQ(expected.size(), sound.getSampleCount());
+		EXPECT_EQ(channelCount, sound.getChannelCount());
+		EXPECT_EQ(22050u, sound.getSampleRate());
+
+		// Reads of any size, across frames
+		std::vector<Int16> samples(expected.size());
+		Uint64 count = 0;
+		for (Uint64 size = 1; count < samples.size(); size = size * 3 + 1)
+			count += sound.read(&samples[count], std::min<Uint64>(size, samples.size() - count));
+		EXPECT_EQ(expected, samples);
+		EXPECT_EQ(0u, sound.read(&samples[0], 1));
+
+		// Seeks into the middle of a frame
+		Uint64 offset = 517 * channelCount;
+		sound.seek(offset);
+		ASSERT_EQ(samples.size() - offset, sound.read(&samples[0], samples.size()));
+		EXPECT_TRUE(std::equal(expected.begin() + offset, expected.end(), samples.begin()));
+	}
+}
+
+TEST(Adpcm, HistoryStartsAnyFrame){
+	const Uint32 sampleCount = 22050 * 10 + 5;
+	priv::AdpcmChannel channels[2];
+	std::vector<Uint8> file = makeFile(1, sampleCount, channels);
+	const Uint8* data = &file[file.size() - priv::getAdpcmSize(sampleCount, 1)];
+
+	std::vector<Int16> expected(sampleCount);
+	priv::AdpcmChannel channel = channels[0];
+	priv::decodeAdpcm(data, sampleCount, 1, &channel, &expected[0]);
+
+	Clock clock;
+	std::vector<Int16> history;
+	priv::getAdpcmHistory(data, sampleCount, channels[0], history);
+	float milliseconds = clock.getElapsedTime().asSeconds() * 1000.f;
+	std::size_t frameCount = priv::getAdpcmSize(sampleCount, 1) / priv::AdpcmFrameSize;
+	ASSERT_EQ(frameCount * 2, history.size());
+
+	// Decoding from any frame with its history gives the samples decoded from the start
+	Int16 samples[priv::AdpcmFrameSamples];
+	for (std::size_t frame = 0; frame < frameCount; frame += 97) {
+		channel = channels[0];
+		channel.history1 = history[frame * 2];
+		channel.history2 = history[frame * 2 + 1];
+		Uint32 count = std::min<Uint32>(priv::AdpcmFrameSamples, sampleCount - frame * priv::AdpcmFrameSamples);
+		priv::decodeAdpcm(data + frame * priv::AdpcmFrameSize, count, 1, &channel, samples);
+		EXPECT_TRUE(std::equal(samples, samples + count, expected.begin() + frame * priv::AdpcmFrameSamples)) << "frame " << frame;
+	}
+
+	std::cout << "[ BENCH    ] History of " << frameCount << " frames found in " << milliseconds << " ms, "
+	          << history.size() * sizeof(Int16) / 1024 << " KB" << std::endl;
+}
+
+TEST(Adpcm, Decode){
+	const Uint32 sampleCount = 22050 * 10;
+	priv::AdpcmChannel channels[2];
+	std::vector<Uint8> file = makeFile(1, sampleCount, channels);
+	const Uint8* data = &file[file.size() - priv::getAdpcmSize(sampleCount, 1)];
+	std::vector<Int16> samples(sampleCount);
+
+	Clock clock;
+	priv::decodeAdpcm(data, sampleCount, 1, channels, &samples[0]);
+	float milliseconds = clock.getElapsedTime().asSeconds() * 1000.f;
+
+	std::cout << "[ BENCH    ] 10 s of mono 22050 Hz decoded in " << milliseconds << " ms, "
+	          << priv::getAdpcmSize(sampleCount, 1) / 1024 << " KB of frames instead of "
+	          << sampleCount * sizeof(Int16) / 1024 << " KB of samples" << std::endl;
+	EXPECT_LE(priv::getAdpcmSize(sampleCount, 1) * 3, sampleCount * sizeof(Int16));
+}
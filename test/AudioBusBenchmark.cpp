@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Audio/AudioBus.hpp>
+#include <cpp3ds/Audio/AudioNodes.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int sampleRate = 32000;
+	const double pi = 3.14159265358979;
+
+	std::vector<Int16> makeTone(float frequency, float amplitude, unsigned int frameCount, unsigned int channelCount) {
+		std::vector<Int16> tone(frameCount * channelCount);
+		for (unsigned int i = 0; i < frameCount; ++i)
+			for (unsigned int c = 0; c < channelCount; ++c)
+				tone[i * channelCount + c] = static_cast<Int16>(amplitude * 32767 * std::sin(2 * pi * std::fmod(double(frequency) * i, sampleRate) / sampleRate));
+		return tone;
+	}
+
+	// Peak of the samples after the first ones, where the nodes have settled
+	float measurePeak(const std::vector<Int16>& samples, std::size_t skip) {
+		int peak = 0;
+		for (std::size_t i = skip; i < samples.size(); ++i)
+			peak = std::max(peak, std::abs(static_cast<int>(samples[i])));
+		return peak / 32767.f;
+	}
+
+}
+
+TEST(AudioBus, LetsSamplesThrough){
+	std::vector<Int16> tone = makeTone(440, 0.5f, 1000, 2);
+	std::vector<Int16> samples = tone;
+
+	// Empty, or with every node bypassed
+	AudioBus bus;
+	bus.prepare(sampleRate, 2);
+	bus.process(&samples[0], samples.size());
+	EXPECT_EQ(tone, samples);
+
+	BiquadNode filter(BiquadNode::LowPass, 200.f);
+	filter.setBypassed(true);
+	bus.add(filter);
+	bus.prepare(sampleRate, 2);
+	bus.process(&samples[0], samples.size());
+	EXPECT_EQ(tone, samples);
+	EXPECT_EQ(0, filter.getCpuTime().asMicroseconds());
+
+	GainNode unity;
+	bus.add(unity);
+	bus.prepare(sampleRate, 2);
+	bus.process(&samples[0], samples.size());
+	EXPECT_EQ(tone, samples);
+}
+
+TEST(AudioBus, FiltersTones){
+	BiquadNode filter(BiquadNode::LowPass, 500.f);
+	AudioBus bus;
+	bus.add(filter);
+
+	// Well below the cutoff
+	std::vector<Int16> low = makeTone(100, 0.5f, sampleRate / 4, 1);
+	bus.prepare(sampleRate, 1);
+	bus.process(&low[0], low.size());
+	EXPECT_NEAR(0.5f, measurePeak(low, 1000), 0.02f);
+
+	// Two octaves above, 24 dB down
+	std::vector<Int16> high = makeTone(2000, 0.5f, sampleRate / 4, 1);
+	bus.prepare(sampleRate, 1);
+	bus.process(&high[0], high.size());
+	EXPECT_LT(measurePeak(high, 1000), 0.5f / 12);
+
+	// Changed while playing
+	filter.setType(BiquadNode::HighPass);
+	high = makeTone(2000, 0.5f, sampleRate / 4, 1);
+	bus.process(&high[0], high.size());
+	EXPECT_NEAR(0.5f, measurePeak(high, 1000), 0.02f);
+}
+
+TEST(AudioBus, FadesAndCompresses){
+	GainNode gain;
+	AudioBus bus;
+	bus.add(gain);
+	bus.prepare(sampleRate, 2);
+
+	// Ducked in 100 ms, in pieces smaller than a block
+	gain.setGain(0.25f, milliseconds(100));
+	std::vector<Int16> tone = makeTone(440, 1.f, sampleRate / 5, 2);
+	for (std::size_t i = 0; i < tone.size(); i += 200)
+		bus.process(&tone[i], std::min<std::size_t>(200, tone.size() - i));
+	EXPECT_NEAR(0.25f, measurePeak(tone, tone.size() / 2 + 400), 0.01f);
+	EXPECT_GT(measurePeak(std::vector<Int16>(tone.begin(), tone.begin() + 400), 0), 0.9f);
+
+	// A full scale tone limited to about -12 dB
+	CompressorNode limiter(-12.f, 100.f, milliseconds(1), milliseconds(50));
+	AudioBus limited;
+	limited.add(limiter);
+	limited.prepare(sampleRate, 2);
+	tone = makeTone(440, 1.f, sampleRate / 2, 2);
+	limited.process(&tone[0], tone.size());
+	EXPECT_NEAR(std::pow(10.f, -12.f / 20), measurePeak(tone, tone.size() / 2), 0.03f);
+	EXPECT_NEAR(12.f, limiter.getGainReduction(), 1.f);
+}
+
+TEST(AudioBus, Echoes){
+	DelayNode delay(milliseconds(100), milliseconds(10), 0.5f, 0.5f);
+	AudioBus bus;
+	bus.add(delay);
+	bus.prepare(sampleRate, 1);
+
+	// An impulse comes back every 10 ms, halved each time
+	std::vector<Int16> samples(sampleRate / 10);
+	samples[0] = 16384;
+	bus.process(&samples[0], samples.size());
+	const unsigned int period = sampleRate / 100;
+	EXPECT_EQ(8192, samples[0]);
+	EXPECT_EQ(8192, samples[period]);
+	EXPECT_EQ(4096, samples[period * 2]);
+	EXPECT_EQ(2048, samples[period * 3]);
+	EXPECT_EQ(0, samples[period + 1]);
+}
+
+TEST(AudioBus, Throughput){
+	const unsigned int seconds = 10;
+	BiquadNode lowPass(BiquadNode::LowPass, 600.f);
+	BiquadNode shelf(BiquadNode::HighShelf, 4000.f, 0.7071f, -6.f);
+	DelayNode echo(milliseconds(500), milliseconds(120));
+	CompressorNode limiter(-6.f, 20.f);
+	GainNode gain(0.8f);
+	AudioNode* nodes[] = {&lowPass, &shelf, &echo, &limiter, &gain};
+	const char* names[] = {"Low-pass", "High shelf", "Delay", "Compressor", "Gain"};
+
+	AudioBus bus;
+	for (int i = 0; i < 5; ++i)
+		bus.add(*nodes[i]);
+	bus.prepare(sampleRate, 2);
+
+	// In the chunk size of a stream
+	std::vector<Int16> tone = makeTone(440, 1.f, sampleRate * seconds, 2);
+	Clock clock;
+	for (std::size_t i = 0; i < tone.size(); i += 2048)
+		bus.process(&tone[i], std::min<std::size_t>(2048, tone.size() - i));
+	float elapsed = clock.getElapsedTime().asSeconds();
+
+	std::cout << "[ BENCH    ] " << seconds << " s of stereo " << sampleRate << " Hz through 5 nodes in "
+	          << elapsed * 1000.f << " ms (" << seconds / elapsed << "x real time, bus at "
+	          << bus.getCpuLoad() * 100.f << "% CPU)" << std::endl;
+	for (int i = 0; i < 5; ++i)
+		std::cout << "[ BENCH    ]   " << names[i] << ": " << nodes[i]->getCpuLoad() * 100.f << "% CPU" << std::endl;
+	EXPECT_GT(bus.getCpuTime(), Time::Zero);
+}
@@ -0,0 +1,173 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/System/Clock.hpp>
+#include "../src/cpp3ds/Graphics/DepthSort.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int width = 400;
+	const unsigned int height = 240;
+
+	// Quads covering a rectangle, as two triangles
+	std::vector<Vertex> makeQuads(const std::vector<IntRect>& rects) {
+		std::vector<Vertex> vertices;
+		for (std::size_t i = 0; i < rects.size(); ++i) {
+			Vector2f topLeft(rects[i].left, rects[i].top);
+			Vector2f bottomRight(rects[i].left + rects[i].width, rects[i].top + rects[i].height);
+			vertices.push_back(Vertex(topLeft));
+			vertices.push_back(Vertex(Vector2f(bottomRight.x, topLeft.y)));
+			vertices.push_back(Vertex(Vector2f(topLeft.x, bottomRight.y)));
+			vertices.push_back(Vertex(Vector2f(topLeft.x, bottomRight.y)));
+			vertices.push_back(Vertex(Vector2f(bottomRight.x, topLeft.y)));
+			vertices.push_back(Vertex(bottomRight));
+		}
+		return vertices;
+	}
+
+	priv::DepthDraw makeDraw(const Vertex* vertices, int layer, bool opaque) {
+		RenderStates states(opaque ? BlendNone : BlendAlpha);
+		states.layer = layer;
+		priv::DepthDraw draw = {vertices, 6, Triangles, states, 0.f};
+		return draw;
+	}
+
+	bool covers(const priv::DepthDraw& draw, unsigned int x, unsigned int y) {
+		return (x >= draw.vertices[0].position.x) && (x < draw.vertices[5].position.x)
+		    && (y >= draw.vertices[0].position.y) && (y < draw.vertices[5].position.y);
+	}
+
+	// Fragments written by the draws in order, the depth test rejecting
+	// the ones behind opaque draws when enabled
+	Uint64 countFragments(const std::vector<priv::DepthDraw>& draws, std::size_t opaqueCount, bool depthTest) {
+		std::vector<float> depth(width * height, 1.f);
+		Uint64 count = 0;
+		for (std::size_t i = 0; i < draws.size(); ++i) {
+			const priv::DepthDraw& draw = draws[i];
+			for (unsigned int y = draw.vertices[0].position.y; y < draw.vertices[5].position.y; ++y)
+				for (unsigned int x = draw.vertices[0].position.x; x < draw.vertices[5].position.x; ++x) {
+					float& pixel = depth[y * width + x];
+					if (depthTest && draw.depth >= pixel)
+						continue;
+					if (i < opaqueCount)
+						pixel = draw.depth;
+					++count;
+				}
+		}
+		return count;
+	}
+
+}
+
+TEST(DepthSort, OpaqueFrontToBackThenTranslucentBackToFront){
+	std::vector<Vertex> vertices = makeQuads(std::vector<IntRect>(6, IntRect(0, 0, 10, 10)));
+	std::vector<priv::DepthDraw> draws;
+	draws.push_back(makeDraw(&vertices[0],  1, true));
+	draws.push_back(makeDraw(&vertices[6],  0, false));
+	draws.push_back(makeDraw(&vertices[12], 2, true));
+	draws.push_back(makeDraw(&vertices[18], 0, true));
+	draws.push_back(makeDraw(&vertices[24], 2, false));
+	draws.push_back(makeDraw(&vertices[30], 0, false));
+
+	ASSERT_EQ(3u, priv::sortDepthDraws(draws));
+
+	const Vertex* expected[] = {&vertices[12], &vertices[0], &vertices[18], &vertices[6], &vertices[30], &vertices[24]};
+	for (std::size_t i = 0; i < draws.size(); ++i)
+		EXPECT_EQ(expected[i], draws[i].vertices) << i;
+
+	// In front means a smaller depth, and draws recorded later in a layer are in front
+	for (std::size_t i = 1; i < 3; ++i)
+		EXPECT_LT(draws[i - 1].depth, draws[i].depth);
+	EXPECT_LT(draws[4].depth, draws[3].depth);
+	EXPECT_LT(draws[5].depth, draws[4].depth);
+	EXPECT_LT(draws[4].depth, draws[2].depth);
+	EXPECT_GT(draws[3].depth, draws[2].depth);
+	for (std::size_t i = 0; i < draws.size(); ++i) {
+		EXPECT_GT(draws[i].depth, -1.f);
+		EXPECT_LT(draws[i].depth, 1.f);
+	}
+}
+
+TEST(DepthSort, SameFragmentsWinAsPainterOrder){
+	std::srand(99);
+	std::vector<IntRect> rects;
+	for (unsigned int i = 0; i < 50; ++i) {
+		int w = std::rand() % 200 + 1, h = std::rand() % 120 + 1;
+		rects.push_back(IntRect(std::rand() % (width - w), std::rand() % (height - h), w, h));
+	}
+	std::vector<Vertex> vertices = makeQuads(rects);
+	std::vector<priv::DepthDraw> draws;
+	for (unsigned int i = 0; i < rects.size(); ++i)
+		draws.push_back(makeDraw(&vertices[i * 6], std::rand() % 4, std::rand() % 3 != 0));
+
+	// Painter's order is layer, then recording order
+	std::vector<priv::DepthDraw> sorted(draws);
+	priv::sortDepthDraws(sorted);
+	std::vector<priv::DepthDraw> painter;
+	for (int layer = 0; layer < 4; ++layer)
+		for (std::size_t i = 0; i < draws.size(); ++i)
+			if (draws[i].states.layer == layer)
+				painter.push_back(draws[i]);
+
+	// The nearest opaque draw covering a pixel is the last one painted there
+	for (unsigned int y = 0; y < height; y += 7)
+		for (unsigned int x = 0; x < width; x += 7) {
+			const Vertex* last = NULL;
+			for (std::size_t i = 0; i < painter.size(); ++i)
+				if (priv::isOpaque(painter[i].states) && covers(painter[i], x, y))
+					last = painter[i].vertices;
+
+			const Vertex* nearest = NULL;
+			float nearestDepth = 1.f;
+			for (std::size_t j = 0; j < sorted.size(); ++j)
+				if (priv::isOpaque(sorted[j].states) && (sorted[j].depth < nearestDepth) && covers(sorted[j], x, y)) {
+					nearest = sorted[j].vertices;
+					nearestDepth = sorted[j].depth;
+				}
+			EXPECT_EQ(last, nearest);
+		}
+}
+
+TEST(DepthSort, StackedOpaqueLayers){
+	// A background, tiles, panels and a HUD, mostly opaque
+	std::vector<IntRect> rects;
+	std::vector<int> layers;
+	std::vector<bool> opaque;
+	rects.push_back(IntRect(0, 0, width, height)); layers.push_back(0); opaque.push_back(true);
+	for (unsigned int y = 0; y < height; y += 16)
+		for (unsigned int x = 0; x < width; x += 16) {
+			rects.push_back(IntRect(x, y, 16, 16)); layers.push_back(1); opaque.push_back(true);
+		}
+	for (unsigned int i = 0; i < 4; ++i) {
+		rects.push_back(IntRect(20 + i * 90, 40, 80, 160)); layers.push_back(2); opaque.push_back(true);
+	}
+	rects.push_back(IntRect(0, 0, width, 24)); layers.push_back(3); opaque.push_back(false);
+	rects.push_back(IntRect(0, 216, width, 24)); layers.push_back(3); opaque.push_back(false);
+
+	std::vector<Vertex> vertices = makeQuads(rects);
+	std::vector<priv::DepthDraw> draws;
+	for (std::size_t i = 0; i < rects.size(); ++i)
+		draws.push_back(makeDraw(&vertices[i * 6], layers[i], opaque[i]));
+
+	// Before: painter's order without depth test
+	Uint64 painterFragments = countFragments(draws, 0, false);
+
+	// After: opaque front to back with depth test, then translucent
+	Clock clock;
+	std::size_t opaqueCount = priv::sortDepthDraws(draws);
+	float sortSeconds = clock.getElapsedTime().asSeconds();
+	Uint64 sortedFragments = countFragments(draws, opaqueCount, true);
+
+	EXPECT_LT(sortedFragments, painterFragments);
+	EXPECT_GE(sortedFragments, static_cast<Uint64>(width * height));
+
+	std::cout << "[ BENCH    ] " << draws.size() << " draws, painter's order: "
+	          << painterFragments << " fragments ("
+	          << static_cast<float>(painterFragments) / (width * height) << " per pixel)" << std::endl;
+	std::cout << "[ BENCH    ] depth sorted: " << sortedFragments << " fragments ("
+	          << static_cast<float>(sortedFragments) / (width * height) << " per pixel), sorted in "
+	          << sortSeconds * 1000.f << " ms" << std::endl;
+}
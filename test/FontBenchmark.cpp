@@ -0,0 +1,207 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/Graphics/FontFamily.hpp>
+#include <cpp3ds/Graphics/TextLayout.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cpp3ds/Resources.hpp>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <algorithm>
+#include <iostream>
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int smallSize = 12;
+	const unsigned int largeSize = 30;
+	const int iterations = 20000;
+
+	// What laying out two texts of different sizes does for each character
+	float layoutCharacter(const Font& font, unsigned int size) {
+		return font.getKerning(L'A', L'V', size) + font.getLineSpacing(size) + font.getUnderlinePosition(size);
+	}
+
+}
+
+TEST(Font, InterleavedSizesKeepTheirMetrics){
+	priv::ResourceInfo resource = priv::core_resources["opensans.ttf"];
+	Font alone, shared;
+	ASSERT_TRUE(alone.loadFromMemory(resource.data, resource.size));
+	ASSERT_TRUE(shared.loadFromMemory(resource.data, resource.size));
+
+	float expected = layoutCharacter(alone, smallSize);
+	for (int i = 0; i < 10; ++i) {
+		layoutCharacter(shared, largeSize);
+		EXPECT_FLOAT_EQ(expected, layoutCharacter(shared, smallSize));
+	}
+	EXPECT_NE(shared.getLineSpacing(smallSize), shared.getLineSpacing(largeSize));
+}
+
+TEST(Font, InterleavedSizes){
+	priv::ResourceInfo resource = priv::core_resources["opensans.ttf"];
+
+	// Before: the face is scaled again on every size change
+	FT_Library library;
+	FT_Face face;
+	ASSERT_EQ(0, FT_Init_FreeType(&library));
+	ASSERT_EQ(0, FT_New_Memory_Face(library, resource.data, resource.size, 0, &face));
+	FT_UInt first = FT_Get_Char_Index(face, L'A');
+	FT_UInt second = FT_Get_Char_Index(face, L'V');
+	FT_Vector kerning;
+	Clock clock;
+	for (int i = 0; i < iterations; ++i) {
+		FT_Set_Pixel_Sizes(face, 0, i % 2 ? largeSize : smallSize);
+		FT_Get_Kerning(face, first, second, FT_KERNING_DEFAULT, &kerning);
+	}
+	float rescaleSeconds = clock.getElapsedTime().asSeconds();
+	FT_Done_Face(face);
+	FT_Done_FreeType(library);
+
+	// After: each size has its own FT_Size and cached metrics
+	Font font;
+	ASSERT_TRUE(font.loadFromMemory(resource.data, resource.size));
+	float sum = 0.f;
+	clock.restart();
+	for (int i = 0; i < iterations; ++i)
+		sum += layoutCharacter(font, i % 2 ? largeSize : smallSize);
+	float interleavedSeconds = clock.getElapsedTime().asSeconds();
+
+	clock.restart();
+	for (int i = 0; i < iterations; ++i)
+		sum += layoutCharacter(font, smallSize);
+	float singleSeconds = clock.getElapsedTime().asSeconds();
+
+	EXPECT_GT(sum, 0.f);
+
+	std::cout << "[ BENCH    ] " << iterations << " interleaved sizes, rescaling the face: "
+	          << rescaleSeconds * 1000.f << " ms" << std::endl;
+	std::cout << "[ BENCH    ] " << iterations << " interleaved sizes, one FT_Size per size: "
+	          << interleavedSeconds * 1000.f << " ms" << std::endl;
+	std::cout << "[ BENCH    ] " << iterations << " single size: "
+	          << singleSeconds * 1000.f << " ms" << std::endl;
+}
+
+TEST(Font, AsyncGlyphsMatchSyncGlyphs){
+	priv::ResourceInfo resource = priv::core_resources["opensans.ttf"];
+	Font sync, async;
+	ASSERT_TRUE(sync.loadFromMemory(resource.data, resource.size));
+	ASSERT_TRUE(async.loadFromMemory(resource.data, resource.size));
+	async.setAsyncLoading(true);
+
+	// Placeholders keep the advance so that layout doesn't jump
+	Glyph placeholder = async.getGlyph(L'g', largeSize, false);
+	EXPECT_TRUE(async.hasPendingGlyphs());
+	EXPECT_EQ(0, placeholder.textureRect.width);
+	EXPECT_NEAR(sync.getGlyph(L'g', largeSize, false).advance, placeholder.advance, 1.f);
+
+	unsigned int updateCount = async.getUpdateCount();
+	Clock clock;
+	while (async.hasPendingGlyphs() && clock.getElapsedTime() < seconds(5))
+		Font::commitPendingGlyphs();
+	ASSERT_FALSE(async.hasPendingGlyphs());
+	EXPECT_NE(updateCount, async.getUpdateCount());
+
+	const Glyph& expected = sync.getGlyph(L'g', largeSize, false);
+	const Glyph& loaded = async.getGlyph(L'g', largeSize, false);
+	EXPECT_FLOAT_EQ(expected.advance, loaded.advance);
+	EXPECT_EQ(expected.bounds, loaded.bounds);
+	EXPECT_EQ(expected.textureRect.width, loaded.textureRect.width);
+	EXPECT_EQ(expected.textureRect.height, loaded.textureRect.height);
+}
+
+TEST(Font, AsyncLoadingFrameSpike){
+	priv::ResourceInfo resource = priv::core_resources["opensans.ttf"];
+	const Uint32 first = 0x400; // A chat message in a new script: Cyrillic
+	const Uint32 count = 64;
+
+	// Before: the frame showing the message rasterizes every glyph
+	Font sync;
+	ASSERT_TRUE(sync.loadFromMemory(resource.data, resource.size));
+	Clock clock;
+	for (Uint32 c = first; c < first + count; ++c)
+		sync.getGlyph(c, largeSize, false, 1.f);
+	float syncSeconds = clock.getElapsedTime().asSeconds();
+
+	// After: that frame only queues them, later frames commit a few each
+	Font async;
+	ASSERT_TRUE(async.loadFromMemory(resource.data, resource.size));
+	async.setAsyncLoading(true);
+	clock.restart();
+	for (Uint32 c = first; c < first + count; ++c)
+		async.getGlyph(c, largeSize, false, 1.f);
+	float queueSeconds = clock.getElapsedTime().asSeconds();
+
+	float worstCommitSeconds = 0.f;
+	Clock timeout;
+	while (async.hasPendingGlyphs() && timeout.getElapsedTime() < seconds(10)) {
+		clock.restart();
+		Font::commitPendingGlyphs();
+		worstCommitSeconds = std::max(worstCommitSeconds, clock.getElapsedTime().asSeconds());
+	}
+	EXPECT_FALSE(async.hasPendingGlyphs());
+
+	std::cout << "[ BENCH    ] " << count << " new outlined glyphs, synchronous: "
+	          << syncSeconds * 1000.f << " ms in one frame" << std::endl;
+	std::cout << "[ BENCH    ] " << count << " new outlined glyphs, asynchronous: "
+	          << queueSeconds * 1000.f << " ms to queue, worst commit "
+	          << worstCommitSeconds * 1000.f << " ms" << std::endl;
+}
+
+TEST(FontFamily, FallbacksOpenOnFirstMiss){
+	// Sansation has no Cyrillic, Open Sans does
+	priv::ResourceInfo latin = priv::core_resources["sansation.ttf"];
+	priv::ResourceInfo cyrillic = priv::core_resources["opensans.ttf"];
+	FontFamily family;
+	ASSERT_TRUE(family.addFromMemory(latin.data, latin.size));
+	ASSERT_TRUE(family.addFromMemory(cyrillic.data, cyrillic.size));
+	ASSERT_TRUE(family.addFromMemory(latin.data, latin.size));
+	EXPECT_EQ(3u, family.getFaceCount());
+
+	IntRect latinRect = family.getGlyph(L'A', largeSize, false).textureRect;
+	EXPECT_EQ(1u, family.getOpenFaceCount());
+
+	Font expected;
+	ASSERT_TRUE(expected.loadFromMemory(cyrillic.data, cyrillic.size));
+	const Glyph& fallback = family.getGlyph(0x416, largeSize, false);
+	EXPECT_EQ(2u, family.getOpenFaceCount());
+	EXPECT_FLOAT_EQ(expected.getGlyph(0x416, largeSize, false).advance, fallback.advance);
+	EXPECT_EQ(expected.getGlyph(0x416, largeSize, false).textureRect.width, fallback.textureRect.width);
+
+	// Both scripts are in the family's page, the last fallback was never needed
+	EXPECT_GT(fallback.textureRect.width, 0);
+	EXPECT_FALSE(latinRect.intersects(fallback.textureRect));
+	EXPECT_EQ(2u, family.getOpenFaceCount());
+	EXPECT_EQ(0.f, family.getKerning(L'A', 0x416, largeSize));
+}
+
+TEST(FontFamily, FallbacksReplaceMissingGlyphs){
+	priv::ResourceInfo latin = priv::core_resources["sansation.ttf"];
+	priv::ResourceInfo cyrillic = priv::core_resources["opensans.ttf"];
+	FontFamily family;
+	ASSERT_TRUE(family.addFromMemory(latin.data, latin.size));
+
+	// Drawn before the fallback is there, as the missing glyph box
+	float missingAdvance = family.getGlyph(0x416, largeSize, false).advance;
+	float latinAdvance = family.getGlyph(L'A', largeSize, false).advance;
+	unsigned int updateCount = family.getUpdateCount();
+	TextLayout layout(String(Uint32(0x416)), family, largeSize);
+	EXPECT_FLOAT_EQ(missingAdvance, layout.getSize().x);
+
+	ASSERT_TRUE(family.addFromMemory(cyrillic.data, cyrillic.size));
+	EXPECT_GT(family.getUpdateCount(), updateCount);
+
+	Font expected;
+	ASSERT_TRUE(expected.loadFromMemory(cyrillic.data, cyrillic.size));
+	float expectedAdvance = expected.getGlyph(0x416, largeSize, false).advance;
+	ASSERT_NE(missingAdvance, expectedAdvance);
+	EXPECT_FLOAT_EQ(expectedAdvance, family.getGlyph(0x416, largeSize, false).advance);
+	EXPECT_FLOAT_EQ(latinAdvance, family.getGlyph(L'A', largeSize, false).advance);
+	EXPECT_FLOAT_EQ(expectedAdvance, layout.getSize().x);
+
+	// The fallback keeps its sizes apart, like the font's own face
+	for (Uint32 codePoint = 0x417; codePoint < 0x430; ++codePoint) {
+		EXPECT_FLOAT_EQ(expected.getGlyph(codePoint, smallSize, false).advance, family.getGlyph(codePoint, smallSize, false).advance);
+		EXPECT_FLOAT_EQ(expected.getGlyph(codePoint, largeSize, false).advance, family.getGlyph(codePoint, largeSize, false).advance);
+	}
+}
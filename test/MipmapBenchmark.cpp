@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/System/Clock.hpp>
+#include "../src/cpp3ds/Graphics/TextureCodec.hpp"
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+TEST(Mipmap, BoxFilterAveragesQuads){
+	// Four 2x2 quads of distinct colors, each averaging to a known value
+	Uint8 source[4 * 4 * 4];
+	for (unsigned int y = 0; y < 4; ++y)
+		for (unsigned int x = 0; x < 4; ++x) {
+			Uint8* p = source + (y * 4 + x) * 4;
+			p[0] = (x + y) % 2 ? 200 : 100;
+			p[1] = x < 2 ? 10 : 20;
+			p[2] = y < 2 ? 255 : 0;
+			p[3] = 255;
+		}
+
+	Uint8 dest[2 * 2 * 4];
+	priv::downsampleBox(source, 4, 4, dest);
+	for (unsigned int i = 0; i < 4; ++i) {
+		EXPECT_EQ(150, dest[i * 4 + 0]);
+		EXPECT_EQ(i % 2 ? 20 : 10, dest[i * 4 + 1]);
+		EXPECT_EQ(i < 2 ? 255 : 0, dest[i * 4 + 2]);
+		EXPECT_EQ(255, dest[i * 4 + 3]);
+	}
+}
+
+TEST(Mipmap, GenerationThroughput){
+	const unsigned int size = 1024;
+	const int iterations = 10;
+
+	std::vector<Uint8> pixels(size * size * 4);
+	for (std::size_t i = 0; i < pixels.size(); ++i)
+		pixels[i] = static_cast<Uint8>(i * 31);
+
+	std::vector<Uint8> levels[2] = {std::vector<Uint8>(size * size), std::vector<Uint8>(size * size)};
+	std::vector<Uint8> tiled(size * size * 4);
+
+	Clock clock;
+	for (int i = 0; i < iterations; ++i) {
+		// Full chain like Texture::generateMipmap: filter, then tile each level
+		const Uint8* source = &pixels[0];
+		unsigned int width = size;
+		int current = 0;
+		while (width > 8) {
+			Uint8* dest = &levels[current][0];
+			priv::downsampleBox(source, width, width, dest);
+			width /= 2;
+			ASSERT_TRUE(priv::encodeTexture(dest, width, width, 0, 0, &tiled[0], width, width, GPU_RGBA8));
+			source = dest;
+			current ^= 1;
+		}
+	}
+	float seconds = clock.getElapsedTime().asSeconds();
+
+	float megapixels = iterations * size * size / 1000000.f;
+	std::cout << "[ BENCH    ] " << size << "x" << size << " RGBA8 mipmap chain: "
+	          << (seconds * 1000.f / iterations) << " ms per texture, "
+	          << (megapixels / seconds) << " source Mpx/s" << std::endl;
+}
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Audio/InputSoundFile.hpp>
+#include <cpp3ds/Audio/Music.hpp>
+#include <cpp3ds/Audio/OutputSoundFile.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cpp3ds/System/Sleep.hpp>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TestFiles.hpp"
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int sampleRate = 8000;
+	const unsigned int frameCount = sampleRate * 3;
+
+	// Pulls chunks the way the stream thread does
+	class TestMusic : public Music {
+	public:
+		using Music::onGetData;
+		using Music::onSeek;
+	};
+
+	// Stereo samples that are easy to tell apart
+	std::vector<Int16> makeSamples() {
+		std::vector<Int16> samples(frameCount * 2);
+		for (std::size_t i = 0; i < samples.size(); ++i)
+			samples[i] = static_cast<Int16>(i % 30000);
+		return samples;
+	}
+
+	// A music file, removed when the test is over
+	class MusicFile : public TestFile {
+	protected:
+		// In the format of the file's extension
+		void writeFile(const char* name, const std::vector<Int16>& samples) {
+			filename = testFilePath(name);
+			OutputSoundFile file;
+			ASSERT_TRUE(file.openFromFile(filename, sampleRate, 2));
+			file.write(&samples[0], samples.size());
+		}
+	};
+
+}
+
+TEST_F(MusicFile, LoopsWithoutGap){
+	std::vector<Int16> samples = makeSamples();
+	ASSERT_NO_FATAL_FAILURE(writeFile("MusicBenchmark.wav", samples));
+
+	TestMusic music;
+	ASSERT_TRUE(music.openFromFile(filename));
+	music.setLoop(true);
+
+	// Each loop streams the whole file, whether decoded ahead or not
+	std::size_t position = 0;
+	float loopMilliseconds = 0;
+	for (int loop = 0; loop < 4;) {
+		SoundStream::Chunk chunk = {NULL, 0};
+		bool playing = music.onGetData(chunk);
+		for (std::size_t i = 0; i < chunk.sampleCount; ++i)
+			ASSERT_EQ(samples[position++], chunk.samples[i]);
+
+		if (!playing) {
+			ASSERT_EQ(samples.size(), position);
+			Clock clock;
+			music.onSeek(Time::Zero);
+			music.onGetData(chunk);
+			loopMilliseconds += clock.getElapsedTime().asSeconds() * 1000.f;
+			for (std::size_t i = 0; i < chunk.sampleCount; ++i)
+				ASSERT_EQ(samples[i], chunk.samples[i]);
+			position = chunk.sampleCount;
+			++loop;
+			sleep(milliseconds(20));
+		}
+	}
+
+	std::cout << "[ BENCH    ] Starting over took " << loopMilliseconds / 4 << " ms on average" << std::endl;
+
+	// Seeks anywhere else land on the right sample
+	music.onSeek(seconds(1.5f));
+	SoundStream::Chunk chunk = {NULL, 0};
+	EXPECT_TRUE(music.onGetData(chunk));
+	EXPECT_EQ(samples[sampleRate * 3], chunk.samples[0]);
+
+	// Without looping, the music ends with the file
+	music.setLoop(false);
+	music.onSeek(Time::Zero);
+	position = 0;
+	while (music.onGetData(chunk))
+		position += chunk.sampleCount;
+	EXPECT_EQ(samples.size(), position + chunk.sampleCount);
+}
+
+#ifdef CPP3DS_ENABLE_OGG
+namespace {
+
+	// The chunk streamed after a seek is where a linear decode has it
+	void expectSeekDecodes(TestMusic& music, const std::vector<Int16>& decoded, float seconds) {
+		music.onSeek(cpp3ds::seconds(seconds));
+		SoundStream::Chunk chunk = {NULL, 0};
+		music.onGetData(chunk);
+		std::size_t offset = static_cast<std::size_t>(seconds * sampleRate) * 2;
+		ASSERT_LT(0u, chunk.sampleCount);
+		ASSERT_LE(offset + chunk.sampleCount, decoded.size());
+		for (std::size_t i = 0; i < chunk.sampleCount; ++i)
+			ASSERT_EQ(decoded[offset + i], chunk.samples[i]) << "sample " << i << " after seeking to " << seconds << " s";
+	}
+
+}
+
+TEST_F(MusicFile, OggSeeksMatchLinearDecode){
+	// A few seek intervals of a chord, Vorbis drops what can't be heard
+	std::vector<Int16> samples(sampleRate * 6 * 2);
+	for (std::size_t i = 0; i < samples.size(); ++i)
+		samples[i] = static_cast<Int16>(6000 * (std::sin(i * 3.14159265f * 440 / sampleRate) + std::sin(i * 3.14159265f * 554 / sampleRate)));
+	ASSERT_NO_FATAL_FAILURE(writeFile("MusicBenchmark.ogg", samples));
+
+	InputSoundFile file;
+	ASSERT_TRUE(file.openFromFile(filename));
+	std::vector<Int16> decoded(file.getSampleCount());
+	ASSERT_EQ(decoded.size(), file.read(&decoded[0], decoded.size()));
+
+	TestMusic music;
+	ASSERT_TRUE(music.openFromFile(filename));
+
+	// Nothing read yet, the file is bisected
+	Clock clock;
+	expectSeekDecodes(music, decoded, 4.25f);
+	float bisectMilliseconds = clock.getElapsedTime().asSeconds() * 1000.f;
+
+	// Once read through, seeks start from the page indexed in their second,
+	// or decode up to the frame when it is less than a second ahead
+	music.onSeek(Time::Zero);
+	SoundStream::Chunk chunk = {NULL, 0};
+	while (music.onGetData(chunk)) {
+	}
+	clock.restart();
+	expectSeekDecodes(music, decoded, 1.5f);
+	expectSeekDecodes(music, decoded, 2.5f);
+	expectSeekDecodes(music, decoded, 4.75f);
+	expectSeekDecodes(music, decoded, 0.5f);
+	float indexedMilliseconds = clock.getElapsedTime().asSeconds() * 1000.f / 4;
+
+	std::cout << "[ BENCH    ] Ogg seek took " << bisectMilliseconds << " ms bisecting, "
+	          << indexedMilliseconds << " ms on average from the index" << std::endl;
+}
+#endif
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Audio/Resampler.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace {
+
+	const double pi = 3.14159265358979;
+
+	// The phase is wrapped every period, so that long tones stay exact
+	std::vector<Int16> makeTone(float frequency, unsigned int sampleRate, unsigned int frameCount, unsigned int channelCount) {
+		std::vector<Int16> tone(frameCount * channelCount);
+		for (unsigned int i = 0; i < frameCount; ++i)
+			for (unsigned int c = 0; c < channelCount; ++c)
+				tone[i * channelCount + c] = static_cast<Int16>(16384 * std::sin(2 * pi * std::fmod(double(frequency) * i, sampleRate) / sampleRate + c));
+		return tone;
+	}
+
+	// Signal to noise ratio against the same tone generated at the output rate, away from the edges
+	float measureSnr(const std::vector<Int16>& output, float frequency, unsigned int sampleRate, unsigned int channelCount) {
+		std::vector<Int16> expected = makeTone(frequency, sampleRate, output.size() / channelCount, channelCount);
+		double signal = 0, noise = 0;
+		for (std::size_t i = 200 * channelCount; i < output.size() - 200 * channelCount; ++i) {
+			signal += double(expected[i]) * expected[i];
+			noise += double(output[i] - expected[i]) * (output[i] - expected[i]);
+		}
+		return static_cast<float>(10 * std::log10(signal / noise));
+	}
+
+}
+
+TEST(Resampler, ConvertsTones){
+	const unsigned int rates[][2] = {{22050, 44100}, {44100, 32000}, {48000, 32728}, {32000, 22050}};
+	for (unsigned int r = 0; r < 4; ++r) {
+		unsigned int inputRate = rates[r][0], outputRate = rates[r][1];
+		std::vector<Int16> input = makeTone(1000, inputRate, inputRate / 2, 2);
+		std::vector<Int16> output;
+		Resampler::resample(&input[0], input.size(), 2, inputRate, outputRate, output, Resampler::Medium);
+
+		// As long as the input, and the same tone
+		EXPECT_EQ((inputRate / 2 * Uint64(outputRate) + inputRate - 1) / inputRate * 2, output.size());
+		EXPECT_GT(measureSnr(output, 1000, outputRate, 2), 50.f) << inputRate << " to " << outputRate;
+	}
+}
+
+TEST(Resampler, StreamsInPieces){
+	std::vector<Int16> input = makeTone(3000, 44100, 20000, 2);
+	std::vector<Int16> whole;
+	Resampler::resample(&input[0], input.size(), 2, 44100, 32000, whole);
+
+	// Any split of the input gives the same output
+	Resampler resampler(44100, 32000, 2);
+	std::vector<Int16> pieces;
+	for (std::size_t i = 0, size = 2; i < input.size(); size = size * 3 % 2000 + 2) {
+		size = std::min(size, input.size() - i);
+		resampler.process(&input[i], size, pieces);
+		i += size;
+	}
+	resampler.flush(pieces);
+	EXPECT_EQ(whole, pieces);
+
+	// Same rates copy the samples
+	Resampler copier(32000, 32000, 2);
+	std::vector<Int16> copy;
+	copier.process(&input[0], input.size(), copy);
+	EXPECT_EQ(input, copy);
+}
+
+TEST(Resampler, Throughput){
+	const unsigned int seconds = 10;
+	std::vector<Int16> input = makeTone(1000, 44100, 44100 * seconds, 2);
+	const char* names[] = {"Fast", "Medium", "Best"};
+
+	for (int quality = Resampler::Fast; quality <= Resampler::Best; ++quality) {
+		std::vector<Int16> output;
+		Clock clock;
+		Resampler::resample(&input[0], input.size(), 2, 44100, 32000, output, static_cast<Resampler::Quality>(quality));
+		float elapsed = clock.getElapsedTime().asSeconds();
+
+		std::cout << "[ BENCH    ] " << names[quality] << ": " << seconds << " s of stereo 44100 Hz to 32000 Hz in "
+		          << elapsed * 1000.f << " ms (" << seconds / elapsed << "x real time), "
+		          << measureSnr(output, 1000, 32000, 2) << " dB SNR" << std::endl;
+	}
+}
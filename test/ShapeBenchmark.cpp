@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/CircleShape.hpp>
+#include <cpp3ds/Graphics/ConvexShape.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cmath>
+#include <iostream>
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int frameCount = 10000;
+
+	void expectRectNear(const FloatRect& expected, const FloatRect& actual) {
+		EXPECT_NEAR(expected.left, actual.left, 1e-3f);
+		EXPECT_NEAR(expected.top, actual.top, 1e-3f);
+		EXPECT_NEAR(expected.width, actual.width, 1e-3f);
+		EXPECT_NEAR(expected.height, actual.height, 1e-3f);
+	}
+
+}
+
+TEST(Shape, OutlineThicknessOnlyMovesOutline){
+	ConvexShape shape(4);
+	shape.setPoint(0, Vector2f(0, 0));
+	shape.setPoint(1, Vector2f(50, 10));
+	shape.setPoint(2, Vector2f(40, 60));
+	shape.setPoint(3, Vector2f(-5, 30));
+	expectRectNear(FloatRect(-5, 0, 55, 60), shape.getLocalBounds());
+
+	// Thinner, thicker, then back to none
+	const float thicknesses[] = {4.f, 10.f, -3.f, 0.f};
+	for (unsigned int i = 0; i < 4; ++i) {
+		shape.setOutlineThickness(thicknesses[i]);
+		ConvexShape fresh(4);
+		for (unsigned int j = 0; j < 4; ++j)
+			fresh.setPoint(j, shape.getPoint(j));
+		fresh.setOutlineThickness(thicknesses[i]);
+		expectRectNear(fresh.getLocalBounds(), shape.getLocalBounds());
+	}
+}
+
+TEST(Shape, CircleRadiusScalesGeometry){
+	CircleShape circle(10.f, 24);
+	circle.setOutlineThickness(3.f);
+	circle.setRadius(37.f);
+
+	CircleShape fresh(37.f, 24);
+	fresh.setOutlineThickness(3.f);
+	expectRectNear(fresh.getLocalBounds(), circle.getLocalBounds());
+	for (unsigned int i = 0; i < 24; ++i) {
+		EXPECT_NEAR(fresh.getPoint(i).x, circle.getPoint(i).x, 1e-4f);
+		EXPECT_NEAR(fresh.getPoint(i).y, circle.getPoint(i).y, 1e-4f);
+	}
+
+	// Through a zero radius, which can't be scaled from
+	circle.setRadius(0.f);
+	circle.setRadius(5.f);
+	CircleShape small(5.f, 24);
+	small.setOutlineThickness(3.f);
+	expectRectNear(small.getLocalBounds(), circle.getLocalBounds());
+}
+
+TEST(Shape, AdaptivePointCount){
+	unsigned int previous = 0;
+	for (float radius = 0.f; radius < 2000.f; radius += 7.f) {
+		unsigned int count = CircleShape::getAdaptivePointCount(radius);
+		EXPECT_EQ(0u, count % 4);
+		EXPECT_GE(count, previous);
+		EXPECT_GE(count, 8u);
+		EXPECT_LE(count, 120u);
+		if (count < 120)
+			EXPECT_LE(radius * (1.f - std::cos(3.141592654f / count)), 0.25f) << radius;
+		previous = count;
+	}
+
+	CircleShape circle(100.f);
+	circle.setAdaptivePointCount(true);
+	EXPECT_TRUE(circle.hasAdaptivePointCount());
+	EXPECT_EQ(CircleShape::getAdaptivePointCount(100.f), circle.getPointCount());
+	circle.setPointCount(30);
+	EXPECT_FALSE(circle.hasAdaptivePointCount());
+}
+
+TEST(Shape, AnimateCircle){
+	// Before: every radius or outline change rebuilt the whole shape
+	Clock clock;
+	for (unsigned int i = 0; i < frameCount; ++i) {
+		float t = static_cast<float>(i % 60) / 60.f;
+		CircleShape circle(20.f + 30.f * t, 30);
+		circle.setOutlineThickness(2.f + 4.f * t);
+	}
+	float rebuildSeconds = clock.getElapsedTime().asSeconds();
+
+	// After: the radius is a scale, the outline is moved along cached directions
+	CircleShape circle(20.f, 30);
+	clock.restart();
+	for (unsigned int i = 0; i < frameCount; ++i) {
+		float t = static_cast<float>(i % 60) / 60.f;
+		circle.setRadius(20.f + 30.f * t);
+		circle.setOutlineThickness(2.f + 4.f * t);
+	}
+	float animateSeconds = clock.getElapsedTime().asSeconds();
+
+	// Color changes never touched the geometry
+	clock.restart();
+	for (unsigned int i = 0; i < frameCount; ++i)
+		circle.setFillColor(Color(i % 256, 0, 0));
+	float colorSeconds = clock.getElapsedTime().asSeconds();
+
+	std::cout << "[ BENCH    ] " << frameCount << " frames of a 30 point circle, rebuilt: "
+	          << rebuildSeconds * 1000.f << " ms, scaled: " << animateSeconds * 1000.f
+	          << " ms, color only: " << colorSeconds * 1000.f << " ms" << std::endl;
+}
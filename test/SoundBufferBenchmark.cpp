@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Audio/OutputSoundFile.hpp>
+#include <cpp3ds/Audio/SoundBuffer.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TestFiles.hpp"
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int sampleRate = 22050;
+
+	std::vector<Int16> makeTone(unsigned int sampleCount) {
+		std::vector<Int16> tone(sampleCount);
+		for (unsigned int i = 0; i < sampleCount; ++i)
+			tone[i] = static_cast<Int16>(16384 * std::sin(i * 2 * 3.14159265f * 440 / sampleRate));
+		return tone;
+	}
+
+	// A few seconds of sound effect, in a file removed when the test is over
+	class SoundBufferFile : public TestFile {
+	protected:
+		void SetUp() {
+			filename = testFilePath("SoundBufferBenchmark.wav");
+			std::vector<Int16> tone = makeTone(sampleRate * 5);
+			OutputSoundFile file;
+			ASSERT_TRUE(file.openFromFile(filename, sampleRate, 1));
+			file.write(&tone[0], tone.size());
+		}
+	};
+
+}
+
+TEST(SoundBuffer, CopiesShareSamples){
+	std::vector<Int16> tone = makeTone(1000);
+	SoundBuffer buffer;
+	ASSERT_TRUE(buffer.loadFromSamples(&tone[0], tone.size(), 1, sampleRate));
+
+	SoundBuffer copy(buffer);
+	SoundBuffer assigned;
+	assigned = buffer;
+	EXPECT_EQ(buffer.getSamples(), copy.getSamples());
+	EXPECT_EQ(buffer.getSamples(), assigned.getSamples());
+	EXPECT_EQ(buffer.getDuration(), copy.getDuration());
+
+	// Loading new samples leaves the copies alone
+	std::vector<Int16> silence(500);
+	ASSERT_TRUE(buffer.loadFromSamples(&silence[0], silence.size(), 1, sampleRate));
+	EXPECT_NE(buffer.getSamples(), copy.getSamples());
+	EXPECT_EQ(1000u, copy.getSampleCount());
+	EXPECT_EQ(tone[100], copy.getSamples()[100]);
+}
+
+TEST_F(SoundBufferFile, LoadsFilesOnce){
+	const int bufferCount = 20;
+
+	Clock clock;
+	SoundBuffer first;
+	ASSERT_TRUE(first.loadFromFile(filename));
+	float decodeMilliseconds = clock.getElapsedTime().asSeconds() * 1000.f;
+
+	clock.restart();
+	std::vector<SoundBuffer> buffers(bufferCount);
+	for (int i = 0; i < bufferCount; ++i) {
+		ASSERT_TRUE(buffers[i].loadFromFile(filename));
+		EXPECT_EQ(first.getSamples(), buffers[i].getSamples());
+	}
+	float sharedMilliseconds = clock.getElapsedTime().asSeconds() * 1000.f;
+
+	std::cout << "[ BENCH    ] 5 s sound decoded in " << decodeMilliseconds << " ms, then loaded "
+	          << bufferCount << " more times in " << sharedMilliseconds << " ms, "
+	          << first.getSampleCount() * sizeof(Int16) / 1024 << " KB of samples held once" << std::endl;
+
+	// Once no buffer uses the file anymore, it is decoded again
+	first = SoundBuffer();
+	buffers.clear();
+	SoundBuffer reloaded;
+	ASSERT_TRUE(reloaded.loadFromFile(filename));
+	EXPECT_EQ(sampleRate * 5, reloaded.getSampleCount());
+}
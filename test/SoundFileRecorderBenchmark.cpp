@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Audio/InputSoundFile.hpp>
+#include <cpp3ds/Audio/SoundFileRecorder.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TestFiles.hpp"
+
+using namespace cpp3ds;
+
+namespace {
+
+	// The rate the 3DS calls 16 kHz
+	const unsigned int sampleRate = 16360;
+
+	// Feeds samples the way the capture thread does, without a microphone
+	class TestRecorder : public SoundFileRecorder {
+	public:
+		using SoundFileRecorder::onProcessSamples;
+		using SoundFileRecorder::onStop;
+		using SoundFileRecorder::startEncoding;
+	};
+
+	std::vector<Int16> makeSamples(std::size_t count) {
+		std::vector<Int16> samples(count);
+		for (std::size_t i = 0; i < count; ++i)
+			samples[i] = static_cast<Int16>((i * 7919) % 60000 - 30000);
+		return samples;
+	}
+
+	// A recording, removed when the test is over
+	class SoundFileRecorderFile : public TestFile {
+	protected:
+		void SetUp() {
+			filename = testFilePath("SoundFileRecorderBenchmark.wav");
+		}
+	};
+
+}
+
+TEST_F(SoundFileRecorderFile, WritesEverySample){
+	TestRecorder recorder;
+	recorder.setFile(filename);
+	recorder.setLatency(milliseconds(10));
+	ASSERT_TRUE(recorder.startEncoding(sampleRate));
+
+	// A second, in reads of the microphone, fits in the default two seconds of buffer
+	std::vector<Int16> samples = makeSamples(sampleRate);
+	std::size_t readSize = sampleRate / 100;
+	for (std::size_t i = 0; i < samples.size(); i += readSize)
+		ASSERT_TRUE(recorder.onProcessSamples(&samples[i], std::min(readSize, samples.size() - i)));
+	recorder.onStop();
+
+	EXPECT_EQ(samples.size(), recorder.getSampleCount());
+	EXPECT_EQ(0u, recorder.getDroppedSampleCount());
+
+	InputSoundFile file;
+	ASSERT_TRUE(file.openFromFile(filename));
+	EXPECT_EQ(sampleRate, file.getSampleRate());
+	ASSERT_EQ(samples.size(), file.getSampleCount());
+	std::vector<Int16> read(samples.size());
+	EXPECT_EQ(samples.size(), file.read(&read[0], read.size()));
+	EXPECT_EQ(samples, read);
+}
+
+TEST_F(SoundFileRecorderFile, CountsWhatTheRingDrops){
+	TestRecorder recorder;
+	recorder.setFile(filename);
+	recorder.setBufferDuration(milliseconds(250));
+	ASSERT_TRUE(recorder.startEncoding(sampleRate));
+
+	// A quarter second is 4090 samples, which the ring rounds up to 4096.
+	// The rest is dropped without waiting.
+	std::vector<Int16> samples = makeSamples(8192);
+	Clock clock;
+	EXPECT_TRUE(recorder.onProcessSamples(&samples[0], samples.size()));
+	float pushMilliseconds = clock.getElapsedTime().asSeconds() * 1000.f;
+	EXPECT_EQ(4096u, recorder.getDroppedSampleCount());
+	recorder.onStop();
+
+	EXPECT_EQ(4096u, recorder.getSampleCount());
+	EXPECT_EQ(4096u, recorder.getDroppedSampleCount());
+
+	std::cout << "[ BENCH    ] Overfeeding the ring by 4096 samples took "
+	          << pushMilliseconds << " ms" << std::endl;
+
+	// Without a buffer, the ring still holds four 20 ms reads of the microphone:
+	// 1312 samples, rounded up to 2048. A new capture starts counting again.
+	recorder.setBufferDuration(Time::Zero);
+	ASSERT_TRUE(recorder.startEncoding(sampleRate));
+	EXPECT_EQ(0u, recorder.getSampleCount());
+	EXPECT_EQ(0u, recorder.getDroppedSampleCount());
+	EXPECT_TRUE(recorder.onProcessSamples(&samples[0], samples.size()));
+	EXPECT_EQ(samples.size() - 2048, recorder.getDroppedSampleCount());
+	recorder.onStop();
+	EXPECT_EQ(2048u, recorder.getSampleCount());
+}
@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Audio/InputSoundFile.hpp>
+#include <cpp3ds/Audio/OutputSoundFile.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "TestFiles.hpp"
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int sampleRate = 44100;
+
+	// In memory when tmpfs is there, so that the writers are measured rather than the disk
+	std::string tmpfsPath(const char* filename) {
+		std::string path = std::string("/dev/shm/") + filename;
+		if (std::ofstream(path.c_str()))
+			return path;
+		return filename;
+	}
+
+	// InputSoundFile::openFromFile would look for the file in the romfs
+	std::vector<char> readFile(const std::string& filename) {
+		std::ifstream file(filename.c_str(), std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	std::vector<Int16> makeSamples(unsigned int frameCount) {
+		std::vector<Int16> samples(frameCount * 2);
+		for (std::size_t i = 0; i < samples.size(); ++i)
+			samples[i] = static_cast<Int16>((i * 7919) % 60000 - 30000);
+		return samples;
+	}
+
+	// In the chunk size of a recorder, returns the longest call
+	float writeInChunks(OutputSoundFile& file, const std::vector<Int16>& samples) {
+		float longest = 0;
+		for (std::size_t i = 0; i < samples.size(); i += 2048) {
+			Clock clock;
+			file.write(&samples[i], std::min<std::size_t>(2048, samples.size() - i));
+			longest = std::max(longest, clock.getElapsedTime().asSeconds());
+		}
+		return longest;
+	}
+
+	// A file written by a writer, removed when the test is over
+	class SoundFileWriterFile : public TestFile {
+	};
+
+}
+
+TEST_F(SoundFileWriterFile, WavThroughput){
+	const unsigned int seconds = 60;
+	filename = tmpfsPath("SoundFileWriterBenchmark.wav");
+	std::vector<Int16> samples = makeSamples(sampleRate * seconds);
+
+	OutputSoundFile file;
+	ASSERT_TRUE(file.openFromFile(filename, sampleRate, 2));
+	Clock clock;
+	writeInChunks(file, samples);
+	file.close();
+	float elapsed = clock.getElapsedTime().asSeconds();
+
+	float megabytes = samples.size() * 2 / (1024.f * 1024.f);
+	std::cout << "[ BENCH    ] " << seconds << " s of stereo " << sampleRate << " Hz to WAV in "
+	          << elapsed * 1000.f << " ms (" << megabytes / elapsed << " MB/s)" << std::endl;
+
+	// Every sample is there, and the header tells how many
+	std::vector<char> bytes = readFile(filename);
+	InputSoundFile input;
+	ASSERT_TRUE(input.openFromMemory(bytes.data(), bytes.size()));
+	EXPECT_EQ(samples.size(), input.getSampleCount());
+	std::vector<Int16> read(samples.size());
+	EXPECT_EQ(samples.size(), input.read(&read[0], read.size()));
+	EXPECT_EQ(samples, read);
+}
+
+#ifdef CPP3DS_ENABLE_OGG
+TEST_F(SoundFileWriterFile, OggWritesDontWaitForTheEncoder){
+	const unsigned int seconds = 10;
+	filename = tmpfsPath("SoundFileWriterBenchmark.ogg");
+	std::vector<Int16> samples = makeSamples(sampleRate * seconds);
+
+	OutputSoundFile file;
+	ASSERT_TRUE(file.openFromFile(filename, sampleRate, 2));
+	Clock clock;
+	float longest = writeInChunks(file, std::vector<Int16>(samples.begin(), samples.begin() + sampleRate));
+	float written = clock.getElapsedTime().asSeconds();
+	writeInChunks(file, std::vector<Int16>(samples.begin() + sampleRate, samples.end()));
+	file.close();
+	float elapsed = clock.getElapsedTime().asSeconds();
+
+	std::cout << "[ BENCH    ] Writing half a second to Ogg took " << written * 1000.f << " ms, "
+	          << longest * 1000.f << " ms at most per chunk" << std::endl;
+	std::cout << "[ BENCH    ] " << seconds << " s of stereo " << sampleRate << " Hz encoded in "
+	          << elapsed * 1000.f << " ms (" << seconds / elapsed << "x real time)" << std::endl;
+
+	// Queuing a chunk takes a lot less than playing it, the encoder never holds up the writer
+	float chunkSeconds = 1024.f / sampleRate;
+	EXPECT_LT(longest, chunkSeconds);
+	EXPECT_LT(written, 0.5f);
+
+	// Vorbis keeps the exact length
+	std::vector<char> bytes = readFile(filename);
+	InputSoundFile input;
+	ASSERT_TRUE(input.openFromMemory(bytes.data(), bytes.size()));
+	ASSERT_EQ(2u, input.getChannelCount());
+	EXPECT_EQ(static_cast<Uint64>(sampleRate) * seconds, input.getSampleCount() / 2);
+	std::vector<Int16> read(samples.size() + 2048);
+	EXPECT_EQ(samples.size(), input.read(&read[0], read.size()));
+}
+#endif
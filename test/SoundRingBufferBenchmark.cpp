@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Audio/SoundRingBuffer.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cpp3ds/System/Lock.hpp>
+#include <cpp3ds/System/Mutex.hpp>
+#include <cpp3ds/System/Sleep.hpp>
+#include <cpp3ds/System/Thread.hpp>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace {
+
+	const std::size_t sampleCount = 4 * 1024 * 1024;
+
+	// Spin on a full or empty ring, and only give the other thread a turn after
+	// many misses in a row, which a single core needs to make progress
+	void backoff(std::size_t moved, unsigned int& misses) {
+		if (moved > 0)
+			misses = 0;
+		else if (++misses % 256 == 0)
+			sleep(Time::Zero);
+	}
+
+	// Pushes a counting sequence in chunks of varying sizes
+	template <typename Ring>
+	struct Producer {
+		Ring* ring;
+		std::size_t chunkSize;
+
+		void run() {
+			std::vector<Int16> chunk(chunkSize);
+			std::size_t sent = 0;
+			unsigned int misses = 0;
+			for (std::size_t i = 0; sent < sampleCount; ++i) {
+				std::size_t size = std::min(sampleCount - sent, 1 + (i * 7919) % chunkSize);
+				for (std::size_t j = 0; j < size; ++j)
+					chunk[j] = static_cast<Int16>(sent + j);
+				for (std::size_t pushed = 0; pushed < size;) {
+					std::size_t count = ring->push(&chunk[pushed], size - pushed);
+					pushed += count;
+					backoff(count, misses);
+				}
+				sent += size;
+			}
+		}
+	};
+
+	// The same ring behind a mutex, for comparison
+	struct LockedRing {
+		SoundRingBuffer ring;
+		Mutex mutex;
+		std::size_t push(const Int16* samples, std::size_t count) {Lock lock(mutex); return ring.push(samples, count);}
+		std::size_t pop(Int16* samples, std::size_t count) {Lock lock(mutex); return ring.pop(samples, count);}
+	};
+
+}
+
+TEST(SoundRingBuffer, Wraps){
+	SoundRingBuffer ring(100);
+	EXPECT_EQ(128u, ring.getCapacity());
+	EXPECT_EQ(128u, ring.getFreeCount());
+
+	// Odd sizes cross the end of the storage at every offset
+	std::vector<Int16> in(200), out(200);
+	Int16 next = 0, expected = 0;
+	for (int i = 0; i < 500; ++i) {
+		std::size_t size = 1 + (i * 37) % 97;
+		for (std::size_t j = 0; j < size; ++j)
+			in[j] = next++;
+		std::size_t pushed = ring.push(&in[0], size);
+		next -= static_cast<Int16>(size - pushed);
+		EXPECT_LE(ring.getCount(), ring.getCapacity());
+
+		std::size_t popped = ring.pop(&out[0], 1 + (i * 53) % 89);
+		for (std::size_t j = 0; j < popped; ++j)
+			ASSERT_EQ(expected++, out[j]);
+	}
+
+	// Full, then dropped
+	ring.clear();
+	EXPECT_EQ(0u, ring.getCount());
+	EXPECT_EQ(128u, ring.push(&in[0], in.size()));
+	EXPECT_EQ(0u, ring.push(&in[0], 1));
+	EXPECT_EQ(100u, ring.skip(100));
+	EXPECT_EQ(28u, ring.getCount());
+}
+
+TEST(SoundRingBuffer, StressesTwoThreads){
+	// A small ring keeps both threads waiting on each other
+	SoundRingBuffer ring(256);
+	Producer<SoundRingBuffer> producer = {&ring, 300};
+	Thread thread(&Producer<SoundRingBuffer>::run, &producer);
+	thread.launch();
+
+	std::vector<Int16> chunk(300);
+	std::size_t received = 0;
+	unsigned int misses = 0;
+	bool ordered = true;
+	for (std::size_t i = 0; received < sampleCount; ++i) {
+		std::size_t popped = ring.pop(&chunk[0], 1 + (i * 104729) % chunk.size());
+		for (std::size_t j = 0; j < popped; ++j)
+			ordered &= (chunk[j] == static_cast<Int16>(received + j));
+		received += popped;
+		backoff(popped, misses);
+	}
+	thread.wait();
+
+	EXPECT_TRUE(ordered);
+	EXPECT_EQ(0u, ring.getCount());
+}
+
+TEST(SoundRingBuffer, Throughput){
+	// Two seconds of stereo 32728 Hz audio, in DSP-sized chunks
+	SoundRingBuffer ring(32728 * 2 * 2);
+	Producer<SoundRingBuffer> producer = {&ring, 1024};
+	Thread thread(&Producer<SoundRingBuffer>::run, &producer);
+
+	std::vector<Int16> chunk(1024);
+	unsigned int misses = 0;
+	Clock clock;
+	thread.launch();
+	for (std::size_t received = 0; received < sampleCount;) {
+		std::size_t popped = ring.pop(&chunk[0], chunk.size());
+		received += popped;
+		backoff(popped, misses);
+	}
+	thread.wait();
+	float lockFreeSeconds = clock.getElapsedTime().asSeconds();
+
+	LockedRing locked;
+	locked.ring.setCapacity(32728 * 2 * 2);
+	Producer<LockedRing> lockedProducer = {&locked, 1024};
+	Thread lockedThread(&Producer<LockedRing>::run, &lockedProducer);
+
+	clock.restart();
+	lockedThread.launch();
+	for (std::size_t received = 0; received < sampleCount;) {
+		std::size_t popped = locked.pop(&chunk[0], chunk.size());
+		received += popped;
+		backoff(popped, misses);
+	}
+	lockedThread.wait();
+	float lockedSeconds = clock.getElapsedTime().asSeconds();
+
+	float megabytes = sampleCount * sizeof(Int16) / (1024.f * 1024.f);
+	std::cout << "[ BENCH    ] " << megabytes << " MB through the ring at " << megabytes / lockFreeSeconds
+	          << " MB/s lock-free, " << megabytes / lockedSeconds << " MB/s behind a mutex" << std::endl;
+}
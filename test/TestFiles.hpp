@@ -0,0 +1,35 @@
+#ifndef CPP3DS_TEST_TESTFILES_HPP
+#define CPP3DS_TEST_TESTFILES_HPP
+
+#include "gtest/gtest.h"
+#include <cpp3ds/System/FileSystem.hpp>
+#include <sys/stat.h>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+	// Files are read through FileSystem::getFilePath, which maps them to ../res/test/romfs
+	// in the tests, so the files a test writes go there too. The directories are created
+	// as needed, relative to where the tests run.
+	inline std::string testFilePath(const std::string& filename) {
+		mkdir("../res", 0755);
+		mkdir("../res/test", 0755);
+		mkdir("../res/test/romfs", 0755);
+		return cpp3ds::FileSystem::getFilePath(filename);
+	}
+
+	// A file a test writes, removed when the test is over if the test named one
+	class TestFile : public ::testing::Test {
+	protected:
+		void TearDown() {
+			if (!filename.empty())
+				std::remove(filename.c_str());
+		}
+
+		std::string filename;
+	};
+
+}
+
+#endif // CPP3DS_TEST_TESTFILES_HPP
@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/Text.hpp>
+#include <cpp3ds/Graphics/TextLayout.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cpp3ds/Resources.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int characterSize = 14;
+
+	// Words of 2 to 9 letters, with a paragraph break every 80 words
+	std::string makeDocument(unsigned int wordCount) {
+		std::srand(1234);
+		std::string document;
+		for (unsigned int i = 0; i < wordCount; ++i) {
+			unsigned int length = std::rand() % 8 + 2;
+			for (unsigned int j = 0; j < length; ++j)
+				document += static_cast<char>('a' + std::rand() % 26);
+			if (i + 1 < wordCount)
+				document += (i % 80 == 79) ? '\n' : ' ';
+		}
+		return document;
+	}
+
+	Font& getFont() {
+		static Font font;
+		static bool loaded = false;
+		if (!loaded) {
+			priv::ResourceInfo resource = priv::core_resources["opensans.ttf"];
+			loaded = font.loadFromMemory(resource.data, resource.size);
+		}
+		return font;
+	}
+
+}
+
+TEST(TextLayout, AddsUpAdvancesAndKerning){
+	const Font& font = getFont();
+	String string("AVAT yo\tWA\nTAVA");
+	TextLayout layout(string, font, characterSize);
+
+	float hspace = font.getGlyph(L' ', characterSize, false).advance;
+	float x = 0.f;
+	float y = 0.f;
+	Uint32 prevChar = 0;
+	for (std::size_t i = 0; i < string.getSize(); ++i) {
+		Uint32 curChar = string[i];
+		x += font.getKerning(prevChar, curChar, characterSize);
+		EXPECT_EQ(Vector2f(x, y), layout.findCharacterPos(i)) << i;
+		prevChar = curChar;
+		switch (curChar) {
+			case ' ':  x += hspace; break;
+			case '\t': x += hspace * 4; break;
+			case '\n': x = 0.f; y += font.getLineSpacing(characterSize); prevChar = 0; break;
+			default:   x += font.getGlyph(curChar, characterSize, false).advance;
+		}
+	}
+	EXPECT_EQ(Vector2f(x, y), layout.findCharacterPos(string.getSize()));
+	EXPECT_EQ(2u, layout.getLines().size());
+	EXPECT_FLOAT_EQ(2 * font.getLineSpacing(characterSize), layout.getSize().y);
+}
+
+TEST(TextLayout, TextUsesLayout){
+	Text text("Hello, World!\nTAVA", getFont(), characterSize);
+	text.setWrapWidth(60.f);
+	const TextLayout& layout = text.getLayout();
+
+	EXPECT_EQ(layout.findCharacterPos(9), text.findCharacterPos(9));
+	EXPECT_EQ(3u, layout.getLines().size());
+	EXPECT_NEAR(layout.getSize().y, text.getLocalBounds().top + text.getLocalBounds().height, characterSize);
+}
+
+TEST(TextLayout, WrapsAtSpaces){
+	const float width = 100.f;
+	TextLayout layout(makeDocument(60), getFont(), characterSize);
+	layout.setWrapWidth(width);
+
+	const std::vector<TextLayout::Line>& lines = layout.getLines();
+	const std::vector<TextLayout::Character>& characters = layout.getCharacters();
+	ASSERT_GT(lines.size(), 1u);
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		EXPECT_LE(lines[i].width, width);
+		EXPECT_EQ(i * getFont().getLineSpacing(characterSize), lines[i].top);
+		if (i + 1 < lines.size()) {
+			// Broken after a space, never inside a word
+			EXPECT_EQ(lines[i].end, lines[i + 1].begin);
+			EXPECT_EQ(L' ', characters[lines[i].end - 1].codePoint);
+		}
+	}
+	EXPECT_FALSE(layout.isTruncated());
+}
+
+TEST(TextLayout, CutsLongWords){
+	TextLayout layout("abcdefghijklmnopqrstuvwxyz", getFont(), characterSize);
+	layout.setWrapWidth(40.f);
+
+	EXPECT_GT(layout.getLines().size(), 2u);
+	EXPECT_LE(layout.getSize().x, 40.f);
+	EXPECT_EQ(26u, layout.getVisibleCount());
+}
+
+TEST(TextLayout, TruncatesWithEllipsis){
+	TextLayout layout(makeDocument(60), getFont(), characterSize);
+	layout.setWrapWidth(100.f);
+	layout.setMaxLines(2);
+
+	const std::vector<TextLayout::Character>& characters = layout.getCharacters();
+	EXPECT_EQ(2u, layout.getLines().size());
+	EXPECT_TRUE(layout.isTruncated());
+	EXPECT_LE(layout.getSize().x, 100.f);
+	ASSERT_EQ(layout.getVisibleCount() + 3, characters.size());
+	EXPECT_EQ(L'.', characters.back().codePoint);
+
+	// Hidden characters are at the ellipsis
+	EXPECT_EQ(characters[layout.getVisibleCount()].position, layout.findCharacterPos(characters.size() + 10));
+}
+
+TEST(TextLayout, MeasureDocument){
+	const unsigned int wordCount = 10000;
+	String document(makeDocument(wordCount));
+
+	// Warm the glyph cache, both ways use the same glyphs
+	TextLayout(document, getFont(), characterSize).getSize();
+
+	// Before: measuring a Text builds its vertices
+	Text text(document, getFont(), characterSize);
+	Clock clock;
+	FloatRect bounds = text.getLocalBounds();
+	float textSeconds = clock.getElapsedTime().asSeconds();
+
+	// After: the layout only adds up advances and kerning
+	TextLayout layout(document, getFont(), characterSize);
+	clock.restart();
+	Vector2f size = layout.getSize();
+	float layoutSeconds = clock.getElapsedTime().asSeconds();
+
+	layout.setWrapWidth(300.f);
+	clock.restart();
+	Vector2f wrappedSize = layout.getSize();
+	float wrapSeconds = clock.getElapsedTime().asSeconds();
+
+	// Cached until something changes
+	clock.restart();
+	layout.getSize();
+	float cachedSeconds = clock.getElapsedTime().asSeconds();
+
+	EXPECT_GT(size.x, 0.f);
+	EXPECT_NEAR(bounds.top + bounds.height, size.y, characterSize);
+	EXPECT_GT(wrappedSize.y, size.y);
+
+	std::cout << "[ BENCH    ] " << wordCount << " words, Text::getLocalBounds: "
+	          << textSeconds * 1000.f << " ms" << std::endl;
+	std::cout << "[ BENCH    ] " << wordCount << " words, TextLayout: "
+	          << layoutSeconds * 1000.f << " ms, wrapped at 300px: " << wrapSeconds * 1000.f
+	          << " ms, cached: " << cachedSeconds * 1000.f << " ms" << std::endl;
+}
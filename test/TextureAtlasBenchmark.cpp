@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <cpp3ds/Graphics/Sprite.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/Graphics/VertexArray.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include "../src/cpp3ds/Graphics/AtlasPacker.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace {
+
+	unsigned int paddedSize(unsigned int size) {
+		unsigned int powerOfTwo = 8;
+		while (powerOfTwo < size)
+			powerOfTwo *= 2;
+		return powerOfTwo;
+	}
+
+	// Counts the draws submitted to it, without a GL context to draw them with:
+	// every submitted draw activates the target once, and binds its texture
+	class CountingTarget : public RenderTarget {
+	public:
+		CountingTarget() : m_drawCount(0) {}
+
+		Vector2u getSize() const {
+			return Vector2u(400, 240);
+		}
+
+		std::size_t getDrawCount() const {
+			return m_drawCount;
+		}
+
+	private:
+		bool activate(bool active) {
+			++m_drawCount;
+			return false;
+		}
+
+		std::size_t m_drawCount;
+	};
+
+	void appendQuad(VertexArray& vertices, Vector2f position, const IntRect& rect) {
+		Vector2f size(rect.width, rect.height);
+		Vector2f texTopLeft(rect.left, rect.top);
+		const Vector2f corners[] = {Vector2f(0, 0), Vector2f(size.x, 0), Vector2f(0, size.y),
+		                            Vector2f(0, size.y), Vector2f(size.x, 0), size};
+		for (int i = 0; i < 6; ++i)
+			vertices.append(Vertex(position + corners[i], texTopLeft + corners[i]));
+	}
+
+	// Typical sprite sheet: icons, tiles and a few larger frames
+	std::vector<Vector2u> makeSpriteSizes(unsigned int count) {
+		std::srand(1234);
+		std::vector<Vector2u> sizes;
+		for (unsigned int i = 0; i < count; ++i) {
+			unsigned int large = (i % 10 == 0) ? 3 : 1;
+			sizes.push_back(Vector2u((std::rand() % 60 + 10) * large, (std::rand() % 60 + 10) * large));
+		}
+		return sizes;
+	}
+
+}
+
+TEST(TextureAtlas, PackerKeepsRectsApart){
+	std::vector<Vector2u> sizes = makeSpriteSizes(300);
+	std::vector<priv::AtlasPlacement> placements;
+	std::vector<Vector2u> pages = priv::packAtlas(sizes, 1024, 1, placements);
+	ASSERT_FALSE(pages.empty());
+	ASSERT_EQ(sizes.size(), placements.size());
+
+	for (std::size_t i = 0; i < placements.size(); ++i) {
+		const IntRect& rect = placements[i].rect;
+		ASSERT_LT(placements[i].page, pages.size());
+		EXPECT_EQ(sizes[i].x, static_cast<unsigned int>(rect.width));
+		EXPECT_EQ(sizes[i].y, static_cast<unsigned int>(rect.height));
+		EXPECT_LE(static_cast<unsigned int>(rect.left + rect.width), pages[placements[i].page].x);
+		EXPECT_LE(static_cast<unsigned int>(rect.top + rect.height), pages[placements[i].page].y);
+
+		// Grow by the padding, neighbours must still not touch
+		IntRect padded(rect.left, rect.top, rect.width + 1, rect.height + 1);
+		for (std::size_t j = i + 1; j < placements.size(); ++j) {
+			if (placements[j].page == placements[i].page) {
+				EXPECT_FALSE(padded.intersects(placements[j].rect)) << i << " overlaps " << j;
+			}
+		}
+	}
+}
+
+TEST(TextureAtlas, PackerRejectsOversizedImages){
+	std::vector<Vector2u> sizes(1, Vector2u(2048, 16));
+	std::vector<priv::AtlasPlacement> placements;
+	EXPECT_TRUE(priv::packAtlas(sizes, 1024, 1, placements).empty());
+}
+
+TEST(TextureAtlas, DrawCallsAndMemory){
+	const unsigned int count = 200;
+	const int iterations = 100;
+	std::vector<Vector2u> sizes = makeSpriteSizes(count);
+
+	// Before: one padded RGBA8 texture per sprite, each sprite a draw of its own
+	std::size_t separateBytes = 0;
+	std::vector<Texture> textures(count);
+	std::vector<Sprite> sprites(count);
+	for (std::size_t i = 0; i < sizes.size(); ++i) {
+		separateBytes += paddedSize(sizes[i].x) * paddedSize(sizes[i].y) * 4;
+		sprites[i].setTexture(textures[i]);
+		sprites[i].setTextureRect(IntRect(0, 0, sizes[i].x, sizes[i].y));
+		sprites[i].setPosition(i % 20 * 20, i / 20 * 20);
+	}
+
+	CountingTarget separateTarget;
+	for (std::size_t i = 0; i < sprites.size(); ++i)
+		separateTarget.draw(sprites[i]);
+
+	// After: sprites sharing a page batched into one VertexArray each
+	std::vector<priv::AtlasPlacement> placements;
+	std::vector<Vector2u> pages;
+	Clock clock;
+	for (int i = 0; i < iterations; ++i)
+		pages = priv::packAtlas(sizes, 1024, 1, placements);
+	float seconds = clock.getElapsedTime().asSeconds();
+
+	std::size_t atlasBytes = 0;
+	for (std::size_t i = 0; i < pages.size(); ++i)
+		atlasBytes += pages[i].x * pages[i].y * 4;
+
+	std::vector<Texture> pageTextures(pages.size());
+	std::vector<VertexArray> batches(pages.size(), VertexArray(Triangles));
+	for (std::size_t i = 0; i < placements.size(); ++i)
+		appendQuad(batches[placements[i].page], sprites[i].getPosition(), placements[i].rect);
+
+	CountingTarget atlasTarget;
+	for (std::size_t i = 0; i < batches.size(); ++i)
+		atlasTarget.draw(batches[i], RenderStates(&pageTextures[i]));
+
+	// Every page holds sprites, so none is allocated or drawn for nothing
+	for (std::size_t i = 0; i < batches.size(); ++i)
+		EXPECT_GT(batches[i].getVertexCount(), 0u) << "page " << i;
+
+	EXPECT_EQ(count, separateTarget.getDrawCount());
+	EXPECT_EQ(pages.size(), atlasTarget.getDrawCount());
+	EXPECT_LT(pages.size(), count);
+	EXPECT_LT(atlasBytes, separateBytes);
+
+	std::cout << "[ BENCH    ] " << count << " sprites: " << separateTarget.getDrawCount() << " draw calls, "
+	          << separateBytes / 1024 << " KiB as separate textures" << std::endl;
+	std::cout << "[ BENCH    ] " << count << " sprites: " << atlasTarget.getDrawCount() << " draw calls, "
+	          << atlasBytes / 1024 << " KiB as atlas, packed in "
+	          << (seconds * 1000.f / iterations) << " ms" << std::endl;
+}
@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/System/Clock.hpp>
+#include "../src/cpp3ds/Audio/VoiceMixer.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace {
+
+	const unsigned int sampleRate = 22050;
+	const unsigned int chunkFrames = 128;
+
+	// A second of a 440 Hz tone at half volume
+	const std::vector<Int16>& getTone(unsigned int channelCount) {
+		static std::vector<Int16> tones[2];
+		std::vector<Int16>& tone = tones[channelCount - 1];
+		if (tone.empty()) {
+			tone.resize(sampleRate * channelCount);
+			for (unsigned int i = 0; i < tone.size(); ++i)
+				tone[i] = static_cast<Int16>(16384 * std::sin(i / channelCount * 2 * 3.14159265f * 440 / sampleRate));
+		}
+		return tone;
+	}
+
+	priv::VoiceSource makeSource(unsigned int channelCount, unsigned int frameCount = sampleRate, unsigned int rate = sampleRate) {
+		priv::VoiceSource source = {&getTone(channelCount)[0], frameCount, channelCount, rate};
+		return source;
+	}
+
+}
+
+TEST(VoiceMixer, MixesAndSaturates){
+	priv::VoiceMixer mixer(8, sampleRate);
+	std::vector<Int16> output(chunkFrames * 2);
+
+	mixer.play(makeSource(1), 0, 1.f, false);
+	mixer.mix(&output[0], chunkFrames);
+	for (unsigned int i = 0; i < chunkFrames; ++i) {
+		EXPECT_NEAR(getTone(1)[i], output[i * 2], 1);
+		EXPECT_EQ(output[i * 2], output[i * 2 + 1]);
+	}
+
+	// Four tones at half volume add up past the 16-bit range
+	for (int i = 0; i < 3; ++i)
+		mixer.play(makeSource(1), 0, 1.f, false);
+	mixer.mix(&output[0], chunkFrames);
+	Int16 peak = 0;
+	for (unsigned int i = 0; i < output.size(); ++i)
+		peak = std::max(peak, output[i]);
+	EXPECT_EQ(32767, peak);
+}
+
+TEST(VoiceMixer, EndsAndLoops){
+	priv::VoiceMixer mixer(2, sampleRate);
+	std::vector<Int16> output(chunkFrames * 2);
+
+	Uint32 once = mixer.play(makeSource(2, 100), 0, 1.f, false);
+	Uint32 looping = mixer.play(makeSource(2, 100), 0, 1.f, true);
+	mixer.mix(&output[0], chunkFrames);
+	EXPECT_FALSE(mixer.isPlaying(once));
+	EXPECT_TRUE(mixer.isPlaying(looping));
+	EXPECT_EQ(1u, mixer.getVoiceCount());
+
+	// The looping voice started again at frame 100
+	EXPECT_NEAR(output[100 * 2], output[0], 1);
+}
+
+TEST(VoiceMixer, StealsByPriorityThenAge){
+	priv::VoiceMixer mixer(3, sampleRate);
+	Uint32 important = mixer.play(makeSource(1), 5, 1.f, true);
+	Uint32 oldest = mixer.play(makeSource(1), 0, 1.f, true);
+	Uint32 newest = mixer.play(makeSource(1), 0, 1.f, true);
+
+	Uint32 stealer = mixer.play(makeSource(1), 0, 1.f, true);
+	EXPECT_NE(0u, stealer);
+	EXPECT_FALSE(mixer.isPlaying(oldest));
+	EXPECT_TRUE(mixer.isPlaying(newest));
+	EXPECT_TRUE(mixer.isPlaying(important));
+
+	// Higher priorities steal, until everything left matters more
+	mixer.stop(newest);
+	mixer.play(makeSource(1), 3, 1.f, true);
+	EXPECT_NE(0u, mixer.play(makeSource(1), 1, 1.f, true));
+	EXPECT_FALSE(mixer.isPlaying(stealer));
+	EXPECT_EQ(0u, mixer.play(makeSource(1), 0, 1.f, true));
+	EXPECT_TRUE(mixer.isPlaying(important));
+}
+
+TEST(VoiceMixer, CullsByDistance){
+	priv::VoiceMixer mixer(4, sampleRate);
+	mixer.setListener(Vector3f(), 10.f, 100.f);
+
+	Uint32 near = mixer.play(makeSource(1), 0, 1.f, true);
+	mixer.setPosition(near, Vector3f(-50.f, 0.f, 0.f));
+	Uint32 far = mixer.play(makeSource(1), 0, 1.f, true);
+	mixer.setPosition(far, Vector3f(500.f, 0.f, 0.f));
+	EXPECT_TRUE(mixer.isCulled(Vector3f(500.f, 0.f, 0.f)));
+	EXPECT_EQ(2u, mixer.getVoiceCount());
+	EXPECT_EQ(1u, mixer.getAudibleVoiceCount());
+
+	// Only on the left, at about half volume
+	std::vector<Int16> output(chunkFrames * 2);
+	mixer.mix(&output[0], chunkFrames);
+	for (unsigned int i = 0; i < chunkFrames; ++i) {
+		EXPECT_NEAR(getTone(1)[i] * 50 / 90, output[i * 2], 2);
+		EXPECT_EQ(0, output[i * 2 + 1]);
+	}
+
+	// The culled voice is the first to go
+	mixer.play(makeSource(1), 0, 1.f, true);
+	mixer.play(makeSource(1), 0, 1.f, true);
+	mixer.play(makeSource(1), 0, 1.f, true);
+	EXPECT_FALSE(mixer.isPlaying(far));
+	EXPECT_TRUE(mixer.isPlaying(near));
+}
+
+TEST(VoiceMixer, ResamplesToOutputRate){
+	priv::VoiceMixer mixer(1, sampleRate);
+	Uint32 voice = mixer.play(makeSource(1, 1000, sampleRate * 2), 0, 1.f, false);
+	std::vector<Int16> output(chunkFrames * 2);
+	for (int i = 0; i < 4; ++i)
+		mixer.mix(&output[0], chunkFrames);
+	EXPECT_FALSE(mixer.isPlaying(voice));
+}
+
+TEST(VoiceMixer, MixVoices){
+	const unsigned int voiceCount = 256;
+	const unsigned int chunkCount = sampleRate / chunkFrames;
+	std::vector<Int16> output(chunkFrames * 2);
+
+	const char* names[] = {"mono", "stereo", "mono at 2x rate"};
+	for (int kind = 0; kind < 3; ++kind) {
+		priv::VoiceMixer mixer(voiceCount, sampleRate);
+		for (unsigned int i = 0; i < voiceCount; ++i)
+			mixer.play(makeSource(kind == 1 ? 2 : 1, sampleRate, kind == 2 ? sampleRate * 2 : sampleRate), 0, 0.01f, true);
+
+		Clock clock;
+		for (unsigned int i = 0; i < chunkCount; ++i)
+			mixer.mix(&output[0], chunkFrames);
+		float milliseconds = clock.getElapsedTime().asSeconds() * 1000.f;
+		EXPECT_EQ(voiceCount, mixer.getVoiceCount());
+
+		// Voices mixed through a millisecond of audio per millisecond spent
+		float audioMilliseconds = chunkCount * chunkFrames * 1000.f / sampleRate;
+		std::cout << "[ BENCH    ] " << voiceCount << " " << names[kind] << " voices, "
+		          << audioMilliseconds << " ms of audio in " << milliseconds << " ms: "
+		          << voiceCount * audioMilliseconds / milliseconds << " voices per ms" << std::endl;
+	}
+
+	// Culled voices cost nothing but moving forward
+	priv::VoiceMixer mixer(voiceCount, sampleRate);
+	mixer.setListener(Vector3f(), 1.f, 100.f);
+	for (unsigned int i = 0; i < voiceCount; ++i)
+		mixer.setPosition(mixer.play(makeSource(1), 0, 1.f, true), Vector3f(1000.f, 0.f, 0.f));
+	Clock clock;
+	for (unsigned int i = 0; i < chunkCount; ++i)
+		mixer.mix(&output[0], chunkFrames);
+	std::cout << "[ BENCH    ] " << voiceCount << " culled voices: "
+	          << clock.getElapsedTime().asSeconds() * 1000.f << " ms" << std::endl;
+}